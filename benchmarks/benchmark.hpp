@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+/**
+ * @file benchmark.hpp
+ * @brief @copybrief ocpp::benchmark::BenchmarkSuite
+ *
+ * @class ocpp::benchmark::BenchmarkSuite
+ * @brief Minimal benchmark runner for the libocpp benchmarks.
+ *
+ * Every benchmark is run repeatedly until a minimum time has passed. The results of all benchmarks of a suite are
+ * written as json to stdout (or to the file given with --output), so they can be compared between releases.
+ *
+ * Supported command line arguments:
+ * - --filter <text>        Only run benchmarks which name contains <text>
+ * - --min-time-ms <ms>     Minimum time to run each benchmark (default 200 ms)
+ * - --output <file>        Write the json results to <file> instead of stdout
+ *
+ * All other arguments of the form --<name> <value> are kept as options of the suite, see get_option.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace ocpp {
+namespace benchmark {
+
+using json = nlohmann::json;
+
+/// \brief Result of a single benchmark
+struct BenchmarkResult {
+    std::string name;
+    std::uint64_t iterations = 0;
+    /// \brief Number of items processed per iteration, e.g. the number of variables requested
+    std::uint64_t items_per_iteration = 1;
+    std::chrono::nanoseconds total{0};
+    /// \brief Additional benchmark specific values
+    json counters = json::object();
+};
+
+inline void to_json(json& j, const BenchmarkResult& result) {
+    const double total_ns = static_cast<double>(result.total.count());
+    const double items = static_cast<double>(result.iterations * result.items_per_iteration);
+    j = json{{"name", result.name},
+             {"iterations", result.iterations},
+             {"items_per_iteration", result.items_per_iteration},
+             {"total_ns", result.total.count()},
+             {"ns_per_iteration", result.iterations > 0 ? total_ns / static_cast<double>(result.iterations) : 0.0},
+             {"items_per_second", total_ns > 0 ? items * 1e9 / total_ns : 0.0}};
+    if (!result.counters.empty()) {
+        j["counters"] = result.counters;
+    }
+}
+
+class BenchmarkSuite {
+private:
+    std::string name;
+    std::vector<BenchmarkResult> results;
+    std::optional<std::string> filter;
+    std::optional<std::string> output;
+    std::chrono::nanoseconds min_time = std::chrono::milliseconds(200);
+    std::map<std::string, std::string> options;
+
+    bool is_filtered(const std::string& benchmark_name) const {
+        return this->filter.has_value() and benchmark_name.find(this->filter.value()) == std::string::npos;
+    }
+
+public:
+    BenchmarkSuite(std::string name, int argc, char** argv) : name(std::move(name)) {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            const std::string argument = argv[i];
+            const std::string value = argv[i + 1];
+            if (argument == "--filter") {
+                this->filter = value;
+            } else if (argument == "--min-time-ms") {
+                this->min_time = std::chrono::milliseconds(std::stoll(value));
+            } else if (argument == "--output") {
+                this->output = value;
+            } else if (argument.rfind("--", 0) == 0) {
+                this->options[argument.substr(2)] = value;
+            } else {
+                std::cerr << "Ignoring unknown argument " << argument << std::endl;
+            }
+        }
+    }
+
+    ///
+    /// \brief Get a benchmark specific numeric option that was given as --<name> <value>.
+    /// \param name             Name of the option without the leading dashes.
+    /// \param default_value    Returned if the option was not given.
+    ///
+    std::int64_t get_option(const std::string& name, std::int64_t default_value) const {
+        const auto it = this->options.find(name);
+        if (it == this->options.end()) {
+            return default_value;
+        }
+        return std::stoll(it->second);
+    }
+
+    ///
+    /// \brief Run a benchmark, where \p setup is executed before every iteration and not measured.
+    /// \param benchmark_name       Name of the benchmark.
+    /// \param items_per_iteration  Number of items that are processed by a single call of \p func.
+    /// \param setup                Called before every iteration, not part of the measured time.
+    /// \param func                 The code to benchmark.
+    /// \return The result, which can be used to add counters until the next benchmark is run. Nullptr if the benchmark
+    ///         was filtered out.
+    ///
+    template <typename Setup, typename Func>
+    BenchmarkResult* run_with_setup(const std::string& benchmark_name, std::uint64_t items_per_iteration,
+                                    Setup&& setup, Func&& func) {
+        if (this->is_filtered(benchmark_name)) {
+            return nullptr;
+        }
+
+        BenchmarkResult result;
+        result.name = benchmark_name;
+        result.items_per_iteration = items_per_iteration;
+        while (result.iterations == 0 or result.total < this->min_time) {
+            setup();
+            const auto start = std::chrono::steady_clock::now();
+            func();
+            result.total += std::chrono::steady_clock::now() - start;
+            result.iterations++;
+        }
+
+        std::cerr << benchmark_name << ": " << result.iterations << " iterations, "
+                  << result.total.count() / result.iterations << " ns/iteration" << std::endl;
+        this->results.push_back(std::move(result));
+        return &this->results.back();
+    }
+
+    ///
+    /// \brief Run a benchmark.
+    /// \param benchmark_name       Name of the benchmark.
+    /// \param items_per_iteration  Number of items that are processed by a single call of \p func.
+    /// \param func                 The code to benchmark.
+    /// \return The result, which can be used to add counters until the next benchmark is run. Nullptr if the benchmark
+    ///         was filtered out.
+    ///
+    template <typename Func>
+    BenchmarkResult* run(const std::string& benchmark_name, std::uint64_t items_per_iteration, Func&& func) {
+        return this->run_with_setup(benchmark_name, items_per_iteration, []() {}, std::forward<Func>(func));
+    }
+
+    ///
+    /// \brief Add a result that was measured by the benchmark itself, e.g. latencies measured on another thread.
+    /// \param result   The result to add.
+    ///
+    void add_result(BenchmarkResult&& result) {
+        if (!this->is_filtered(result.name)) {
+            this->results.push_back(std::move(result));
+        }
+    }
+
+    ///
+    /// \brief Write the results of all benchmarks as json.
+    /// \return Exit code for main.
+    ///
+    int report() const {
+        json report = {{"suite", this->name}, {"results", this->results}};
+#ifdef LIBOCPP_VERSION
+        report["libocpp_version"] = LIBOCPP_VERSION;
+#endif
+
+        if (!this->output.has_value()) {
+            std::cout << report.dump(2) << std::endl;
+            return 0;
+        }
+
+        std::ofstream file(this->output.value());
+        if (!file.is_open()) {
+            std::cerr << "Could not open " << this->output.value() << std::endl;
+            return 1;
+        }
+        file << report.dump(2) << std::endl;
+        return 0;
+    }
+};
+
+} // namespace benchmark
+} // namespace ocpp
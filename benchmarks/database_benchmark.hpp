@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <benchmark.hpp>
+
+#include <everest/database/exceptions.hpp>
+#include <everest/database/sqlite/connection.hpp>
+
+namespace ocpp::benchmark {
+
+///
+/// \brief Runs \p sql \p items times per iteration with a statement that is prepared for every call, like the database
+/// handlers did before they used the StatementCache. The results are the baseline of the benchmarks of the handler
+/// functions that execute the same SQL with a cached statement.
+/// \param execute Binds the parameters of call \p i, steps the statement and reads the result like the handler
+///                function. Returns false if the statement failed.
+///
+template <typename Execute>
+BenchmarkResult* run_prepare_per_call(BenchmarkSuite& suite, const std::string& benchmark_name,
+                                      everest::db::sqlite::ConnectionInterface& connection, const std::string& sql,
+                                      const std::uint64_t items, Execute&& execute) {
+    return suite.run(benchmark_name, items, [&]() {
+        for (std::uint64_t i = 0; i < items; i++) {
+            auto stmt = connection.new_statement(sql);
+            if (!execute(*stmt, i)) {
+                throw everest::db::QueryExecutionException(connection.get_error_message());
+            }
+        }
+    });
+}
+
+///
+/// \brief Runs \p execute for the calls 0 to \p calls - 1 per iteration and measures every call. The percentiles of
+/// the latency of a single call are added to the counters of the result as p50_ns, p90_ns, p99_ns and max_ns.
+///
+template <typename Execute>
+BenchmarkResult* run_latency(BenchmarkSuite& suite, const std::string& benchmark_name, const std::uint64_t calls,
+                             Execute&& execute) {
+    std::vector<std::int64_t> latencies;
+    auto* result = suite.run(benchmark_name, calls, [&]() {
+        for (std::uint64_t i = 0; i < calls; i++) {
+            const auto start = std::chrono::steady_clock::now();
+            execute(i);
+            latencies.push_back(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        }
+    });
+    if (result == nullptr or latencies.empty()) {
+        return result;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](const std::size_t percent) {
+        return latencies.at(std::min(latencies.size() - 1, latencies.size() * percent / 100));
+    };
+    result->counters["p50_ns"] = percentile(50);
+    result->counters["p90_ns"] = percentile(90);
+    result->counters["p99_ns"] = percentile(99);
+    result->counters["max_ns"] = latencies.back();
+    return result;
+}
+
+} // namespace ocpp::benchmark
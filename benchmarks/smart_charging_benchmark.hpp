@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <ocpp/common/types.hpp>
+
+namespace ocpp::benchmark {
+
+constexpr std::int32_t SMART_CHARGING_SECONDS_PER_DAY = 86400;
+
+/// \brief Size of a generated profile stack. The OCPP 1.6 and OCPP 2.x smart charging benchmarks use the same stacks,
+/// so their results can be compared.
+///
+/// Every stack level contains a ChargingStationMaxProfile for the station and a TxDefaultProfile and a TxProfile for
+/// every evse. OCPP 2.x adds a ChargingStationExternalConstraints profile for the station and a PriorityCharging
+/// profile for every evse. Every schedule has \p nr_of_periods periods spread over a day. When \p recurring is set the
+/// ChargingStationMaxProfiles and TxDefaultProfiles are daily recurring profiles that started a week ago, otherwise
+/// they are absolute profiles starting at the current hour.
+struct ProfileStackConfig {
+    std::int32_t nr_of_evses;
+    std::int32_t nr_of_periods;
+    std::int32_t stack_levels;
+    bool recurring;
+
+    std::string get_name() const {
+        return std::to_string(nr_of_evses) + "_evses/" + std::to_string(nr_of_periods) + "_periods/" +
+               std::to_string(stack_levels) + "_levels/" + (recurring ? "recurring" : "absolute");
+    }
+
+    std::int32_t get_period_duration() const {
+        return SMART_CHARGING_SECONDS_PER_DAY / nr_of_periods;
+    }
+
+    /// \brief Limit of period \p period_index of a profile at \p stack_level, higher stack levels are more restrictive
+    float get_limit(const std::int32_t stack_level, const std::int32_t period_index) const {
+        const float limit = 32.0F - static_cast<float>(2 * stack_level);
+        return (period_index % 2) == 0 ? limit : limit / 2;
+    }
+};
+
+inline std::vector<ProfileStackConfig> get_profile_stack_configs() {
+    return {{1, 24, 1, false}, {1, 24, 1, true}, {8, 24, 2, true}, {8, 96, 2, true}, {32, 24, 2, true}};
+}
+
+/// \brief The start of the current hour, absolute profiles start here
+inline DateTime get_hour_start(const DateTime& now) {
+    return DateTime(std::chrono::floor<std::chrono::hours>(now.to_time_point()));
+}
+
+/// \brief The start of the recurring profiles, a week before the current hour
+inline DateTime get_recurrence_start(const DateTime& now) {
+    return DateTime(get_hour_start(now).to_time_point() - std::chrono::hours(24 * 7));
+}
+
+/// \brief Transactions started an hour ago
+inline DateTime get_session_start(const DateTime& now) {
+    return DateTime(now.to_time_point() - std::chrono::hours(1));
+}
+
+} // namespace ocpp::benchmark
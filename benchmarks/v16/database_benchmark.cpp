@@ -0,0 +1,270 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <cstdint>
+#include <filesystem>
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark.hpp>
+#include <database_benchmark.hpp>
+
+#include <everest/database/sqlite/connection.hpp>
+#include <ocpp/v16/database_handler.hpp>
+
+using namespace ocpp;
+using namespace ocpp::v16;
+using ocpp::benchmark::BenchmarkSuite;
+using ocpp::benchmark::run_latency;
+using ocpp::benchmark::run_prepare_per_call;
+using everest::db::sqlite::SQLiteString;
+using everest::db::sqlite::StatementInterface;
+
+namespace {
+
+const std::filesystem::path MIGRATION_FILES_PATH = MIGRATION_FILES_LOCATION_V16;
+const std::filesystem::path DATABASE_PATH =
+    std::filesystem::temp_directory_path() / "libocpp_database_benchmark_v16.db";
+constexpr std::int32_t NR_OF_CONNECTORS = 2;
+const std::string SESSION_ID = "benchmark-session";
+
+std::string get_id_tag(const std::uint64_t index) {
+    return "TAG" + std::to_string(index);
+}
+
+void run_authorization_benchmarks(BenchmarkSuite& suite, DatabaseHandler& handler,
+                                  everest::db::sqlite::ConnectionInterface& connection, const std::uint64_t tokens) {
+    IdTagInfo id_tag_info;
+    id_tag_info.status = AuthorizationStatus::Accepted;
+    for (std::uint64_t i = 0; i < tokens; i++) {
+        handler.insert_or_update_authorization_cache_entry(get_id_tag(i), id_tag_info);
+    }
+
+    std::uint64_t found = 0;
+    auto* result = suite.run("get_authorization_cache_entry/statement_cache", tokens, [&]() {
+        found = 0;
+        for (std::uint64_t i = 0; i < tokens; i++) {
+            found += handler.get_authorization_cache_entry(get_id_tag(i)).has_value() ? 1 : 0;
+        }
+    });
+    if (result != nullptr) {
+        result->counters["found"] = found;
+    }
+    run_prepare_per_call(
+        suite, "get_authorization_cache_entry/prepare_per_call", connection,
+        "SELECT ID_TAG, AUTH_STATUS, EXPIRY_DATE, PARENT_ID_TAG FROM AUTH_CACHE WHERE ID_TAG = @id_tag", tokens,
+        [](StatementInterface& stmt, const std::uint64_t i) {
+            stmt.bind_text("@id_tag", get_id_tag(i), SQLiteString::Transient);
+            if (stmt.step() != SQLITE_ROW) {
+                return false;
+            }
+            return v16::conversions::string_to_authorization_status(stmt.column_text(1)) ==
+                   AuthorizationStatus::Accepted;
+        });
+
+    suite.run("insert_or_update_authorization_cache_entry/statement_cache", tokens, [&]() {
+        for (std::uint64_t i = 0; i < tokens; i++) {
+            handler.insert_or_update_authorization_cache_entry(get_id_tag(i), id_tag_info);
+        }
+    });
+    run_prepare_per_call(suite, "insert_or_update_authorization_cache_entry/prepare_per_call", connection,
+                         "INSERT OR REPLACE INTO AUTH_CACHE (ID_TAG, AUTH_STATUS, EXPIRY_DATE, PARENT_ID_TAG) VALUES "
+                         "(@id_tag, @auth_status, @expiry_date, @parent_id_tag)",
+                         tokens, [](StatementInterface& stmt, const std::uint64_t i) {
+                             stmt.bind_text("@id_tag", get_id_tag(i), SQLiteString::Transient);
+                             stmt.bind_text("@auth_status", "Accepted", SQLiteString::Transient);
+                             stmt.bind_null("@expiry_date");
+                             stmt.bind_null("@parent_id_tag");
+                             return stmt.step() == SQLITE_DONE;
+                         });
+}
+
+void run_transaction_benchmarks(BenchmarkSuite& suite, DatabaseHandler& handler,
+                                everest::db::sqlite::ConnectionInterface& connection, const std::uint64_t updates) {
+    const auto time_start = DateTime().to_rfc3339();
+    handler.insert_transaction(SESSION_ID, 1, 1, "TAG0", time_start, 0, false, std::nullopt, "benchmark-message");
+
+    std::int32_t meter_value = 0;
+    suite.run("update_transaction_meter_value/statement_cache", updates, [&]() {
+        for (std::uint64_t i = 0; i < updates; i++) {
+            handler.update_transaction_meter_value(SESSION_ID, meter_value++, DateTime().to_rfc3339());
+        }
+    });
+    run_prepare_per_call(suite, "update_transaction_meter_value/prepare_per_call", connection,
+                         "UPDATE TRANSACTIONS SET METER_LAST=@meter_last, METER_LAST_TIME=@meter_last_time, "
+                         "LAST_UPDATE=@last_update WHERE ID==@session_id",
+                         updates, [&meter_value](StatementInterface& stmt, const std::uint64_t) {
+                             const auto now = DateTime().to_rfc3339();
+                             stmt.bind_int("@meter_last", meter_value++);
+                             stmt.bind_text("@meter_last_time", now, SQLiteString::Transient);
+                             stmt.bind_text("@last_update", now, SQLiteString::Transient);
+                             stmt.bind_text("@session_id", SESSION_ID);
+                             return stmt.step() == SQLITE_DONE;
+                         });
+
+    suite.run("get_connector_availability/statement_cache", updates, [&]() {
+        for (std::uint64_t i = 0; i < updates; i++) {
+            handler.get_connector_availability(1);
+        }
+    });
+    run_prepare_per_call(suite, "get_connector_availability/prepare_per_call", connection,
+                         "SELECT AVAILABILITY FROM CONNECTORS WHERE ID = @connector", updates,
+                         [](StatementInterface& stmt, const std::uint64_t) {
+                             stmt.bind_int("@connector", 1);
+                             if (stmt.step() != SQLITE_ROW) {
+                                 return false;
+                             }
+                             return v16::conversions::string_to_availability_type(stmt.column_text(0)) ==
+                                    AvailabilityType::Operative;
+                         });
+}
+
+/// \brief Stores local authorization lists of 1k, 10k and 100k entries like a Full SendLocalList. The entries are also
+/// stored one by one like before the bulk insert, which commits every entry on its own, up to \p max_per_entry entries.
+void run_local_authorization_list_benchmarks(BenchmarkSuite& suite, DatabaseHandler& handler,
+                                             const std::uint64_t max_entries, const std::uint64_t max_per_entry) {
+    IdTagInfo id_tag_info;
+    id_tag_info.status = AuthorizationStatus::Accepted;
+    id_tag_info.expiryDate = DateTime("2030-01-01T00:00:00Z");
+
+    for (const std::uint64_t entries : {1000, 10000, 100000}) {
+        if (entries > max_entries) {
+            continue;
+        }
+        std::vector<LocalAuthorizationList> list;
+        list.reserve(entries);
+        for (std::uint64_t i = 0; i < entries; i++) {
+            LocalAuthorizationList authorization_data;
+            authorization_data.idTag = get_id_tag(i);
+            authorization_data.idTagInfo = id_tag_info;
+            list.push_back(authorization_data);
+        }
+
+        const auto clear = [&handler]() { handler.clear_local_authorization_list(); };
+        suite.run_with_setup("insert_or_update_local_authorization_list/" + std::to_string(entries), entries, clear,
+                             [&]() { handler.insert_or_update_local_authorization_list(list); });
+        if (entries <= max_per_entry) {
+            suite.run_with_setup("insert_or_update_local_authorization_list_entry/" + std::to_string(entries), entries,
+                                 clear, [&]() {
+                                     for (const auto& authorization_data : list) {
+                                         handler.insert_or_update_local_authorization_list_entry(
+                                             authorization_data.idTag, authorization_data.idTagInfo.value());
+                                     }
+                                 });
+        }
+        handler.clear_local_authorization_list();
+    }
+}
+
+/// \brief Measures the latency of the lookups of authorize_id_token in the local authorization list of \p entries
+/// entries and in the authorization cache. The handler, which answers from its AuthorizationIndex, is compared with a
+/// lookup in SQLite like before the index (`sqlite`). Known id tags are looked up in a set of \p tokens id tags, whose
+/// entries stay in the index, and in all entries of the list, whose entries do not fit into the index
+/// (`known_uncached`).
+void run_authorize_latency_benchmarks(BenchmarkSuite& suite, DatabaseHandler& handler,
+                                      everest::db::sqlite::ConnectionInterface& connection, const std::uint64_t entries,
+                                      const std::uint64_t tokens) {
+    IdTagInfo id_tag_info;
+    id_tag_info.status = AuthorizationStatus::Accepted;
+
+    std::vector<LocalAuthorizationList> list;
+    list.reserve(entries);
+    std::vector<CiString<20>> all_id_tags;
+    all_id_tags.reserve(entries);
+    for (std::uint64_t i = 0; i < entries; i++) {
+        all_id_tags.emplace_back("TAP" + std::to_string(i));
+        LocalAuthorizationList authorization_data;
+        authorization_data.idTag = all_id_tags.back();
+        authorization_data.idTagInfo = id_tag_info;
+        list.push_back(authorization_data);
+    }
+    handler.clear_local_authorization_list();
+    handler.insert_or_update_local_authorization_list(list);
+
+    std::vector<CiString<20>> known_id_tags;
+    std::vector<CiString<20>> unknown_id_tags;
+    for (std::uint64_t i = 0; i < tokens; i++) {
+        known_id_tags.push_back(all_id_tags.at(i % entries));
+        unknown_id_tags.emplace_back("UNKNOWN" + std::to_string(i));
+        handler.insert_or_update_authorization_cache_entry(known_id_tags.back(), id_tag_info);
+    }
+
+    for (const std::string table_name : {"AUTH_LIST", "AUTH_CACHE"}) {
+        // Prepared once and reused, like the cached statement of the handler before the index
+        auto stmt = connection.new_statement("SELECT ID_TAG, AUTH_STATUS, EXPIRY_DATE, PARENT_ID_TAG FROM " +
+                                             table_name + " WHERE ID_TAG = @id_tag");
+        const auto get_entry_from_sqlite = [&stmt](const CiString<20>& id_tag) -> std::optional<IdTagInfo> {
+            stmt->reset();
+            stmt->bind_text("@id_tag", id_tag.get(), SQLiteString::Transient);
+            if (stmt->step() != SQLITE_ROW) {
+                return std::nullopt;
+            }
+            IdTagInfo info;
+            info.status = v16::conversions::string_to_authorization_status(stmt->column_text(1));
+            if (stmt->column_type(2) != SQLITE_NULL) {
+                info.expiryDate.emplace(stmt->column_text(2));
+            }
+            if (stmt->column_type(3) != SQLITE_NULL) {
+                info.parentIdTag.emplace(stmt->column_text(3));
+            }
+            return info;
+        };
+        const auto get_entry = [&handler, &table_name](const CiString<20>& id_tag) {
+            return table_name == "AUTH_LIST" ? handler.get_local_authorization_list_entry(id_tag)
+                                             : handler.get_authorization_cache_entry(id_tag);
+        };
+        const std::string benchmark_name =
+            table_name == "AUTH_LIST" ? "get_local_authorization_list_entry/" : "get_authorization_cache_entry/";
+
+        std::vector<std::pair<std::string, const std::vector<CiString<20>>*>> lookups = {
+            {"known", &known_id_tags}, {"unknown", &unknown_id_tags}};
+        if (table_name == "AUTH_LIST") {
+            lookups.emplace_back("known_uncached", &all_id_tags);
+        }
+        for (const auto& [name, lookup_id_tags] : lookups) {
+            const auto* id_tags = lookup_id_tags; // structured bindings can not be captured in C++17
+            run_latency(suite, benchmark_name + name + "/index", id_tags->size(),
+                        [&](const std::uint64_t i) { get_entry(id_tags->at(i)); });
+            run_latency(suite, benchmark_name + name + "/sqlite", id_tags->size(),
+                        [&](const std::uint64_t i) { get_entry_from_sqlite(id_tags->at(i)); });
+        }
+    }
+    handler.clear_local_authorization_list();
+    handler.clear_authorization_cache();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchmarkSuite suite("database_v16", argc, argv);
+    const auto tokens = static_cast<std::uint64_t>(suite.get_option("tokens", 1000));
+    const auto updates = static_cast<std::uint64_t>(suite.get_option("updates", 100));
+    const auto local_list_entries = static_cast<std::uint64_t>(suite.get_option("local-list-entries", 100000));
+    const auto local_list_per_entry = static_cast<std::uint64_t>(suite.get_option("local-list-per-entry", 10000));
+    const auto authorize_entries =
+        static_cast<std::uint64_t>(std::max<std::int64_t>(suite.get_option("authorize-entries", 10000), 1));
+
+    std::filesystem::remove(DATABASE_PATH);
+    {
+        DatabaseHandler handler(std::make_unique<everest::db::sqlite::Connection>(DATABASE_PATH),
+                                MIGRATION_FILES_PATH, NR_OF_CONNECTORS);
+        handler.open_connection();
+        // Second connection to the same database for the baseline, which prepares every statement again
+        everest::db::sqlite::Connection connection(DATABASE_PATH);
+        connection.open_connection();
+
+        run_authorization_benchmarks(suite, handler, connection, tokens);
+        run_transaction_benchmarks(suite, handler, connection, updates);
+        run_local_authorization_list_benchmarks(suite, handler, local_list_entries, local_list_per_entry);
+        run_authorize_latency_benchmarks(suite, handler, connection, authorize_entries, tokens);
+
+        connection.close_connection();
+        handler.close_connection();
+    }
+    std::filesystem::remove(DATABASE_PATH);
+    return suite.report();
+}
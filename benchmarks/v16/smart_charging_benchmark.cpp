@@ -0,0 +1,232 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark.hpp>
+#include <smart_charging_benchmark.hpp>
+
+#include <everest/database/sqlite/connection.hpp>
+#include <ocpp/v16/charge_point_configuration.hpp>
+#include <ocpp/v16/connector.hpp>
+#include <ocpp/v16/database_handler.hpp>
+#include <ocpp/v16/smart_charging.hpp>
+
+using namespace ocpp;
+using namespace ocpp::v16;
+using ocpp::benchmark::BenchmarkSuite;
+using ocpp::benchmark::ProfileStackConfig;
+
+namespace {
+
+const std::filesystem::path MIGRATION_FILES_PATH = MIGRATION_FILES_LOCATION_V16;
+const std::filesystem::path CONFIG_DIR = CONFIG_DIR_V16;
+const std::filesystem::path BENCHMARK_PATH =
+    std::filesystem::temp_directory_path() / "libocpp_smart_charging_benchmark_v16";
+const std::filesystem::path USER_CONFIG_PATH = BENCHMARK_PATH / "user_config.json";
+const std::filesystem::path DATABASE_PATH = BENCHMARK_PATH / "cp.db";
+constexpr std::int32_t STATION_WIDE_ID = 0;
+
+/// \brief A profile and the connector it is added for
+struct ProfileEntry {
+    ChargingProfile profile;
+    std::int32_t connector_id;
+};
+
+/// \brief SmartChargingHandler of a station with \p nr_of_connectors connectors, every connector has an active
+/// transaction with the connector id as transaction id
+class Station {
+public:
+    Station(ChargePointConfiguration& configuration, const std::int32_t nr_of_connectors,
+            const DateTime& session_start) :
+        database_handler(std::make_shared<DatabaseHandler>(
+            std::make_unique<everest::db::sqlite::Connection>(DATABASE_PATH), MIGRATION_FILES_PATH, nr_of_connectors)),
+        handler(connectors, database_handler, configuration) {
+        this->database_handler->open_connection();
+        for (std::int32_t id = 0; id <= nr_of_connectors; id++) {
+            auto connector = std::make_shared<Connector>(id);
+            if (id != STATION_WIDE_ID) {
+                connector->transaction = std::make_shared<Transaction>(
+                    -1, id, "benchmark-session-" + std::to_string(id), "benchmark", 0, std::nullopt, session_start,
+                    std::unique_ptr<Everest::SteadyTimer>());
+                connector->transaction->set_transaction_id(id);
+            }
+            this->connectors[id] = connector;
+        }
+    }
+
+    std::map<std::int32_t, std::shared_ptr<Connector>> connectors;
+    std::shared_ptr<DatabaseHandler> database_handler;
+    SmartChargingHandler handler;
+};
+
+std::unique_ptr<ChargePointConfiguration> create_configuration() {
+    std::ofstream(USER_CONFIG_PATH) << "{}";
+    std::ifstream ifs(CONFIG_DIR / "config.json");
+    std::stringstream config;
+    config << ifs.rdbuf();
+    return std::make_unique<ChargePointConfiguration>(config.str(), CONFIG_DIR, USER_CONFIG_PATH);
+}
+
+ChargingSchedule create_schedule(const ProfileStackConfig& config, const std::int32_t stack_level,
+                                 const std::optional<DateTime>& start_schedule) {
+    ChargingSchedule schedule;
+    schedule.chargingRateUnit = ChargingRateUnit::A;
+    schedule.startSchedule = start_schedule;
+    for (std::int32_t i = 0; i < config.nr_of_periods; i++) {
+        ChargingSchedulePeriod period;
+        period.startPeriod = i * config.get_period_duration();
+        period.limit = config.get_limit(stack_level, i);
+        schedule.chargingSchedulePeriod.push_back(period);
+    }
+    return schedule;
+}
+
+ChargingProfile create_profile(const std::int32_t id, const std::int32_t stack_level,
+                               const ChargingProfilePurposeType purpose, const ChargingProfileKindType kind,
+                               ChargingSchedule schedule) {
+    ChargingProfile profile;
+    profile.chargingProfileId = id;
+    profile.stackLevel = stack_level;
+    profile.chargingProfilePurpose = purpose;
+    profile.chargingProfileKind = kind;
+    if (kind == ChargingProfileKindType::Recurring) {
+        profile.recurrencyKind = RecurrencyKindType::Daily;
+    }
+    profile.chargingSchedule = std::move(schedule);
+    return profile;
+}
+
+/// \brief The profiles of the stack described by \p config, see ProfileStackConfig. OCPP 1.6 has no
+/// ChargingStationExternalConstraints and PriorityCharging profiles.
+std::vector<ProfileEntry> create_profile_stack(const ProfileStackConfig& config, const DateTime& now) {
+    const auto hour_start = ocpp::benchmark::get_hour_start(now);
+    const auto recurring_kind =
+        config.recurring ? ChargingProfileKindType::Recurring : ChargingProfileKindType::Absolute;
+    const auto recurring_start = config.recurring ? ocpp::benchmark::get_recurrence_start(now) : hour_start;
+    const auto session_start = ocpp::benchmark::get_session_start(now);
+
+    std::vector<ProfileEntry> profiles;
+    std::int32_t id = 1;
+    for (std::int32_t stack_level = 0; stack_level < config.stack_levels; stack_level++) {
+        profiles.push_back({create_profile(id++, stack_level, ChargingProfilePurposeType::ChargePointMaxProfile,
+                                           recurring_kind, create_schedule(config, stack_level, recurring_start)),
+                            STATION_WIDE_ID});
+
+        for (std::int32_t connector_id = 1; connector_id <= config.nr_of_evses; connector_id++) {
+            profiles.push_back({create_profile(id++, stack_level, ChargingProfilePurposeType::TxDefaultProfile,
+                                               recurring_kind, create_schedule(config, stack_level, recurring_start)),
+                                connector_id});
+
+            auto tx_profile =
+                create_profile(id++, stack_level, ChargingProfilePurposeType::TxProfile,
+                               ChargingProfileKindType::Absolute, create_schedule(config, stack_level, session_start));
+            tx_profile.transactionId = connector_id;
+            profiles.push_back({std::move(tx_profile), connector_id});
+        }
+    }
+    return profiles;
+}
+
+/// \brief Validates and adds all \p profiles like a SetChargingProfile.req, returns the number of accepted profiles
+std::size_t add_profiles(SmartChargingHandler& handler, ChargePointConfiguration& configuration,
+                         const ProfileStackConfig& config, const std::vector<ProfileEntry>& profiles) {
+    // The limits of the example configuration are too small for the larger stacks
+    const auto max_charging_profiles_installed = static_cast<int>(profiles.size()) + 1;
+    const auto allowed_charging_rate_units = configuration.getChargingScheduleAllowedChargingRateUnitVector();
+
+    std::size_t accepted = 0;
+    for (const auto& entry : profiles) {
+        auto profile = entry.profile;
+        if (!handler.validate_profile(profile, entry.connector_id, false, configuration.getChargeProfileMaxStackLevel(),
+                                      max_charging_profiles_installed, config.nr_of_periods,
+                                      allowed_charging_rate_units)) {
+            continue;
+        }
+        handler.clear_all_profiles_with_filter(profile.chargingProfileId, std::nullopt, std::nullopt, std::nullopt,
+                                               true);
+        handler.clear_all_profiles_with_filter(std::nullopt, entry.connector_id, profile.stackLevel,
+                                               profile.chargingProfilePurpose, false);
+        if (profile.chargingProfilePurpose == ChargingProfilePurposeType::ChargePointMaxProfile) {
+            handler.add_charge_point_max_profile(profile);
+        } else if (profile.chargingProfilePurpose == ChargingProfilePurposeType::TxDefaultProfile) {
+            handler.add_tx_default_profile(profile, entry.connector_id);
+        } else if (profile.chargingProfilePurpose == ChargingProfilePurposeType::TxProfile) {
+            handler.add_tx_profile(profile, entry.connector_id);
+        }
+        accepted++;
+    }
+    return accepted;
+}
+
+void run_smart_charging_benchmarks(BenchmarkSuite& suite, ChargePointConfiguration& configuration,
+                                   const ProfileStackConfig& config) {
+    const DateTime now;
+    const DateTime end_time(now.to_time_point() +
+                            std::chrono::seconds(ocpp::benchmark::SMART_CHARGING_SECONDS_PER_DAY));
+    const auto profiles = create_profile_stack(config, now);
+
+    std::filesystem::remove(DATABASE_PATH);
+    Station station(configuration, config.nr_of_evses, ocpp::benchmark::get_session_start(now));
+    const auto installed_profiles = add_profiles(station.handler, configuration, config, profiles);
+
+    const auto suffix = "/" + config.get_name();
+    std::size_t accepted = 0;
+    auto* result = suite.run("validate_and_add_profile" + suffix, profiles.size(), [&]() {
+        accepted = add_profiles(station.handler, configuration, config, profiles);
+    });
+    if (result != nullptr) {
+        result->counters["installed_profiles"] = installed_profiles;
+        result->counters["accepted_profiles"] = accepted;
+    }
+
+    std::size_t periods = 0;
+    result = suite.run("calculate_composite_schedule" + suffix, 1, [&]() {
+        const auto schedule =
+            station.handler.calculate_composite_schedule(now, end_time, 1, ChargingRateUnit::A, false, true);
+        periods = schedule.chargingSchedulePeriod.size();
+    });
+    if (result != nullptr) {
+        result->counters["periods"] = periods;
+    }
+
+    // Like ChargePoint::get_all_composite_charging_schedules
+    std::size_t schedules = 0;
+    result = suite.run("get_all_composite_schedules" + suffix, config.nr_of_evses + 1, [&]() {
+        std::map<std::int32_t, ChargingSchedule> charging_schedules;
+        for (std::int32_t connector_id = 0; connector_id <= config.nr_of_evses; connector_id++) {
+            charging_schedules[connector_id] = station.handler.get_composite_schedule(
+                connector_id, ocpp::benchmark::SMART_CHARGING_SECONDS_PER_DAY, ChargingRateUnit::A, false, true);
+        }
+        schedules = charging_schedules.size();
+    });
+    if (result != nullptr) {
+        result->counters["schedules"] = schedules;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchmarkSuite suite("smart_charging_v16", argc, argv);
+
+    std::filesystem::remove_all(BENCHMARK_PATH);
+    std::filesystem::create_directories(BENCHMARK_PATH);
+    auto configuration = create_configuration();
+
+    for (const auto& config : ocpp::benchmark::get_profile_stack_configs()) {
+        run_smart_charging_benchmarks(suite, *configuration, config);
+    }
+
+    configuration.reset();
+    std::filesystem::remove_all(BENCHMARK_PATH);
+    return suite.report();
+}
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark.hpp>
+
+#include <ocpp/common/constants.hpp>
+#include <ocpp/v2/profile.hpp>
+
+using namespace ocpp;
+using namespace ocpp::v2;
+using ocpp::benchmark::BenchmarkSuite;
+
+namespace {
+
+const std::vector<std::int64_t> NR_OF_EVSES = {1, 8, 32};
+constexpr std::int32_t SECONDS_PER_HOUR = 3600;
+constexpr std::int32_t SECONDS_PER_DAY = 24 * SECONDS_PER_HOUR;
+
+/// \brief A schedule with \p nr_of_periods periods of \p period_duration seconds and alternating limits
+ChargingSchedule create_schedule(const std::int32_t nr_of_periods, const std::int32_t period_duration,
+                                 const float limit, const std::optional<DateTime>& start_schedule) {
+    ChargingSchedule schedule;
+    schedule.id = 1;
+    schedule.chargingRateUnit = ChargingRateUnitEnum::A;
+    schedule.startSchedule = start_schedule;
+    for (std::int32_t i = 0; i < nr_of_periods; i++) {
+        ChargingSchedulePeriod period;
+        period.startPeriod = i * period_duration;
+        period.limit = (i % 2) == 0 ? limit : limit / 2;
+        schedule.chargingSchedulePeriod.push_back(period);
+    }
+    return schedule;
+}
+
+ChargingProfile create_profile(const std::int32_t id, const ChargingProfilePurposeEnum purpose,
+                               const ChargingProfileKindEnum kind, ChargingSchedule schedule) {
+    ChargingProfile profile;
+    profile.id = id;
+    profile.stackLevel = 1;
+    profile.chargingProfilePurpose = purpose;
+    profile.chargingProfileKind = kind;
+    if (kind == ChargingProfileKindEnum::Recurring) {
+        profile.recurrencyKind = RecurrencyKindEnum::Daily;
+    }
+    profile.chargingSchedule = {std::move(schedule)};
+    return profile;
+}
+
+/// \brief Every evse has a daily recurring TxDefaultProfile with hourly periods, an absolute TxProfile with quarter
+/// hourly periods and a transaction that started an hour ago
+std::vector<EvseCompositeScheduleInput> create_evse_inputs(const std::int64_t nr_of_evses, const DateTime& now) {
+    const DateTime hour_start(std::chrono::floor<std::chrono::hours>(now.to_time_point()));
+    const DateTime session_start(now.to_time_point() - std::chrono::hours(1));
+
+    std::vector<EvseCompositeScheduleInput> evses;
+    for (std::int32_t evse_id = 1; evse_id <= nr_of_evses; evse_id++) {
+        EvseCompositeScheduleInput input;
+        input.evse_id = evse_id;
+        input.session_start = session_start;
+        input.profiles.push_back(create_profile(evse_id * 10, ChargingProfilePurposeEnum::TxDefaultProfile,
+                                                ChargingProfileKindEnum::Recurring,
+                                                create_schedule(24, SECONDS_PER_HOUR, 32.0F, hour_start)));
+        input.profiles.push_back(create_profile(evse_id * 10 + 1, ChargingProfilePurposeEnum::TxProfile,
+                                                ChargingProfileKindEnum::Absolute,
+                                                create_schedule(96, SECONDS_PER_HOUR / 4, 16.0F, session_start)));
+        evses.push_back(std::move(input));
+    }
+    return evses;
+}
+
+void run_composite_schedule_benchmarks(BenchmarkSuite& suite, const std::int64_t nr_of_evses,
+                                       const std::size_t max_workers) {
+    const DateTime now;
+    CompositeScheduleParameters parameters;
+    parameters.start_time = now;
+    parameters.end_time = DateTime(now.to_time_point() + std::chrono::seconds(SECONDS_PER_DAY));
+    parameters.charging_rate_unit = ChargingRateUnitEnum::A;
+    parameters.simulate_transaction_active = false;
+    parameters.current_limit = DEFAULT_LIMIT_AMPS;
+    parameters.power_limit = DEFAULT_LIMIT_WATTS;
+    parameters.default_number_phases = DEFAULT_AND_MAX_NUMBER_PHASES;
+    parameters.supply_voltage = LOW_VOLTAGE;
+    parameters.ocpp_version = OcppProtocolVersion::v201;
+
+    const std::vector<ChargingProfile> station_wide_profiles = {
+        create_profile(1, ChargingProfilePurposeEnum::ChargingStationMaxProfile, ChargingProfileKindEnum::Absolute,
+                       create_schedule(48, SECONDS_PER_HOUR / 2, 32.0F * static_cast<float>(nr_of_evses), now))};
+    const auto evses = create_evse_inputs(nr_of_evses, now);
+
+    // All evses and the station as a whole, like get_all_composite_schedules
+    std::vector<std::int32_t> evse_ids;
+    for (std::int32_t evse_id = 0; evse_id <= nr_of_evses; evse_id++) {
+        evse_ids.push_back(evse_id);
+    }
+
+    const auto suffix = "/" + std::to_string(nr_of_evses);
+    const std::vector<std::pair<std::string, std::size_t>> runs = {{"sequential", 1}, {"parallel", max_workers}};
+    for (const auto& [name, nr_of_workers] : runs) {
+        // Started outside of the measurement, like the pool SmartCharging owns
+        WorkerPool workers(nr_of_workers);
+        std::size_t periods = 0;
+        auto* result = suite.run(name + suffix, evse_ids.size(), [&]() {
+            const auto schedules =
+                calculate_composite_schedules(parameters, station_wide_profiles, evses, evse_ids, workers);
+            periods = schedules.front().chargingSchedulePeriod.size();
+        });
+        if (result != nullptr) {
+            result->counters["workers"] = workers.get_nr_of_workers();
+            result->counters["station_periods"] = periods;
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchmarkSuite suite("composite_schedule", argc, argv);
+
+    const auto max_workers = static_cast<std::size_t>(std::max<std::int64_t>(suite.get_option("workers", 4), 1));
+    for (const auto nr_of_evses : NR_OF_EVSES) {
+        run_composite_schedule_benchmarks(suite, nr_of_evses, max_workers);
+    }
+
+    return suite.report();
+}
@@ -0,0 +1,383 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark.hpp>
+#include <database_benchmark.hpp>
+
+#include <everest/database/sqlite/connection.hpp>
+#include <ocpp/v2/database_handler.hpp>
+#include <ocpp/v2/transaction.hpp>
+#include <ocpp/v2/utils.hpp>
+
+using namespace ocpp;
+using namespace ocpp::v2;
+using ocpp::benchmark::BenchmarkSuite;
+using ocpp::benchmark::run_latency;
+using ocpp::benchmark::run_prepare_per_call;
+
+namespace {
+
+const std::filesystem::path MIGRATION_FILES_PATH = MIGRATION_FILES_LOCATION_V2;
+const std::filesystem::path DATABASE_PATH = std::filesystem::temp_directory_path() / "libocpp_database_benchmark_v2.db";
+const std::string TRANSACTION_ID = "benchmark-transaction";
+
+using everest::db::sqlite::SQLiteString;
+using everest::db::sqlite::StatementInterface;
+
+std::string get_token_hash(const std::uint64_t index) {
+    return "benchmark-token-hash-" + std::to_string(index);
+}
+
+std::int64_t get_unix_milliseconds() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(DateTime().to_time_point().time_since_epoch())
+        .count();
+}
+
+void run_authorization_benchmarks(BenchmarkSuite& suite, DatabaseHandler& handler,
+                                  everest::db::sqlite::ConnectionInterface& connection, const std::uint64_t tokens) {
+    IdTokenInfo id_token_info;
+    id_token_info.status = AuthorizationStatusEnum::Accepted;
+    for (std::uint64_t i = 0; i < tokens; i++) {
+        handler.authorization_cache_insert_entry(get_token_hash(i), id_token_info);
+    }
+
+    std::uint64_t found = 0;
+    auto* result = suite.run("authorization_cache_get_entry/statement_cache", tokens, [&]() {
+        found = 0;
+        for (std::uint64_t i = 0; i < tokens; i++) {
+            found += handler.authorization_cache_get_entry(get_token_hash(i)).has_value() ? 1 : 0;
+        }
+    });
+    if (result != nullptr) {
+        result->counters["found"] = found;
+    }
+    run_prepare_per_call(suite, "authorization_cache_get_entry/prepare_per_call", connection,
+                         "SELECT ID_TOKEN_INFO, LAST_USED FROM AUTH_CACHE WHERE ID_TOKEN_HASH = @id_token_hash", tokens,
+                         [](StatementInterface& stmt, const std::uint64_t i) {
+                             stmt.bind_text("@id_token_hash", get_token_hash(i), SQLiteString::Transient);
+                             if (stmt.step() != SQLITE_ROW) {
+                                 return false;
+                             }
+                             const AuthorizationCacheEntry entry{json::parse(stmt.column_text(0)),
+                                                                 DateTime(date::utc_clock::time_point(
+                                                                     std::chrono::milliseconds(stmt.column_int64(1))))};
+                             return entry.id_token_info.status == AuthorizationStatusEnum::Accepted;
+                         });
+
+    // The timestamps are written by a single flush like the authorization cache cleanup thread does
+    suite.run("authorization_cache_update_last_used/deferred", tokens, [&]() {
+        for (std::uint64_t i = 0; i < tokens; i++) {
+            handler.authorization_cache_update_last_used(get_token_hash(i));
+        }
+        handler.authorization_cache_flush_last_used();
+    });
+    run_prepare_per_call(suite, "authorization_cache_update_last_used/prepare_per_call", connection,
+                         "UPDATE AUTH_CACHE SET LAST_USED = @last_used WHERE ID_TOKEN_HASH = @id_token_hash", tokens,
+                         [](StatementInterface& stmt, const std::uint64_t i) {
+                             stmt.bind_int64("@last_used", get_unix_milliseconds());
+                             stmt.bind_text("@id_token_hash", get_token_hash(i), SQLiteString::Transient);
+                             return stmt.step() == SQLITE_DONE;
+                         });
+
+    suite.run("authorization_cache_get_binary_size/tracked", tokens, [&]() {
+        for (std::uint64_t i = 0; i < tokens; i++) {
+            handler.authorization_cache_get_binary_size();
+        }
+    });
+    suite.run("authorization_cache_get_binary_size/dbstat", 1,
+              [&]() { handler.authorization_cache_reconcile_binary_size(); });
+
+    // Every iteration exceeds the size by a tenth of the entries, which are removed again by their age
+    const auto new_tokens = std::max<std::uint64_t>(1, tokens / 10);
+    const auto max_binary_size = handler.authorization_cache_get_binary_size();
+    std::uint64_t next_token = tokens;
+    suite.run("authorization_cache_delete_oldest_entries_exceeding", new_tokens, [&]() {
+        for (std::uint64_t i = 0; i < new_tokens; i++) {
+            handler.authorization_cache_insert_entry(get_token_hash(next_token++), id_token_info);
+        }
+        handler.authorization_cache_delete_oldest_entries_exceeding(max_binary_size);
+    });
+}
+
+void run_transaction_benchmarks(BenchmarkSuite& suite, DatabaseHandler& handler,
+                                everest::db::sqlite::ConnectionInterface& connection, const std::uint64_t updates) {
+    EnhancedTransaction transaction(handler, true);
+    transaction.transactionId = TRANSACTION_ID;
+    transaction.connector_id = 1;
+    transaction.seq_no = 0;
+    transaction.chargingState = ChargingStateEnum::Charging;
+    handler.transaction_insert(transaction, 1);
+
+    std::int32_t seq_no = 0;
+    suite.run("transaction_update_seq_no/statement_cache", updates, [&]() {
+        for (std::uint64_t i = 0; i < updates; i++) {
+            handler.transaction_update_seq_no(TRANSACTION_ID, seq_no++);
+        }
+    });
+    run_prepare_per_call(suite, "transaction_update_seq_no/prepare_per_call", connection,
+                         "UPDATE TRANSACTIONS SET SEQ_NO = @seq_no WHERE TRANSACTION_ID = @transaction_id", updates,
+                         [&seq_no](StatementInterface& stmt, const std::uint64_t) {
+                             stmt.bind_int("@seq_no", seq_no++);
+                             stmt.bind_text("@transaction_id", TRANSACTION_ID);
+                             return stmt.step() == SQLITE_DONE;
+                         });
+
+    // Every transaction related message is queued until it is acknowledged
+    common::DBTransactionMessage message;
+    message.json_message = json::array({2, "benchmark-message", "TransactionEvent", json::object()});
+    message.message_type = "TransactionEvent";
+    message.message_attempts = 0;
+    message.unique_id = "benchmark-message";
+    suite.run("insert_and_remove_message_queue_message/statement_cache", updates, [&]() {
+        for (std::uint64_t i = 0; i < updates; i++) {
+            handler.insert_message_queue_message(message);
+            handler.remove_message_queue_message(message.unique_id);
+        }
+    });
+
+    handler.transaction_delete(TRANSACTION_ID);
+}
+
+/// \brief Stores local authorization lists of 1k, 10k and 100k entries like a Full SendLocalList. The entries are also
+/// stored one by one like before the bulk insert, which commits every entry on its own, up to \p max_per_entry entries.
+void run_local_authorization_list_benchmarks(BenchmarkSuite& suite, DatabaseHandler& handler,
+                                             const std::uint64_t max_entries, const std::uint64_t max_per_entry) {
+    IdTokenInfo id_token_info;
+    id_token_info.status = AuthorizationStatusEnum::Accepted;
+    id_token_info.cacheExpiryDateTime = DateTime("2030-01-01T00:00:00Z");
+
+    for (const std::uint64_t entries : {1000, 10000, 100000}) {
+        if (entries > max_entries) {
+            continue;
+        }
+        std::vector<AuthorizationData> list;
+        list.reserve(entries);
+        for (std::uint64_t i = 0; i < entries; i++) {
+            list.push_back(
+                AuthorizationData{IdToken{"RFID" + std::to_string(i), IdTokenEnumStringType::ISO14443}, id_token_info});
+        }
+
+        const auto clear = [&handler]() { handler.clear_local_authorization_list(); };
+        suite.run_with_setup("insert_or_update_local_authorization_list/" + std::to_string(entries), entries, clear,
+                             [&]() { handler.insert_or_update_local_authorization_list(list); });
+        if (entries <= max_per_entry) {
+            suite.run_with_setup("insert_or_update_local_authorization_list_entry/" + std::to_string(entries), entries,
+                                 clear, [&]() {
+                                     for (const auto& authorization_data : list) {
+                                         handler.insert_or_update_local_authorization_list_entry(
+                                             authorization_data.idToken, authorization_data.idTokenInfo.value());
+                                     }
+                                 });
+        }
+        handler.clear_local_authorization_list();
+    }
+}
+
+/// \brief Measures the latency of the lookups of validate_token in the local authorization list of \p entries entries
+/// and in the authorization cache. The handler, which answers from its AuthorizationIndex, is compared with a lookup in
+/// SQLite like before the index (`sqlite`). Known tokens are looked up in a set of \p tokens tokens, whose entries stay
+/// in the index, and in all entries of the list, whose entries do not fit into the index (`known_uncached`).
+void run_authorize_latency_benchmarks(BenchmarkSuite& suite, DatabaseHandler& handler,
+                                      everest::db::sqlite::ConnectionInterface& connection, const std::uint64_t entries,
+                                      const std::uint64_t tokens) {
+    IdTokenInfo id_token_info;
+    id_token_info.status = AuthorizationStatusEnum::Accepted;
+
+    std::vector<AuthorizationData> list;
+    list.reserve(entries);
+    std::vector<IdToken> all_id_tokens;
+    all_id_tokens.reserve(entries);
+    for (std::uint64_t i = 0; i < entries; i++) {
+        all_id_tokens.push_back(IdToken{"TAP" + std::to_string(i), IdTokenEnumStringType::ISO14443});
+        list.push_back(AuthorizationData{all_id_tokens.back(), id_token_info});
+    }
+    handler.clear_local_authorization_list();
+    handler.insert_or_update_local_authorization_list(list);
+
+    std::vector<IdToken> known_id_tokens;
+    std::vector<IdToken> unknown_id_tokens;
+    for (std::uint64_t i = 0; i < tokens; i++) {
+        known_id_tokens.push_back(all_id_tokens.at(i % entries));
+        unknown_id_tokens.push_back(IdToken{"UNKNOWN" + std::to_string(i), IdTokenEnumStringType::ISO14443});
+    }
+
+    // Prepared once and reused, like the cached statement of the handler before the index
+    auto list_stmt =
+        connection.new_statement("SELECT ID_TOKEN_INFO FROM AUTH_LIST WHERE ID_TOKEN_HASH = @id_token_hash");
+    const auto get_list_entry_from_sqlite = [&list_stmt](const IdToken& id_token) -> std::optional<IdTokenInfo> {
+        list_stmt->reset();
+        list_stmt->bind_text("@id_token_hash", utils::generate_token_hash(id_token), SQLiteString::Transient);
+        if (list_stmt->step() != SQLITE_ROW) {
+            return std::nullopt;
+        }
+        return IdTokenInfo(json::parse(list_stmt->column_text(0)));
+    };
+
+    const std::vector<std::pair<std::string, const std::vector<IdToken>*>> list_lookups = {
+        {"known", &known_id_tokens}, {"known_uncached", &all_id_tokens}, {"unknown", &unknown_id_tokens}};
+    for (const auto& [name, lookup_id_tokens] : list_lookups) {
+        const auto* id_tokens = lookup_id_tokens; // structured bindings can not be captured in C++17
+        run_latency(suite, "get_local_authorization_list_entry/" + name + "/index", id_tokens->size(),
+                    [&](const std::uint64_t i) { handler.get_local_authorization_list_entry(id_tokens->at(i)); });
+        run_latency(suite, "get_local_authorization_list_entry/" + name + "/sqlite", id_tokens->size(),
+                    [&](const std::uint64_t i) { get_list_entry_from_sqlite(id_tokens->at(i)); });
+    }
+    list_stmt.reset();
+    handler.clear_local_authorization_list();
+
+    std::vector<std::string> known_hashes;
+    std::vector<std::string> unknown_hashes;
+    for (std::uint64_t i = 0; i < tokens; i++) {
+        known_hashes.push_back(utils::generate_token_hash(known_id_tokens.at(i)));
+        unknown_hashes.push_back(utils::generate_token_hash(unknown_id_tokens.at(i)));
+        handler.authorization_cache_insert_entry(known_hashes.back(), id_token_info);
+    }
+
+    auto cache_stmt = connection.new_statement(
+        "SELECT ID_TOKEN_INFO, LAST_USED FROM AUTH_CACHE WHERE ID_TOKEN_HASH = @id_token_hash");
+    const auto get_cache_entry_from_sqlite =
+        [&cache_stmt](const std::string& id_token_hash) -> std::optional<AuthorizationCacheEntry> {
+        cache_stmt->reset();
+        cache_stmt->bind_text("@id_token_hash", id_token_hash, SQLiteString::Transient);
+        if (cache_stmt->step() != SQLITE_ROW) {
+            return std::nullopt;
+        }
+        return AuthorizationCacheEntry{
+            json::parse(cache_stmt->column_text(0)),
+            DateTime(date::utc_clock::time_point(std::chrono::milliseconds(cache_stmt->column_int64(1))))};
+    };
+
+    const std::vector<std::pair<std::string, const std::vector<std::string>*>> cache_lookups = {
+        {"known", &known_hashes}, {"unknown", &unknown_hashes}};
+    for (const auto& [name, lookup_hashes] : cache_lookups) {
+        const auto* hashes = lookup_hashes;
+        run_latency(suite, "authorization_cache_get_entry/" + name + "/index", hashes->size(),
+                    [&](const std::uint64_t i) { handler.authorization_cache_get_entry(hashes->at(i)); });
+        run_latency(suite, "authorization_cache_get_entry/" + name + "/sqlite", hashes->size(),
+                    [&](const std::uint64_t i) { get_cache_entry_from_sqlite(hashes->at(i)); });
+    }
+    cache_stmt.reset();
+    handler.authorization_cache_clear();
+}
+
+MeterValue create_meter_value(const std::uint64_t index) {
+    const auto create_sampled_value = [](const float value, const MeasurandEnum measurand,
+                                         const std::optional<PhaseEnum> phase) {
+        SampledValue sampled_value;
+        sampled_value.value = value;
+        sampled_value.measurand = measurand;
+        sampled_value.phase = phase;
+        sampled_value.context = ReadingContextEnum::Sample_Periodic;
+        return sampled_value;
+    };
+
+    const auto energy = static_cast<float>(index) * 12.5F;
+    MeterValue meter_value;
+    meter_value.timestamp = DateTime(date::utc_clock::time_point(std::chrono::seconds(1700000000 + index * 60)));
+    meter_value.sampledValue = {
+        create_sampled_value(energy, MeasurandEnum::Energy_Active_Import_Register, std::nullopt),
+        create_sampled_value(11000.0F, MeasurandEnum::Power_Active_Import, std::nullopt),
+        create_sampled_value(15.9F, MeasurandEnum::Current_Import, PhaseEnum::L1),
+        create_sampled_value(16.1F, MeasurandEnum::Current_Import, PhaseEnum::L2),
+        create_sampled_value(15.8F, MeasurandEnum::Current_Import, PhaseEnum::L3)};
+    return meter_value;
+}
+
+/// \brief Returns the number of bytes of the pages of the database that are in use
+std::int64_t get_used_database_bytes(everest::db::sqlite::ConnectionInterface& connection) {
+    const auto get_pragma = [&connection](const std::string& pragma) {
+        auto stmt = connection.new_statement("PRAGMA " + pragma);
+        return stmt->step() == SQLITE_ROW ? stmt->column_int64(0) : 0;
+    };
+    return (get_pragma("page_count") - get_pragma("freelist_count")) * get_pragma("page_size");
+}
+
+/// \brief Stores \p meter_values_per_transaction meter values for a new transaction per iteration, like the evse does
+/// during a charging session. Reports the database size per stored meter value, which is what is written to flash.
+void run_meter_value_benchmark(BenchmarkSuite& suite, const std::string& name, DatabaseHandler& handler,
+                               everest::db::sqlite::ConnectionInterface& connection,
+                               const std::uint64_t meter_values_per_transaction, const std::uint64_t batch_size,
+                               const std::optional<bool> compact) {
+    std::vector<MeterValue> meter_values;
+    for (std::uint64_t i = 0; i < meter_values_per_transaction; i++) {
+        meter_values.push_back(create_meter_value(i));
+    }
+
+    std::vector<std::string> transaction_ids;
+    const auto used_bytes_before = get_used_database_bytes(connection);
+    auto* result = suite.run(name, meter_values_per_transaction, [&]() {
+        transaction_ids.push_back(TRANSACTION_ID + "-" + std::to_string(transaction_ids.size()));
+        if (!compact.has_value()) {
+            for (const auto& meter_value : meter_values) {
+                handler.transaction_metervalues_insert(transaction_ids.back(), meter_value);
+            }
+            return;
+        }
+        for (std::uint64_t i = 0; i < meter_values.size(); i += batch_size) {
+            const auto end = std::min<std::uint64_t>(i + batch_size, meter_values.size());
+            handler.transaction_metervalues_insert_batch(
+                transaction_ids.back(), std::vector<MeterValue>(meter_values.begin() + i, meter_values.begin() + end),
+                compact.value());
+        }
+    });
+    if (result != nullptr and !transaction_ids.empty()) {
+        const auto stored_meter_values = transaction_ids.size() * meter_values_per_transaction;
+        result->counters["bytes_per_meter_value"] =
+            static_cast<double>(get_used_database_bytes(connection) - used_bytes_before) / stored_meter_values;
+        result->counters["read_back"] = handler.transaction_metervalues_get_all(transaction_ids.back()).size();
+    }
+
+    for (const auto& transaction_id : transaction_ids) {
+        handler.transaction_metervalues_clear(transaction_id);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchmarkSuite suite("database_v2", argc, argv);
+    const auto tokens = static_cast<std::uint64_t>(suite.get_option("tokens", 1000));
+    const auto updates = static_cast<std::uint64_t>(suite.get_option("updates", 100));
+    const auto local_list_entries = static_cast<std::uint64_t>(suite.get_option("local-list-entries", 100000));
+    const auto local_list_per_entry = static_cast<std::uint64_t>(suite.get_option("local-list-per-entry", 10000));
+    const auto meter_values = static_cast<std::uint64_t>(suite.get_option("meter-values", 240));
+    const auto batch_size = static_cast<std::uint64_t>(std::max<std::int64_t>(suite.get_option("batch-size", 10), 1));
+    const auto authorize_entries =
+        static_cast<std::uint64_t>(std::max<std::int64_t>(suite.get_option("authorize-entries", 10000), 1));
+
+    std::filesystem::remove(DATABASE_PATH);
+    {
+        DatabaseHandler handler(std::make_unique<everest::db::sqlite::Connection>(DATABASE_PATH),
+                                MIGRATION_FILES_PATH);
+        handler.open_connection();
+        // Second connection to the same database for the baseline, which prepares every statement again
+        everest::db::sqlite::Connection connection(DATABASE_PATH);
+        connection.open_connection();
+
+        run_authorization_benchmarks(suite, handler, connection, tokens);
+        run_transaction_benchmarks(suite, handler, connection, updates);
+        run_local_authorization_list_benchmarks(suite, handler, local_list_entries, local_list_per_entry);
+        run_authorize_latency_benchmarks(suite, handler, connection, authorize_entries, tokens);
+        run_meter_value_benchmark(suite, "transaction_metervalues_insert/rows", handler, connection, meter_values, 1,
+                                  std::nullopt);
+        run_meter_value_benchmark(suite, "transaction_metervalues_insert_batch/rows", handler, connection,
+                                  meter_values, batch_size, false);
+        run_meter_value_benchmark(suite, "transaction_metervalues_insert_batch/compact", handler, connection,
+                                  meter_values, batch_size, true);
+
+        connection.close_connection();
+        handler.close_connection();
+    }
+    std::filesystem::remove(DATABASE_PATH);
+    return suite.report();
+}
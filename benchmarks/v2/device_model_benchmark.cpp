@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+
+#include <benchmark.hpp>
+
+#include <ocpp/v2/ctrlr_component_variables.hpp>
+#include <ocpp/v2/device_model.hpp>
+#include <ocpp/v2/device_model_storage_in_memory.hpp>
+#include <ocpp/v2/device_model_storage_sqlite.hpp>
+#include <ocpp/v2/init_device_model_db.hpp>
+#include <ocpp/v2/notify_report_requests_splitter.hpp>
+
+using namespace ocpp;
+using namespace ocpp::v2;
+using ocpp::benchmark::BenchmarkSuite;
+
+namespace {
+
+const std::filesystem::path MIGRATION_FILES_PATH = MIGRATION_FILES_DEVICE_MODEL_LOCATION_V2;
+const std::filesystem::path CONFIG_PATH = DEVICE_MODEL_CONFIG_LOCATION_V2;
+const std::filesystem::path DATABASE_PATH =
+    std::filesystem::temp_directory_path() / "libocpp_device_model_benchmark.db";
+
+void initialize_database(const bool delete_db_if_exists) {
+    InitDeviceModelDb db(DATABASE_PATH, MIGRATION_FILES_PATH);
+    db.initialize_database(CONFIG_PATH, delete_db_if_exists);
+}
+
+std::unique_ptr<DeviceModelStorageInterface> create_storage(const std::string& backend) {
+    if (backend == "in_memory") {
+        return std::make_unique<DeviceModelStorageInMemory>(std::make_unique<DeviceModelStorageSqlite>(DATABASE_PATH));
+    }
+    return std::make_unique<DeviceModelStorageSqlite>(DATABASE_PATH);
+}
+
+bool has_actual_attribute(const ReportData& report_data) {
+    return std::any_of(report_data.variableAttribute.begin(), report_data.variableAttribute.end(),
+                       [](const VariableAttribute& attribute) {
+                           return attribute.type.value_or(AttributeEnum::Actual) == AttributeEnum::Actual;
+                       });
+}
+
+/// \brief All component variables of the device model that have an 'Actual' attribute, repeated until there are
+/// \p count entries.
+std::vector<GetVariableData> get_variable_data(DeviceModel& device_model, const std::size_t count) {
+    std::vector<GetVariableData> all;
+    device_model.get_base_report_data(ReportBaseEnum::FullInventory, [&all](ReportData&& report_data) {
+        if (!has_actual_attribute(report_data)) {
+            return;
+        }
+        GetVariableData data;
+        data.component = report_data.component;
+        data.variable = report_data.variable;
+        data.attributeType = AttributeEnum::Actual;
+        all.push_back(std::move(data));
+    });
+
+    std::vector<GetVariableData> result;
+    while (!all.empty() and result.size() < count) {
+        result.push_back(all.at(result.size() % all.size()));
+    }
+    return result;
+}
+
+/// \brief Periodic monitor requests for every variable that supports monitoring, repeated until there are \p count
+/// requests.
+std::vector<SetMonitoringData> get_monitoring_data(DeviceModel& device_model, const std::size_t count) {
+    std::vector<SetMonitoringData> all;
+    device_model.get_base_report_data(ReportBaseEnum::FullInventory, [&all](ReportData&& report_data) {
+        if (!report_data.variableCharacteristics.has_value() or
+            !report_data.variableCharacteristics->supportsMonitoring) {
+            return;
+        }
+        SetMonitoringData data;
+        data.value = 60.0;
+        data.type = MonitorEnum::Periodic;
+        data.severity = 5;
+        data.component = std::move(report_data.component);
+        data.variable = std::move(report_data.variable);
+        all.push_back(std::move(data));
+    });
+
+    std::vector<SetMonitoringData> result;
+    while (!all.empty() and result.size() < count) {
+        result.push_back(all.at(result.size() % all.size()));
+    }
+    return result;
+}
+
+void run_init_benchmarks(BenchmarkSuite& suite) {
+    suite.run_with_setup(
+        "InitDeviceModelDb/cold_start", 1, []() { std::filesystem::remove(DATABASE_PATH); },
+        []() { initialize_database(false); });
+
+    initialize_database(true);
+    suite.run("InitDeviceModelDb/warm_start", 1, []() { initialize_database(false); });
+}
+
+void run_device_model_benchmarks(BenchmarkSuite& suite, const std::string& backend) {
+    initialize_database(true);
+    auto storage = create_storage(backend);
+    // Writes of the in memory storage are only queued, so the benchmarks of writes wait until they are persisted
+    auto* in_memory_storage = dynamic_cast<DeviceModelStorageInMemory*>(storage.get());
+    const auto wait_until_persisted = [in_memory_storage]() {
+        if (in_memory_storage != nullptr) {
+            in_memory_storage->flush();
+        }
+    };
+    DeviceModel device_model(std::move(storage));
+    const auto& heartbeat_interval = ControllerComponentVariables::HeartbeatInterval;
+
+    suite.run(backend + "/get_value", 1, [&device_model]() {
+        static_cast<void>(device_model.get_value<int>(ControllerComponentVariables::ItemsPerMessageGetVariables));
+    });
+
+    std::uint64_t value = 0;
+    suite.run(backend + "/set_value", 1, [&device_model, &heartbeat_interval, &value, &wait_until_persisted]() {
+        device_model.set_value(heartbeat_interval.component, heartbeat_interval.variable.value(),
+                               AttributeEnum::Actual, std::to_string(30 + (value++ % 100)), "benchmark");
+        wait_until_persisted();
+    });
+
+    for (const std::size_t count : {100, 1000}) {
+        const auto get_variable_data = ::get_variable_data(device_model, count);
+        suite.run(backend + "/GetVariables/" + std::to_string(count), count, [&device_model, &get_variable_data]() {
+            std::vector<GetVariableResult> results;
+            results.reserve(get_variable_data.size());
+            for (const auto& data : get_variable_data) {
+                GetVariableResult result;
+                result.component = data.component;
+                result.variable = data.variable;
+                result.attributeType = data.attributeType;
+                const auto response =
+                    device_model.request_value<std::string>(data.component, data.variable, AttributeEnum::Actual);
+                result.attributeStatus = response.status;
+                if (response.value.has_value()) {
+                    result.attributeValue = response.value.value();
+                }
+                results.push_back(std::move(result));
+            }
+        });
+    }
+
+    std::size_t nr_of_report_data = 0;
+    std::size_t nr_of_messages = 0;
+    auto* full_inventory = suite.run(backend + "/FullInventory", 1, [&]() {
+        NotifyReportRequest request;
+        request.requestId = 1;
+        std::int32_t message_count = 0;
+        NotifyReportRequestsSplitter splitter(request, 65000, [&message_count]() {
+            return MessageId(std::to_string(message_count++));
+        });
+        nr_of_report_data = 0;
+        nr_of_messages = 0;
+        device_model.get_base_report_data(ReportBaseEnum::FullInventory, [&](ReportData&& report_data) {
+            nr_of_report_data++;
+            if (splitter.add_report_data(report_data).has_value()) {
+                nr_of_messages++;
+            }
+        });
+        static_cast<void>(splitter.finalize());
+        nr_of_messages++;
+    });
+    if (full_inventory != nullptr) {
+        full_inventory->counters["report_data"] = nr_of_report_data;
+        full_inventory->counters["messages"] = nr_of_messages;
+    }
+
+    const auto monitoring_data = get_monitoring_data(device_model, 100);
+    std::size_t accepted = 0;
+    auto* set_monitors =
+        suite.run(backend + "/SetVariableMonitoring/" + std::to_string(monitoring_data.size()), monitoring_data.size(),
+                  [&device_model, &monitoring_data, &accepted, &wait_until_persisted]() {
+                      accepted = 0;
+                      for (const auto& result : device_model.set_monitors(monitoring_data)) {
+                          if (result.status == SetMonitoringStatusEnum::Accepted) {
+                              accepted++;
+                          }
+                      }
+                      device_model.clear_custom_monitors();
+                      wait_until_persisted();
+                  });
+    if (set_monitors != nullptr) {
+        set_monitors->counters["accepted"] = accepted;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchmarkSuite suite("device_model", argc, argv);
+
+    run_init_benchmarks(suite);
+    run_device_model_benchmarks(suite, "sqlite");
+    run_device_model_benchmarks(suite, "in_memory");
+
+    std::filesystem::remove(DATABASE_PATH);
+    return suite.report();
+}
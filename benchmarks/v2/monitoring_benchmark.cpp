@@ -0,0 +1,230 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+#include <benchmark.hpp>
+
+#include <ocpp/v2/ctrlr_component_variables.hpp>
+#include <ocpp/v2/device_model.hpp>
+#include <ocpp/v2/device_model_storage_in_memory.hpp>
+#include <ocpp/v2/device_model_storage_sqlite.hpp>
+#include <ocpp/v2/init_device_model_db.hpp>
+#include <ocpp/v2/monitoring_updater.hpp>
+
+using namespace ocpp;
+using namespace ocpp::v2;
+using ocpp::benchmark::BenchmarkResult;
+using ocpp::benchmark::BenchmarkSuite;
+
+namespace {
+
+const std::filesystem::path MIGRATION_FILES_PATH = MIGRATION_FILES_DEVICE_MODEL_LOCATION_V2;
+const std::filesystem::path CONFIG_PATH = DEVICE_MODEL_CONFIG_LOCATION_V2;
+const std::filesystem::path BENCHMARK_PATH = std::filesystem::temp_directory_path() / "libocpp_monitoring_benchmark";
+const std::filesystem::path DATABASE_PATH = BENCHMARK_PATH / "device_model.db";
+
+/// \brief Number of monitor types that are cycled through for the monitors of a variable
+constexpr std::int64_t NR_OF_MONITOR_TYPES = 5;
+constexpr std::int64_t MAX_MONITORS_PER_VARIABLE = 50;
+
+struct BenchmarkConfig {
+    std::int64_t components;
+    std::int64_t variables;
+    std::int64_t monitors;
+};
+
+Component get_component(const std::int64_t component_index) {
+    Component component;
+    component.name = "BenchmarkComponent" + std::to_string(component_index);
+    return component;
+}
+
+Variable get_variable(const std::int64_t variable_index) {
+    Variable variable;
+    variable.name = "BenchmarkVariable" + std::to_string(variable_index);
+    return variable;
+}
+
+/// \brief Copies the device model config and adds \p config.components components with \p config.variables
+/// monitorable decimal variables each
+std::filesystem::path create_config(const BenchmarkConfig& config) {
+    const auto config_path = BENCHMARK_PATH / "component_config";
+    std::filesystem::remove_all(BENCHMARK_PATH);
+    std::filesystem::create_directories(config_path);
+    std::filesystem::copy(CONFIG_PATH, config_path, std::filesystem::copy_options::recursive);
+
+    for (std::int64_t c = 0; c < config.components; c++) {
+        const auto component = get_component(c);
+        json properties = json::object();
+        for (std::int64_t v = 0; v < config.variables; v++) {
+            const auto variable = get_variable(v);
+            properties[variable.name.get()] = {
+                {"variable_name", variable.name.get()},
+                {"characteristics", {{"supportsMonitoring", true}, {"dataType", "decimal"}}},
+                {"attributes", json::array({{{"type", "Actual"}, {"mutability", "ReadWrite"}}})},
+                {"default", 0},
+                {"type", "number"}};
+        }
+        const json component_config = {{"$schema", "http://json-schema.org/draft-07/schema#"},
+                                       {"description", "Schema for " + component.name.get()},
+                                       {"type", "object"},
+                                       {"name", component.name.get()},
+                                       {"properties", properties}};
+        std::ofstream file(config_path / "custom" / (component.name.get() + ".json"));
+        file << component_config.dump(2);
+    }
+    return config_path;
+}
+
+/// \brief Monitors for every benchmark variable, the type is cycled through all monitor types
+std::vector<SetMonitoringData> get_monitoring_data(const BenchmarkConfig& config) {
+    std::vector<SetMonitoringData> result;
+    for (std::int64_t c = 0; c < config.components; c++) {
+        for (std::int64_t v = 0; v < config.variables; v++) {
+            for (std::int64_t m = 0; m < config.monitors; m++) {
+                SetMonitoringData data;
+                data.component = get_component(c);
+                data.variable = get_variable(v);
+                data.severity = static_cast<std::int32_t>((result.size() / NR_OF_MONITOR_TYPES) % 10);
+                switch (m % NR_OF_MONITOR_TYPES) {
+                case 0:
+                    data.type = MonitorEnum::UpperThreshold;
+                    data.value = 50.0 + static_cast<float>(m);
+                    break;
+                case 1:
+                    data.type = MonitorEnum::LowerThreshold;
+                    data.value = 50.0 - static_cast<float>(m);
+                    break;
+                case 2:
+                    data.type = MonitorEnum::Delta;
+                    data.value = 10.0;
+                    break;
+                case 3:
+                    data.type = MonitorEnum::Periodic;
+                    data.value = 3600.0;
+                    break;
+                default:
+                    data.type = MonitorEnum::PeriodicClockAligned;
+                    data.value = 3600.0;
+                    break;
+                }
+                result.push_back(std::move(data));
+            }
+        }
+    }
+    return result;
+}
+
+void add_statistics(BenchmarkResult* result, MonitoringUpdater& monitoring_updater, const std::uint64_t events) {
+    if (result == nullptr) {
+        return;
+    }
+    const auto statistics = monitoring_updater.get_statistics();
+    result->counters["events"] = events;
+    result->counters["processing_runs"] = statistics.processing_runs;
+    result->counters["idle_processing_runs"] = statistics.idle_processing_runs;
+    result->counters["processing_time_ns"] = statistics.processing_time.count();
+    result->counters["variable_changes"] = statistics.variable_changes;
+    result->counters["monitor_evaluations"] = statistics.monitor_evaluations;
+    result->counters["evaluation_time_ns"] = statistics.evaluation_time.count();
+}
+
+void run_monitoring_benchmarks(BenchmarkSuite& suite, const BenchmarkConfig& config) {
+    const auto config_path = create_config(config);
+    {
+        InitDeviceModelDb db(DATABASE_PATH, MIGRATION_FILES_PATH);
+        db.initialize_database(config_path, true);
+    }
+    DeviceModel device_model(
+        std::make_unique<DeviceModelStorageInMemory>(std::make_unique<DeviceModelStorageSqlite>(DATABASE_PATH)));
+
+    std::uint64_t events = 0;
+    MonitoringUpdater monitoring_updater(
+        device_model, [&events](std::vector<SeverityEventData>&& event_data) { events += event_data.size(); },
+        []() { return false; });
+
+    // Started while monitoring is disabled, so that no timer processes the monitors in the background
+    monitoring_updater.start_monitoring();
+    const auto& monitoring_enabled = ControllerComponentVariables::MonitoringCtrlrEnabled;
+    device_model.set_value(monitoring_enabled.component, monitoring_enabled.variable.value(), AttributeEnum::Actual,
+                           "true", "benchmark");
+    monitoring_updater.set_timing_enabled(true);
+
+    const auto monitoring_data = get_monitoring_data(config);
+    std::vector<SetMonitoringData> periodic_monitors;
+    for (const auto& result : device_model.set_monitors(monitoring_data)) {
+        if (result.status == SetMonitoringStatusEnum::Accepted and result.type == MonitorEnum::Periodic) {
+            SetMonitoringData data;
+            data.id = result.id;
+            data.value = 0.0;
+            data.type = result.type;
+            data.severity = result.severity;
+            data.component = result.component;
+            data.variable = result.variable;
+            periodic_monitors.push_back(std::move(data));
+        }
+    }
+    const std::string suffix = "/" + std::to_string(config.components) + "x" + std::to_string(config.variables) +
+                               "x" + std::to_string(config.monitors);
+
+    // Alternates between values that trigger the upper and the lower threshold monitors
+    const auto component = get_component(0);
+    const auto variable = get_variable(0);
+    std::uint64_t change = 0;
+    events = 0;
+    auto* variable_change = suite.run("variable_change" + suffix, 1, [&]() {
+        device_model.set_value(component, variable, AttributeEnum::Actual, (change++ % 2) == 0 ? "100" : "0",
+                               "benchmark");
+    });
+    monitoring_updater.process_triggered_monitors();
+    add_statistics(variable_change, monitoring_updater, events);
+
+    events = 0;
+    auto* idle = suite.run("tick/idle" + suffix, 1, [&monitoring_updater]() { monitoring_updater.process_monitors(); });
+    add_statistics(idle, monitoring_updater, events);
+
+    // Changes every benchmark variable and sends the events of all triggered monitors
+    const auto nr_of_variables = static_cast<std::uint64_t>(config.components * config.variables);
+    events = 0;
+    auto* throughput = suite.run("notify_event_throughput" + suffix, nr_of_variables, [&]() {
+        const auto value = (change++ % 2) == 0 ? "100" : "0";
+        for (std::int64_t c = 0; c < config.components; c++) {
+            const auto changed_component = get_component(c);
+            for (std::int64_t v = 0; v < config.variables; v++) {
+                device_model.set_value(changed_component, get_variable(v), AttributeEnum::Actual, value, "benchmark");
+            }
+        }
+        monitoring_updater.process_triggered_monitors();
+    });
+    add_statistics(throughput, monitoring_updater, events);
+
+    // An interval of 0 makes every periodic monitor due on every tick
+    static_cast<void>(device_model.set_monitors(periodic_monitors));
+    events = 0;
+    auto* periodic_due = suite.run("tick/periodic_due" + suffix, std::max<std::size_t>(periodic_monitors.size(), 1),
+                                   [&monitoring_updater]() { monitoring_updater.process_monitors(); });
+    add_statistics(periodic_due, monitoring_updater, events);
+
+    monitoring_updater.stop_monitoring();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchmarkSuite suite("monitoring", argc, argv);
+
+    BenchmarkConfig config;
+    config.components = std::max<std::int64_t>(suite.get_option("components", 10), 1);
+    config.variables = std::max<std::int64_t>(suite.get_option("variables", 100), 1);
+    config.monitors = std::clamp<std::int64_t>(suite.get_option("monitors", NR_OF_MONITOR_TYPES), 1,
+                                               MAX_MONITORS_PER_VARIABLE);
+
+    run_monitoring_benchmarks(suite, config);
+
+    std::filesystem::remove_all(BENCHMARK_PATH);
+    return suite.report();
+}
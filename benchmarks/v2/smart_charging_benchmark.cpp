@@ -0,0 +1,332 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include <benchmark.hpp>
+#include <smart_charging_benchmark.hpp>
+
+#include <component_state_manager_mock.hpp>
+#include <connectivity_manager_mock.hpp>
+#include <evse_manager_fake.hpp>
+#include <evse_security_mock.hpp>
+#include <message_dispatcher_mock.hpp>
+
+#include <everest/database/sqlite/connection.hpp>
+#include <ocpp/common/call_types.hpp>
+#include <ocpp/v2/ctrlr_component_variables.hpp>
+#include <ocpp/v2/database_handler.hpp>
+#include <ocpp/v2/device_model.hpp>
+#include <ocpp/v2/device_model_storage_in_memory.hpp>
+#include <ocpp/v2/device_model_storage_sqlite.hpp>
+#include <ocpp/v2/functional_blocks/functional_block_context.hpp>
+#include <ocpp/v2/functional_blocks/smart_charging.hpp>
+#include <ocpp/v2/init_device_model_db.hpp>
+#include <ocpp/v2/messages/SetChargingProfile.hpp>
+#include <ocpp/v21/messages/UpdateDynamicSchedule.hpp>
+
+using namespace ocpp;
+using namespace ocpp::v2;
+using ocpp::benchmark::BenchmarkSuite;
+using ocpp::benchmark::ProfileStackConfig;
+
+namespace {
+
+const std::filesystem::path MIGRATION_FILES_PATH = MIGRATION_FILES_LOCATION_V2;
+const std::filesystem::path DEVICE_MODEL_MIGRATION_FILES_PATH = MIGRATION_FILES_DEVICE_MODEL_LOCATION_V2;
+const std::filesystem::path CONFIG_PATH = DEVICE_MODEL_CONFIG_LOCATION_V2;
+const std::filesystem::path BENCHMARK_PATH =
+    std::filesystem::temp_directory_path() / "libocpp_smart_charging_benchmark_v2";
+const std::filesystem::path DEVICE_MODEL_DATABASE_PATH = BENCHMARK_PATH / "device_model.db";
+const std::filesystem::path DATABASE_PATH = BENCHMARK_PATH / "cp.db";
+constexpr std::int32_t STATION_WIDE_ID = 0;
+
+/// \brief Exposes the calculation of a composite schedule, which is not cached, and the statistics of the cache of the
+/// intermediate profiles per evse
+class BenchmarkSmartCharging : public SmartCharging {
+public:
+    using SmartCharging::calculate_composite_schedule;
+    using SmartCharging::get_evse_intermediate_profiles_cache_statistics;
+    using SmartCharging::SmartCharging;
+};
+
+/// \brief A profile and the evse it is added for
+struct ProfileEntry {
+    ChargingProfile profile;
+    std::int32_t evse_id;
+    CiString<20> charging_limit_source;
+};
+
+/// \brief SmartCharging of a station with \p nr_of_evses evses, the other functional blocks are replaced by the mocks
+/// of the unit tests. Every evse has an active transaction.
+class Station {
+public:
+    Station(DeviceModel& device_model, const std::int32_t nr_of_evses, const DateTime& session_start,
+            std::optional<EffectiveLimitChangedCallback> effective_limit_changed_callback = std::nullopt) :
+        evse_manager(nr_of_evses),
+        database_handler(std::make_unique<everest::db::sqlite::Connection>(DATABASE_PATH), MIGRATION_FILES_PATH),
+        ocpp_version(OcppProtocolVersion::v21),
+        context(dispatcher, device_model, connectivity_manager, evse_manager, database_handler, evse_security,
+                component_state_manager, ocpp_version),
+        smart_charging(
+            context, []() {},
+            [](const std::int32_t, const ReasonEnum&) { return RequestStartStopStatusEnum::Accepted; },
+            std::move(effective_limit_changed_callback)) {
+        this->database_handler.open_connection();
+        for (std::int32_t evse_id = 1; evse_id <= nr_of_evses; evse_id++) {
+            this->evse_manager.open_transaction(evse_id, get_transaction_id(evse_id), session_start);
+        }
+    }
+
+    static std::string get_transaction_id(const std::int32_t evse_id) {
+        return "benchmark-transaction-" + std::to_string(evse_id);
+    }
+
+    EvseManagerFake evse_manager;
+    ::testing::NiceMock<MockMessageDispatcher> dispatcher;
+    ::testing::NiceMock<ConnectivityManagerMock> connectivity_manager;
+    ::testing::NiceMock<EvseSecurityMock> evse_security;
+    ::testing::NiceMock<ComponentStateManagerMock> component_state_manager;
+    DatabaseHandler database_handler;
+    std::atomic<OcppProtocolVersion> ocpp_version;
+    FunctionalBlockContext context;
+    BenchmarkSmartCharging smart_charging;
+};
+
+void set_device_model_value(DeviceModel& device_model, const ComponentVariable& component_variable,
+                            const std::string& value) {
+    device_model.set_value(component_variable.component, component_variable.variable.value(), AttributeEnum::Actual,
+                           value, "benchmark", true);
+}
+
+std::unique_ptr<DeviceModel> create_device_model() {
+    InitDeviceModelDb db(DEVICE_MODEL_DATABASE_PATH, DEVICE_MODEL_MIGRATION_FILES_PATH);
+    db.initialize_database(CONFIG_PATH, true);
+    auto device_model = std::make_unique<DeviceModel>(
+        std::make_unique<DeviceModelStorageInMemory>(std::make_unique<DeviceModelStorageSqlite>(
+            DEVICE_MODEL_DATABASE_PATH)));
+
+    set_device_model_value(*device_model, ControllerComponentVariables::ChargingScheduleChargingRateUnit, "A,W");
+    set_device_model_value(*device_model, ControllerComponentVariables::SupportedAdditionalPurposes,
+                           "PriorityCharging");
+    set_device_model_value(*device_model, ControllerComponentVariables::SmartChargingCtrlrAvailable, "true");
+    set_device_model_value(*device_model, ControllerComponentVariables::SupportsDynamicProfiles, "true");
+    return device_model;
+}
+
+ChargingSchedule create_schedule(const ProfileStackConfig& config, const std::int32_t stack_level,
+                                 const std::optional<DateTime>& start_schedule) {
+    ChargingSchedule schedule;
+    schedule.id = 1;
+    schedule.chargingRateUnit = ChargingRateUnitEnum::A;
+    schedule.startSchedule = start_schedule;
+    for (std::int32_t i = 0; i < config.nr_of_periods; i++) {
+        ChargingSchedulePeriod period;
+        period.startPeriod = i * config.get_period_duration();
+        period.limit = config.get_limit(stack_level, i);
+        schedule.chargingSchedulePeriod.push_back(period);
+    }
+    return schedule;
+}
+
+ChargingProfile create_profile(const std::int32_t id, const std::int32_t stack_level,
+                               const ChargingProfilePurposeEnum purpose, const ChargingProfileKindEnum kind,
+                               ChargingSchedule schedule) {
+    ChargingProfile profile;
+    profile.id = id;
+    profile.stackLevel = stack_level;
+    profile.chargingProfilePurpose = purpose;
+    profile.chargingProfileKind = kind;
+    if (kind == ChargingProfileKindEnum::Recurring) {
+        profile.recurrencyKind = RecurrencyKindEnum::Daily;
+    }
+    profile.chargingSchedule = {std::move(schedule)};
+    return profile;
+}
+
+/// \brief The profiles of the stack described by \p config, see ProfileStackConfig
+std::vector<ProfileEntry> create_profile_stack(const ProfileStackConfig& config, const DateTime& now) {
+    const auto hour_start = ocpp::benchmark::get_hour_start(now);
+    const auto recurring_kind =
+        config.recurring ? ChargingProfileKindEnum::Recurring : ChargingProfileKindEnum::Absolute;
+    const auto recurring_start = config.recurring ? ocpp::benchmark::get_recurrence_start(now) : hour_start;
+    const auto session_start = ocpp::benchmark::get_session_start(now);
+
+    std::vector<ProfileEntry> profiles;
+    std::int32_t id = 1;
+    for (std::int32_t stack_level = 0; stack_level < config.stack_levels; stack_level++) {
+        profiles.push_back({create_profile(id++, stack_level, ChargingProfilePurposeEnum::ChargingStationMaxProfile,
+                                           recurring_kind, create_schedule(config, stack_level, recurring_start)),
+                            STATION_WIDE_ID, ChargingLimitSourceEnumStringType::CSO});
+        profiles.push_back({create_profile(id++, stack_level,
+                                           ChargingProfilePurposeEnum::ChargingStationExternalConstraints,
+                                           ChargingProfileKindEnum::Absolute,
+                                           create_schedule(config, stack_level, hour_start)),
+                            STATION_WIDE_ID, ChargingLimitSourceEnumStringType::EMS});
+
+        for (std::int32_t evse_id = 1; evse_id <= config.nr_of_evses; evse_id++) {
+            profiles.push_back({create_profile(id++, stack_level, ChargingProfilePurposeEnum::TxDefaultProfile,
+                                               recurring_kind, create_schedule(config, stack_level, recurring_start)),
+                                evse_id, ChargingLimitSourceEnumStringType::CSO});
+
+            auto tx_profile = create_profile(id++, stack_level, ChargingProfilePurposeEnum::TxProfile,
+                                             ChargingProfileKindEnum::Absolute,
+                                             create_schedule(config, stack_level, session_start));
+            tx_profile.transactionId = Station::get_transaction_id(evse_id);
+            profiles.push_back({std::move(tx_profile), evse_id, ChargingLimitSourceEnumStringType::CSO});
+
+            profiles.push_back({create_profile(id++, stack_level, ChargingProfilePurposeEnum::PriorityCharging,
+                                               ChargingProfileKindEnum::Relative,
+                                               create_schedule(config, stack_level, std::nullopt)),
+                                evse_id, ChargingLimitSourceEnumStringType::CSO});
+        }
+    }
+    return profiles;
+}
+
+/// \brief An UpdateDynamicSchedule.req for \p profile_id as it is received from the CSMS
+EnhancedMessage<MessageType> create_update_dynamic_schedule_message(const std::int32_t profile_id, const float limit) {
+    ocpp::v21::UpdateDynamicScheduleRequest request;
+    request.chargingProfileId = profile_id;
+    request.scheduleUpdate.limit = limit;
+
+    EnhancedMessage<MessageType> message;
+    message.uniqueId = "benchmark-update-dynamic-schedule";
+    message.messageType = MessageType::UpdateDynamicSchedule;
+    message.messageTypeId = MessageTypeId::CALL;
+    message.message = Call<ocpp::v21::UpdateDynamicScheduleRequest>(request);
+    return message;
+}
+
+/// \brief Adds all \p profiles, returns the number of accepted profiles
+std::size_t add_profiles(SmartCharging& smart_charging, const std::vector<ProfileEntry>& profiles) {
+    std::size_t accepted = 0;
+    for (const auto& entry : profiles) {
+        auto profile = entry.profile;
+        const auto response =
+            smart_charging.conform_validate_and_add_profile(profile, entry.evse_id, entry.charging_limit_source);
+        if (response.status == ChargingProfileStatusEnum::Accepted) {
+            accepted++;
+        }
+    }
+    return accepted;
+}
+
+void run_smart_charging_benchmarks(BenchmarkSuite& suite, DeviceModel& device_model,
+                                   const ProfileStackConfig& config) {
+    const DateTime now;
+    const DateTime end_time(now.to_time_point() +
+                            std::chrono::seconds(ocpp::benchmark::SMART_CHARGING_SECONDS_PER_DAY));
+    const auto profiles = create_profile_stack(config, now);
+
+    std::filesystem::remove(DATABASE_PATH);
+    std::chrono::steady_clock::time_point received;
+    std::chrono::steady_clock::duration max_latency{};
+    std::size_t limit_changes = 0;
+    Station station(device_model, config.nr_of_evses, ocpp::benchmark::get_session_start(now),
+                    [&](const std::int32_t evse_id, const EffectiveLimit&) {
+                        if (evse_id == 1) {
+                            max_latency = std::max(max_latency, std::chrono::steady_clock::now() - received);
+                            limit_changes++;
+                        }
+                    });
+    const auto installed_profiles = add_profiles(station.smart_charging, profiles);
+
+    // ChargingStationExternalConstraints can not be replaced, all other profiles are replaced by themselves
+    std::vector<ProfileEntry> replaced_profiles;
+    for (const auto& entry : profiles) {
+        if (entry.profile.chargingProfilePurpose != ChargingProfilePurposeEnum::ChargingStationExternalConstraints) {
+            replaced_profiles.push_back(entry);
+        }
+    }
+
+    const auto suffix = "/" + config.get_name();
+    std::size_t accepted = 0;
+    auto* result = suite.run("conform_validate_and_add_profile" + suffix, replaced_profiles.size(),
+                             [&]() { accepted = add_profiles(station.smart_charging, replaced_profiles); });
+    if (result != nullptr) {
+        result->counters["installed_profiles"] = installed_profiles;
+        result->counters["accepted_profiles"] = accepted;
+    }
+
+    std::size_t periods = 0;
+    result = suite.run("calculate_composite_schedule" + suffix, 1, [&]() {
+        const auto schedule = station.smart_charging.calculate_composite_schedule(now, end_time, 1,
+                                                                                  ChargingRateUnitEnum::A, false, true);
+        periods = schedule.chargingSchedulePeriod.size();
+    });
+    if (result != nullptr) {
+        result->counters["periods"] = periods;
+    }
+
+    std::size_t schedules = 0;
+    result = suite.run("get_all_composite_schedules" + suffix, config.nr_of_evses + 1, [&]() {
+        schedules = station.smart_charging
+                        .get_all_composite_schedules(ocpp::benchmark::SMART_CHARGING_SECONDS_PER_DAY,
+                                                     ChargingRateUnitEnum::A)
+                        .size();
+    });
+    if (result != nullptr) {
+        result->counters["schedules"] = schedules;
+    }
+
+    // A dynamic TxProfile above the stack, every update changes the effective limit of the evse. Measures the time
+    // from receiving the UpdateDynamicSchedule.req until the effective limit changed callback is called.
+    auto dynamic_profile =
+        create_profile(static_cast<std::int32_t>(profiles.size()) + 1, config.stack_levels,
+                       ChargingProfilePurposeEnum::TxProfile, ChargingProfileKindEnum::Dynamic,
+                       create_schedule(config, config.stack_levels, std::nullopt));
+    dynamic_profile.chargingSchedule.at(0).chargingSchedulePeriod.resize(1);
+    dynamic_profile.transactionId = Station::get_transaction_id(1);
+    add_profiles(station.smart_charging, {{dynamic_profile, 1, ChargingLimitSourceEnumStringType::CSO}});
+    const std::vector<EnhancedMessage<MessageType>> update_messages = {
+        create_update_dynamic_schedule_message(dynamic_profile.id, 6.0F),
+        create_update_dynamic_schedule_message(dynamic_profile.id, 10.0F)};
+    std::size_t update_index = 0;
+    max_latency = {};
+    limit_changes = 0;
+    const auto misses_before = station.smart_charging.get_evse_intermediate_profiles_cache_statistics().misses;
+    result = suite.run("update_dynamic_schedule" + suffix, 1, [&]() {
+        received = std::chrono::steady_clock::now();
+        station.smart_charging.handle_message(update_messages.at(update_index++ % update_messages.size()));
+    });
+    if (result != nullptr) {
+        result->counters["limit_changes"] = limit_changes;
+        // Only the evse of the profile is calculated again, the other evses are taken from the cache
+        const auto misses = station.smart_charging.get_evse_intermediate_profiles_cache_statistics().misses;
+        result->counters["calculated_evses_per_update"] =
+            static_cast<double>(misses - misses_before) / static_cast<double>(result->iterations);
+        result->counters["max_latency_us"] =
+            std::chrono::duration_cast<std::chrono::microseconds>(max_latency).count();
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // The mocks of the unit tests are only used as placeholders, calls to them are expected
+    GMOCK_FLAG_SET(verbose, "error");
+
+    BenchmarkSuite suite("smart_charging_v2", argc, argv);
+
+    std::filesystem::remove_all(BENCHMARK_PATH);
+    std::filesystem::create_directories(BENCHMARK_PATH);
+    auto device_model = create_device_model();
+
+    for (const auto& config : ocpp::benchmark::get_profile_stack_configs()) {
+        run_smart_charging_benchmarks(suite, *device_model, config);
+    }
+
+    device_model.reset();
+    std::filesystem::remove_all(BENCHMARK_PATH);
+    return suite.report();
+}
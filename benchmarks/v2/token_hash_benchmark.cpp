@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+
+#include <benchmark.hpp>
+
+#include <ocpp/v2/utils.hpp>
+
+using namespace ocpp;
+using namespace ocpp::v2;
+using ocpp::benchmark::BenchmarkSuite;
+
+namespace {
+
+/// \brief The token hash as it was calculated before utils::sha256_hex: of the concatenated type and id, encoded by a
+/// std::stringstream
+std::string generate_token_hash_stringstream(const IdToken& token) {
+    const std::string str = token.type.get() + token.idToken.get();
+    std::array<unsigned char, SHA256_DIGEST_LENGTH> hash;
+    EVP_Digest(str.c_str(), str.size(), hash.data(), nullptr, EVP_sha256(), nullptr);
+    std::stringstream ss;
+    ss << std::hex << std::setfill('0');
+    for (const auto& byte : hash) {
+        ss << std::setw(2) << (int)byte;
+    }
+    return ss.str();
+}
+
+/// \brief Tokens like the ones of an RFID reader, the types alternate between ISO14443, ISO15693 and Central
+std::vector<IdToken> create_tokens(const std::uint64_t nr_of_tokens) {
+    const std::array<CiString<20>, 3> types = {IdTokenEnumStringType::ISO14443, IdTokenEnumStringType::ISO15693,
+                                               IdTokenEnumStringType::Central};
+    std::vector<IdToken> tokens;
+    tokens.reserve(nr_of_tokens);
+    for (std::uint64_t i = 0; i < nr_of_tokens; i++) {
+        std::stringstream id;
+        id << std::hex << std::uppercase << std::setfill('0') << std::setw(14) << (0x04A2B3C4D50000 + i);
+        tokens.push_back(IdToken{id.str(), types.at(i % types.size())});
+    }
+    return tokens;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchmarkSuite suite("token_hash", argc, argv);
+
+    const auto nr_of_tokens = static_cast<std::uint64_t>(std::max<std::int64_t>(suite.get_option("tokens", 1000), 1));
+    const auto tokens = create_tokens(nr_of_tokens);
+
+    // Every implementation must return the hashes that are stored in existing databases
+    for (const auto& token : tokens) {
+        if (utils::generate_token_hash(token) != generate_token_hash_stringstream(token)) {
+            std::cerr << "Token hash of " << token.idToken.get() << " differs from the stringstream implementation\n";
+            return 1;
+        }
+    }
+
+    std::uint64_t checksum = 0;
+    suite.run("generate_token_hash/stringstream", nr_of_tokens, [&]() {
+        for (const auto& token : tokens) {
+            checksum += generate_token_hash_stringstream(token).front();
+        }
+    });
+    suite.run("generate_token_hash/streaming", nr_of_tokens, [&]() {
+        for (const auto& token : tokens) {
+            checksum += utils::generate_token_hash(token).front();
+        }
+    });
+    // Without the conversion to std::string, e.g. to compare or bind the hash
+    auto* result = suite.run("sha256_hex", nr_of_tokens, [&]() {
+        for (const auto& token : tokens) {
+            checksum += utils::sha256_hex({token.type.get(), token.idToken.get()}).front();
+        }
+    });
+    if (result != nullptr) {
+        result->counters["checksum"] = checksum;
+    }
+
+    return suite.report();
+}
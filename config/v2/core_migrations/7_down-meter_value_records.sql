@@ -0,0 +1 @@
+DROP TABLE METER_VALUE_RECORDS;
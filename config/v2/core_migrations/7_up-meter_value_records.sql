@@ -0,0 +1,8 @@
+CREATE TABLE METER_VALUE_RECORDS (
+    TRANSACTION_ID TEXT NOT NULL,
+    SEQ_NO INTEGER NOT NULL,
+    TIMESTAMP_DELTA INTEGER NOT NULL,
+    READING_CONTEXT INTEGER REFERENCES READING_CONTEXT_ENUM (ID),
+    SAMPLED_VALUES TEXT NOT NULL,
+    PRIMARY KEY (TRANSACTION_ID, SEQ_NO)
+) WITHOUT ROWID;
@@ -0,0 +1 @@
+DROP TABLE COMPONENT_CONFIG_FINGERPRINT;
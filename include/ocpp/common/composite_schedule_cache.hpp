@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <ocpp/common/types.hpp>
+
+namespace ocpp {
+
+/// \brief Default number of schedules a CompositeScheduleCache keeps
+constexpr std::size_t DEFAULT_COMPOSITE_SCHEDULE_CACHE_CAPACITY = 64;
+
+/// \brief Counters of a CompositeScheduleCache
+struct CompositeScheduleCacheStatistics {
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+};
+
+///
+/// \brief Returns the \p periods of a schedule that are within \p duration seconds from \p offset seconds after the
+/// start of the schedule. The periods must be ordered by startPeriod and the first one must start at 0, the returned
+/// periods are relative to \p offset.
+///
+template <typename Period>
+std::vector<Period> slice_schedule_periods(const std::vector<Period>& periods, const std::int32_t offset,
+                                           const std::int32_t duration) {
+    std::vector<Period> result;
+    for (std::size_t i = 0; i < periods.size(); i++) {
+        const auto& period = periods.at(i);
+        if (period.startPeriod >= offset + duration) {
+            break;
+        }
+        const bool next_starts_before_offset = i + 1 < periods.size() and periods.at(i + 1).startPeriod <= offset;
+        if (next_starts_before_offset) {
+            continue;
+        }
+        auto& sliced = result.emplace_back(period);
+        sliced.startPeriod = std::max(period.startPeriod - offset, 0);
+    }
+    return result;
+}
+
+///
+/// \brief Cache of composite schedules, so repeated requests for the same schedule do not recalculate the profile
+/// stack.
+///
+/// A schedule is cached for a Key (e.g. evse, charging rate unit, duration) together with the Inputs it was calculated
+/// from, i.e. everything besides the time it depends on. It is only returned while the current inputs are equal to the
+/// cached ones. A schedule is cached for twice the requested duration, so later requests are answered with a slice of
+/// it until the end of the requested duration would pass the end of the cached schedule. Since a slice contains the
+/// periods at their absolute times, this is exact across period boundaries.
+///
+/// Storing a schedule drops the cached schedules that were calculated with other inputs or that ended before the new
+/// one starts, since they can not be returned anymore. At most \p capacity schedules are kept, the least recently used
+/// one is dropped first.
+///
+template <typename Key, typename Inputs, typename Schedule> class CompositeScheduleCache {
+public:
+    /// \brief Returns the part of the cached \p schedule, which starts at \p schedule_start, that starts \p offset
+    /// seconds later and lasts \p duration seconds
+    using SliceFunction = std::function<Schedule(const Schedule& schedule, const DateTime& schedule_start,
+                                                 std::int32_t offset, std::int32_t duration)>;
+
+    explicit CompositeScheduleCache(SliceFunction slice,
+                                    std::size_t capacity = DEFAULT_COMPOSITE_SCHEDULE_CACHE_CAPACITY) :
+        slice(std::move(slice)), capacity(capacity) {
+    }
+
+    ///
+    /// \brief Returns the cached schedule for \p key from \p start for \p duration seconds if it was calculated with
+    /// the same \p inputs and covers the whole duration
+    ///
+    std::optional<Schedule> get(const Key& key, const Inputs& inputs, const DateTime& start,
+                                const std::int32_t duration) {
+        std::lock_guard<std::mutex> lock(this->cache_mutex);
+        const auto it = this->entries.find(key);
+        if (it != this->entries.end() and it->second.inputs == inputs) {
+            const auto& entry = it->second;
+            const auto offset =
+                std::chrono::duration_cast<std::chrono::seconds>(start.to_time_point() - entry.start.to_time_point())
+                    .count();
+            if (offset >= 0 and offset + duration <= entry.duration) {
+                this->statistics.hits++;
+                this->recently_used.splice(this->recently_used.begin(), this->recently_used, entry.recently_used);
+                return this->slice(entry.schedule, entry.start, static_cast<std::int32_t>(offset), duration);
+            }
+        }
+        this->statistics.misses++;
+        return std::nullopt;
+    }
+
+    ///
+    /// \brief Stores the \p schedule for \p key, calculated with \p inputs, from \p start for \p duration seconds
+    ///
+    void put(const Key& key, Inputs inputs, const DateTime& start, const std::int32_t duration, Schedule schedule) {
+        std::lock_guard<std::mutex> lock(this->cache_mutex);
+        if (this->capacity == 0) {
+            return;
+        }
+        for (auto it = this->entries.begin(); it != this->entries.end();) {
+            const auto& entry = it->second;
+            const auto end = entry.start.to_time_point() + std::chrono::seconds(entry.duration);
+            if (it->first == key or !(entry.inputs == inputs) or end <= start.to_time_point()) {
+                this->recently_used.erase(entry.recently_used);
+                it = this->entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (this->entries.size() >= this->capacity) {
+            this->entries.erase(this->recently_used.back());
+            this->recently_used.pop_back();
+        }
+        this->recently_used.push_front(key);
+        this->entries.emplace(
+            key, Entry{std::move(inputs), start, duration, std::move(schedule), this->recently_used.begin()});
+    }
+
+    /// \brief Removes all cached schedules
+    void clear() {
+        std::lock_guard<std::mutex> lock(this->cache_mutex);
+        this->entries.clear();
+        this->recently_used.clear();
+    }
+
+    /// \brief Returns the number of cached schedules
+    std::size_t size() {
+        std::lock_guard<std::mutex> lock(this->cache_mutex);
+        return this->entries.size();
+    }
+
+    CompositeScheduleCacheStatistics get_statistics() {
+        std::lock_guard<std::mutex> lock(this->cache_mutex);
+        return this->statistics;
+    }
+
+private:
+    struct Entry {
+        Inputs inputs;
+        DateTime start;
+        std::int32_t duration;
+        Schedule schedule;
+        typename std::list<Key>::iterator recently_used;
+    };
+
+    SliceFunction slice;
+    const std::size_t capacity;
+    std::mutex cache_mutex;
+    std::map<Key, Entry> entries;
+    /// \brief Keys of the cached schedules, the most recently used first
+    std::list<Key> recently_used;
+    CompositeScheduleCacheStatistics statistics;
+};
+
+} // namespace ocpp
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -28,6 +29,9 @@ constexpr std::int32_t EVSEID_NOT_SET = -1;
 
 constexpr std::chrono::seconds DEFAULT_WAIT_FOR_FUTURE_TIMEOUT = std::chrono::seconds(60);
 
+/// \brief Maximum size of a message that is split into parts, if the MaxMessageSize variable is not set
+constexpr std::size_t DEFAULT_MAX_MESSAGE_SIZE = 65000;
+
 const std::string VARIABLE_ATTRIBUTE_VALUE_SOURCE_INTERNAL = "internal";
 const std::string VARIABLE_ATTRIBUTE_VALUE_SOURCE_CSMS = "csms";
 
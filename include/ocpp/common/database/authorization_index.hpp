@@ -0,0 +1,207 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ocpp::common {
+
+/// \brief Default number of parsed entries an AuthorizationIndex keeps in memory
+constexpr std::size_t DEFAULT_AUTHORIZATION_INDEX_CAPACITY = 1000;
+
+///
+/// \brief Bloom filter of string keys. may_contain() never returns false for an inserted key and returns true for a
+/// key that was not inserted with a probability of less than 2%.
+///
+/// The filter grows: when the number of inserted keys exceeds the number the filter was created for, another filter of
+/// twice the size and a lower false positive rate is added, so the filter does not have to be created again from all
+/// keys. Keys can not be removed, only all keys at once by clear().
+///
+class BloomFilter {
+public:
+    /// \param expected_keys Number of keys the filter is sized for initially
+    explicit BloomFilter(std::size_t expected_keys = 0);
+
+    void insert(std::string_view key);
+    bool may_contain(std::string_view key) const;
+
+    /// \brief Removes all keys and shrinks the filter to the size for \p expected_keys
+    void clear(std::size_t expected_keys = 0);
+
+    /// \brief Returns the number of inserted keys, keys inserted more than once are counted every time
+    std::size_t size() const;
+
+private:
+    struct Stage {
+        std::vector<std::uint64_t> bits;
+        std::uint64_t nr_of_bits;
+        std::uint32_t nr_of_hashes;
+        std::size_t capacity;
+        std::size_t nr_of_keys;
+    };
+
+    static Stage create_stage(std::size_t capacity, double false_positive_rate);
+
+    std::vector<Stage> stages;
+    double next_false_positive_rate;
+};
+
+///
+/// \brief In memory index of an authorization table (local authorization list or authorization cache) that is stored
+/// in the database, which stays the durable store.
+///
+/// The index consists of a BloomFilter of all keys of the table, so lookups of unknown keys are answered without a
+/// database query, and the parsed values of up to \p capacity recently used keys. The database handler adds every key
+/// it writes to the filter before writing the row and erases the cached value after writing it. Keys that are deleted
+/// stay in the filter until the table is cleared or the index is loaded again, which only costs a database query. The
+/// handler must be the only writer of the table, rows written by another connection are not known to the index.
+///
+/// Until load() is called, the index contains no values and may_contain() returns true for every key. Values read from
+/// the database are only cached if the index has not been modified since the generation that was read before the
+/// query, so a concurrent write is never overwritten by an outdated value.
+///
+template <typename Value> class AuthorizationIndex {
+public:
+    explicit AuthorizationIndex(std::size_t capacity = DEFAULT_AUTHORIZATION_INDEX_CAPACITY) : capacity(capacity) {
+    }
+
+    /// \brief Sets \p keys as the keys of the table and removes all cached values
+    void load(const std::vector<std::string>& keys) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->filter.clear(keys.size());
+        for (const auto& key : keys) {
+            if (!this->filter.may_contain(key)) {
+                this->filter.insert(key);
+            }
+        }
+        this->clear_values_internal();
+        this->loaded = true;
+    }
+
+    /// \brief Returns false if \p key is not in the table
+    bool may_contain(const std::string& key) const {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return !this->loaded or this->filter.may_contain(key);
+    }
+
+    /// \brief Adds \p key to the keys of the table, must be called before a row of \p key is written. Keys that the
+    /// filter may already contain are not inserted again, so rows that are written repeatedly do not grow the filter
+    void insert_key(const std::string& key) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (!this->filter.may_contain(key)) {
+            this->filter.insert(key);
+        }
+    }
+
+    /// \brief Returns the cached value of \p key
+    std::optional<Value> find(const std::string& key) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        const auto it = this->values.find(key);
+        if (it == this->values.end()) {
+            return std::nullopt;
+        }
+        this->recently_used.splice(this->recently_used.begin(), this->recently_used, it->second);
+        return it->second->second;
+    }
+
+    /// \brief Returns the generation to pass to cache_value() for a value that is read from the database afterwards
+    std::uint64_t get_generation() const {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->generation;
+    }
+
+    /// \brief Caches \p value of \p key that was read from the database, if the index was not modified since
+    /// \p read_generation. Evicts the least recently used value if the index is full.
+    void cache_value(const std::string& key, const Value& value, const std::uint64_t read_generation) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (!this->loaded or read_generation != this->generation or this->capacity == 0) {
+            return;
+        }
+        const auto it = this->values.find(key);
+        if (it != this->values.end()) {
+            it->second->second = value;
+            this->recently_used.splice(this->recently_used.begin(), this->recently_used, it->second);
+            return;
+        }
+        if (this->values.size() >= this->capacity) {
+            this->values.erase(this->recently_used.back().first);
+            this->recently_used.pop_back();
+        }
+        this->recently_used.emplace_front(key, value);
+        this->values.emplace(key, this->recently_used.begin());
+    }
+
+    /// \brief Applies \p update to the cached value of \p key, must be called after the row of \p key is written
+    template <typename Update> void update_value(const std::string& key, Update&& update) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->generation++;
+        const auto it = this->values.find(key);
+        if (it != this->values.end()) {
+            update(it->second->second);
+        }
+    }
+
+    /// \brief Removes the cached value of \p key, must be called after the row of \p key is written or deleted
+    void erase_value(const std::string& key) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->generation++;
+        const auto it = this->values.find(key);
+        if (it != this->values.end()) {
+            this->recently_used.erase(it->second);
+            this->values.erase(it);
+        }
+    }
+
+    /// \brief Removes all cached values, must be called after rows were written or deleted by other keys than their key
+    void clear_values() {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->clear_values_internal();
+    }
+
+    /// \brief Removes all keys and cached values, must be called after the table was cleared
+    void clear() {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->filter.clear();
+        this->clear_values_internal();
+    }
+
+    /// \brief Returns the number of cached values
+    std::size_t get_nr_of_values() const {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->values.size();
+    }
+
+    /// \brief Returns the number of keys in the filter
+    std::size_t get_nr_of_keys() const {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->filter.size();
+    }
+
+private:
+    void clear_values_internal() {
+        this->generation++;
+        this->values.clear();
+        this->recently_used.clear();
+    }
+
+    const std::size_t capacity;
+    mutable std::mutex mutex;
+    bool loaded{false};
+    BloomFilter filter;
+    /// \brief Incremented by every modification of the index
+    std::uint64_t generation{0};
+    /// \brief Cached values, the most recently used first
+    std::list<std::pair<std::string, Value>> recently_used;
+    std::unordered_map<std::string, typename std::list<std::pair<std::string, Value>>::iterator> values;
+};
+
+} // namespace ocpp::common
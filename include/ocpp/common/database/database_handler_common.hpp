@@ -9,6 +9,7 @@
 
 #include <everest/database/exceptions.hpp>
 #include <everest/database/sqlite/connection.hpp>
+#include <ocpp/common/database/statement_cache.hpp>
 #include <ocpp/common/types.hpp>
 
 namespace ocpp::common {
@@ -26,10 +27,16 @@ protected:
     std::unique_ptr<everest::db::sqlite::ConnectionInterface> database;
     const fs::path sql_migration_files_path;
     const std::uint32_t target_schema_version;
+    /// \brief Prepared statements of \p database for SQL that is executed frequently. Declared after \p database, so
+    /// the statements are finalized before the connection is closed.
+    StatementCache statement_cache;
 
     /// \brief Perform the initialization needed to use the database. Will be called by open_connection()
     virtual void init_sql() = 0;
 
+    /// \brief Returns all values of \p key_column of \p table_name, the keys an AuthorizationIndex is loaded with
+    std::vector<std::string> get_authorization_index_keys(const std::string& table_name, const std::string& key_column);
+
 public:
     /// \brief Common database handler class
     /// Class handles some common database functionality like inserting and removing transaction messages.
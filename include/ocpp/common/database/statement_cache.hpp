@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <everest/database/sqlite/connection.hpp>
+
+namespace ocpp::common {
+
+class StatementCache;
+
+///
+/// \brief A prepared statement checked out of a StatementCache. The statement is reset and returned to the cache when
+/// the CachedStatement is destroyed, so it does not keep a read transaction open.
+///
+/// Resetting a statement does not clear its bindings, every parameter has to be bound (or bound to null) before the
+/// statement is stepped.
+///
+class CachedStatement {
+public:
+    CachedStatement(CachedStatement&& other) noexcept;
+    CachedStatement& operator=(CachedStatement&& other) = delete;
+    CachedStatement(const CachedStatement&) = delete;
+    CachedStatement& operator=(const CachedStatement&) = delete;
+    ~CachedStatement();
+
+    everest::db::sqlite::StatementInterface* operator->() const {
+        return this->statement.get();
+    }
+
+    everest::db::sqlite::StatementInterface& operator*() const {
+        return *this->statement;
+    }
+
+private:
+    friend class StatementCache;
+
+    CachedStatement(StatementCache* cache, const std::string* sql,
+                    std::unique_ptr<everest::db::sqlite::StatementInterface> statement, std::uint64_t generation);
+
+    StatementCache* cache;
+    /// \brief Points to the key of the statement in the cache, which is never removed
+    const std::string* sql;
+    std::unique_ptr<everest::db::sqlite::StatementInterface> statement;
+    std::uint64_t generation;
+};
+
+///
+/// \brief Keeps the prepared statements of a database connection, so SQLite does not have to parse and plan the same
+/// SQL again on every call.
+///
+/// Statements are keyed by their SQL text. A statement is checked out by get() and returned when the CachedStatement
+/// is destroyed, so the same SQL can be used by several threads or nested calls at the same time; a new statement is
+/// prepared if all cached statements of the SQL are in use. Only SQL with a bounded number of variants (e.g. no
+/// generated IN lists) should be used with the cache, other statements should be created by the connection itself.
+///
+/// The cache must be cleared before the connection is closed or the schema is migrated. Statements that are still
+/// checked out while the cache is cleared are finalized when they are returned.
+///
+class StatementCache {
+public:
+    /// \param database The connection the statements are prepared on, it must outlive the cache
+    explicit StatementCache(everest::db::sqlite::ConnectionInterface& database);
+
+    /// \brief Returns a reset statement for \p sql, prepares a new one if none is available. Throws like
+    /// ConnectionInterface::new_statement if the statement can not be prepared.
+    CachedStatement get(const std::string& sql);
+
+    /// \brief Finalizes all statements that are not checked out
+    void clear();
+
+    /// \brief Returns the number of statements that are not checked out
+    std::size_t size();
+
+private:
+    friend class CachedStatement;
+
+    struct Entry {
+        std::vector<std::unique_ptr<everest::db::sqlite::StatementInterface>> available;
+    };
+
+    void release(const std::string& sql, std::unique_ptr<everest::db::sqlite::StatementInterface> statement,
+                 std::uint64_t generation);
+
+    everest::db::sqlite::ConnectionInterface& database;
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    /// \brief Incremented by clear(), statements of older generations are not returned to the cache
+    std::uint64_t generation{0};
+};
+
+} // namespace ocpp::common
@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <everest/logging.hpp>
+#include <everest/timer.hpp>
+
+#include <ocpp/common/types.hpp>
+
+namespace ocpp {
+
+/// \brief The effective \p limit of an evse from \p start until the start of the next entry of its timeline
+template <typename Limit> struct EffectiveLimitTimelineEntry {
+    DateTime start;
+    Limit limit;
+};
+
+///
+/// \brief Keeps a precomputed timeline of the effective limits of every evse, so an application is notified when the
+/// limit it has to apply changes instead of polling composite schedules.
+///
+/// The timeline of an evse is calculated for \p horizon from the current time. It is only calculated again when
+/// update() is called for the evse, e.g. because a profile was added or a transaction started, or when the end of the
+/// timeline is reached. A single timer is armed at the earliest time at which the effective limit of any evse changes.
+/// The callback is only called when the effective limit of an evse differs from the one it was last called with. It is
+/// called from the thread that called update() or from the timer and must not call update() or advance() itself.
+///
+template <typename Limit> class EffectiveLimitTimeline {
+public:
+    using Entry = EffectiveLimitTimelineEntry<Limit>;
+    /// \brief Returns the timelines of \p evse_ids for \p duration seconds from now, ordered by start. The first entry
+    /// of a timeline must start at or before the current time.
+    using CalculateFunction = std::function<std::vector<std::vector<Entry>>(const std::vector<std::int32_t>& evse_ids,
+                                                                            std::int32_t duration)>;
+    using LimitChangedCallback = std::function<void(std::int32_t evse_id, const Limit& limit)>;
+
+    EffectiveLimitTimeline(CalculateFunction calculate, LimitChangedCallback callback,
+                           const std::chrono::seconds horizon) :
+        calculate(std::move(calculate)), callback(std::move(callback)), horizon(horizon) {
+    }
+
+    ~EffectiveLimitTimeline() {
+        this->timer.stop();
+    }
+
+    EffectiveLimitTimeline(const EffectiveLimitTimeline&) = delete;
+    EffectiveLimitTimeline& operator=(const EffectiveLimitTimeline&) = delete;
+
+    ///
+    /// \brief Calculates the timelines of \p evse_ids again and calls the callback for every evse of which the
+    /// effective limit at \p now changed
+    ///
+    void update(const std::vector<std::int32_t>& evse_ids, const DateTime& now = DateTime()) {
+        std::lock_guard<std::mutex> update_lock(this->update_mutex);
+        this->recalculate(evse_ids, now);
+        this->notify(this->advance_timelines(now));
+    }
+
+    ///
+    /// \brief Moves all timelines to \p now and calls the callback for every evse of which the effective limit changed.
+    /// Timelines that end before \p now are calculated again.
+    ///
+    void advance(const DateTime& now = DateTime()) {
+        std::lock_guard<std::mutex> update_lock(this->update_mutex);
+        std::vector<std::int32_t> ended;
+        {
+            std::lock_guard<std::mutex> lock(this->timelines_mutex);
+            for (const auto& [evse_id, timeline] : this->timelines) {
+                if (timeline.end <= now) {
+                    ended.push_back(evse_id);
+                }
+            }
+        }
+        if (!ended.empty()) {
+            this->recalculate(ended, now);
+        }
+        this->notify(this->advance_timelines(now));
+    }
+
+    /// \brief Returns the effective limit of \p evse_id the callback was last called with
+    std::optional<Limit> get_limit(const std::int32_t evse_id) {
+        std::lock_guard<std::mutex> lock(this->timelines_mutex);
+        const auto it = this->timelines.find(evse_id);
+        if (it == this->timelines.end()) {
+            return std::nullopt;
+        }
+        return it->second.notified;
+    }
+
+    /// \brief Returns the time the timer is armed at, empty if there are no timelines
+    std::optional<DateTime> get_next_change() {
+        std::lock_guard<std::mutex> lock(this->timelines_mutex);
+        return this->next_change;
+    }
+
+private:
+    struct Timeline {
+        /// \brief Starts with the entry that was effective when the timeline was last advanced
+        std::vector<Entry> entries;
+        DateTime end;
+        std::optional<Limit> notified;
+    };
+
+    void recalculate(const std::vector<std::int32_t>& evse_ids, const DateTime& now) {
+        const auto duration = static_cast<std::int32_t>(this->horizon.count());
+        std::vector<std::vector<Entry>> calculated;
+        try {
+            calculated = this->calculate(evse_ids, duration);
+        } catch (const std::exception& e) {
+            EVLOG_warning << "Could not calculate the effective limits: " << e.what();
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(this->timelines_mutex);
+        for (std::size_t i = 0; i < evse_ids.size() and i < calculated.size(); i++) {
+            auto& timeline = this->timelines[evse_ids[i]];
+            timeline.entries = std::move(calculated[i]);
+            timeline.end = DateTime(now.to_time_point() + this->horizon);
+        }
+    }
+
+    /// \brief Drops the entries that ended before \p now, re-arms the timer and returns the changed limits
+    std::vector<std::pair<std::int32_t, Limit>> advance_timelines(const DateTime& now) {
+        std::vector<std::pair<std::int32_t, Limit>> changes;
+        std::lock_guard<std::mutex> lock(this->timelines_mutex);
+        this->next_change.reset();
+        for (auto& [evse_id, timeline] : this->timelines) {
+            auto& entries = timeline.entries;
+            const auto next =
+                std::upper_bound(entries.begin(), entries.end(), now,
+                                 [](const DateTime& time, const Entry& entry) { return time < entry.start; });
+            if (next != entries.begin()) {
+                entries.erase(entries.begin(), std::prev(next));
+                const auto& limit = entries.front().limit;
+                if (!timeline.notified.has_value() or !(timeline.notified.value() == limit)) {
+                    timeline.notified = limit;
+                    changes.emplace_back(evse_id, limit);
+                }
+            }
+
+            auto change = timeline.end;
+            if (!entries.empty() and now < entries.front().start) {
+                change = entries.front().start;
+            } else if (!entries.empty()) {
+                const auto differs = std::find_if(std::next(entries.begin()), entries.end(), [&](const Entry& entry) {
+                    return !(entry.limit == entries.front().limit);
+                });
+                if (differs != entries.end()) {
+                    change = differs->start;
+                }
+            }
+            if (!this->next_change.has_value() or change < this->next_change.value()) {
+                this->next_change = change;
+            }
+        }
+
+        if (this->next_change.has_value()) {
+            this->timer.at([this]() { this->advance(); }, this->next_change.value().to_time_point());
+        } else {
+            this->timer.stop();
+        }
+        return changes;
+    }
+
+    void notify(const std::vector<std::pair<std::int32_t, Limit>>& changes) {
+        for (const auto& [evse_id, limit] : changes) {
+            this->callback(evse_id, limit);
+        }
+    }
+
+    CalculateFunction calculate;
+    LimitChangedCallback callback;
+    std::chrono::seconds horizon;
+    /// \brief Serializes update() and advance(), so the callback is called in the order of the changes
+    std::mutex update_mutex;
+    std::mutex timelines_mutex;
+    std::map<std::int32_t, Timeline> timelines;
+    std::optional<DateTime> next_change;
+    Everest::SystemTimer timer;
+};
+
+} // namespace ocpp
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ocpp {
+
+///
+/// \brief Fixed set of threads that run the tasks of one run() at a time, so the threads are not created for every
+/// calculation that is distributed over them.
+///
+/// The calling thread of run() is one of the \p nr_of_workers, so a pool of one worker does not start any thread.
+/// A run() that is called while another one is in progress, e.g. from another thread, does not wait for it but runs
+/// its tasks on the calling thread only.
+///
+class WorkerPool {
+public:
+    using Task = std::function<void(std::size_t index)>;
+
+    explicit WorkerPool(std::size_t nr_of_workers);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /// \brief Runs \p task for every index below \p count and returns once all tasks are done. The first exception
+    /// thrown by a task is rethrown once all tasks are done.
+    void run(std::size_t count, const Task& task);
+
+    /// \brief Returns the number of threads run() distributes the tasks over, including the calling thread
+    std::size_t get_nr_of_workers() const;
+
+private:
+    struct Job {
+        const Task* task;
+        std::size_t count;
+        std::atomic<std::size_t> next_index{0};
+        std::mutex exception_mutex;
+        std::exception_ptr exception;
+    };
+
+    static void work(Job& job);
+    void worker_loop();
+
+    /// \brief Held for the duration of a run() that uses the threads
+    std::mutex run_mutex;
+    /// \brief Protects the members below
+    std::mutex mutex;
+    std::condition_variable job_cv;
+    std::condition_variable done_cv;
+    Job* job{nullptr};
+    std::uint64_t job_generation{0};
+    std::size_t nr_of_busy_threads{0};
+    bool stopping{false};
+    std::vector<std::thread> threads;
+};
+
+} // namespace ocpp
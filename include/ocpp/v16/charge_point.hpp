@@ -543,6 +543,14 @@ public:
     /// \param callback
     void register_signal_set_charging_profiles_callback(const std::function<void()>& callback);
 
+    /// \brief registers a \p callback function that is called with the effective limit of a connector whenever it
+    /// changes, e.g. because a profile was set or cleared, a transaction started or stopped or the period of the
+    /// composite schedule changed. It is also called once for every connector when it is registered. Connector 0
+    /// receives the limit of the whole charge point. This avoids polling the composite schedules to learn the current
+    /// limit.
+    /// \param callback
+    void register_effective_limit_changed_callback(const EffectiveLimitChangedCallback& callback);
+
     /// \brief registers a \p callback function that can be used when the connection state to CSMS changes. The
     /// connection_state_changed_callback is called when chargepoint has connected to or disconnected from the CSMS.
     /// \param callback
@@ -17,8 +17,6 @@ struct Connector {
     double max_current_offered = 0;
     double max_power_offered = 0;
     std::shared_ptr<Transaction> transaction = nullptr;
-    std::map<int, ChargingProfile> stack_level_tx_default_profiles_map;
-    std::map<int, ChargingProfile> stack_level_tx_profiles_map;
     std::optional<std::vector<ChargePointStatus>> trigger_metervalue_on_status;
     std::optional<double> trigger_metervalue_on_power_kw;
     std::optional<double> trigger_metervalue_on_energy_kwh;
@@ -7,6 +7,7 @@
 #include <fstream>
 #include <iostream>
 
+#include <ocpp/common/database/authorization_index.hpp>
 #include <ocpp/common/database/database_handler_common.hpp>
 #include <ocpp/common/schemas.hpp>
 #include <ocpp/common/support_older_cpp_versions.hpp>
@@ -48,6 +49,15 @@ private:
     void init_sql() override;
     void init_connector_table();
 
+    /// \brief In memory indexes of AUTH_LIST and AUTH_CACHE by id tag, loaded by init_sql()
+    common::AuthorizationIndex<v16::IdTagInfo> local_authorization_list_index;
+    common::AuthorizationIndex<v16::IdTagInfo> authorization_cache_index;
+
+    /// \brief Returns the IdTagInfo of \p id_tag from \p index or else from the \p table_name table (AUTH_LIST or
+    /// AUTH_CACHE), without checking its expiry date
+    std::optional<v16::IdTagInfo> get_id_tag_info(common::AuthorizationIndex<v16::IdTagInfo>& index,
+                                                  const std::string& table_name, const CiString<20>& id_tag);
+
 public:
     DatabaseHandler(std::unique_ptr<everest::db::sqlite::ConnectionInterface> database,
                     const fs::path& sql_migration_files_path, std::int32_t number_of_connectors);
@@ -127,7 +137,10 @@ public:
     void insert_or_update_local_authorization_list_entry(const CiString<20>& id_tag, const v16::IdTagInfo& id_tag_info);
 
     /// \brief Inserts or updates a local authorization list entries \p local_authorization_list to the AUTH_LIST table.
-    void insert_or_update_local_authorization_list(std::vector<v16::LocalAuthorizationList> local_authorization_list);
+    /// All entries are written in one database transaction. If an entry can not be written the remaining entries are
+    /// still committed and a QueryExecutionException is thrown afterwards.
+    void
+    insert_or_update_local_authorization_list(const std::vector<v16::LocalAuthorizationList>& local_authorization_list);
 
     /// \brief Deletes the authorization list entry with the given \p id_tag
     void delete_local_authorization_list_entry(const std::string& id_tag);
@@ -4,9 +4,15 @@
 #ifndef OCPP_V16_SMART_CHARGING_HPP
 #define OCPP_V16_SMART_CHARGING_HPP
 
+#include <atomic>
 #include <cstddef>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <tuple>
 
+#include <ocpp/common/composite_schedule_cache.hpp>
+#include <ocpp/common/effective_limit_timeline.hpp>
 #include <ocpp/v16/charge_point_configuration.hpp>
 #include <ocpp/v16/connector.hpp>
 #include <ocpp/v16/database_handler.hpp>
@@ -34,6 +40,44 @@ struct PeriodDateTimePair {
     ocpp::DateTime end_time;
 };
 
+/// \brief Identifies a cached composite schedule: connector id, charging rate unit, duration, whether the charge point
+/// is offline and whether a transaction is simulated
+using CompositeScheduleKey = std::tuple<std::int32_t, ChargingRateUnit, std::int32_t, bool, bool>;
+
+/// \brief Everything besides the time that a composite schedule is calculated from
+struct CompositeScheduleInputs {
+    std::uint64_t profiles_generation;
+    /// \brief The session id and transaction id of the transaction of every connector, empty if there is none
+    std::vector<std::pair<std::string, std::optional<std::int32_t>>> transactions;
+    std::set<ChargingProfilePurposeType> purposes_to_ignore;
+    float current_limit;
+    float power_limit;
+    std::int32_t default_number_phases;
+    float supply_voltage;
+
+    bool operator==(const CompositeScheduleInputs& other) const;
+};
+
+/// \brief The installed profiles by stack level. A published snapshot is never modified, changes publish a new one.
+struct ChargingProfilesSnapshot {
+    std::map<int, ChargingProfile> charge_point_max_profiles;
+    /// \brief TxDefaultProfiles per connector id, a TxDefaultProfile for connector 0 is stored for every connector
+    std::map<std::int32_t, std::map<int, ChargingProfile>> tx_default_profiles;
+    /// \brief TxProfiles per connector id
+    std::map<std::int32_t, std::map<int, ChargingProfile>> tx_profiles;
+};
+
+/// \brief The limit a connector has to apply, taken from the current period of its composite schedule
+struct EffectiveLimit {
+    ChargingRateUnit charging_rate_unit;
+    float limit;
+    std::optional<std::int32_t> number_phases;
+
+    bool operator==(const EffectiveLimit& other) const;
+};
+
+using EffectiveLimitChangedCallback = std::function<void(std::int32_t connector_id, const EffectiveLimit& limit)>;
+
 /// \brief This class handles and maintains incoming ChargingProfiles and contains the logic
 /// to calculate the composite schedules
 class SmartChargingHandler {
@@ -41,18 +85,47 @@ private:
     std::map<std::int32_t, std::shared_ptr<Connector>> connectors;
     std::shared_ptr<ocpp::v16::DatabaseHandler> database_handler;
     ChargePointConfiguration& configuration;
-    std::map<int, ChargingProfile> stack_level_charge_point_max_profiles_map;
-    std::mutex charge_point_max_profiles_map_mutex;
-    std::mutex tx_default_profiles_map_mutex;
-    std::mutex tx_profiles_map_mutex;
+    /// \brief The current profiles, only accessed with std::atomic_load and std::atomic_store so readers never block
+    std::shared_ptr<const ChargingProfilesSnapshot> profiles;
+    /// \brief Serializes the changes of the profiles, each change copies the current snapshot and publishes the copy
+    std::mutex profiles_write_mutex;
 
     std::unique_ptr<Everest::SteadyTimer> clear_profiles_timer;
 
+    /// \brief Incremented whenever a profile is added or removed, invalidates the composite_schedule_cache
+    std::atomic<std::uint64_t> profiles_generation;
+    CompositeScheduleCache<CompositeScheduleKey, CompositeScheduleInputs, EnhancedChargingSchedule>
+        composite_schedule_cache;
+    /// \brief Whether the effective limits are calculated for an offline charge point
+    std::atomic<bool> effective_limits_offline;
+    /// \brief Only present when an effective limit changed callback is registered. Declared last, so its timer is
+    /// stopped before the members it calculates the limits from are destroyed.
+    std::unique_ptr<EffectiveLimitTimeline<EffectiveLimit>> effective_limit_timeline;
+
+    /// \brief Returns the current snapshot of the installed profiles
+    std::shared_ptr<const ChargingProfilesSnapshot> get_profiles_snapshot() const;
+
+    /// \brief Publishes \p snapshot as the current profiles, profiles_write_mutex must be held
+    void publish_profiles_snapshot(std::shared_ptr<const ChargingProfilesSnapshot> snapshot);
+
+    std::vector<ChargingProfile> get_valid_profiles(const ChargingProfilesSnapshot& snapshot, const int connector_id,
+                                                    const std::set<ChargingProfilePurposeType>& purposes_to_ignore);
+
     bool clear_profiles(std::map<std::int32_t, ChargingProfile>& stack_level_profiles_map,
                         std::optional<int> profile_id_opt, std::optional<int> connector_id_opt, const int connector_id,
                         std::optional<int> stack_level_opt,
                         std::optional<ChargingProfilePurposeType> charging_profile_purpose_opt, bool check_id_only);
 
+    ///
+    /// \brief Checks if the composite schedule for \p connector_id depends on the time it is calculated at, which is
+    /// the case for Relative profiles that do not start with a transaction
+    ///
+    bool depends_on_calculation_time(std::int32_t connector_id);
+
+    /// \brief Calculates the timelines of the effective limits of \p connector_ids for the effective_limit_timeline
+    std::vector<std::vector<EffectiveLimitTimelineEntry<EffectiveLimit>>>
+    calculate_effective_limit_timelines(const std::vector<std::int32_t>& connector_ids, std::int32_t duration);
+
 protected:
     int get_number_installed_profiles();
     void clear_expired_profiles(const date::utc_clock::time_point& now);
@@ -70,19 +143,18 @@ public:
                           const std::vector<ChargingRateUnit>& charging_schedule_allowed_charging_rate_units);
 
     ///
-    /// \brief Adds the given \p profile to the collection of stack_level_charge_point_max_profiles_map
+    /// \brief Adds the given \p profile to the ChargePointMaxProfiles
     ///
     void add_charge_point_max_profile(const ChargingProfile& profile);
 
     ///
-    /// \brief Adds the given \p profile to the collection of stack_level_tx_default_profiles_map of the respective
-    /// connector or to all connectors if \p connector_id is 0
+    /// \brief Adds the given \p profile to the TxDefaultProfiles of the respective connector or to all connectors if
+    /// \p connector_id is 0
     ///
     void add_tx_default_profile(const ChargingProfile& profile, const int connector_id);
 
     ///
-    /// \brief Adds the given \p profile to the collection of stack_level_tx_profiles_map of the respective
-    /// connector
+    /// \brief Adds the given \p profile to the TxProfiles of the respective connector
     ///
     void add_tx_profile(const ChargingProfile& profile, const int connector_id);
 
@@ -118,6 +190,42 @@ public:
     ChargingSchedule calculate_composite_schedule(const ocpp::DateTime& start_time, const ocpp::DateTime& end_time,
                                                   const std::int32_t evse_id, ChargingRateUnit charging_rate_unit,
                                                   bool is_offline, bool simulate_transaction_active);
+
+    ///
+    /// \brief Returns the enhanced composite schedule for \p evse_id from now for \p duration seconds. The schedule is
+    /// taken from a cache if none of its inputs changed since it was calculated.
+    ///
+    EnhancedChargingSchedule get_enhanced_composite_schedule(std::int32_t evse_id, std::int32_t duration,
+                                                             ChargingRateUnit charging_rate_unit, bool is_offline,
+                                                             bool simulate_transaction_active);
+
+    ///
+    /// \brief Returns the composite schedule for \p evse_id from now for \p duration seconds, see
+    /// get_enhanced_composite_schedule
+    ///
+    ChargingSchedule get_composite_schedule(std::int32_t evse_id, std::int32_t duration,
+                                            ChargingRateUnit charging_rate_unit, bool is_offline,
+                                            bool simulate_transaction_active);
+
+    ///
+    /// \brief Registers a \p callback that is called with the effective limit of a connector whenever it changes, and
+    /// once for every connector with its current limit. The limits use the first of the
+    /// ChargingScheduleAllowedChargingRateUnit and are calculated again when profiles are added or cleared, see
+    /// update_effective_limits.
+    ///
+    void register_effective_limit_changed_callback(const EffectiveLimitChangedCallback& callback);
+
+    ///
+    /// \brief Calculates the effective limits of \p connector_id again, or of all connectors if it is 0, e.g. because
+    /// its transaction started or stopped. Does nothing if no effective limit changed callback is registered.
+    ///
+    void update_effective_limits(std::int32_t connector_id);
+
+    ///
+    /// \brief Sets whether the effective limits are calculated for an offline charge point, for which the profile
+    /// purposes configured in IgnoredProfilePurposesOffline are ignored
+    ///
+    void set_offline(bool is_offline);
 };
 
 bool validate_schedule(const ChargingSchedule& schedule, const int charging_schedule_max_periods,
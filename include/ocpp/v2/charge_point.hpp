@@ -13,6 +13,8 @@
 
 #include <ocpp/v2/average_meter_values.hpp>
 #include <ocpp/v2/charge_point_callbacks.hpp>
+#include <ocpp/v2/monitoring_updater.hpp>
+#include <ocpp/v2/notify_event_coalescer.hpp>
 #include <ocpp/v2/ocpp_enums.hpp>
 #include <ocpp/v2/ocpp_types.hpp>
 #include <ocpp/v2/ocsp_updater.hpp>
@@ -318,6 +320,15 @@ public:
     virtual std::vector<CompositeSchedule> get_all_composite_schedules(const std::int32_t duration,
                                                                        const ChargingRateUnitEnum& unit) = 0;
 
+    /// \brief Gets the counters of the coalescing of EventData into NotifyEvent.req, see
+    /// NotifyEventCoalescingWindow and NotifyEventCoalescingMaxEvents of the MonitoringCtrlr
+    /// \return the number of coalesced events and of NotifyEvent.req saved by sending them together
+    virtual NotifyEventCoalescerStatistics get_notify_event_statistics() = 0;
+
+    /// \brief Gets the counters about the overhead of the monitoring. The processing and evaluation times are only
+    /// measured if MonitoringTimingEnabled of the InternalCtrlr is true
+    virtual MonitoringStatistics get_monitoring_statistics() = 0;
+
     /// \brief Gets the configured NetworkConnectionProfile based on the given \p configuration_slot . The
     /// central system uri of the connection options will not contain ws:// or wss:// because this method removes it if
     /// present. This returns the value from the cached network connection profiles. \param
@@ -612,6 +623,9 @@ public:
     std::vector<CompositeSchedule> get_all_composite_schedules(const std::int32_t duration,
                                                                const ChargingRateUnitEnum& unit) override;
 
+    NotifyEventCoalescerStatistics get_notify_event_statistics() override;
+    MonitoringStatistics get_monitoring_statistics() override;
+
     std::optional<NetworkConnectionProfile>
     get_network_connection_profile(const std::int32_t configuration_slot) const override;
 
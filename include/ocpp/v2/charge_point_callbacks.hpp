@@ -19,6 +19,8 @@
 #include <ocpp/v2/messages/UpdateFirmware.hpp>
 
 namespace ocpp::v2 {
+struct EffectiveLimit;
+
 struct Callbacks {
     /// @addtogroup ocpp201_callbacks OCPP 2.0.1 callbacks
     /// Callbacks will call be called when necessary and must be implemented by the calling class.
@@ -116,6 +118,12 @@ struct Callbacks {
     /// \brief Callback for indicating when a charging profile is received and was accepted.
     std::function<void()> set_charging_profiles_callback;
 
+    /// \brief Callback for when the limits and setpoints an evse has to apply change, e.g. because a profile was set,
+    /// a transaction started or a new period of the composite schedule started. Also called for evse 0 with the limits
+    /// of the charging station as a whole.
+    std::optional<std::function<void(const std::int32_t evse_id, const EffectiveLimit& limit)>>
+        effective_limit_changed_callback;
+
     /// \brief  Callback for when a bootnotification response is received
     std::optional<std::function<void(const ocpp::v2::BootNotificationResponse& boot_notification_response)>>
         boot_notification_callback;
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ocpp/v2/ocpp_types.hpp>
+#include <ocpp/v2/types.hpp>
+
+namespace ocpp::v2 {
+
+class DatabaseHandlerInterface;
+
+/// \brief A charging profile together with the data that is stored next to it
+struct StoredChargingProfile {
+    std::int32_t evse_id;
+    ChargingProfile profile;
+    CiString<20> charging_limit_source;
+};
+
+/// \brief Replaces the limits and setpoints of the first period of every schedule of \p profile by those of \p update.
+/// Values that are not present in \p update are removed from the periods.
+void apply_charging_schedule_update(ChargingProfile& profile, const ChargingScheduleUpdate& update);
+
+/// \brief In-memory store of the installed charging profiles, indexed by evse, purpose, stack level, transaction id
+/// and profile id.
+///
+/// The profiles are loaded from the CHARGING_PROFILES table on first use, afterwards the database is only used as
+/// write-through persistence. Every change is written to the database before the store is updated, so the store is
+/// unchanged if the database operation throws. Profiles are returned in the order they were stored, which is the order
+/// the database returns them in.
+class ChargingProfileStore {
+public:
+    explicit ChargingProfileStore(DatabaseHandlerInterface& database_handler);
+
+    /// \brief Inserts the \p profile for \p evse_id or replaces the profile with the same id
+    void insert_or_update(std::int32_t evse_id, const ChargingProfile& profile,
+                          const CiString<20>& charging_limit_source);
+
+    /// \brief Applies \p update to the Dynamic profile with \p profile_id, see apply_charging_schedule_update, and sets
+    /// its dynUpdateTime to \p update_time. The profile is only changed in memory, so frequent updates do not rewrite
+    /// the database. After a restart the profile has the values it was installed with until it is updated again.
+    /// \return the updated profile, empty if there is no Dynamic profile with \p profile_id
+    std::optional<StoredChargingProfile> update_dynamic_schedule(std::int32_t profile_id,
+                                                                 const ChargingScheduleUpdate& update,
+                                                                 const DateTime& update_time);
+
+    /// \brief Removes the profile with \p profile_id
+    /// \return true if a profile was removed
+    bool erase(std::int32_t profile_id);
+
+    /// \brief Removes all profiles of the transaction with \p transaction_id
+    void erase_by_transaction_id(const std::string& transaction_id);
+
+    /// \brief Removes the profile with \p profile_id or all profiles matching \p criteria, see
+    /// DatabaseHandlerInterface::clear_charging_profiles_matching_criteria
+    /// \return true if any profile was removed
+    bool clear_matching_criteria(std::optional<std::int32_t> profile_id,
+                                 const std::optional<ClearChargingProfile>& criteria);
+
+    /// \brief Returns all profiles matching \p evse_id and \p criteria, see
+    /// DatabaseHandlerInterface::get_charging_profiles_matching_criteria
+    std::vector<ReportedChargingProfile> get_matching_criteria(std::optional<std::int32_t> evse_id,
+                                                               const ChargingProfileCriterion& criteria);
+
+    /// \brief Returns all profiles installed on \p evse_id
+    std::vector<ChargingProfile> get_for_evse(std::int32_t evse_id);
+
+    /// \brief Returns all profiles with the given \p purpose, optionally only those on \p evse_id and with
+    /// \p stack_level
+    std::vector<StoredChargingProfile> get_by_purpose(ChargingProfilePurposeEnum purpose,
+                                                      std::optional<std::int32_t> evse_id = std::nullopt,
+                                                      std::optional<std::int32_t> stack_level = std::nullopt);
+
+    /// \brief Returns all profiles of the transaction with \p transaction_id
+    std::vector<ChargingProfile> get_by_transaction_id(const std::string& transaction_id);
+
+    /// \brief Returns the profile with \p profile_id if it exists
+    std::optional<StoredChargingProfile> get(std::int32_t profile_id);
+
+    /// \brief Returns a number that changes whenever a profile is added, replaced or removed, so results calculated
+    /// from the profiles can be reused while it is unchanged
+    std::uint64_t get_generation();
+
+    /// \brief Returns the generation of the last change of the profiles installed on \p evse_id, so results calculated
+    /// from the profiles of one evse can be reused while the profiles of other evses change
+    std::uint64_t get_generation(std::int32_t evse_id);
+
+private:
+    /// \brief Key of a profile in the indexes. The sequence number keeps the profiles in the order they were stored.
+    using ProfileKey = std::pair<std::uint64_t, std::int32_t>;
+    using EvsePurposeStackLevel = std::tuple<std::int32_t, ChargingProfilePurposeEnum, std::int32_t>;
+
+    struct Entry {
+        StoredChargingProfile stored;
+        std::uint64_t sequence;
+    };
+
+    DatabaseHandlerInterface& database_handler;
+
+    /// \brief Protects all members below
+    std::mutex store_mutex;
+    bool loaded;
+    std::uint64_t next_sequence;
+    std::uint64_t generation;
+    std::map<std::int32_t, Entry> profiles;
+    std::map<std::int32_t, std::uint64_t> evse_generations;
+    std::map<std::int32_t, std::set<ProfileKey>> by_evse;
+    std::map<EvsePurposeStackLevel, std::set<ProfileKey>> by_evse_purpose_stack_level;
+    std::unordered_map<std::string, std::set<ProfileKey>> by_transaction_id;
+
+    /// \brief Loads all profiles from the database if this was not done yet. Requires the store_mutex to be locked.
+    void load_internal();
+    void insert_internal(std::int32_t evse_id, const ChargingProfile& profile,
+                         const CiString<20>& charging_limit_source);
+    bool erase_internal(std::int32_t profile_id);
+
+    /// \brief Erases all profiles for which \p predicate returns true
+    template <typename Predicate> void erase_if_internal(Predicate predicate);
+};
+
+} // namespace ocpp::v2
@@ -139,6 +139,9 @@ extern const ComponentVariable OcspRequestInterval;
 extern const ComponentVariable WebsocketPingPayload;
 extern const ComponentVariable WebsocketPongTimeout;
 extern const ComponentVariable MonitorsProcessingInterval;
+extern const ComponentVariable MonitoringTimingEnabled;
+extern const ComponentVariable NotifyEventCoalescingWindow;
+extern const ComponentVariable NotifyEventCoalescingMaxEvents;
 extern const ComponentVariable MaxCustomerInformationDataLength;
 extern const ComponentVariable V2GCertificateExpireCheckInitialDelaySeconds;
 extern const ComponentVariable V2GCertificateExpireCheckIntervalSeconds;
@@ -147,6 +150,8 @@ extern const ComponentVariable ClientCertificateExpireCheckIntervalSeconds;
 extern const ComponentVariable MessageQueueSizeThreshold;
 extern const ComponentVariable MaxMessageSize;
 extern const ComponentVariable ResumeTransactionsOnBoot;
+extern const ComponentVariable MeterValuesPersistBatchSize;
+extern const ComponentVariable CompactMeterValueStorage;
 extern const ComponentVariable AllowSecurityLevelZeroConnections;
 extern const RequiredComponentVariable SupportedOcppVersions;
 extern const ComponentVariable AlignedDataCtrlrEnabled;
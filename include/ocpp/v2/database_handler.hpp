@@ -5,10 +5,15 @@
 
 #include "ocpp/v2/types.hpp"
 #include "sqlite3.h"
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <ocpp/common/support_older_cpp_versions.hpp>
 
 #include <everest/database/sqlite/connection.hpp>
+#include <ocpp/common/database/authorization_index.hpp>
 #include <ocpp/common/database/database_handler_common.hpp>
 #include <ocpp/v2/ocpp_types.hpp>
 #include <ocpp/v2/transaction.hpp>
@@ -36,12 +41,17 @@ public:
     virtual void authorization_cache_insert_entry(const std::string& id_token_hash,
                                                   const IdTokenInfo& id_token_info) = 0;
 
-    /// \brief Updates the last_used field in the entry
+    /// \brief Updates the last_used field in the entry. The entry returned by authorization_cache_get_entry() is
+    /// updated immediately, the database is only updated by authorization_cache_flush_last_used() or before entries
+    /// are removed by their last_used field.
     ///
     /// \param id_token_hash
-    /// \retval true if entry was updated
     virtual void authorization_cache_update_last_used(const std::string& id_token_hash) = 0;
 
+    /// \brief Writes the last_used fields updated by authorization_cache_update_last_used() to the database in one
+    /// transaction
+    virtual void authorization_cache_flush_last_used() = 0;
+
     /// \brief Gets cache entry for given \p id_token_hash if present
     /// \param id_token_hash
     /// \return
@@ -57,6 +67,10 @@ public:
     /// \retval True if succeeded
     virtual void authorization_cache_delete_nr_of_oldest_entries(size_t nr_to_remove) = 0;
 
+    /// \brief Removes as many items from the cache, starting from the least recently used, as needed for the binary
+    /// size of the cache to not exceed \p max_binary_size. The items are removed by a single statement.
+    virtual void authorization_cache_delete_oldest_entries_exceeding(size_t max_binary_size) = 0;
+
     /// \brief Removes all entries from the cache that have passed their expiry date or auth cache lifetime
     ///
     /// \param auth_cache_lifetime The maximum time tokens can stay in the cache without being used
@@ -67,11 +81,19 @@ public:
     /// \brief Deletes all entries of the AUTH_CACHE table. Returns true if the operation was successful, else false
     virtual void authorization_cache_clear() = 0;
 
-    /// \brief Get the binary size of the authorization cache table
+    /// \brief Get the binary size of the authorization cache table. The size is measured by
+    /// authorization_cache_reconcile_binary_size() and afterwards updated with the estimated size of every entry that
+    /// is inserted or removed, so it does not require a query.
     ///
     /// \retval The size of the authorization cache table in bytes
     virtual size_t authorization_cache_get_binary_size() = 0;
 
+    /// \brief Measures the binary size of the authorization cache table, which scans all pages of the table, and uses
+    /// it as the binary size from now on
+    ///
+    /// \retval The size of the authorization cache table in bytes
+    virtual size_t authorization_cache_reconcile_binary_size() = 0;
+
     // Availability
 
     /// \brief Persist operational settings for the charging station
@@ -104,6 +126,8 @@ public:
                                                                  const IdTokenInfo& id_token_info) = 0;
 
     /// \brief Inserts or updates a local authorization list entries \p local_authorization_list to the AUTH_LIST table.
+    /// All entries are written in one database transaction. If an entry can not be written the remaining entries are
+    /// still committed and a QueryExecutionException is thrown afterwards.
     virtual void
     insert_or_update_local_authorization_list(const std::vector<v2::AuthorizationData>& local_authorization_list) = 0;
 
@@ -124,7 +148,15 @@ public:
     /// \brief Inserts a \p meter_value to the database linked to transaction with id \p transaction_id
     virtual void transaction_metervalues_insert(const std::string& transaction_id, const MeterValue& meter_value) = 0;
 
-    /// \brief Get all metervalues linked to transaction with id \p transaction_id
+    /// \brief Inserts the \p meter_values of transaction \p transaction_id in one database transaction, so they cause
+    /// a single commit. Invalid meter values and meter values with the timestamp and reading context of an already
+    /// stored one are logged and skipped, the others are still inserted.
+    /// \param compact If true, every meter value is stored as one row with a timestamp relative to the previous meter
+    /// value of the transaction, otherwise as one row per sampled value like transaction_metervalues_insert
+    virtual void transaction_metervalues_insert_batch(const std::string& transaction_id,
+                                                      const std::vector<MeterValue>& meter_values, bool compact) = 0;
+
+    /// \brief Get all metervalues linked to transaction with id \p transaction_id, in the order they were stored
     virtual std::vector<MeterValue> transaction_metervalues_get_all(const std::string& transaction_id) = 0;
 
     /// \brief Remove all metervalue entries linked to transaction with id \p transaction_id
@@ -218,6 +250,37 @@ private:
                              bool replace);
     OperationalStatusEnum get_availability(std::int32_t evse_id, std::int32_t connector_id);
 
+    // Transaction metervalues (internal helpers)
+    void insert_meter_value_items(std::int64_t meter_value_id, const MeterValue& meter_value);
+    void insert_meter_value_records(const std::string& transaction_id, const std::vector<MeterValue>& meter_values);
+    std::vector<MeterValue> get_meter_value_records(const std::string& transaction_id);
+
+    /// \brief Sequence number and absolute timestamp of the last row in METER_VALUE_RECORDS per transaction
+    struct MeterValueRecordsPosition {
+        std::int64_t next_seq_no;
+        std::int64_t last_timestamp;
+        /// \brief Absolute timestamps and reading contexts of the stored rows, so a meter value is only stored once
+        /// like in METER_VALUES
+        std::set<std::pair<std::int64_t, int>> stored_readings;
+    };
+    std::mutex meter_value_records_mutex;
+    std::map<std::string, MeterValueRecordsPosition> meter_value_records_positions;
+
+    /// \brief In memory indexes of AUTH_LIST and AUTH_CACHE by token hash, loaded by init_sql()
+    common::AuthorizationIndex<IdTokenInfo> local_authorization_list_index;
+    common::AuthorizationIndex<AuthorizationCacheEntry> authorization_cache_index;
+
+    /// \brief Returns the estimated size of the AUTH_CACHE row of \p id_token_hash, 0 if there is none
+    std::int64_t authorization_cache_get_row_size(const std::string& id_token_hash);
+    void authorization_cache_subtract_binary_size(std::int64_t size);
+
+    /// \brief Binary size of AUTH_CACHE as measured by authorization_cache_reconcile_binary_size(), updated with the
+    /// estimated size of every row that is written or deleted afterwards
+    std::atomic<std::int64_t> authorization_cache_binary_size{0};
+    /// \brief LAST_USED (unix milliseconds) of AUTH_CACHE rows that is not written yet, by token hash
+    std::mutex authorization_cache_last_used_mutex;
+    std::map<std::string, std::int64_t> authorization_cache_last_used;
+
 public:
     DatabaseHandler(std::unique_ptr<everest::db::sqlite::ConnectionInterface> database,
                     const fs::path& sql_migration_files_path);
@@ -225,12 +288,15 @@ public:
     // Authorization cache management
     void authorization_cache_insert_entry(const std::string& id_token_hash, const IdTokenInfo& id_token_info) override;
     void authorization_cache_update_last_used(const std::string& id_token_hash) override;
+    void authorization_cache_flush_last_used() override;
     std::optional<AuthorizationCacheEntry> authorization_cache_get_entry(const std::string& id_token_hash) override;
     void authorization_cache_delete_entry(const std::string& id_token_hash) override;
     void authorization_cache_delete_nr_of_oldest_entries(size_t nr_to_remove) override;
+    void authorization_cache_delete_oldest_entries_exceeding(size_t max_binary_size) override;
     void authorization_cache_delete_expired_entries(std::optional<std::chrono::seconds> auth_cache_lifetime) override;
     void authorization_cache_clear() override;
     size_t authorization_cache_get_binary_size() override;
+    size_t authorization_cache_reconcile_binary_size() override;
 
     // Availability
     void insert_cs_availability(OperationalStatusEnum operational_status, bool replace) override;
@@ -256,6 +322,8 @@ public:
 
     // Transaction metervalues
     void transaction_metervalues_insert(const std::string& transaction_id, const MeterValue& meter_value) override;
+    void transaction_metervalues_insert_batch(const std::string& transaction_id,
+                                              const std::vector<MeterValue>& meter_values, bool compact) override;
     std::vector<MeterValue> transaction_metervalues_get_all(const std::string& transaction_id) override;
     void transaction_metervalues_clear(const std::string& transaction_id) override;
 
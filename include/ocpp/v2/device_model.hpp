@@ -92,6 +92,8 @@ using on_monitor_updated = std::function<void(const VariableMonitoringMeta& upda
                                               const Variable& variable, const VariableCharacteristics& characteristics,
                                               const VariableAttribute& attribute, const std::string& current_value)>;
 
+using on_monitor_cleared = std::function<void(std::int32_t monitor_id)>;
+
 /// \brief This class manages access to the device model representation and to the device model interface and provides
 /// functionality to support the use cases defined in the functional block Provisioning
 class DeviceModel {
@@ -102,8 +104,10 @@ private:
 
     /// \brief Listener for the internal change of a variable
     on_variable_changed variable_listener;
-    /// \brief Listener for the internal update of a monitor
+    /// \brief Listener for the internal update of a monitor, called for new and for updated monitors
     on_monitor_updated monitor_update_listener;
+    /// \brief Listener for the removal of a monitor
+    on_monitor_cleared monitor_cleared_listener;
 
     /// \brief Private helper method that does some checks with the device model representation in memory to evaluate if
     /// a value for the given parameters can be requested. If it can be requested it will be retrieved from the device
@@ -275,6 +279,12 @@ public:
     /// \return
     std::vector<ReportData> get_base_report_data(const ReportBaseEnum& report_base);
 
+    /// \brief Streams the ReportData for the specified \p report_base to the given \p callback. The data is read from
+    /// the device model storage in a single ordered pass, so the report never has to be held in memory as a whole.
+    /// \param report_base
+    /// \param callback invoked for every ReportData that is part of the requested report
+    void get_base_report_data(const ReportBaseEnum& report_base, const ReportDataCallback& callback);
+
     /// \brief Gets the ReportData for the specifed filter \p component_variables and \p
     /// component_criteria
     /// \param report_base
@@ -293,6 +303,10 @@ public:
         monitor_update_listener = std::move(listener);
     }
 
+    void register_monitor_cleared_listener(on_monitor_cleared&& listener) {
+        monitor_cleared_listener = std::move(listener);
+    }
+
     /// \brief Sets the given monitor \p requests in the device model
     /// \param request
     /// \param type The type of the set monitors. HardWiredMonitor - used for OEM specific monitors,
@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <ocpp/v2/device_model_storage_interface.hpp>
+
+namespace ocpp {
+namespace v2 {
+
+/// \brief DeviceModelStorageInterface implementation that keeps the complete device model in memory.
+///
+/// On construction the device model is loaded once from the given persistent storage (e.g. DeviceModelStorageSqlite).
+/// All reads are served from memory and never touch the persistent storage. Writes are applied to memory immediately
+/// and are written through to the persistent storage in the background, in the same order as they were applied.
+///
+/// The persistent storage stays the single source of truth after a restart: every write is applied there as its own
+/// transaction, so a crash can at most lose the writes that were not written through yet, but never leaves the
+/// persistent storage in an inconsistent state. Use \ref flush to wait until all writes are persisted.
+class DeviceModelStorageInMemory : public DeviceModelStorageInterface {
+private:
+    /// \brief A variable with everything that belongs to it.
+    struct StoredVariable {
+        std::size_t component_index;
+        Variable variable;
+        VariableCharacteristics characteristics;
+        std::optional<std::string> source;
+        /// \brief Sorted by attribute type
+        std::vector<VariableAttribute> attributes;
+        std::vector<VariableMonitoringMeta> monitors;
+    };
+
+    using PersistOperation = std::function<void(DeviceModelStorageInterface& storage)>;
+
+    std::unique_ptr<DeviceModelStorageInterface> persistent_storage;
+
+    /// \brief Protects all members below that hold the device model.
+    mutable std::mutex device_model_mutex;
+    std::vector<Component> components;
+    /// \brief Variables ordered by component, so variables of the same component are adjacent.
+    std::vector<StoredVariable> variables;
+    std::map<Component, std::map<Variable, std::size_t>> variable_index;
+    /// \brief Monitor id to the index of the variable the monitor belongs to.
+    std::unordered_map<std::int32_t, std::size_t> monitor_index;
+    std::int32_t next_monitor_id;
+
+    /// \brief Protects the members below that hold the write through state.
+    std::mutex persist_mutex;
+    std::condition_variable persist_cv;
+    std::deque<PersistOperation> persist_queue;
+    bool persisting;
+    bool stop_persisting;
+    std::thread persist_thread;
+
+    void load(DeviceModelStorageInterface& storage);
+    StoredVariable* find_variable(const Component& component_id, const Variable& variable_id);
+    void remove_monitor(std::int32_t monitor_id);
+    void persist(PersistOperation&& operation);
+    void persist_handler();
+
+public:
+    /// \brief Loads the device model from \p persistent_storage and starts writing through to it.
+    /// \param persistent_storage   Storage to load the device model from and to persist all changes to.
+    explicit DeviceModelStorageInMemory(std::unique_ptr<DeviceModelStorageInterface> persistent_storage);
+
+    /// \brief Writes all pending changes to the persistent storage before returning.
+    ~DeviceModelStorageInMemory() override;
+
+    /// \brief Blocks until all changes that were made so far are written to the persistent storage.
+    void flush();
+
+    DeviceModelMap get_device_model() final;
+
+    std::optional<VariableAttribute> get_variable_attribute(const Component& component_id, const Variable& variable_id,
+                                                            const AttributeEnum& attribute_enum) final;
+
+    std::vector<VariableAttribute> get_variable_attributes(const Component& component_id, const Variable& variable_id,
+                                                           const std::optional<AttributeEnum>& attribute_enum) final;
+
+    void for_each_report_data(const ReportDataCallback& callback) final;
+
+    SetVariableStatusEnum set_variable_attribute_value(const Component& component_id, const Variable& variable_id,
+                                                       const AttributeEnum& attribute_enum, const std::string& value,
+                                                       const std::string& source) final;
+
+    std::optional<VariableMonitoringMeta> set_monitoring_data(const SetMonitoringData& data,
+                                                              const VariableMonitorType type) final;
+
+    bool update_monitoring_reference(const std::int32_t monitor_id, const std::string& reference_value) final;
+
+    std::vector<VariableMonitoringMeta> get_monitoring_data(const std::vector<MonitoringCriterionEnum>& criteria,
+                                                            const Component& component_id,
+                                                            const Variable& variable_id) final;
+
+    ClearMonitoringStatusEnum clear_variable_monitor(int monitor_id, bool allow_protected) final;
+
+    std::int32_t clear_custom_variable_monitors() final;
+
+    void check_integrity() final;
+};
+
+} // namespace v2
+} // namespace ocpp
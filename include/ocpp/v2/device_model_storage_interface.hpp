@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <ocpp/common/support_older_cpp_versions.hpp>
@@ -39,6 +40,9 @@ struct VariableMetaData {
 using VariableMap = std::map<Variable, VariableMetaData>;
 using DeviceModelMap = std::map<Component, VariableMap>;
 
+/// \brief Callback that is invoked for every ReportData that is streamed from the device model (storage)
+using ReportDataCallback = std::function<void(ReportData&& report_data)>;
+
 class DeviceModelError : public std::exception {
 public:
     [[nodiscard]] const char* what() const noexcept override {
@@ -85,6 +89,27 @@ public:
     get_variable_attributes(const Component& component_id, const Variable& variable_id,
                             const std::optional<AttributeEnum>& attribute_enum = std::nullopt) = 0;
 
+    /// \brief Streams every Variable of the storage including its VariableCharacteristics and all of its
+    /// VariableAttribute(s). The default implementation queries the attributes of each variable of get_device_model()
+    /// separately, storages can override it to fetch the data in a single ordered pass.
+    /// \param callback invoked once for every Variable that has at least one VariableAttribute. The ReportData
+    /// contains all VariableAttribute(s) of the Variable and its VariableCharacteristics
+    virtual void for_each_report_data(const ReportDataCallback& callback) {
+        for (const auto& [component, variable_map] : this->get_device_model()) {
+            for (const auto& [variable, variable_meta_data] : variable_map) {
+                ReportData report_data;
+                report_data.component = component;
+                report_data.variable = variable;
+                report_data.variableAttribute = this->get_variable_attributes(component, variable);
+                if (report_data.variableAttribute.empty()) {
+                    continue;
+                }
+                report_data.variableCharacteristics = variable_meta_data.characteristics;
+                callback(std::move(report_data));
+            }
+        }
+    }
+
     /// \brief Sets the value of an VariableAttribute if present
     /// \param component_id
     /// \param variable_id
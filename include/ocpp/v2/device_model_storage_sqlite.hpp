@@ -60,6 +60,8 @@ public:
     std::vector<VariableAttribute> get_variable_attributes(const Component& component_id, const Variable& variable_id,
                                                            const std::optional<AttributeEnum>& attribute_enum) final;
 
+    void for_each_report_data(const ReportDataCallback& callback) final;
+
     SetVariableStatusEnum set_variable_attribute_value(const Component& component_id, const Variable& variable_id,
                                                        const AttributeEnum& attribute_enum, const std::string& value,
                                                        const std::string& source) final;
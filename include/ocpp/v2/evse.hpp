@@ -6,6 +6,8 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include <ocpp/v2/average_meter_values.hpp>
 #include <ocpp/v2/component_state_manager.hpp>
@@ -198,6 +200,21 @@ private:
     /// \param timestamp
     void start_metering_timers(const DateTime& timestamp);
 
+    /// \brief Meter values of the active transaction that are not written to the database yet
+    std::vector<MeterValue> pending_transaction_meter_values;
+    std::mutex pending_transaction_meter_values_mutex;
+
+    ///
+    /// \brief Stores \p meter_value for the active transaction. Meter values are collected until
+    /// MeterValuesPersistBatchSize meter values are pending, which are then written in one database transaction.
+    /// \param flush Write \p meter_value and all pending meter values immediately
+    ///
+    void store_transaction_meter_value(const MeterValue& meter_value, bool flush);
+
+    /// \brief Writes the pending meter values of the active transaction to the database, the caller must hold
+    /// pending_transaction_meter_values_mutex
+    void write_pending_transaction_meter_values();
+
     ///
     /// \brief Send metervalue to CSMS after a pricing trigger occured.
     /// \param meter_value  The metervalue to send.
@@ -47,6 +47,7 @@ private: // Members
 
     // threads and synchronization
     bool auth_cache_cleanup_required;
+    bool auth_cache_last_used_flush_required;
     std::condition_variable auth_cache_cleanup_cv;
     std::mutex auth_cache_cleanup_mutex;
     std::thread auth_cache_cleanup_thread;
@@ -77,6 +78,11 @@ public:
 private: // Functions
     void stop_auth_cache_cleanup_thread();
 
+    /// \brief Writes the last used timestamps of the authorization cache to the database after a delay, so the
+    /// timestamps of all tokens used in the meantime are written in one transaction
+    void trigger_authorization_cache_last_used_flush();
+    void flush_authorization_cache_last_used();
+
     // Functional Block C: Authorization
     void handle_clear_cache_req(Call<ClearCacheRequest> call);
     void cache_cleanup_handler();
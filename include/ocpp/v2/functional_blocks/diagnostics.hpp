@@ -6,6 +6,7 @@
 #include <ocpp/v2/message_handler.hpp>
 
 #include <ocpp/v2/monitoring_updater.hpp>
+#include <ocpp/v2/notify_event_coalescer.hpp>
 
 namespace ocpp::v2 {
 class AuthorizationInterface;
@@ -38,6 +39,10 @@ public:
     virtual void stop_monitoring() = 0;
     virtual void start_monitoring() = 0;
     virtual void process_triggered_monitors() = 0;
+    /// \brief Returns the counters of the NotifyEvent coalescing
+    virtual NotifyEventCoalescerStatistics get_notify_event_statistics() = 0;
+    /// \brief Returns the counters about the overhead of the monitoring
+    virtual MonitoringStatistics get_monitoring_statistics() = 0;
 };
 
 class Diagnostics : public DiagnosticsInterface {
@@ -51,11 +56,16 @@ public:
     void stop_monitoring() override;
     void start_monitoring() override;
     void process_triggered_monitors() override;
+    NotifyEventCoalescerStatistics get_notify_event_statistics() override;
+    MonitoringStatistics get_monitoring_statistics() override;
 
 private:
     // Members
     const FunctionalBlockContext& context;
     AuthorizationInterface& authorization;
+    /// \brief Collects the events of the monitoring updater and of notify_event_req into as few NotifyEvent messages
+    /// as possible. Declared before the monitoring updater, which sends its events to it
+    NotifyEventCoalescer notify_event_coalescer;
     /// \brief Updater for triggered monitors
     MonitoringUpdater monitoring_updater;
     GetLogRequestCallback get_log_request_callback;
@@ -70,6 +80,9 @@ private:
     // Functions
     /* OCPP message requests */
     void notify_customer_information_req(const std::string& data, const std::int32_t request_id);
+    /// \brief Sends \p events as NotifyEvent.req, split into a series of messages chained with tbc if they exceed the
+    /// MaxMessageSize. \returns the number of sent messages
+    std::size_t send_notify_event_req(std::vector<EventData>&& events);
     void notify_monitoring_report_req(const int request_id, std::vector<MonitoringData>& montoring_data);
 
     /* OCPP message handlers */
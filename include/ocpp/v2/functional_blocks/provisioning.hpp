@@ -111,6 +111,10 @@ private:
 
     void notify_report_req(const int request_id, const std::vector<ReportData>& report_data);
 
+    /// \brief Streams the base report \p report_base from the device model and queues it as one or multiple
+    /// NotifyReport.req while it is generated. All parts are queued at once, they are not generated on demand.
+    void notify_base_report_req(const int request_id, const ReportBaseEnum& report_base);
+
     /* OCPP message handlers */
 
     void handle_boot_notification_response(CallResult<BootNotificationResponse> call_result);
@@ -5,7 +5,17 @@
 
 #include <ocpp/v2/message_handler.hpp>
 
+#include <ocpp/common/composite_schedule_cache.hpp>
+#include <ocpp/common/effective_limit_timeline.hpp>
+#include <ocpp/common/worker_pool.hpp>
+#include <ocpp/v2/charging_profile_store.hpp>
 #include <ocpp/v2/evse.hpp>
+#include <ocpp/v2/profile.hpp>
+
+namespace ocpp::v21 {
+struct UpdateDynamicScheduleRequest;
+struct UpdateDynamicScheduleResponse;
+} // namespace ocpp::v21
 
 namespace ocpp::v2 {
 struct FunctionalBlockContext;
@@ -35,6 +45,19 @@ enum class LimitSetpointType {
     SetpointReactive
 };
 
+/// \brief The limits and setpoints an evse has to apply, taken from the current period of its composite schedule
+struct EffectiveLimit {
+    ChargingRateUnitEnum charging_rate_unit;
+    /// \brief The current period of the composite schedule, its startPeriod is always 0
+    ChargingSchedulePeriod period;
+
+    /// \brief Compares the unit and the limits, setpoints and modes of the periods. The V2X curves and custom data are
+    /// not compared since composite schedules do not contain them.
+    bool operator==(const EffectiveLimit& other) const;
+};
+
+using EffectiveLimitChangedCallback = std::function<void(std::int32_t evse_id, const EffectiveLimit& limit)>;
+
 enum class ProfileValidationResultEnum {
     Valid,
     EvseDoesNotExist,
@@ -123,6 +146,12 @@ public:
     ///
     virtual void delete_transaction_tx_profiles(const std::string& transaction_id) = 0;
 
+    ///
+    /// \brief removes the charging profile with the given \p profile_id.
+    /// \return true if a profile was removed
+    ///
+    virtual bool delete_charging_profile(std::int32_t profile_id) = 0;
+
     ///
     /// \brief validates the given \p profile according to the specification,
     /// adding it to our stored list of profiles if valid.
@@ -159,6 +188,71 @@ public:
     /// \brief Initiates a NotifyEvChargingNeeds.req message to the CSMS
     /// \param req the request to send
     virtual void notify_ev_charging_needs_req(const NotifyEVChargingNeedsRequest& req) = 0;
+
+    /// \brief Calculates the effective limits of \p evse_id again, or of all evses if it is 0, e.g. because its
+    /// transaction started or finished. Does nothing if there is no effective limit changed callback.
+    virtual void update_effective_limits(std::int32_t evse_id) = 0;
+
+    /// \brief Applies the schedule update of an UpdateDynamicSchedule.req to the Dynamic profile it is meant for
+    /// (OCPP 2.1). Only the intermediate profiles of the evse of the profile are calculated again, the station wide
+    /// effective limit sums them with the cached ones of the other evses.
+    /// \param request the UpdateDynamicSchedule.req
+    /// \return Accepted if the profile exists, is Dynamic and its updated schedule is valid
+    virtual v21::UpdateDynamicScheduleResponse
+    update_dynamic_schedule(const v21::UpdateDynamicScheduleRequest& request) = 0;
+};
+
+/// \brief Identifies a cached composite schedule: evse id, charging rate unit, duration, whether the charging station
+/// is offline and whether a transaction is simulated
+using CompositeScheduleKey = std::tuple<std::int32_t, ChargingRateUnitEnum, std::int32_t, bool, bool>;
+
+/// \brief Everything besides the time that a composite schedule is calculated from
+struct CompositeScheduleInputs {
+    std::uint64_t profile_generation;
+    /// \brief The transaction id of every evse, empty if there is no transaction
+    std::vector<std::string> transaction_ids;
+    std::vector<ChargingProfilePurposeEnum> purposes_to_ignore;
+    float current_limit;
+    float power_limit;
+    std::int32_t default_number_phases;
+    float supply_voltage;
+
+    bool operator==(const CompositeScheduleInputs& other) const;
+};
+
+/// \brief Identifies the cached intermediate profiles of an evse: evse id, whether the charging station is offline,
+/// whether a transaction is simulated, the profile generations of the evse and of the station wide profiles, the
+/// transaction id of the evse, empty if there is no transaction, and the start of its session
+using EvseIntermediateProfilesKey =
+    std::tuple<std::int32_t, bool, bool, std::uint64_t, std::uint64_t, std::string, std::optional<DateTime>>;
+
+/// \brief Everything besides the key and the time that the intermediate profiles of every evse are calculated from
+struct EvseIntermediateProfilesInputs {
+    std::vector<ChargingProfilePurposeEnum> purposes_to_ignore;
+    OcppProtocolVersion ocpp_version;
+
+    bool operator==(const EvseIntermediateProfilesInputs& other) const;
+};
+
+/// \brief Everything besides an installed profile itself that its validation depends on
+struct ProfileValidationInputs {
+    std::uint64_t profile_generation;
+    OcppProtocolVersion ocpp_version;
+    /// \brief The values of the device model variables used by the validation
+    std::vector<std::optional<std::string>> device_model_values;
+    bool evse_exists;
+    CurrentPhaseType phase_type;
+    bool dc_input_phase_control;
+    /// \brief The id of the active transaction of the evse, empty if there is none
+    std::string transaction_id;
+
+    bool operator==(const ProfileValidationInputs& other) const;
+};
+
+/// \brief The installed profiles of an evse that were valid for the given inputs, in their conformed form
+struct ValidatedProfiles {
+    ProfileValidationInputs inputs;
+    std::vector<ChargingProfile> profiles;
 };
 
 class SmartCharging : public SmartChargingInterface {
@@ -167,11 +261,26 @@ private: // Members
     std::function<void()> set_charging_profiles_callback;
     std::map<ChargingProfilePurposeEnum, DateTime> last_charging_profile_update;
     StopTransactionCallback stop_transaction_callback;
+    /// \brief All installed profiles, mutable since it is loaded from the database on first use
+    mutable ChargingProfileStore profile_store;
+    CompositeScheduleCache<CompositeScheduleKey, CompositeScheduleInputs, CompositeSchedule> composite_schedule_cache;
+    /// \brief The intermediate profiles per evse, so a change of the profiles of one evse only calculates that evse
+    /// again and the station wide schedule sums its limits with the cached ones of the other evses
+    CompositeScheduleCache<EvseIntermediateProfilesKey, EvseIntermediateProfilesInputs, EvseIntermediateProfiles>
+        evse_intermediate_profiles_cache;
+    /// \brief Threads the composite schedules of multiple evses are calculated on, started once with SmartCharging
+    WorkerPool composite_schedule_workers;
+    /// \brief The valid profiles per evse, so they are only validated again when the validation inputs change
+    std::map<std::int32_t, ValidatedProfiles> validated_profiles;
+    std::mutex validated_profiles_mutex;
+    /// \brief Only present when there is an effective limit changed callback
+    std::unique_ptr<EffectiveLimitTimeline<EffectiveLimit>> effective_limit_timeline;
 
 public:
     SmartCharging(const FunctionalBlockContext& functional_block_context,
                   std::function<void()> set_charging_profiles_callback,
-                  StopTransactionCallback stop_transaction_callback);
+                  StopTransactionCallback stop_transaction_callback,
+                  std::optional<EffectiveLimitChangedCallback> effective_limit_changed_callback = std::nullopt);
     void handle_message(const ocpp::EnhancedMessage<MessageType>& message) override;
     GetCompositeScheduleResponse get_composite_schedule(const GetCompositeScheduleRequest& request) override;
     std::optional<CompositeSchedule> get_composite_schedule(std::int32_t evse_id, std::chrono::seconds duration,
@@ -180,6 +289,7 @@ public:
                                                                const ChargingRateUnitEnum& unit) override;
 
     void delete_transaction_tx_profiles(const std::string& transaction_id) override;
+    bool delete_charging_profile(std::int32_t profile_id) override;
 
     SetChargingProfileResponse conform_validate_and_add_profile(
         ChargingProfile& profile, std::int32_t evse_id,
@@ -189,6 +299,9 @@ public:
         ChargingProfile& profile, std::int32_t evse_id,
         AddChargingProfileSource source_of_request = AddChargingProfileSource::SetChargingProfile) override;
     void notify_ev_charging_needs_req(const NotifyEVChargingNeedsRequest& req) override;
+    void update_effective_limits(std::int32_t evse_id) override;
+    v21::UpdateDynamicScheduleResponse
+    update_dynamic_schedule(const v21::UpdateDynamicScheduleRequest& request) override;
 
 protected:
     ///
@@ -198,6 +311,18 @@ protected:
                                                    const std::int32_t evse_id, ChargingRateUnitEnum charging_rate_unit,
                                                    bool is_offline, bool simulate_transaction_active);
 
+    ///
+    /// \brief Calculates the composite schedules for all \p evse_ids. The profiles that apply to all evses are only
+    /// processed once and the per evse calculations are distributed over a few threads. With
+    /// \p use_evse_intermediate_profiles_cache the intermediate profiles of the evses are taken from and added to the
+    /// evse_intermediate_profiles_cache.
+    ///
+    std::vector<CompositeSchedule>
+    calculate_composite_schedules(const ocpp::DateTime& start_time, const ocpp::DateTime& end_time,
+                                  const std::vector<std::int32_t>& evse_ids, ChargingRateUnitEnum charging_rate_unit,
+                                  bool is_offline, bool simulate_transaction_active,
+                                  bool use_evse_intermediate_profiles_cache = false);
+
     ///
     /// \brief validates the existence of the given \p evse_id according to the specification
     ///
@@ -259,6 +384,9 @@ protected:
     std::vector<ChargingProfile>
     get_valid_profiles(std::int32_t evse_id, const std::vector<ChargingProfilePurposeEnum>& purposes_to_ignore = {});
 
+    /// \brief Returns the hits and misses of the cache of the intermediate profiles per evse
+    CompositeScheduleCacheStatistics get_evse_intermediate_profiles_cache_statistics();
+
 private: // Functions
     /* OCPP message requests */
     void report_charging_profile_req(const std::int32_t request_id, const std::int32_t evse_id,
@@ -272,10 +400,48 @@ private: // Functions
     void handle_get_charging_profiles_req(Call<GetChargingProfilesRequest> call);
     void handle_get_composite_schedule_req(Call<GetCompositeScheduleRequest> call);
     void handle_notify_ev_charging_needs_response(const EnhancedMessage<MessageType>& call_result);
+    void handle_update_dynamic_schedule_req(Call<v21::UpdateDynamicScheduleRequest> call);
 
     GetCompositeScheduleResponse get_composite_schedule_internal(const GetCompositeScheduleRequest& request,
                                                                  bool simulate_transaction_active = true);
 
+    /// \brief Calculates the timelines of the effective limits of \p evse_ids for the effective_limit_timeline
+    std::vector<std::vector<EffectiveLimitTimelineEntry<EffectiveLimit>>>
+    calculate_effective_limit_timelines(const std::vector<std::int32_t>& evse_ids, std::int32_t duration);
+
+    /// \brief Returns \p requested_unit if it is supported, or the first supported unit if none is requested
+    std::optional<ChargingRateUnitEnum>
+    get_supported_charging_rate_unit(const std::optional<ChargingRateUnitEnum>& requested_unit) const;
+
+    ///
+    /// \brief Returns the composite schedules for \p evse_ids from now for \p duration seconds. The schedules are taken
+    /// from the composite_schedule_cache if none of their inputs changed since they were calculated, the others are
+    /// calculated together from the evse_intermediate_profiles_cache and the evses that changed.
+    ///
+    std::vector<CompositeSchedule> get_cached_composite_schedules(const std::vector<std::int32_t>& evse_ids,
+                                                                  std::int32_t duration,
+                                                                  ChargingRateUnitEnum charging_rate_unit,
+                                                                  bool is_offline, bool simulate_transaction_active);
+
+    ///
+    /// \brief Checks if the composite schedule for \p evse_id depends on the time it is calculated at, which is the
+    /// case for Relative profiles that do not start with a transaction and for Dynamic profiles whose schedule changes
+    /// after it started
+    ///
+    bool depends_on_calculation_time(std::int32_t evse_id);
+
+    ///
+    /// \brief Completes the inputs of the \p evses for a calculation with \p parameters. With \p use_cache, evses whose
+    /// intermediate profiles do not depend on the calculation time get them from the evse_intermediate_profiles_cache,
+    /// missing ones are calculated for twice the duration and added to it. Only the other evses get their valid
+    /// profiles, so only their intermediate profiles are calculated with the composite schedules.
+    /// \return the valid station wide profiles
+    ///
+    std::vector<ChargingProfile> complete_evse_inputs(const CompositeScheduleParameters& parameters,
+                                                      const std::vector<ChargingProfilePurposeEnum>& purposes_to_ignore,
+                                                      bool is_offline, bool use_cache,
+                                                      std::vector<EvseCompositeScheduleInput>& evses);
+
     ///
     /// \brief Checks a given \p candidate_profile and associated \p evse_id validFrom and validTo range
     /// This method assumes that the existing candidate_profile will have dates set for validFrom and validTo
@@ -285,10 +451,17 @@ private: // Functions
     std::vector<ChargingProfile> get_evse_specific_tx_default_profiles() const;
     std::vector<ChargingProfile> get_station_wide_tx_default_profiles() const;
     std::vector<ChargingProfile> get_charging_station_max_profiles() const;
+    ///
+    /// \brief Returns the installed profiles of \p evse_id that are valid, except the ones with \p purposes_to_ignore.
+    /// The profiles of an evse are only validated again when their ProfileValidationInputs changed.
+    ///
     std::vector<ChargingProfile>
     get_valid_profiles_for_evse(std::int32_t evse_id,
                                 const std::vector<ChargingProfilePurposeEnum>& purposes_to_ignore = {});
 
+    /// \brief Returns the current inputs of the validation of the profiles of \p evse_id
+    ProfileValidationInputs get_profile_validation_inputs(std::int32_t evse_id) const;
+
     CurrentPhaseType get_current_phase_type(const std::optional<EvseInterface*> evse_opt) const;
 
     ///
@@ -130,6 +130,19 @@ private:
 std::map<ComponentKey, std::vector<DeviceModelVariable>>
 get_all_component_configs(const std::filesystem::path& directory);
 
+///
+/// \brief Calculate a fingerprint of all component config files in the given directory.
+///
+/// The fingerprint covers the names and contents of the standardized and custom component config files and the device
+/// model database version, so it changes whenever a component config file is added, removed or modified.
+///
+/// \param directory    The parent directory containing the standardized and custom component config files.
+/// \return The fingerprint as hex string.
+///
+/// \throws std::filesystem::filesystem_error   If the component config path does not exist
+///
+std::string get_component_config_fingerprint(const std::filesystem::path& directory);
+
 class InitDeviceModelDb : public common::DatabaseHandlerCommon {
 private: // Members
     /// \brief Database path of the device model database.
@@ -167,6 +180,26 @@ public:
     void initialize_database(const std::map<ComponentKey, std::vector<DeviceModelVariable>>& component_configs,
                              const bool delete_db_if_exists);
 
+    ///
+    /// \brief Initialize the database schema and component config from the component config files in the given
+    ///        directory.
+    ///
+    /// A fingerprint of the component config files is stored in the database. When the database already exists and
+    /// the fingerprint did not change, the component config files are not parsed and the database is not updated.
+    ///
+    /// \param config_path          The parent directory containing the standardized and custom component config files.
+    /// \param delete_db_if_exists  Set to true to delete the database if it already exists.
+    ///
+    /// \throws InitDeviceModelDbError  - When database could not be initialized or
+    ///                                 - Foreign keys could not be turned on or
+    ///                                 - Something could not be added to, retrieved or removed from the database
+    /// \throws std::runtime_error      If something went wrong during migration
+    /// \throws MigrationException  If something went wrong during migration
+    /// \throws ConnectionException If the database could not be opened
+    /// \throws std::filesystem::filesystem_error   If the component config path does not exist
+    ///
+    void initialize_database(const std::filesystem::path& config_path, const bool delete_db_if_exists);
+
 private: // Functions
     ///
     /// \brief Initialize the database.
@@ -180,6 +213,36 @@ private: // Functions
     ///
     void execute_init_sql(const bool delete_db_if_exists);
 
+    ///
+    /// \brief Apply the component config to the database.
+    ///
+    /// Removing, inserting and updating the components and storing the fingerprint is done in a single transaction.
+    ///
+    /// \param component_configs    A map with all components, variables, characteristics and attributes.
+    /// \param fingerprint          Fingerprint of the component config files, std::nullopt if the component config was
+    ///                             not read from files.
+    ///
+    /// \throws InitDeviceModelDbError When the component config is not valid or could not be applied.
+    ///
+    void apply_component_configs(const std::map<ComponentKey, std::vector<DeviceModelVariable>>& component_configs,
+                                 const std::optional<std::string>& fingerprint);
+
+    ///
+    /// \brief Get the component config fingerprint stored in the database.
+    /// \return The fingerprint, std::nullopt if there is none.
+    ///
+    /// \throws InitDeviceModelDbError When the fingerprint could not be read from the database.
+    ///
+    std::optional<std::string> get_component_config_fingerprint_from_db();
+
+    ///
+    /// \brief Store the component config fingerprint in the database.
+    /// \param fingerprint  The fingerprint to store. When std::nullopt, the stored fingerprint is removed.
+    ///
+    /// \throws InitDeviceModelDbError When the fingerprint could not be stored.
+    ///
+    void set_component_config_fingerprint(const std::optional<std::string>& fingerprint);
+
     ///
     /// \brief Get all paths to the component configs (*.json) in the given directory.
     /// \param directory    Parent directory holding the standardized and component config's.
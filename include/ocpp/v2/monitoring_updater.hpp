@@ -3,6 +3,12 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <set>
 #include <unordered_map>
 
 #include <everest/timer.hpp>
@@ -12,6 +18,7 @@
 #include <ocpp/v2/ocpp_types.hpp>
 
 #include <ocpp/v2/device_model_storage_interface.hpp>
+#include <ocpp/v2/notify_event_coalescer.hpp>
 
 namespace ocpp::v2 {
 
@@ -50,8 +57,55 @@ struct PeriodicMetadata {
     /// \brief Next time when we require to trigger a clock aligned value. Has meaning
     /// only for periodic monitors
     std::chrono::time_point<std::chrono::system_clock> next_trigger_clock_aligned;
+
+    /// \brief Id of the currently valid entry of this monitor in the periodic monitor schedule
+    std::uint64_t schedule_id;
+};
+
+/// \brief Entry of the periodic monitor schedule. Entries of monitors that were removed or rescheduled
+/// are not removed from the schedule, but discarded when they become due
+struct PeriodicScheduleEntry {
+    std::chrono::time_point<std::chrono::steady_clock> due;
+    std::int32_t monitor_id;
+    std::uint64_t schedule_id;
+
+    bool operator>(const PeriodicScheduleEntry& other) const {
+        return due > other.due;
+    }
 };
 
+/// \brief Trigger monitors (Delta, LowerThreshold, UpperThreshold) of a variable with all values already parsed, so
+/// that a variable change only has to parse the new value once. The monitors are stored as parallel arrays and are
+/// evaluated without branching on the monitor type, which allows the compiler to vectorize the evaluation
+struct VariableMonitorEvaluation {
+    /// \brief Number of monitors of the variable (including periodic ones) the data was created from
+    std::size_t nr_of_monitors;
+    /// \brief If the variable has a numeric type, otherwise every value change triggers all monitors
+    bool is_numeric;
+    std::vector<std::int32_t> monitor_ids;
+    /// \brief 1 for UpperThreshold, -1 for LowerThreshold and 0 for Delta monitors
+    std::vector<double> threshold_factors;
+    /// \brief 1 for Delta monitors, 0 otherwise
+    std::vector<double> delta_factors;
+    /// \brief The monitor value, that is the threshold or the allowed delta
+    std::vector<double> values;
+    /// \brief Reference of Delta monitors, NaN if it is missing so that the monitor never triggers
+    std::vector<double> references;
+    /// \brief Result of the last evaluation
+    std::vector<std::uint8_t> triggered;
+};
+
+/// \brief Creates the evaluation data of the trigger monitors in \p monitors of a variable with the given
+/// \p characteristics. Monitors of other types are not part of the evaluation
+VariableMonitorEvaluation
+create_monitor_evaluation(const std::unordered_map<std::int64_t, VariableMonitoringMeta>& monitors,
+                          const VariableCharacteristics& characteristics);
+
+/// \brief Evaluates all monitors of \p evaluation for the changed value of a variable of type \p data_type and
+/// stores the results in VariableMonitorEvaluation::triggered
+void evaluate_monitors(VariableMonitorEvaluation& evaluation, DataEnum data_type, const std::string& value_previous,
+                       const std::string& value_current);
+
 /// \brief Meta data required for our internal keeping needs
 struct UpdaterMonitorMeta {
     UpdateMonitorMetaType type;
@@ -93,7 +147,23 @@ public:
     }
 };
 
-using notify_events = std::function<void(const std::vector<EventData>&)>;
+/// \brief Counters about the overhead of the monitoring. The times are only measured if enabled with
+/// 'MonitoringTimingEnabled'
+struct MonitoringStatistics {
+    /// \brief Processing runs that had monitors to process, including the runs skipped because monitoring is disabled
+    std::uint64_t processing_runs{0};
+    /// \brief Processing runs without any due or pending monitor
+    std::uint64_t idle_processing_runs{0};
+    std::chrono::nanoseconds processing_time{0};
+    std::uint64_t events_generated{0};
+    /// \brief Changes of variables with monitors
+    std::uint64_t variable_changes{0};
+    std::uint64_t monitor_evaluations{0};
+    std::chrono::nanoseconds evaluation_time{0};
+};
+
+/// \brief Called with all events of a processing run, together with the severity of the monitor that generated them
+using notify_events = std::function<void(std::vector<SeverityEventData>&& events)>;
 using is_offline = std::function<bool()>;
 
 class MonitoringUpdater {
@@ -103,7 +173,7 @@ public:
 
     /// \brief Constructs a new variable monitor updater
     /// \param device_model Currently used variable device model
-    /// \param notify_csms_events Function that can be invoked with a number of alert events
+    /// \param notify_csms_events Function that is invoked with all alert events of a processing run
     /// \param is_chargepoint_offline Function that can be invoked in order to retrieve the
     /// status of the charging station connection to the CSMS
     MonitoringUpdater(DeviceModel& device_model, notify_events notify_csms_events, is_offline is_chargepoint_offline);
@@ -120,6 +190,16 @@ public:
     /// moment, for example in the case of an internal variable modification
     void process_triggered_monitors();
 
+    /// \brief Processes the periodic monitors that are due and the triggered monitors, like it is done periodically
+    /// by the monitoring timer
+    void process_monitors();
+
+    /// \brief Enables or disables measuring the time spent processing and evaluating monitors
+    void set_timing_enabled(bool enabled);
+
+    /// \brief Returns the counters about the overhead of the monitoring
+    MonitoringStatistics get_statistics();
+
 private:
     /// \brief Callback that is registered to the 'device_model' that determines if any of
     /// the monitors are triggered for a certain variable when the internal value is used. Will
@@ -133,20 +213,37 @@ private:
                              const VariableCharacteristics& characteristics, const VariableAttribute& attribute,
                              const std::string& value_previous, const std::string& value_current);
 
-    /// \brief Callback that is registered to the 'device_model' that determines if any of
-    /// the already existing monitors were updated. It is required for some spec requirements
-    /// that must refresh monitor data in the case of a monitor update
+    /// \brief Callback that is registered to the 'device_model' that is called for every new
+    /// or updated monitor. It keeps the periodic monitor schedule up to date and is required for
+    /// some spec requirements that must refresh monitor data in the case of a monitor update
     void on_monitor_updated(const VariableMonitoringMeta& updated_monitor, const Component& component,
                             const Variable& variable, const VariableCharacteristics& characteristics,
                             const VariableAttribute& attribute, const std::string& current_value);
 
+    /// \brief Callback that is registered to the 'device_model' that is called for every
+    /// removed monitor. Removes the monitor from the periodic monitor schedule
+    void on_monitor_cleared(std::int32_t monitor_id);
+
     /// \brief Evaluates if an monitor was triggered, and if it is triggered
-    /// it adds it to our internal list
+    /// it adds it to our internal list. Must be called with the monitors_mutex locked
     void evaluate_monitor(const VariableMonitoringMeta& monitor_meta, const Component& component,
                           const Variable& variable, const VariableCharacteristics& characteristics,
                           const VariableAttribute& attribute, const std::string& value_previous,
                           const std::string& value_current);
 
+    /// \brief Updates the internal state of \p monitor_meta after it was evaluated to \p monitor_triggered. A trivial
+    /// monitor is one of a non numeric variable, which triggers on every value change
+    void apply_monitor_evaluation(const VariableMonitoringMeta& monitor_meta, const Component& component,
+                                  const Variable& variable, const VariableAttribute& attribute,
+                                  const std::string& value_previous, const std::string& value_current,
+                                  bool monitor_triggered, bool monitor_trivial);
+
+    /// \brief Returns the evaluation data of the \p monitors of \p component and \p variable, creating it if required
+    VariableMonitorEvaluation&
+    get_monitor_evaluation(const std::unordered_map<std::int64_t, VariableMonitoringMeta>& monitors,
+                           const Component& component, const Variable& variable,
+                           const VariableCharacteristics& characteristics);
+
     /// \brief Processes the periodic monitors. Since this can be somewhat of a costly
     /// operation (DB query of each triggered monitor's actual value) the processing time
     /// can be configured using the 'VariableMonitoringProcessTime' internal variable. If
@@ -158,15 +255,25 @@ private:
     /// of the offline state
     void process_monitor_meta_internal(UpdaterMonitorMeta& updater_meta_data);
 
-    /// \brief Query the database (from in-memory data for fast retrieval)
-    /// and updates our internal monitors with the new database data
-    void update_periodic_monitors_internal();
+    /// \brief Adds all periodic monitors of the device model that are not known yet to the schedule
+    void load_periodic_monitors_internal();
+
+    /// \brief Adds the periodic \p monitor_meta or refreshes it if it is already known, restarting its interval
+    void add_periodic_monitor_internal(const Component& component, const Variable& variable,
+                                       const VariableMonitoringMeta& monitor_meta);
+
+    /// \brief Adds a new entry for \p updater_meta_data to the periodic monitor schedule at the time
+    /// its next event is due, invalidating any previous entry of this monitor
+    void schedule_periodic_monitor_internal(UpdaterMonitorMeta& updater_meta_data);
 
     void get_monitoring_info(bool& out_is_offline, int& out_offline_severity, int& out_active_monitoring_level,
                              MonitoringBaseEnum& out_active_monitoring_base);
 
     bool is_monitoring_enabled();
 
+    /// \brief Returns the time passed since \p start if timing is enabled, otherwise 0
+    std::chrono::nanoseconds get_elapsed_time(std::chrono::time_point<std::chrono::steady_clock> start) const;
+
     DeviceModel& device_model;
     Everest::SteadyTimer monitors_timer;
 
@@ -176,7 +283,39 @@ private:
     notify_events notify_csms_events;
     is_offline is_chargepoint_offline;
 
+    /// \brief Protects the monitor state below. The device model listeners are called on the thread that modifies the
+    /// device model, while the monitors are processed on the timer thread
+    std::mutex monitors_mutex;
+
     std::unordered_map<std::int32_t, UpdaterMonitorMeta> updater_monitors_meta;
+
+    /// \brief Min-heap of the periodic monitors by the time their next event is due, so that a
+    /// processing tick only has to look at the monitors that are actually due
+    std::priority_queue<PeriodicScheduleEntry, std::vector<PeriodicScheduleEntry>, std::greater<PeriodicScheduleEntry>>
+        periodic_schedule;
+    std::uint64_t next_schedule_id;
+
+    /// \brief Evaluation data per component and variable. It is cleared whenever a monitor is set or cleared and
+    /// rebuilt on the next change of a variable
+    std::map<Component, std::map<Variable, VariableMonitorEvaluation>> monitor_evaluation_index;
+
+    /// \brief Monitors that have to be processed independent of the schedule, that is triggers
+    /// with a state that was not reported yet and monitors with events cached while offline
+    std::set<std::int32_t> pending_monitors;
+
+    std::atomic<bool> timing_enabled;
+
+    /// \brief Counters of the MonitoringStatistics. They are atomic so the hot paths do not need a lock, the times are
+    /// only added if timing is enabled
+    struct {
+        std::atomic<std::uint64_t> processing_runs{0};
+        std::atomic<std::uint64_t> idle_processing_runs{0};
+        std::atomic<std::int64_t> processing_time_ns{0};
+        std::atomic<std::uint64_t> events_generated{0};
+        std::atomic<std::uint64_t> variable_changes{0};
+        std::atomic<std::uint64_t> monitor_evaluations{0};
+        std::atomic<std::int64_t> evaluation_time_ns{0};
+    } statistics;
 };
 
 } // namespace ocpp::v2
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <everest/timer.hpp>
+
+#include <ocpp/v2/ocpp_types.hpp>
+
+namespace ocpp::v2 {
+
+/// \brief EventData together with the severity that is used to order the events of a batch
+struct SeverityEventData {
+    EventData event;
+    std::int32_t severity;
+};
+
+/// \brief Counters of the NotifyEventCoalescer
+struct NotifyEventCoalescerStatistics {
+    /// \brief Number of events that were sent together with other events
+    std::uint64_t events_coalesced{0};
+    /// \brief Number of NotifyEvent messages that were saved compared to sending one message per event
+    std::uint64_t messages_saved{0};
+};
+
+/// \brief Collects EventData for up to a configurable time window or number of events and sends them as one batch.
+///
+/// A batch is ordered by severity (most severe first), events of the same severity keep the order they were added in.
+/// A window of 0 sends every added group of events immediately, so only events that are added together are coalesced.
+class NotifyEventCoalescer {
+public:
+    /// \brief Sends the given batch of events and returns the number of NotifyEvent messages that were used for it
+    using SendCallback = std::function<std::size_t(std::vector<EventData>&& events)>;
+
+    /// \brief Creates a coalescer that passes the collected events to \p send_callback.
+    /// \param window       Maximum time an event is held back before it is sent, 0 to send immediately
+    /// \param max_events   Number of collected events that causes an immediate send
+    NotifyEventCoalescer(SendCallback send_callback, std::chrono::milliseconds window, std::size_t max_events);
+    NotifyEventCoalescer() = delete;
+
+    /// \brief Stops the window timer and sends the events that are still collected, so that none of them is lost
+    ~NotifyEventCoalescer();
+
+    /// \brief Adds \p events to the current batch. Sends the batch if the window is 0 or the batch is full.
+    void add(std::vector<SeverityEventData>&& events);
+
+    /// \brief Sends all collected events now
+    void flush();
+
+    NotifyEventCoalescerStatistics get_statistics();
+
+private:
+    SendCallback send_callback;
+    const std::chrono::milliseconds window;
+    const std::size_t max_events;
+
+    /// \brief Protects the batch, the timer state and the statistics
+    std::mutex batch_mutex;
+    std::vector<SeverityEventData> batch;
+    bool window_timer_running{false};
+    NotifyEventCoalescerStatistics statistics;
+
+    /// \brief Serializes the sending of batches, so that they are sent in the order they were collected
+    std::mutex send_mutex;
+
+    /// \brief Declared last so that it is destroyed first, its callback uses the members above
+    Everest::SteadyTimer window_timer;
+};
+
+} // namespace ocpp::v2
@@ -12,6 +12,10 @@ namespace ocpp {
 namespace v2 {
 
 /// \brief Utility class that is used to split NotifyReportRequest into several ones in case ReportData is too big.
+///
+/// The splitter can either split a complete NotifyReportRequest (see create_call_payloads) or consume the ReportData
+/// one by one (see add_report_data and finalize). The latter allows to emit the payloads of large reports while they
+/// are generated, so that the full report never has to be held in memory.
 class NotifyReportRequestsSplitter {
 
 private:
@@ -26,7 +30,21 @@ private:
     const size_t json_skeleton_size; // size of the json skeleton for a call json object which includes everything
                                      // except the requests' reportData and the messageId
 
+    // State of the payload that is currently assembled
+    // cppcheck-suppress unusedStructMember
+    bool payload_open{false};
+    // cppcheck-suppress unusedStructMember
+    int seq_no{0};
+    std::string message_id;
+    json report_data_json;
+    // cppcheck-suppress unusedStructMember
+    size_t report_data_size{0}; // size of the dumped report_data_json
+    // cppcheck-suppress unusedStructMember
+    size_t remaining_size{0}; // size that is available for report_data_json in the current payload
+
 public:
+    /// \brief Creates a splitter for the given \p originalRequest. The reportData of \p originalRequest is only used
+    /// by create_call_payloads, all other fields are used for every created payload.
     NotifyReportRequestsSplitter(const NotifyReportRequest& originalRequest, size_t max_size,
                                  std::function<MessageId()>&& message_id_generator_callback);
     NotifyReportRequestsSplitter() = delete;
@@ -35,18 +53,24 @@ public:
     /// \returns the json messages that serialize the resulting Call<NotifyReportRequest> objects
     std::vector<json> create_call_payloads();
 
+    /// \brief Adds the given \p report_data to the payload that is currently assembled. If \p report_data does not
+    /// fit into this payload anymore, the payload is completed (with tbc set to true) and a new one is started.
+    /// \returns the completed Call<NotifyReportRequest> payload, if any
+    std::optional<json> add_report_data(const ReportData& report_data);
+
+    /// \brief Completes the payload that is currently assembled (with tbc set to false). A report always results in
+    /// at least one payload, so this returns a payload without reportData if no data was added before.
+    /// \returns the last Call<NotifyReportRequest> payload of the report
+    json finalize();
+
 private:
     size_t create_request_template_json_and_return_skeleton_size();
 
-    // Create next call payload (with as many reportData items as possible)
-    json create_next_payload(const int& seq_no, std::vector<ocpp::v2::ReportData>::const_iterator& report_data_iterator,
-                             const std::vector<ocpp::v2::ReportData>::const_iterator& report_data_end,
-                             const std::string& message_id);
+    // Start a new call payload and reserve the space that is required for everything except the reportData
+    void open_payload();
 
-    // Create next request payload (with as many reportData items as possible) to be contained in next call payload
-    static json create_next_report_data_json(std::vector<ocpp::v2::ReportData>::const_iterator& report_data_iterator,
-                                             const std::vector<ocpp::v2::ReportData>::const_iterator& report_data_end,
-                                             const size_t& remaining_size);
+    // Complete the current call payload
+    json close_payload(const bool tbc);
 };
 
 } // namespace v2
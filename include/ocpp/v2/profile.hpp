@@ -1,7 +1,10 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright 2020 - 2024 Pionix GmbH and Contributors to EVerest
 
+#pragma once
+
 #include <ocpp/common/constants.hpp>
+#include <ocpp/common/worker_pool.hpp>
 #include <ocpp/v2/ocpp_types.hpp>
 
 namespace ocpp {
@@ -149,5 +152,54 @@ std::vector<ChargingSchedulePeriod>
 convert_intermediate_into_schedule(const IntermediateProfile& profile, ChargingRateUnitEnum charging_rate_unit,
                                    float default_limit, std::int32_t default_number_phases, float supply_voltage);
 
+/// \brief Parameters of a composite schedule calculation that are the same for all evses
+struct CompositeScheduleParameters {
+    DateTime start_time;
+    DateTime end_time;
+    ChargingRateUnitEnum charging_rate_unit;
+    bool simulate_transaction_active;
+    float current_limit;
+    float power_limit;
+    std::int32_t default_number_phases;
+    float supply_voltage;
+    OcppProtocolVersion ocpp_version;
+};
+
+/// \brief The ChargingStationExternalConstraints and the combined Tx(Default)Profiles of an evse, which do not depend
+/// on the other evses, and their lowest limits, which is what the evse contributes to the station wide schedule
+struct EvseIntermediateProfiles {
+    std::vector<IntermediateProfile> intermediates;
+    IntermediateProfile lowest_limits;
+};
+
+/// \brief The valid profiles installed on an evse and the start of its charging session
+struct EvseCompositeScheduleInput {
+    std::int32_t evse_id;
+    std::vector<ChargingProfile> profiles;
+    std::optional<DateTime> session_start;
+    /// \brief The intermediate profiles of the evse if they are already known for the parameters of the calculation,
+    /// then the \p profiles are not used
+    std::optional<EvseIntermediateProfiles> intermediate_profiles;
+};
+
+/// \brief Calculates the intermediate profiles of \p evse from its profiles and the \p station_wide_profiles
+EvseIntermediateProfiles calculate_evse_intermediate_profiles(const CompositeScheduleParameters& parameters,
+                                                              const std::vector<ChargingProfile>& station_wide_profiles,
+                                                              const EvseCompositeScheduleInput& evse);
+
+/// \brief Calculates the composite schedules for all \p evse_ids.
+/// \param parameters the parameters of the calculation
+/// \param station_wide_profiles the valid profiles installed on evse 0
+/// \param evses the inputs of every evse, an evse id of 0 requires the inputs of all evses. Only the intermediate
+/// profiles that are not given are calculated.
+/// \param evse_ids the evses to calculate the composite schedule for
+/// \param workers the threads the per evse calculations are distributed over, the results do not depend on them
+/// \return the composite schedules in the order of \p evse_ids
+std::vector<CompositeSchedule> calculate_composite_schedules(const CompositeScheduleParameters& parameters,
+                                                             const std::vector<ChargingProfile>& station_wide_profiles,
+                                                             const std::vector<EvseCompositeScheduleInput>& evses,
+                                                             const std::vector<std::int32_t>& evse_ids,
+                                                             WorkerPool& workers);
+
 } // namespace v2
 } // namespace ocpp
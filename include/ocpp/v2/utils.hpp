@@ -3,6 +3,10 @@
 #ifndef V2_UTILS_HPP
 #define V2_UTILS_HPP
 
+#include <array>
+#include <initializer_list>
+#include <string_view>
+
 #include <ocpp/v2/ocpp_types.hpp>
 #include <ocpp/v2/types.hpp>
 namespace ocpp {
@@ -49,16 +53,30 @@ std::vector<MeterValue> get_meter_values_with_measurands_applied(
 ///
 MeterValue set_meter_value_reading_context(const MeterValue& meter_value, const ReadingContextEnum reading_context);
 
+/// \brief Number of characters of a SHA256 hash encoded as lowercase hex string
+constexpr std::size_t SHA256_HEX_LENGTH = 64;
+
+/// \brief SHA256 hash encoded as lowercase hex string, without null terminator
+using Sha256Hex = std::array<char, SHA256_HEX_LENGTH>;
+
 /// \brief Returns the given \p str hashed using SHA256
 /// \param str
 /// \return
 std::string sha256(const std::string& str);
 
+/// \brief Returns the SHA256 hash of the concatenation of \p parts. The parts are hashed one after another, so they
+/// are not concatenated, and the hash is encoded into the returned array, so no memory is allocated.
+Sha256Hex sha256_hex(std::initializer_list<std::string_view> parts);
+
 /// \brief Return a SHA256 hash generated from a combination of the \p token type and id
 /// \param token the token to generate the hash for
 /// \return A SHA256 hash string
 std::string generate_token_hash(const IdToken& token);
 
+/// \brief Returns the number of characters of \p j serialized without indentation, which equals j.dump().size(). The
+/// serialized string is only counted and never allocated.
+std::size_t get_json_dump_size(const json& j);
+
 /// \brief Align the clock aligned timestamps to the interval values
 /// \param timestamp the timestamp to align
 /// \param align_interval the clock aligned interval to align to since midnight 00:00
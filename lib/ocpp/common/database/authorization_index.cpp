@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <ocpp/common/database/authorization_index.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ocpp::common {
+
+namespace {
+/// \brief Minimum number of keys of a stage of the BloomFilter
+constexpr std::size_t MIN_BLOOM_FILTER_CAPACITY = 1024;
+/// \brief False positive rate of the first stage, every following stage has half the rate of the previous one so the
+/// rate of the whole filter stays below twice this value
+constexpr double BLOOM_FILTER_FALSE_POSITIVE_RATE = 0.01;
+
+/// \brief FNV-1a hash of \p key
+std::uint64_t fnv1a_hash(std::string_view key) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (const auto c : key) {
+        hash ^= static_cast<std::uint8_t>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/// \brief Finalizer of splitmix64, used to derive a second independent hash from the first one
+std::uint64_t mix(std::uint64_t hash) {
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+} // namespace
+
+BloomFilter::BloomFilter(std::size_t expected_keys) {
+    this->clear(expected_keys);
+}
+
+BloomFilter::Stage BloomFilter::create_stage(std::size_t capacity, double false_positive_rate) {
+    const double ln2 = std::log(2.0);
+    const auto nr_of_bits = static_cast<std::uint64_t>(
+        std::ceil(-static_cast<double>(capacity) * std::log(false_positive_rate) / (ln2 * ln2)));
+    Stage stage;
+    stage.bits.resize((nr_of_bits + 63) / 64, 0);
+    stage.nr_of_bits = stage.bits.size() * 64;
+    stage.nr_of_hashes =
+        std::max<std::uint32_t>(1, static_cast<std::uint32_t>(std::round(-std::log2(false_positive_rate))));
+    stage.capacity = capacity;
+    stage.nr_of_keys = 0;
+    return stage;
+}
+
+void BloomFilter::insert(std::string_view key) {
+    if (this->stages.back().nr_of_keys >= this->stages.back().capacity) {
+        this->stages.push_back(create_stage(this->stages.back().capacity * 2, this->next_false_positive_rate));
+        this->next_false_positive_rate /= 2;
+    }
+
+    auto& stage = this->stages.back();
+    const auto hash = fnv1a_hash(key);
+    const auto step = mix(hash) | 1;
+    for (std::uint32_t i = 0; i < stage.nr_of_hashes; i++) {
+        const auto bit = (hash + i * step) % stage.nr_of_bits;
+        stage.bits[bit / 64] |= std::uint64_t{1} << (bit % 64);
+    }
+    stage.nr_of_keys++;
+}
+
+bool BloomFilter::may_contain(std::string_view key) const {
+    const auto hash = fnv1a_hash(key);
+    const auto step = mix(hash) | 1;
+    return std::any_of(this->stages.begin(), this->stages.end(), [hash, step](const Stage& stage) {
+        for (std::uint32_t i = 0; i < stage.nr_of_hashes; i++) {
+            const auto bit = (hash + i * step) % stage.nr_of_bits;
+            if ((stage.bits[bit / 64] & (std::uint64_t{1} << (bit % 64))) == 0) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+void BloomFilter::clear(std::size_t expected_keys) {
+    this->stages.clear();
+    this->stages.push_back(
+        create_stage(std::max(expected_keys, MIN_BLOOM_FILTER_CAPACITY), BLOOM_FILTER_FALSE_POSITIVE_RATE));
+    this->next_false_positive_rate = BLOOM_FILTER_FALSE_POSITIVE_RATE / 2;
+}
+
+std::size_t BloomFilter::size() const {
+    std::size_t nr_of_keys = 0;
+    for (const auto& stage : this->stages) {
+        nr_of_keys += stage.nr_of_keys;
+    }
+    return nr_of_keys;
+}
+
+} // namespace ocpp::common
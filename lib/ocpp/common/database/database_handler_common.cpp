@@ -16,10 +16,13 @@ DatabaseHandlerCommon::DatabaseHandlerCommon(std::unique_ptr<ConnectionInterface
                                              std::uint32_t target_schema_version) noexcept :
     database(std::move(database)),
     sql_migration_files_path(sql_migration_files_path),
-    target_schema_version(target_schema_version) {
+    target_schema_version(target_schema_version),
+    statement_cache(*this->database) {
 }
 
 void DatabaseHandlerCommon::open_connection() {
+    // Statements prepared for the previous schema must not outlive the migration
+    this->statement_cache.clear();
     SchemaUpdater updater{this->database.get()};
 
     if (!updater.apply_migration_files(this->sql_migration_files_path, target_schema_version)) {
@@ -34,9 +37,26 @@ void DatabaseHandlerCommon::open_connection() {
 }
 
 void DatabaseHandlerCommon::close_connection() {
+    this->statement_cache.clear();
     this->database->close_connection();
 }
 
+std::vector<std::string> DatabaseHandlerCommon::get_authorization_index_keys(const std::string& table_name,
+                                                                           const std::string& key_column) {
+    auto stmt = this->database->new_statement("SELECT " + key_column + " FROM " + table_name);
+
+    std::vector<std::string> keys;
+    int status = SQLITE_ERROR;
+    while ((status = stmt->step()) == SQLITE_ROW) {
+        keys.push_back(stmt->column_text(0));
+    }
+
+    if (status != SQLITE_DONE) {
+        throw QueryExecutionException(this->database->get_error_message());
+    }
+    return keys;
+}
+
 std::vector<DBTransactionMessage> DatabaseHandlerCommon::get_message_queue_messages(const QueueType queue_type) {
     std::vector<DBTransactionMessage> messages;
 
@@ -90,7 +110,7 @@ void DatabaseHandlerCommon::insert_message_queue_message(const DBTransactionMess
                             " (UNIQUE_ID, MESSAGE, MESSAGE_TYPE, MESSAGE_ATTEMPTS, MESSAGE_TIMESTAMP) VALUES "
                             "(@unique_id, @message, @message_type, @message_attempts, @message_timestamp)";
 
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     const std::string message = db_message.json_message.dump();
     stmt->bind_text("@unique_id", db_message.unique_id);
@@ -108,7 +128,7 @@ void DatabaseHandlerCommon::remove_message_queue_message(const std::string& uniq
     const std::string table_name = queue_type == QueueType::Normal ? "NORMAL_QUEUE" : "TRANSACTION_QUEUE";
     const std::string sql = "DELETE FROM " + table_name + " WHERE UNIQUE_ID = @unique_id";
 
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_text("@unique_id", unique_id);
 
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <ocpp/common/database/statement_cache.hpp>
+
+#include <everest/logging.hpp>
+
+using namespace everest::db::sqlite;
+
+namespace ocpp::common {
+
+CachedStatement::CachedStatement(StatementCache* cache, const std::string* sql,
+                                 std::unique_ptr<StatementInterface> statement, std::uint64_t generation) :
+    cache(cache), sql(sql), statement(std::move(statement)), generation(generation) {
+}
+
+CachedStatement::CachedStatement(CachedStatement&& other) noexcept :
+    cache(other.cache), sql(other.sql), statement(std::move(other.statement)), generation(other.generation) {
+}
+
+CachedStatement::~CachedStatement() {
+    if (this->statement == nullptr) {
+        return;
+    }
+    try {
+        this->statement->reset();
+        this->cache->release(*this->sql, std::move(this->statement), this->generation);
+    } catch (const std::exception& e) {
+        EVLOG_warning << "Could not return statement to the statement cache: " << e.what();
+    }
+}
+
+StatementCache::StatementCache(ConnectionInterface& database) : database(database) {
+}
+
+CachedStatement StatementCache::get(const std::string& sql) {
+    const std::string* key = nullptr;
+    std::uint64_t current_generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto& [entry_sql, entry] = *this->entries.try_emplace(sql).first;
+        key = &entry_sql;
+        current_generation = this->generation;
+        if (!entry.available.empty()) {
+            auto statement = std::move(entry.available.back());
+            entry.available.pop_back();
+            return CachedStatement(this, key, std::move(statement), current_generation);
+        }
+    }
+
+    // Prepared without holding the lock, the connection serializes access to the database itself
+    return CachedStatement(this, key, this->database.new_statement(sql), current_generation);
+}
+
+void StatementCache::clear() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // The keys are kept, checked out statements refer to them
+    for (auto& [sql, entry] : this->entries) {
+        entry.available.clear();
+    }
+    this->generation++;
+}
+
+std::size_t StatementCache::size() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::size_t size = 0;
+    for (const auto& [sql, entry] : this->entries) {
+        size += entry.available.size();
+    }
+    return size;
+}
+
+void StatementCache::release(const std::string& sql, std::unique_ptr<StatementInterface> statement,
+                             std::uint64_t statement_generation) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (statement_generation != this->generation) {
+        return;
+    }
+    this->entries.at(sql).available.push_back(std::move(statement));
+}
+
+} // namespace ocpp::common
@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <ocpp/common/worker_pool.hpp>
+
+namespace ocpp {
+
+WorkerPool::WorkerPool(const std::size_t nr_of_workers) {
+    for (std::size_t i = 1; i < nr_of_workers; i++) {
+        this->threads.emplace_back([this]() { this->worker_loop(); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        const std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->job_cv.notify_all();
+    for (auto& thread : this->threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::run(const std::size_t count, const Task& task) {
+    std::unique_lock<std::mutex> run_lock(this->run_mutex, std::try_to_lock);
+    if (!run_lock.owns_lock() or this->threads.empty() or count <= 1) {
+        for (std::size_t i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    Job job;
+    job.task = &task;
+    job.count = count;
+    {
+        const std::lock_guard<std::mutex> lock(this->mutex);
+        this->job = &job;
+        this->job_generation++;
+        this->nr_of_busy_threads = this->threads.size();
+    }
+    this->job_cv.notify_all();
+
+    work(job);
+
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->done_cv.wait(lock, [this]() { return this->nr_of_busy_threads == 0; });
+        this->job = nullptr;
+    }
+    if (job.exception) {
+        std::rethrow_exception(job.exception);
+    }
+}
+
+std::size_t WorkerPool::get_nr_of_workers() const {
+    return this->threads.size() + 1;
+}
+
+void WorkerPool::work(Job& job) {
+    for (auto i = job.next_index++; i < job.count; i = job.next_index++) {
+        try {
+            (*job.task)(i);
+        } catch (...) {
+            const std::lock_guard<std::mutex> lock(job.exception_mutex);
+            if (!job.exception) {
+                job.exception = std::current_exception();
+            }
+        }
+    }
+}
+
+void WorkerPool::worker_loop() {
+    std::uint64_t done_generation = 0;
+    while (true) {
+        Job* current_job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->job_cv.wait(
+                lock, [this, done_generation]() { return this->stopping or this->job_generation != done_generation; });
+            if (this->stopping) {
+                return;
+            }
+            done_generation = this->job_generation;
+            current_job = this->job;
+        }
+
+        work(*current_job);
+
+        bool last = false;
+        {
+            const std::lock_guard<std::mutex> lock(this->mutex);
+            last = --this->nr_of_busy_threads == 0;
+        }
+        if (last) {
+            this->done_cv.notify_one();
+        }
+    }
+}
+
+} // namespace ocpp
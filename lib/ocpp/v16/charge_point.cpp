@@ -309,6 +309,10 @@ void ChargePoint::register_signal_set_charging_profiles_callback(const std::func
     this->charge_point->register_signal_set_charging_profiles_callback(callback);
 }
 
+void ChargePoint::register_effective_limit_changed_callback(const EffectiveLimitChangedCallback& callback) {
+    this->charge_point->register_effective_limit_changed_callback(callback);
+}
+
 void ChargePoint::register_connection_state_changed_callback(const std::function<void(bool is_connected)>& callback) {
     this->charge_point->register_connection_state_changed_callback(callback);
 }
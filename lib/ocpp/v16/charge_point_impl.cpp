@@ -311,6 +311,7 @@ void ChargePointImpl::init_websocket() {
             not this->configuration->getIgnoredProfilePurposesOffline().empty()) {
             this->signal_set_charging_profiles_callback();
         }
+        this->smart_charging_handler->set_offline(false);
         // Reupdate ws connection options once connected so that after upgrading security profile we use the real config
         // values. Prior we would continue using only 1 connection attempt
         auto connection_options = this->get_ws_connection_options();
@@ -336,6 +337,7 @@ void ChargePointImpl::init_websocket() {
             not this->configuration->getIgnoredProfilePurposesOffline().empty()) {
             this->signal_set_charging_profiles_callback();
         }
+        this->smart_charging_handler->set_offline(true);
     });
     this->websocket->register_stopped_connecting_callback([this](const WebsocketCloseReason /*reason*/) {
         if (this->switch_security_profile_callback != nullptr) {
@@ -2355,6 +2357,8 @@ void ChargePointImpl::handleStartTransactionResponse(ocpp::CallResult<StartTrans
                                                               start_transaction_response.transactionId);
         const std::int32_t connector = transaction->get_connector();
         transaction->set_transaction_id(start_transaction_response.transactionId);
+        // TxProfiles for the transaction id apply from now on
+        this->smart_charging_handler->update_effective_limits(connector);
         auto idTag = transaction->get_id_tag();
 
         try {
@@ -2539,21 +2543,19 @@ void ChargePointImpl::handleGetCompositeScheduleRequest(ocpp::Call<GetCompositeS
         EVLOG_warning << "GetCompositeScheduleRequest: ChargingRateUnit not allowed";
         response.status = GetCompositeScheduleStatus::Rejected;
     } else {
-        const auto start_time = ocpp::DateTime(std::chrono::floor<std::chrono::seconds>(date::utc_clock::now()));
         if (call.msg.duration > this->configuration->getMaxCompositeScheduleDuration()) {
             EVLOG_warning << "GetCompositeScheduleRequest: Requested duration of " << call.msg.duration << "s"
                           << " is bigger than configured maximum value of "
                           << this->configuration->getMaxCompositeScheduleDuration() << "s";
         }
         const auto duration = std::min(this->configuration->getMaxCompositeScheduleDuration(), call.msg.duration);
-        const auto end_time = ocpp::DateTime(start_time.to_time_point() + std::chrono::seconds(duration));
 
-        const auto composite_schedule = this->smart_charging_handler->calculate_composite_schedule(
-            start_time, end_time, connector_id, call.msg.chargingRateUnit.value_or(allowed_charging_rate_units.at(0)),
-            is_offline, true);
+        const auto composite_schedule = this->smart_charging_handler->get_composite_schedule(
+            connector_id, duration, call.msg.chargingRateUnit.value_or(allowed_charging_rate_units.at(0)), is_offline,
+            true);
         response.status = GetCompositeScheduleStatus::Accepted;
         response.connectorId = connector_id;
-        response.scheduleStart = start_time;
+        response.scheduleStart = composite_schedule.startSchedule;
         response.chargingSchedule = composite_schedule;
     }
 
@@ -3155,7 +3157,7 @@ void ChargePointImpl::handleSendLocalListRequest(ocpp::Call<SendLocalListRequest
             response.status = UpdateStatus::NotSupported;
         } else if (call.msg.updateType == UpdateType::Full) {
             if (call.msg.localAuthorizationList) {
-                auto local_auth_list = call.msg.localAuthorizationList.value();
+                const auto& local_auth_list = call.msg.localAuthorizationList.value();
                 this->database_handler->clear_local_authorization_list();
                 this->database_handler->insert_or_update_local_list_version(call.msg.listVersion);
                 this->database_handler->insert_or_update_local_authorization_list(local_auth_list);
@@ -3166,7 +3168,7 @@ void ChargePointImpl::handleSendLocalListRequest(ocpp::Call<SendLocalListRequest
             response.status = UpdateStatus::Accepted;
         } else if (call.msg.updateType == UpdateType::Differential) {
             if (call.msg.localAuthorizationList) {
-                auto local_auth_list = call.msg.localAuthorizationList.value();
+                const auto& local_auth_list = call.msg.localAuthorizationList.value();
                 try {
                     if (this->database_handler->get_local_list_version() < call.msg.listVersion) {
                         this->database_handler->insert_or_update_local_list_version(call.msg.listVersion);
@@ -3614,24 +3616,11 @@ std::map<std::int32_t, ChargingSchedule>
 ChargePointImpl::get_all_composite_charging_schedules(const std::int32_t duration_s, const ChargingRateUnit unit) {
 
     std::map<std::int32_t, ChargingSchedule> charging_schedules;
-    std::set<ChargingProfilePurposeType> purposes_to_ignore;
     const auto is_offline = this->websocket == nullptr or not this->websocket->is_connected();
 
-    if (not is_offline) {
-        const auto purposes_to_ignore_vec = this->configuration->getIgnoredProfilePurposesOffline();
-        purposes_to_ignore.insert(purposes_to_ignore_vec.begin(), purposes_to_ignore_vec.end());
-    }
-
     for (int connector_id = 0; connector_id <= this->configuration->getNumberOfConnectors(); connector_id++) {
-        const auto start_time = ocpp::DateTime();
-        const auto duration = std::chrono::seconds(duration_s);
-        const auto end_time = ocpp::DateTime(start_time.to_time_point() + duration);
-
-        const auto valid_profiles =
-            this->smart_charging_handler->get_valid_profiles(start_time, end_time, connector_id, purposes_to_ignore);
-        const auto composite_schedule = this->smart_charging_handler->calculate_composite_schedule(
-            start_time, end_time, connector_id, unit, is_offline, true);
-        charging_schedules[connector_id] = composite_schedule;
+        charging_schedules[connector_id] =
+            this->smart_charging_handler->get_composite_schedule(connector_id, duration_s, unit, is_offline, true);
     }
 
     return charging_schedules;
@@ -3642,22 +3631,11 @@ ChargePointImpl::get_all_enhanced_composite_charging_schedules(const std::int32_
                                                                const ChargingRateUnit unit) {
 
     std::map<std::int32_t, EnhancedChargingSchedule> charging_schedules;
-    std::set<ChargingProfilePurposeType> purposes_to_ignore;
-
-    if (this->websocket == nullptr or not this->websocket->is_connected()) {
-        const auto purposes_to_ignore_vec = this->configuration->getIgnoredProfilePurposesOffline();
-        purposes_to_ignore.insert(purposes_to_ignore_vec.begin(), purposes_to_ignore_vec.end());
-    }
+    const auto is_offline = this->connection_state != ChargePointConnectionState::Booted;
 
     for (int connector_id = 0; connector_id <= this->configuration->getNumberOfConnectors(); connector_id++) {
-        const auto start_time = ocpp::DateTime();
-        const auto duration = std::chrono::seconds(duration_s);
-        const auto end_time = ocpp::DateTime(start_time.to_time_point() + duration);
-
-        const auto composite_schedule = this->smart_charging_handler->calculate_enhanced_composite_schedule(
-            start_time, end_time, connector_id, unit, (this->connection_state != ChargePointConnectionState::Booted),
-            true);
-        charging_schedules[connector_id] = composite_schedule;
+        charging_schedules[connector_id] = this->smart_charging_handler->get_enhanced_composite_schedule(
+            connector_id, duration_s, unit, is_offline, true);
     }
 
     return charging_schedules;
@@ -4316,6 +4294,7 @@ void ChargePointImpl::start_transaction(std::shared_ptr<Transaction> transaction
 
     this->transaction_handler->add_transaction(transaction);
     this->connectors.at(req.connectorId)->transaction = transaction;
+    this->smart_charging_handler->update_effective_limits(req.connectorId);
 
     ocpp::Call<StartTransactionRequest> call(req, message_id);
 
@@ -4454,6 +4433,10 @@ void ChargePointImpl::on_transaction_stopped(const std::int32_t connector, const
     if (profile_cleared and this->signal_set_charging_profiles_callback != nullptr) {
         this->signal_set_charging_profiles_callback();
     }
+    if (!profile_cleared) {
+        // Otherwise the limits were already updated when the TxProfiles were cleared
+        this->smart_charging_handler->update_effective_limits(connector);
+    }
     reset_pricing_triggers(connector);
 }
 
@@ -4782,6 +4765,11 @@ void ChargePointImpl::register_signal_set_charging_profiles_callback(const std::
     this->signal_set_charging_profiles_callback = callback;
 }
 
+void ChargePointImpl::register_effective_limit_changed_callback(const EffectiveLimitChangedCallback& callback) {
+    this->smart_charging_handler->set_offline(this->websocket == nullptr or not this->websocket->is_connected());
+    this->smart_charging_handler->register_effective_limit_changed_callback(callback);
+}
+
 void ChargePointImpl::register_upload_diagnostics_callback(
     const std::function<GetLogResponse(const GetDiagnosticsRequest& request)>& callback) {
     this->upload_diagnostics_callback = callback;
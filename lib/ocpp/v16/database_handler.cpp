@@ -27,13 +27,16 @@ void DatabaseHandler::init_sql() {
     } catch (const QueryExecutionException& e) {
         EVLOG_warning << "Could not insert or ignore version into AUTH_LIST_VERSION table: " << e.what();
     }
+
+    this->local_authorization_list_index.load(this->get_authorization_index_keys("AUTH_LIST", "ID_TAG"));
+    this->authorization_cache_index.load(this->get_authorization_index_keys("AUTH_CACHE", "ID_TAG"));
 }
 
 void DatabaseHandler::init_connector_table() {
     for (std::int32_t connector = 0; connector <= this->number_of_connectors; connector++) {
         const std::string sql =
             "INSERT OR IGNORE INTO CONNECTORS (ID, AVAILABILITY) VALUES (@connector, @availability_type)";
-        auto stmt = this->database->new_statement(sql);
+        auto stmt = this->statement_cache.get(sql);
 
         stmt->bind_int("@connector", connector);
         stmt->bind_text("@availability_type", "Operative", SQLiteString::Transient);
@@ -56,7 +59,7 @@ void DatabaseHandler::insert_transaction(const std::string& session_id, const st
         "CSMS_ACK, METER_LAST, METER_LAST_TIME, LAST_UPDATE, RESERVATION_ID, START_TRANSACTION_MESSAGE_ID) VALUES "
         "(@session_id, @transaction_id, @connector, @id_tag_start, @time_start, @meter_start, @csms_ack, "
         "@meter_last, @meter_last_time, @last_update, @reservation_id, @start_transaction_message_id)";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_text("@session_id", session_id);
     stmt->bind_int("@transaction_id", transaction_id);
@@ -86,12 +89,14 @@ void DatabaseHandler::update_transaction(const std::string& session_id, std::int
 
     const std::string sql = "UPDATE TRANSACTIONS SET TRANSACTION_ID=@transaction_id, PARENT_ID_TAG=@parent_id_tag, "
                             "LAST_UPDATE=@last_update WHERE ID==@session_id";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     // bindings
     stmt->bind_int("@transaction_id", transaction_id);
     if (parent_id_tag.has_value()) {
         stmt->bind_text("@parent_id_tag", parent_id_tag.value().get(), SQLiteString::Transient);
+    } else {
+        stmt->bind_null("@parent_id_tag");
     }
     stmt->bind_text("@last_update", ocpp::DateTime().to_rfc3339(), SQLiteString::Transient);
     stmt->bind_text("@session_id", session_id);
@@ -108,16 +113,20 @@ void DatabaseHandler::update_transaction(const std::string& session_id, std::int
     const std::string sql = "UPDATE TRANSACTIONS SET METER_STOP=@meter_stop, TIME_END=@time_end, "
                             "ID_TAG_END=@id_tag_end, STOP_REASON=@stop_reason, LAST_UPDATE=@last_update, "
                             "STOP_TRANSACTION_MESSAGE_ID=@stop_transaction_message_id WHERE ID==@session_id";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_int("@meter_stop", meter_stop);
     stmt->bind_text("@time_end", time_end);
     if (id_tag_end.has_value()) {
         stmt->bind_text("@id_tag_end", id_tag_end.value().get(), SQLiteString::Transient);
+    } else {
+        stmt->bind_null("@id_tag_end");
     }
     if (stop_reason.has_value()) {
         stmt->bind_text("@stop_reason", v16::conversions::reason_to_string(stop_reason.value()),
                         SQLiteString::Transient);
+    } else {
+        stmt->bind_null("@stop_reason");
     }
     stmt->bind_text("@last_update", ocpp::DateTime().to_rfc3339(), SQLiteString::Transient);
     stmt->bind_text("@session_id", session_id);
@@ -131,7 +140,7 @@ void DatabaseHandler::update_transaction(const std::string& session_id, std::int
 void DatabaseHandler::update_transaction_csms_ack(const std::int32_t transaction_id) {
     const std::string sql =
         "UPDATE TRANSACTIONS SET CSMS_ACK=1, LAST_UPDATE=@last_update WHERE TRANSACTION_ID==@transaction_id";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_text("@last_update", ocpp::DateTime().to_rfc3339(), SQLiteString::Transient);
     stmt->bind_int("@transaction_id", transaction_id);
@@ -145,7 +154,7 @@ void DatabaseHandler::update_start_transaction_message_id(const std::string& /*s
                                                           const std::string& start_transaction_message_id) {
     const std::string sql = "UPDATE TRANSACTIONS SET START_TRANSACTION_MESSAGE_ID=@start_transaction_message_id, "
                             "LAST_UPDATE=@last_update WHERE ID==@session_id";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_text("@last_update", ocpp::DateTime().to_rfc3339(), SQLiteString::Transient);
     stmt->bind_text("@start_transaction_message_id", start_transaction_message_id);
@@ -159,7 +168,7 @@ void DatabaseHandler::update_transaction_meter_value(const std::string& session_
                                                      const std::string& last_meter_time) {
     const std::string sql = "UPDATE TRANSACTIONS SET METER_LAST=@meter_last, METER_LAST_TIME=@meter_last_time, "
                             "LAST_UPDATE=@last_update WHERE ID==@session_id";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_int("@meter_last", value);
     stmt->bind_text("@meter_last_time", last_meter_time);
@@ -180,7 +189,7 @@ std::vector<TransactionEntry> DatabaseHandler::get_transactions(bool filter_inco
         sql += " WHERE CSMS_ACK==0";
     }
 
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     int status = SQLITE_ERROR;
     while ((status = stmt->step()) == SQLITE_ROW) {
@@ -237,28 +246,45 @@ void DatabaseHandler::insert_or_update_authorization_cache_entry(const CiString<
     const std::string sql =
         "INSERT OR REPLACE INTO AUTH_CACHE (ID_TAG, AUTH_STATUS, EXPIRY_DATE, PARENT_ID_TAG) VALUES "
         "(@id_tag, @auth_status, @expiry_date, @parent_id_tag)";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_text("@id_tag", id_tag.get(), SQLiteString::Transient);
     stmt->bind_text("@auth_status", v16::conversions::authorization_status_to_string(id_tag_info.status),
                     SQLiteString::Transient);
     if (id_tag_info.expiryDate.has_value()) {
         stmt->bind_text("@expiry_date", id_tag_info.expiryDate.value().to_rfc3339(), SQLiteString::Transient);
+    } else {
+        stmt->bind_null("@expiry_date");
     }
     if (id_tag_info.parentIdTag.has_value()) {
         stmt->bind_text("@parent_id_tag", id_tag_info.parentIdTag.value().get(), SQLiteString::Transient);
+    } else {
+        stmt->bind_null("@parent_id_tag");
     }
 
-    if (stmt->step() != SQLITE_DONE) {
+    this->authorization_cache_index.insert_key(id_tag.get());
+    const auto status = stmt->step();
+    this->authorization_cache_index.erase_value(id_tag.get());
+    if (status != SQLITE_DONE) {
         throw QueryExecutionException(this->database->get_error_message());
     }
 }
 
-std::optional<v16::IdTagInfo> DatabaseHandler::get_authorization_cache_entry(const CiString<20>& id_tag) {
+std::optional<v16::IdTagInfo> DatabaseHandler::get_id_tag_info(AuthorizationIndex<v16::IdTagInfo>& index,
+                                                               const std::string& table_name,
+                                                               const CiString<20>& id_tag) {
+    // Unknown id tags are answered by the index without a query
+    if (!index.may_contain(id_tag.get())) {
+        return std::nullopt;
+    }
+    if (auto id_tag_info = index.find(id_tag.get())) {
+        return id_tag_info;
+    }
 
+    const auto generation = index.get_generation();
     const std::string sql =
-        "SELECT ID_TAG, AUTH_STATUS, EXPIRY_DATE, PARENT_ID_TAG FROM AUTH_CACHE WHERE ID_TAG = @id_tag";
-    auto stmt = this->database->new_statement(sql);
+        "SELECT ID_TAG, AUTH_STATUS, EXPIRY_DATE, PARENT_ID_TAG FROM " + table_name + " WHERE ID_TAG = @id_tag";
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_text("@id_tag", id_tag.get(), SQLiteString::Transient);
 
@@ -269,47 +295,56 @@ std::optional<v16::IdTagInfo> DatabaseHandler::get_authorization_cache_entry(con
         return std::nullopt;
     }
 
-    if (status == SQLITE_ROW) {
-        v16::IdTagInfo id_tag_info;
-        id_tag_info.status = v16::conversions::string_to_authorization_status(stmt->column_text(1));
+    if (status != SQLITE_ROW) {
+        throw QueryExecutionException(this->database->get_error_message());
+    }
 
-        if (stmt->column_type(2) != SQLITE_NULL) {
-            id_tag_info.expiryDate.emplace(stmt->column_text(2));
-        }
+    v16::IdTagInfo id_tag_info;
+    id_tag_info.status = v16::conversions::string_to_authorization_status(stmt->column_text(1));
 
-        if (stmt->column_type(3) != SQLITE_NULL) {
-            id_tag_info.parentIdTag.emplace(stmt->column_text(3));
-        }
+    if (stmt->column_type(2) != SQLITE_NULL) {
+        id_tag_info.expiryDate.emplace(stmt->column_text(2));
+    }
 
-        // check if expiry date is set and the entry should be set to Expired
-        if (id_tag_info.status != v16::AuthorizationStatus::Expired) {
-            if (id_tag_info.expiryDate) {
-                auto now = DateTime();
-                if (id_tag_info.expiryDate.value() <= now) {
-                    EVLOG_debug << "IdTag " << id_tag
-                                << " in auth cache has expiry date in the past, setting entry to expired.";
-                    id_tag_info.status = v16::AuthorizationStatus::Expired;
-                    this->insert_or_update_authorization_cache_entry(id_tag, id_tag_info);
-                }
+    if (stmt->column_type(3) != SQLITE_NULL) {
+        id_tag_info.parentIdTag.emplace(stmt->column_text(3));
+    }
+
+    index.cache_value(id_tag.get(), id_tag_info, generation);
+    return id_tag_info;
+}
+
+std::optional<v16::IdTagInfo> DatabaseHandler::get_authorization_cache_entry(const CiString<20>& id_tag) {
+    auto id_tag_info = this->get_id_tag_info(this->authorization_cache_index, "AUTH_CACHE", id_tag);
+
+    // check if expiry date is set and the entry should be set to Expired
+    if (id_tag_info.has_value() and id_tag_info->status != v16::AuthorizationStatus::Expired) {
+        if (id_tag_info->expiryDate) {
+            auto now = DateTime();
+            if (id_tag_info->expiryDate.value() <= now) {
+                EVLOG_debug << "IdTag " << id_tag
+                            << " in auth cache has expiry date in the past, setting entry to expired.";
+                id_tag_info->status = v16::AuthorizationStatus::Expired;
+                this->insert_or_update_authorization_cache_entry(id_tag, id_tag_info.value());
             }
         }
-        return id_tag_info;
     }
-
-    throw QueryExecutionException(this->database->get_error_message());
+    return id_tag_info;
 }
 
 void DatabaseHandler::clear_authorization_cache() {
     const auto retval = this->database->clear_table("AUTH_CACHE");
     if (retval == false) {
+        this->authorization_cache_index.clear_values();
         throw QueryExecutionException(this->database->get_error_message());
     }
+    this->authorization_cache_index.clear();
 }
 
 void DatabaseHandler::insert_or_update_connector_availability(std::int32_t connector,
                                                               const v16::AvailabilityType& availability_type) {
     const std::string sql = "INSERT OR REPLACE INTO CONNECTORS (ID, AVAILABILITY) VALUES (@id, @availability)";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_int("@id", connector);
     stmt->bind_text("@availability", v16::conversions::availability_type_to_string(availability_type),
@@ -331,7 +366,7 @@ void DatabaseHandler::insert_or_update_connector_availability(const std::vector<
 
 v16::AvailabilityType DatabaseHandler::get_connector_availability(std::int32_t connector) {
     const std::string sql = "SELECT AVAILABILITY FROM CONNECTORS WHERE ID = @connector";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_int("@connector", connector);
 
@@ -352,7 +387,7 @@ v16::AvailabilityType DatabaseHandler::get_connector_availability(std::int32_t c
 std::map<std::int32_t, v16::AvailabilityType> DatabaseHandler::get_connector_availability() {
     std::map<std::int32_t, v16::AvailabilityType> availability_map;
     const std::string sql = "SELECT ID, AVAILABILITY FROM CONNECTORS";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     int status = SQLITE_ERROR;
     while ((status = stmt->step()) == SQLITE_ROW) {
@@ -369,7 +404,7 @@ std::map<std::int32_t, v16::AvailabilityType> DatabaseHandler::get_connector_ava
 
 void DatabaseHandler::insert_or_ignore_local_list_version(std::int32_t version) {
     const std::string sql = "INSERT OR IGNORE INTO AUTH_LIST_VERSION (ID, VERSION) VALUES (0, @version)";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_int("@version", version);
     if (stmt->step() != SQLITE_DONE) {
@@ -380,7 +415,7 @@ void DatabaseHandler::insert_or_ignore_local_list_version(std::int32_t version)
 // local auth list management
 void DatabaseHandler::insert_or_update_local_list_version(std::int32_t version) {
     const std::string sql = "INSERT OR REPLACE INTO AUTH_LIST_VERSION (ID, VERSION) VALUES (0, @version)";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_int("@version", version);
     if (stmt->step() != SQLITE_DONE) {
@@ -390,7 +425,7 @@ void DatabaseHandler::insert_or_update_local_list_version(std::int32_t version)
 
 std::int32_t DatabaseHandler::get_local_list_version() {
     const std::string sql = "SELECT VERSION FROM AUTH_LIST_VERSION WHERE ID = 0";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     const int status = stmt->step();
     if (status == SQLITE_DONE) {
@@ -409,26 +444,35 @@ void DatabaseHandler::insert_or_update_local_authorization_list_entry(const CiSt
     // add or replace
     const std::string sql = "INSERT OR REPLACE INTO AUTH_LIST (ID_TAG, AUTH_STATUS, EXPIRY_DATE, PARENT_ID_TAG) VALUES "
                             "(@id_tag, @auth_status, @expiry_date, @parent_id_tag)";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_text("@id_tag", id_tag.get(), SQLiteString::Transient);
     stmt->bind_text("@auth_status", v16::conversions::authorization_status_to_string(id_tag_info.status),
                     SQLiteString::Transient);
     if (id_tag_info.expiryDate.has_value()) {
         stmt->bind_text("@expiry_date", id_tag_info.expiryDate.value().to_rfc3339(), SQLiteString::Transient);
+    } else {
+        stmt->bind_null("@expiry_date");
     }
     if (id_tag_info.parentIdTag.has_value()) {
         stmt->bind_text("@parent_id_tag", id_tag_info.parentIdTag.value().get(), SQLiteString::Transient);
+    } else {
+        stmt->bind_null("@parent_id_tag");
     }
 
-    if (stmt->step() != SQLITE_DONE) {
+    this->local_authorization_list_index.insert_key(id_tag.get());
+    const auto status = stmt->step();
+    this->local_authorization_list_index.erase_value(id_tag.get());
+    if (status != SQLITE_DONE) {
         EVLOG_error << "Could not insert or update local authorization list entry into the database";
         throw QueryExecutionException(this->database->get_error_message());
     }
 }
 
 void DatabaseHandler::insert_or_update_local_authorization_list(
-    std::vector<v16::LocalAuthorizationList> local_authorization_list) {
+    const std::vector<v16::LocalAuthorizationList>& local_authorization_list) {
+    // All entries are written in one database transaction, so the list is committed (and synced) only once
+    auto transaction = this->database->begin_transaction();
     bool success = true; // indicates if all database operations succeeded
     for (const auto& authorization_data : local_authorization_list) {
         try {
@@ -443,6 +487,7 @@ void DatabaseHandler::insert_or_update_local_authorization_list(
             success = false;
         }
     }
+    transaction->commit();
 
     if (!success) {
         throw QueryExecutionException("At least one insertion or deletion of local authorization list entries failed");
@@ -451,69 +496,46 @@ void DatabaseHandler::insert_or_update_local_authorization_list(
 
 void DatabaseHandler::delete_local_authorization_list_entry(const std::string& id_tag) {
     const std::string sql = "DELETE FROM AUTH_LIST WHERE ID_TAG = @id_tag;";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_text("@id_tag", id_tag);
-    if (stmt->step() != SQLITE_DONE) {
+    const auto status = stmt->step();
+    this->local_authorization_list_index.erase_value(id_tag);
+    if (status != SQLITE_DONE) {
         throw QueryExecutionException(this->database->get_error_message());
     }
 }
 
 std::optional<v16::IdTagInfo> DatabaseHandler::get_local_authorization_list_entry(const CiString<20>& id_tag) {
-    const std::string sql =
-        "SELECT ID_TAG, AUTH_STATUS, EXPIRY_DATE, PARENT_ID_TAG FROM AUTH_LIST WHERE ID_TAG = @id_tag";
-    auto stmt = this->database->new_statement(sql);
-
-    stmt->bind_text("@id_tag", id_tag.get(), SQLiteString::Transient);
-
-    const int status = stmt->step();
-
-    // entry was not found
-    if (status == SQLITE_DONE) {
-        return std::nullopt;
-    }
-
-    // entry was found
-    if (status == SQLITE_ROW) {
-        v16::IdTagInfo id_tag_info;
-        id_tag_info.status = v16::conversions::string_to_authorization_status(stmt->column_text(1));
-
-        if (stmt->column_type(2) != SQLITE_NULL) {
-            id_tag_info.expiryDate.emplace(stmt->column_text(2));
-        }
-
-        if (stmt->column_type(3) != SQLITE_NULL) {
-            id_tag_info.parentIdTag.emplace(stmt->column_text(3));
-        }
-
-        // check if expiry date is set and the entry should be set to Expired
-        if (id_tag_info.status != v16::AuthorizationStatus::Expired) {
-            if (id_tag_info.expiryDate) {
-                auto now = DateTime();
-                if (id_tag_info.expiryDate.value() <= now) {
-                    EVLOG_debug << "IdTag " << id_tag
-                                << " in auth list has expiry date in the past, setting entry to expired.";
-                    id_tag_info.status = v16::AuthorizationStatus::Expired;
-                    this->insert_or_update_local_authorization_list_entry(id_tag, id_tag_info);
-                }
+    auto id_tag_info = this->get_id_tag_info(this->local_authorization_list_index, "AUTH_LIST", id_tag);
+
+    // check if expiry date is set and the entry should be set to Expired
+    if (id_tag_info.has_value() and id_tag_info->status != v16::AuthorizationStatus::Expired) {
+        if (id_tag_info->expiryDate) {
+            auto now = DateTime();
+            if (id_tag_info->expiryDate.value() <= now) {
+                EVLOG_debug << "IdTag " << id_tag
+                            << " in auth list has expiry date in the past, setting entry to expired.";
+                id_tag_info->status = v16::AuthorizationStatus::Expired;
+                this->insert_or_update_local_authorization_list_entry(id_tag, id_tag_info.value());
             }
         }
-        return id_tag_info;
     }
-
-    throw QueryExecutionException(this->database->get_error_message());
+    return id_tag_info;
 }
 
 void DatabaseHandler::clear_local_authorization_list() {
     const auto retval = this->database->clear_table("AUTH_LIST");
     if (retval == false) {
+        this->local_authorization_list_index.clear_values();
         throw QueryExecutionException(this->database->get_error_message());
     }
+    this->local_authorization_list_index.clear();
 }
 
 std::int32_t DatabaseHandler::get_local_authorization_list_number_of_entries() {
     const std::string sql = "SELECT COUNT(*) FROM AUTH_LIST;";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     if (stmt->step() != SQLITE_ROW) {
         throw QueryExecutionException(this->database->get_error_message());
@@ -534,37 +556,37 @@ void DatabaseHandler::insert_or_update_charging_profile(const int connector_id,
     std::string sql = "DELETE FROM CHARGING_PROFILES WHERE "
                       "Json_extract(PROFILE, '$.stackLevel') = @level AND "
                       "Json_extract(PROFILE, '$.chargingProfilePurpose') = @purpose";
-    auto stmt = this->database->new_statement(sql);
+    auto delete_stmt = this->statement_cache.get(sql);
 
     const std::string purpose =
         ocpp::v16::conversions::charging_profile_purpose_type_to_string(profile.chargingProfilePurpose);
 
-    stmt->bind_int("@level", profile.stackLevel);
-    stmt->bind_text("@purpose", purpose, SQLiteString::Transient);
+    delete_stmt->bind_int("@level", profile.stackLevel);
+    delete_stmt->bind_text("@purpose", purpose, SQLiteString::Transient);
 
-    if (stmt->step() != SQLITE_DONE) {
+    if (delete_stmt->step() != SQLITE_DONE) {
         throw QueryExecutionException(this->database->get_error_message());
     }
 
     // add or replace
     sql = "INSERT OR REPLACE INTO CHARGING_PROFILES (ID, CONNECTOR_ID, PROFILE) VALUES "
           "(@id, @connector_id, @profile)";
-    stmt = this->database->new_statement(sql);
+    auto insert_stmt = this->statement_cache.get(sql);
 
     const json json_profile(profile);
 
-    stmt->bind_int("@id", profile.chargingProfileId);
-    stmt->bind_int("@connector_id", connector_id);
-    stmt->bind_text("@profile", json_profile.dump(), SQLiteString::Transient);
+    insert_stmt->bind_int("@id", profile.chargingProfileId);
+    insert_stmt->bind_int("@connector_id", connector_id);
+    insert_stmt->bind_text("@profile", json_profile.dump(), SQLiteString::Transient);
 
-    if (stmt->step() != SQLITE_DONE) {
+    if (insert_stmt->step() != SQLITE_DONE) {
         throw QueryExecutionException(this->database->get_error_message());
     }
 }
 
 void DatabaseHandler::delete_charging_profile(const int profile_id) {
     const std::string sql = "DELETE FROM CHARGING_PROFILES WHERE ID = @id;";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_int("@id", profile_id);
     if (stmt->step() != SQLITE_DONE) {
@@ -583,7 +605,7 @@ std::vector<v16::ChargingProfile> DatabaseHandler::get_charging_profiles() {
 
     std::vector<v16::ChargingProfile> profiles;
     const std::string sql = "SELECT * FROM CHARGING_PROFILES";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     int status = SQLITE_ERROR;
     while ((status = stmt->step()) == SQLITE_ROW) {
@@ -599,7 +621,7 @@ std::vector<v16::ChargingProfile> DatabaseHandler::get_charging_profiles() {
 
 int DatabaseHandler::get_connector_id(const int profile_id) {
     const std::string sql = "SELECT CONNECTOR_ID FROM CHARGING_PROFILES WHERE ID = @profile_id";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_int("@profile_id", profile_id);
 
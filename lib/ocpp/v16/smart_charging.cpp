@@ -66,6 +66,45 @@ void clear_expired_profiles(const date::utc_clock::time_point& now, ocpp::v16::D
 namespace ocpp {
 namespace v16 {
 
+namespace {
+/// \brief Returns the part of the cached composite \p schedule that starts \p offset seconds after \p schedule_start
+/// and lasts \p duration seconds
+EnhancedChargingSchedule slice_composite_schedule(const EnhancedChargingSchedule& schedule,
+                                                  const ocpp::DateTime& schedule_start, const std::int32_t offset,
+                                                  const std::int32_t duration) {
+    EnhancedChargingSchedule result{};
+    result.chargingRateUnit = schedule.chargingRateUnit;
+    result.chargingSchedulePeriod = slice_schedule_periods(schedule.chargingSchedulePeriod, offset, duration);
+    result.duration = duration;
+    result.startSchedule = ocpp::DateTime(schedule_start.to_time_point() + seconds(offset));
+    result.minChargingRate = schedule.minChargingRate;
+    return result;
+}
+
+ChargingSchedule to_charging_schedule(const EnhancedChargingSchedule& enhanced_composite_schedule) {
+    ChargingSchedule composite_schedule;
+    composite_schedule.chargingRateUnit = enhanced_composite_schedule.chargingRateUnit;
+    composite_schedule.duration = enhanced_composite_schedule.duration;
+    composite_schedule.startSchedule = enhanced_composite_schedule.startSchedule;
+    composite_schedule.minChargingRate = enhanced_composite_schedule.minChargingRate;
+    for (const auto enhanced_period : enhanced_composite_schedule.chargingSchedulePeriod) {
+        ChargingSchedulePeriod period;
+        period.startPeriod = enhanced_period.startPeriod;
+        period.limit = enhanced_period.limit;
+        period.numberPhases = enhanced_period.numberPhases;
+        composite_schedule.chargingSchedulePeriod.push_back(period);
+    }
+    return composite_schedule;
+}
+} // namespace
+
+bool CompositeScheduleInputs::operator==(const CompositeScheduleInputs& other) const {
+    return std::tie(this->profiles_generation, this->transactions, this->purposes_to_ignore, this->current_limit,
+                    this->power_limit, this->default_number_phases, this->supply_voltage) ==
+           std::tie(other.profiles_generation, other.transactions, other.purposes_to_ignore, other.current_limit,
+                    other.power_limit, other.default_number_phases, other.supply_voltage);
+}
+
 bool validate_schedule(const ChargingSchedule& schedule, const int charging_schedule_max_periods,
                        const std::vector<ChargingRateUnit>& charging_schedule_allowed_charging_rate_units) {
 
@@ -102,7 +141,13 @@ bool validate_schedule(const ChargingSchedule& schedule, const int charging_sche
 SmartChargingHandler::SmartChargingHandler(std::map<std::int32_t, std::shared_ptr<Connector>>& connectors,
                                            std::shared_ptr<DatabaseHandler> database_handler,
                                            ChargePointConfiguration& configuration) :
-    connectors(connectors), database_handler(database_handler), configuration(configuration) {
+    connectors(connectors),
+    database_handler(database_handler),
+    configuration(configuration),
+    profiles(std::make_shared<ChargingProfilesSnapshot>()),
+    profiles_generation(0),
+    composite_schedule_cache(slice_composite_schedule),
+    effective_limits_offline(false) {
     this->clear_profiles_timer = std::make_unique<Everest::SteadyTimer>();
     this->clear_profiles_timer->interval([this]() { this->clear_expired_profiles(date::utc_clock::now()); },
                                          hours(HOURS_PER_DAY));
@@ -111,30 +156,45 @@ SmartChargingHandler::SmartChargingHandler(std::map<std::int32_t, std::shared_pt
 void SmartChargingHandler::clear_expired_profiles(const date::utc_clock::time_point& now) {
     EVLOG_debug << "Scanning all installed profiles and clearing expired profiles";
 
-    // obtain locks - note the order needs to be consistent with other uses
-    const std::lock_guard<std::mutex> lk_cp(charge_point_max_profiles_map_mutex);
-    const std::lock_guard<std::mutex> lk_txd(tx_default_profiles_map_mutex);
-    const std::lock_guard<std::mutex> lk_tx(tx_profiles_map_mutex);
+    // The next snapshot is built aside, composite schedules are calculated from the current one meanwhile
+    const std::lock_guard<std::mutex> lk(this->profiles_write_mutex);
+    auto snapshot = std::make_shared<ChargingProfilesSnapshot>(*this->get_profiles_snapshot());
 
     // check all profile types for expired entries
-    ::clear_expired_profiles(now, *database_handler, stack_level_charge_point_max_profiles_map);
-    for (auto& [connector_id, connector] : connectors) {
-        ::clear_expired_profiles(now, *database_handler, connector->stack_level_tx_default_profiles_map);
-        ::clear_expired_profiles(now, *database_handler, connector->stack_level_tx_profiles_map);
+    ::clear_expired_profiles(now, *database_handler, snapshot->charge_point_max_profiles);
+    for (auto& [connector_id, stack_level_profiles_map] : snapshot->tx_default_profiles) {
+        ::clear_expired_profiles(now, *database_handler, stack_level_profiles_map);
+    }
+    for (auto& [connector_id, stack_level_profiles_map] : snapshot->tx_profiles) {
+        ::clear_expired_profiles(now, *database_handler, stack_level_profiles_map);
     }
+    this->publish_profiles_snapshot(std::move(snapshot));
 }
 
-int SmartChargingHandler::get_number_installed_profiles() {
-    int number = 0;
+bool EffectiveLimit::operator==(const EffectiveLimit& other) const {
+    return std::tie(this->charging_rate_unit, this->limit, this->number_phases) ==
+           std::tie(other.charging_rate_unit, other.limit, other.number_phases);
+}
 
-    const std::lock_guard<std::mutex> lk_cp(this->charge_point_max_profiles_map_mutex);
-    const std::lock_guard<std::mutex> lk_txd(this->tx_default_profiles_map_mutex);
-    const std::lock_guard<std::mutex> lk_tx(this->tx_profiles_map_mutex);
+std::shared_ptr<const ChargingProfilesSnapshot> SmartChargingHandler::get_profiles_snapshot() const {
+    return std::atomic_load(&this->profiles);
+}
 
-    number += clamp_to<int>(this->stack_level_charge_point_max_profiles_map.size());
-    for (const auto& [connector_id, connector] : this->connectors) {
-        number += clamp_to<int>(connector->stack_level_tx_default_profiles_map.size());
-        number += clamp_to<int>(connector->stack_level_tx_profiles_map.size());
+void SmartChargingHandler::publish_profiles_snapshot(std::shared_ptr<const ChargingProfilesSnapshot> snapshot) {
+    std::atomic_store(&this->profiles, std::move(snapshot));
+    // Incremented after publishing, so a composite schedule is never cached for a generation older than its profiles
+    this->profiles_generation++;
+}
+
+int SmartChargingHandler::get_number_installed_profiles() {
+    const auto snapshot = this->get_profiles_snapshot();
+
+    int number = clamp_to<int>(snapshot->charge_point_max_profiles.size());
+    for (const auto& [connector_id, stack_level_profiles_map] : snapshot->tx_default_profiles) {
+        number += clamp_to<int>(stack_level_profiles_map.size());
+    }
+    for (const auto& [connector_id, stack_level_profiles_map] : snapshot->tx_profiles) {
+        number += clamp_to<int>(stack_level_profiles_map.size());
     }
 
     return number;
@@ -208,21 +268,8 @@ ChargingSchedule SmartChargingHandler::calculate_composite_schedule(const ocpp::
                                                                     const std::int32_t evse_id,
                                                                     ChargingRateUnit charging_rate_unit,
                                                                     bool is_offline, bool simulate_transaction_active) {
-    const auto enhanced_composite_schedule = this->calculate_enhanced_composite_schedule(
-        start_time, end_time, evse_id, charging_rate_unit, is_offline, simulate_transaction_active);
-    ChargingSchedule composite_schedule;
-    composite_schedule.chargingRateUnit = enhanced_composite_schedule.chargingRateUnit;
-    composite_schedule.duration = enhanced_composite_schedule.duration;
-    composite_schedule.startSchedule = enhanced_composite_schedule.startSchedule;
-    composite_schedule.minChargingRate = enhanced_composite_schedule.minChargingRate;
-    for (const auto enhanced_period : enhanced_composite_schedule.chargingSchedulePeriod) {
-        ChargingSchedulePeriod period;
-        period.startPeriod = enhanced_period.startPeriod;
-        period.limit = enhanced_period.limit;
-        period.numberPhases = enhanced_period.numberPhases;
-        composite_schedule.chargingSchedulePeriod.push_back(period);
-    }
-    return composite_schedule;
+    return to_charging_schedule(this->calculate_enhanced_composite_schedule(
+        start_time, end_time, evse_id, charging_rate_unit, is_offline, simulate_transaction_active));
 }
 
 EnhancedChargingSchedule SmartChargingHandler::calculate_enhanced_composite_schedule(
@@ -230,6 +277,8 @@ EnhancedChargingSchedule SmartChargingHandler::calculate_enhanced_composite_sche
     ChargingRateUnit charging_rate_unit, bool is_offline, bool simulate_transaction_active) {
 
     const CompositeScheduleConfig config{this->configuration, is_offline};
+    // All evses are calculated from the same profiles, even if they are changed meanwhile
+    const auto snapshot = this->get_profiles_snapshot();
 
     std::optional<ocpp::DateTime> session_start{};
 
@@ -241,8 +290,7 @@ EnhancedChargingSchedule SmartChargingHandler::calculate_enhanced_composite_sche
         }
     }
 
-    const auto station_wide_profiles =
-        get_valid_profiles(start_time, end_time, STATION_WIDE_ID, config.purposes_to_ignore);
+    const auto station_wide_profiles = get_valid_profiles(*snapshot, STATION_WIDE_ID, config.purposes_to_ignore);
 
     std::vector<IntermediateProfile> combined_profiles{};
 
@@ -257,9 +305,10 @@ EnhancedChargingSchedule SmartChargingHandler::calculate_enhanced_composite_sche
             if (transaction != nullptr) {
                 session_start = transaction->get_start_energy_wh()->timestamp;
             }
-            auto intermediates = generate_evse_intermediates(
-                get_valid_profiles(start_time, end_time, evse, config.purposes_to_ignore), station_wide_profiles,
-                start_time, end_time, session_start, simulate_transaction_active);
+            auto intermediates =
+                generate_evse_intermediates(get_valid_profiles(*snapshot, evse, config.purposes_to_ignore),
+                                            station_wide_profiles, start_time, end_time, session_start,
+                                            simulate_transaction_active);
 
             // Determine the lowest limits per evse
             evse_schedules.push_back(merge_profiles_by_lowest_limit(intermediates));
@@ -272,8 +321,8 @@ EnhancedChargingSchedule SmartChargingHandler::calculate_enhanced_composite_sche
 
     } else {
         combined_profiles = generate_evse_intermediates(
-            get_valid_profiles(start_time, end_time, evse_id, config.purposes_to_ignore), station_wide_profiles,
-            start_time, end_time, session_start, simulate_transaction_active);
+            get_valid_profiles(*snapshot, evse_id, config.purposes_to_ignore), station_wide_profiles, start_time,
+            end_time, session_start, simulate_transaction_active);
     }
 
     // ChargingStationMaxProfile is always station wide
@@ -301,6 +350,144 @@ EnhancedChargingSchedule SmartChargingHandler::calculate_enhanced_composite_sche
     return composite;
 }
 
+EnhancedChargingSchedule SmartChargingHandler::get_enhanced_composite_schedule(const std::int32_t evse_id,
+                                                                              const std::int32_t duration,
+                                                                              ChargingRateUnit charging_rate_unit,
+                                                                              bool is_offline,
+                                                                              bool simulate_transaction_active) {
+    const CompositeScheduleConfig config{this->configuration, is_offline};
+    CompositeScheduleInputs inputs{this->profiles_generation.load(),
+                                   {},
+                                   config.purposes_to_ignore,
+                                   config.current_limit,
+                                   config.power_limit,
+                                   config.default_number_phases,
+                                   config.supply_voltage};
+    for (const auto& [connector_id, connector] : this->connectors) {
+        const auto transaction = connector->transaction;
+        if (transaction != nullptr) {
+            inputs.transactions.emplace_back(transaction->get_session_id(), transaction->get_transaction_id());
+        } else {
+            inputs.transactions.emplace_back();
+        }
+    }
+
+    const auto start_time = floor_seconds(ocpp::DateTime());
+    const CompositeScheduleKey key{evse_id, charging_rate_unit, duration, is_offline, simulate_transaction_active};
+    auto cached = this->composite_schedule_cache.get(key, inputs, start_time, duration);
+    if (cached.has_value()) {
+        return std::move(cached.value());
+    }
+
+    if (this->depends_on_calculation_time(evse_id)) {
+        return this->calculate_enhanced_composite_schedule(
+            start_time, ocpp::DateTime(start_time.to_time_point() + seconds(duration)), evse_id, charging_rate_unit,
+            is_offline, simulate_transaction_active);
+    }
+
+    // Calculated for twice the duration, so that the following requests within the duration are answered by slicing it
+    const auto cached_duration = clamp_to<std::int32_t>(static_cast<std::int64_t>(duration) * 2);
+    const ocpp::DateTime cached_end_time(start_time.to_time_point() + seconds(cached_duration));
+    auto schedule = this->calculate_enhanced_composite_schedule(start_time, cached_end_time, evse_id,
+                                                                charging_rate_unit, is_offline,
+                                                                simulate_transaction_active);
+    auto result = slice_composite_schedule(schedule, start_time, 0, duration);
+    this->composite_schedule_cache.put(key, std::move(inputs), start_time, cached_duration, std::move(schedule));
+    return result;
+}
+
+ChargingSchedule SmartChargingHandler::get_composite_schedule(const std::int32_t evse_id, const std::int32_t duration,
+                                                              ChargingRateUnit charging_rate_unit, bool is_offline,
+                                                              bool simulate_transaction_active) {
+    return to_charging_schedule(this->get_enhanced_composite_schedule(evse_id, duration, charging_rate_unit,
+                                                                      is_offline, simulate_transaction_active));
+}
+
+void SmartChargingHandler::register_effective_limit_changed_callback(const EffectiveLimitChangedCallback& callback) {
+    this->effective_limit_timeline = std::make_unique<EffectiveLimitTimeline<EffectiveLimit>>(
+        [this](const std::vector<std::int32_t>& connector_ids, const std::int32_t duration) {
+            return this->calculate_effective_limit_timelines(connector_ids, duration);
+        },
+        callback, seconds(SECONDS_PER_DAY));
+    this->update_effective_limits(STATION_WIDE_ID);
+}
+
+void SmartChargingHandler::update_effective_limits(const std::int32_t connector_id) {
+    if (this->effective_limit_timeline == nullptr) {
+        return;
+    }
+
+    // The limits of the charge point as a whole depend on the limits of every connector
+    std::vector<std::int32_t> connector_ids{STATION_WIDE_ID};
+    if (connector_id == STATION_WIDE_ID) {
+        for (std::int32_t id = 1; id < clamp_to<std::int32_t>(this->connectors.size()); id++) {
+            connector_ids.push_back(id);
+        }
+    } else {
+        connector_ids.push_back(connector_id);
+    }
+    this->effective_limit_timeline->update(connector_ids);
+}
+
+void SmartChargingHandler::set_offline(const bool is_offline) {
+    if (this->effective_limits_offline.exchange(is_offline) != is_offline) {
+        this->update_effective_limits(STATION_WIDE_ID);
+    }
+}
+
+std::vector<std::vector<EffectiveLimitTimelineEntry<EffectiveLimit>>>
+SmartChargingHandler::calculate_effective_limit_timelines(const std::vector<std::int32_t>& connector_ids,
+                                                          const std::int32_t duration) {
+    std::vector<std::vector<EffectiveLimitTimelineEntry<EffectiveLimit>>> timelines;
+    const auto allowed_charging_rate_units = this->configuration.getChargingScheduleAllowedChargingRateUnitVector();
+    if (allowed_charging_rate_units.empty()) {
+        timelines.resize(connector_ids.size());
+        return timelines;
+    }
+
+    // Tx(Default)Profiles only apply to connectors with a transaction, like the limits they have to apply right now
+    for (const auto connector_id : connector_ids) {
+        const auto schedule =
+            this->get_enhanced_composite_schedule(connector_id, duration, allowed_charging_rate_units.at(0),
+                                                  this->effective_limits_offline.load(), false);
+        const auto start = schedule.startSchedule.value_or(ocpp::DateTime());
+        auto& timeline = timelines.emplace_back();
+        for (const auto& period : schedule.chargingSchedulePeriod) {
+            timeline.push_back({ocpp::DateTime(start.to_time_point() + seconds(period.startPeriod)),
+                                {schedule.chargingRateUnit, period.limit, period.numberPhases}});
+        }
+    }
+    return timelines;
+}
+
+bool SmartChargingHandler::depends_on_calculation_time(const std::int32_t connector_id) {
+    // Relative profiles start when the transaction started, or now if there is none
+    const auto connector = this->connectors.find(connector_id);
+    if (connector_id != STATION_WIDE_ID and connector != this->connectors.end() and
+        connector->second->transaction != nullptr) {
+        return false;
+    }
+
+    const auto is_relative = [](const std::map<std::int32_t, ChargingProfile>& stack_level_profiles_map) {
+        return std::any_of(stack_level_profiles_map.begin(), stack_level_profiles_map.end(), [](const auto& entry) {
+            return entry.second.chargingProfileKind == ChargingProfileKindType::Relative;
+        });
+    };
+
+    const auto snapshot = this->get_profiles_snapshot();
+    if (is_relative(snapshot->charge_point_max_profiles)) {
+        return true;
+    }
+    for (const auto* profiles_per_connector : {&snapshot->tx_default_profiles, &snapshot->tx_profiles}) {
+        for (const auto& [id, stack_level_profiles_map] : *profiles_per_connector) {
+            if ((connector_id == STATION_WIDE_ID or id == connector_id) and is_relative(stack_level_profiles_map)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 bool SmartChargingHandler::validate_profile(
     ChargingProfile& profile, const int connector_id, bool ignore_no_transaction, const int profile_max_stack_level,
     const int max_charging_profiles_installed, const int charging_schedule_max_periods,
@@ -398,40 +585,55 @@ bool SmartChargingHandler::validate_profile(
 }
 
 void SmartChargingHandler::add_charge_point_max_profile(const ChargingProfile& profile) {
-    const std::lock_guard<std::mutex> lk(this->charge_point_max_profiles_map_mutex);
-    this->stack_level_charge_point_max_profiles_map[profile.stackLevel] = profile;
-    try {
-        this->database_handler->insert_or_update_charging_profile(0, profile);
-    } catch (const QueryExecutionException& e) {
-        EVLOG_warning << "Could not store ChargePointMaxProfile in the database: " << e.what();
+    {
+        const std::lock_guard<std::mutex> lk(this->profiles_write_mutex);
+        auto snapshot = std::make_shared<ChargingProfilesSnapshot>(*this->get_profiles_snapshot());
+        snapshot->charge_point_max_profiles[profile.stackLevel] = profile;
+        this->publish_profiles_snapshot(std::move(snapshot));
+        try {
+            this->database_handler->insert_or_update_charging_profile(0, profile);
+        } catch (const QueryExecutionException& e) {
+            EVLOG_warning << "Could not store ChargePointMaxProfile in the database: " << e.what();
+        }
     }
+    this->update_effective_limits(STATION_WIDE_ID);
 }
 
 void SmartChargingHandler::add_tx_default_profile(const ChargingProfile& profile, const int connector_id) {
-    const std::lock_guard<std::mutex> lk(this->tx_default_profiles_map_mutex);
-    if (connector_id == 0) {
-        for (size_t id = 1; id <= this->connectors.size() - 1; id++) {
-            this->connectors.at(clamp_to<int>(id))->stack_level_tx_default_profiles_map[profile.stackLevel] = profile;
+    {
+        const std::lock_guard<std::mutex> lk(this->profiles_write_mutex);
+        auto snapshot = std::make_shared<ChargingProfilesSnapshot>(*this->get_profiles_snapshot());
+        if (connector_id == 0) {
+            for (size_t id = 1; id <= this->connectors.size() - 1; id++) {
+                snapshot->tx_default_profiles[clamp_to<int>(id)][profile.stackLevel] = profile;
+            }
+        } else {
+            snapshot->tx_default_profiles[connector_id][profile.stackLevel] = profile;
+        }
+        this->publish_profiles_snapshot(std::move(snapshot));
+        try {
+            this->database_handler->insert_or_update_charging_profile(connector_id, profile);
+        } catch (const QueryExecutionException& e) {
+            EVLOG_warning << "Could not store TxDefaultProfile for connector id " << connector_id
+                          << " in the database: " << e.what();
         }
-    } else {
-        this->connectors.at(connector_id)->stack_level_tx_default_profiles_map[profile.stackLevel] = profile;
-    }
-    try {
-        this->database_handler->insert_or_update_charging_profile(connector_id, profile);
-    } catch (const QueryExecutionException& e) {
-        EVLOG_warning << "Could not store TxDefaultProfile for connector id " << connector_id
-                      << " in the database: " << e.what();
     }
+    this->update_effective_limits(connector_id);
 }
 
 void SmartChargingHandler::add_tx_profile(const ChargingProfile& profile, const int connector_id) {
-    const std::lock_guard<std::mutex> lk(this->tx_profiles_map_mutex);
-    this->connectors.at(connector_id)->stack_level_tx_profiles_map[profile.stackLevel] = profile;
-    try {
-        this->database_handler->insert_or_update_charging_profile(connector_id, profile);
-    } catch (const QueryExecutionException& e) {
-        EVLOG_warning << "Could not store TxProfile in the database: " << e.what();
+    {
+        const std::lock_guard<std::mutex> lk(this->profiles_write_mutex);
+        auto snapshot = std::make_shared<ChargingProfilesSnapshot>(*this->get_profiles_snapshot());
+        snapshot->tx_profiles[connector_id][profile.stackLevel] = profile;
+        this->publish_profiles_snapshot(std::move(snapshot));
+        try {
+            this->database_handler->insert_or_update_charging_profile(connector_id, profile);
+        } catch (const QueryExecutionException& e) {
+            EVLOG_warning << "Could not store TxProfile in the database: " << e.what();
+        }
     }
+    this->update_effective_limits(connector_id);
 }
 
 bool SmartChargingHandler::clear_profiles(std::map<std::int32_t, ChargingProfile>& stack_level_profiles_map,
@@ -474,63 +676,66 @@ bool SmartChargingHandler::clear_all_profiles_with_filter(
     std::optional<int> profile_id_opt, std::optional<int> connector_id_opt, std::optional<int> stack_level_opt,
     std::optional<ChargingProfilePurposeType> charging_profile_purpose_opt, bool check_id_only) {
 
+    std::unique_lock<std::mutex> lk(this->profiles_write_mutex);
+    auto snapshot = std::make_shared<ChargingProfilesSnapshot>(*this->get_profiles_snapshot());
+
     // for ChargePointMaxProfile
     auto erased_charge_point_max_profile =
-        this->clear_profiles(this->stack_level_charge_point_max_profiles_map, profile_id_opt, connector_id_opt, 0,
+        this->clear_profiles(snapshot->charge_point_max_profiles, profile_id_opt, connector_id_opt, 0,
                              stack_level_opt, charging_profile_purpose_opt, check_id_only);
 
     bool erased_at_least_one_tx_profile = false;
 
-    for (auto& [connector_id, connector] : this->connectors) {
-        // for TxDefaultProfiles
-        auto tmp_erased_tx_default_profile =
-            this->clear_profiles(connector->stack_level_tx_default_profiles_map, profile_id_opt, connector_id_opt,
-                                 connector_id, stack_level_opt, charging_profile_purpose_opt, check_id_only);
-        // for TxProfiles
-        auto tmp_erased_tx_profile =
-            this->clear_profiles(connector->stack_level_tx_profiles_map, profile_id_opt, connector_id_opt, connector_id,
-                                 stack_level_opt, charging_profile_purpose_opt, check_id_only);
-
-        if (!erased_at_least_one_tx_profile and (tmp_erased_tx_profile or tmp_erased_tx_default_profile)) {
-            erased_at_least_one_tx_profile = true;
+    // for TxDefaultProfiles and TxProfiles
+    for (auto* profiles_per_connector : {&snapshot->tx_default_profiles, &snapshot->tx_profiles}) {
+        for (auto& [connector_id, stack_level_profiles_map] : *profiles_per_connector) {
+            if (this->clear_profiles(stack_level_profiles_map, profile_id_opt, connector_id_opt, connector_id,
+                                     stack_level_opt, charging_profile_purpose_opt, check_id_only)) {
+                erased_at_least_one_tx_profile = true;
+            }
         }
     }
-    return erased_charge_point_max_profile or erased_at_least_one_tx_profile;
+
+    if (erased_charge_point_max_profile or erased_at_least_one_tx_profile) {
+        this->publish_profiles_snapshot(std::move(snapshot));
+        lk.unlock();
+        this->update_effective_limits(STATION_WIDE_ID);
+        return true;
+    }
+    return false;
 }
 
 void SmartChargingHandler::clear_all_profiles() {
     EVLOG_info << "Clearing all charging profiles";
-    const std::lock_guard<std::mutex> lk_cp(this->charge_point_max_profiles_map_mutex);
-    const std::lock_guard<std::mutex> lk_txd(this->tx_default_profiles_map_mutex);
-    const std::lock_guard<std::mutex> lk_tx(this->tx_profiles_map_mutex);
-    this->stack_level_charge_point_max_profiles_map.clear();
-
-    for (auto& [connector_id, connector] : this->connectors) {
-        connector->stack_level_tx_default_profiles_map.clear();
-        connector->stack_level_tx_profiles_map.clear();
-    }
+    {
+        const std::lock_guard<std::mutex> lk(this->profiles_write_mutex);
+        this->publish_profiles_snapshot(std::make_shared<ChargingProfilesSnapshot>());
 
-    try {
-        this->database_handler->delete_charging_profiles();
-    } catch (const QueryExecutionException& e) {
-        EVLOG_warning << "Could not delete ChargingProfile from the database: " << e.what();
+        try {
+            this->database_handler->delete_charging_profiles();
+        } catch (const QueryExecutionException& e) {
+            EVLOG_warning << "Could not delete ChargingProfile from the database: " << e.what();
+        }
     }
+    this->update_effective_limits(STATION_WIDE_ID);
 }
 
 std::vector<ChargingProfile>
 SmartChargingHandler::get_valid_profiles(const ocpp::DateTime& /*start_time*/, const ocpp::DateTime& /*end_time*/,
                                          const int connector_id,
                                          const std::set<ChargingProfilePurposeType>& purposes_to_ignore) {
-    std::vector<ChargingProfile> valid_profiles;
+    return this->get_valid_profiles(*this->get_profiles_snapshot(), connector_id, purposes_to_ignore);
+}
 
-    {
-        const std::lock_guard<std::mutex> lk(charge_point_max_profiles_map_mutex);
+std::vector<ChargingProfile>
+SmartChargingHandler::get_valid_profiles(const ChargingProfilesSnapshot& snapshot, const int connector_id,
+                                         const std::set<ChargingProfilePurposeType>& purposes_to_ignore) {
+    std::vector<ChargingProfile> valid_profiles;
 
-        if (std::find(std::begin(purposes_to_ignore), std::end(purposes_to_ignore),
-                      ChargingProfilePurposeType::ChargePointMaxProfile) == std::end(purposes_to_ignore)) {
-            for (const auto& [stack_level, profile] : stack_level_charge_point_max_profiles_map) {
-                valid_profiles.push_back(profile);
-            }
+    if (std::find(std::begin(purposes_to_ignore), std::end(purposes_to_ignore),
+                  ChargingProfilePurposeType::ChargePointMaxProfile) == std::end(purposes_to_ignore)) {
+        for (const auto& [stack_level, profile] : snapshot.charge_point_max_profiles) {
+            valid_profiles.push_back(profile);
         }
     }
 
@@ -546,12 +751,11 @@ SmartChargingHandler::get_valid_profiles(const ocpp::DateTime& /*start_time*/, c
                 transactionId = itt->second->transaction->get_transaction_id();
             }
 
-            const std::lock_guard<std::mutex> lk_txd(tx_default_profiles_map_mutex);
-            const std::lock_guard<std::mutex> lk_tx(tx_profiles_map_mutex);
-
-            if (std::find(std::begin(purposes_to_ignore), std::end(purposes_to_ignore),
+            const auto tx_profiles = snapshot.tx_profiles.find(connector_id);
+            if (tx_profiles != snapshot.tx_profiles.end() and
+                std::find(std::begin(purposes_to_ignore), std::end(purposes_to_ignore),
                           ChargingProfilePurposeType::TxProfile) == std::end(purposes_to_ignore)) {
-                for (const auto& [stack_level, profile] : itt->second->stack_level_tx_profiles_map) {
+                for (const auto& [stack_level, profile] : tx_profiles->second) {
                     // only include profiles that match the transactionId (when there is one)
                     bool b_add{false};
 
@@ -570,9 +774,11 @@ SmartChargingHandler::get_valid_profiles(const ocpp::DateTime& /*start_time*/, c
                     }
                 }
             }
-            if (std::find(std::begin(purposes_to_ignore), std::end(purposes_to_ignore),
+            const auto tx_default_profiles = snapshot.tx_default_profiles.find(connector_id);
+            if (tx_default_profiles != snapshot.tx_default_profiles.end() and
+                std::find(std::begin(purposes_to_ignore), std::end(purposes_to_ignore),
                           ChargingProfilePurposeType::TxDefaultProfile) == std::end(purposes_to_ignore)) {
-                for (const auto& [stack_level, profile] : itt->second->stack_level_tx_default_profiles_map) {
+                for (const auto& [stack_level, profile] : tx_default_profiles->second) {
                     valid_profiles.push_back(profile);
                 }
             }
@@ -128,6 +128,9 @@ void ChargePoint::start(BootReasonEnum bootreason, bool start_connecting) {
     this->provisioning->boot_notification_req(bootreason);
     // call clear_invalid_charging_profiles when system boots
     this->clear_invalid_charging_profiles();
+    if (this->smart_charging != nullptr) {
+        this->smart_charging->update_effective_limits(0);
+    }
 
     if (start_connecting) {
         this->connectivity_manager->connect();
@@ -587,9 +590,9 @@ void ChargePoint::initialize(const std::map<std::int32_t, std::int32_t>& evse_co
 
     if (device_model->get_optional_value<bool>(ControllerComponentVariables::SmartChargingCtrlrAvailable)
             .value_or(false)) {
-        this->smart_charging = std::make_unique<SmartCharging>(*this->functional_block_context,
-                                                               this->callbacks.set_charging_profiles_callback,
-                                                               this->callbacks.stop_transaction_callback);
+        this->smart_charging = std::make_unique<SmartCharging>(
+            *this->functional_block_context, this->callbacks.set_charging_profiles_callback,
+            this->callbacks.stop_transaction_callback, this->callbacks.effective_limit_changed_callback);
     }
 
     this->tariff_and_cost = std::make_unique<TariffAndCost>(
@@ -709,6 +712,7 @@ void ChargePoint::handle_message(const EnhancedMessage<v2::MessageType>& message
         case MessageType::GetChargingProfiles:
         case MessageType::GetCompositeSchedule:
         case MessageType::NotifyEVChargingNeedsResponse:
+        case MessageType::UpdateDynamicSchedule:
             if (this->smart_charging != nullptr) {
                 this->smart_charging->handle_message(message);
             } else {
@@ -868,7 +872,6 @@ void ChargePoint::handle_message(const EnhancedMessage<v2::MessageType>& message
         case MessageType::SetDefaultTariffResponse:
         case MessageType::SetDERControl:
         case MessageType::SetDERControlResponse:
-        case MessageType::UpdateDynamicSchedule:
         case MessageType::UpdateDynamicScheduleResponse:
         case MessageType::UsePriorityCharging:
         case MessageType::UsePriorityChargingResponse:
@@ -1112,6 +1115,11 @@ void ChargePoint::websocket_connected_callback(const int configuration_slot,
     // We have a connection again so next time it fails we should send the notification again
     this->skip_invalid_csms_certificate_notifications = false;
 
+    // The limits change if profile purposes are ignored while offline
+    if (this->smart_charging != nullptr) {
+        this->smart_charging->update_effective_limits(0);
+    }
+
     if (this->callbacks.connection_state_changed_callback.has_value()) {
         this->callbacks.connection_state_changed_callback.value()(true, configuration_slot, network_connection_profile,
                                                                   ocpp_version);
@@ -1129,6 +1137,9 @@ void ChargePoint::websocket_disconnected_callback(const int configuration_slot,
     }
 
     this->security->stop_certificate_expiration_check_timers();
+    if (this->smart_charging != nullptr) {
+        this->smart_charging->update_effective_limits(0);
+    }
     if (this->callbacks.connection_state_changed_callback.has_value()) {
         this->callbacks.connection_state_changed_callback.value()(false, configuration_slot, network_connection_profile,
                                                                   this->ocpp_version);
@@ -1189,7 +1200,7 @@ void ChargePoint::clear_invalid_charging_profiles() {
                     if (this->smart_charging != nullptr &&
                         this->smart_charging->conform_and_validate_profile(profile, evse_id) !=
                             ProfileValidationResultEnum::Valid) {
-                        this->database_handler->delete_charging_profile(profile.id);
+                        this->smart_charging->delete_charging_profile(profile.id);
                     }
                 } catch (const everest::db::QueryExecutionException& e) {
                     EVLOG_warning << "Failed database operation for ChargingProfiles: " << e.what();
@@ -1237,6 +1248,14 @@ std::vector<CompositeSchedule> ChargePoint::get_all_composite_schedules(const st
     return this->smart_charging->get_all_composite_schedules(duration_s, unit);
 }
 
+NotifyEventCoalescerStatistics ChargePoint::get_notify_event_statistics() {
+    return this->diagnostics->get_notify_event_statistics();
+}
+
+MonitoringStatistics ChargePoint::get_monitoring_statistics() {
+    return this->diagnostics->get_monitoring_statistics();
+}
+
 std::optional<NetworkConnectionProfile>
 ChargePoint::get_network_connection_profile(const std::int32_t configuration_slot) const {
     return this->connectivity_manager->get_network_connection_profile(configuration_slot);
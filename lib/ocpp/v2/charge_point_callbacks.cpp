@@ -14,6 +14,8 @@ bool Callbacks::all_callbacks_valid(std::shared_ptr<DeviceModel> device_model,
         this->remote_start_transaction_callback != nullptr and this->is_reservation_for_token_callback != nullptr and
         this->update_firmware_request_callback != nullptr and this->security_event_callback != nullptr and
         this->set_charging_profiles_callback != nullptr and
+        (!this->effective_limit_changed_callback.has_value() or
+         this->effective_limit_changed_callback.value() != nullptr) and
         (!this->variable_changed_callback.has_value() or this->variable_changed_callback.value() != nullptr) and
         (!this->validate_network_profile_callback.has_value() or
          this->validate_network_profile_callback.value() != nullptr) and
@@ -0,0 +1,343 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <ocpp/v2/charging_profile_store.hpp>
+
+#include <algorithm>
+#include <limits>
+
+#include <everest/logging.hpp>
+
+#include <ocpp/v2/database_handler.hpp>
+
+namespace ocpp::v2 {
+
+void apply_charging_schedule_update(ChargingProfile& profile, const ChargingScheduleUpdate& update) {
+    for (auto& schedule : profile.chargingSchedule) {
+        if (schedule.chargingSchedulePeriod.empty()) {
+            continue;
+        }
+        auto& period = schedule.chargingSchedulePeriod.front();
+        period.limit = update.limit;
+        period.limit_L2 = update.limit_L2;
+        period.limit_L3 = update.limit_L3;
+        period.dischargeLimit = update.dischargeLimit;
+        period.dischargeLimit_L2 = update.dischargeLimit_L2;
+        period.dischargeLimit_L3 = update.dischargeLimit_L3;
+        period.setpoint = update.setpoint;
+        period.setpoint_L2 = update.setpoint_L2;
+        period.setpoint_L3 = update.setpoint_L3;
+        period.setpointReactive = update.setpointReactive;
+        period.setpointReactive_L2 = update.setpointReactive_L2;
+        period.setpointReactive_L3 = update.setpointReactive_L3;
+    }
+}
+
+ChargingProfileStore::ChargingProfileStore(DatabaseHandlerInterface& database_handler) :
+    database_handler(database_handler), loaded(false), next_sequence(0), generation(0) {
+}
+
+template <typename Predicate> void ChargingProfileStore::erase_if_internal(Predicate predicate) {
+    std::vector<std::int32_t> profile_ids;
+    for (const auto& [profile_id, entry] : this->profiles) {
+        if (predicate(entry.stored)) {
+            profile_ids.push_back(profile_id);
+        }
+    }
+    for (const auto profile_id : profile_ids) {
+        this->erase_internal(profile_id);
+    }
+}
+
+void ChargingProfileStore::insert_or_update(const std::int32_t evse_id, const ChargingProfile& profile,
+                                            const CiString<20>& charging_limit_source) {
+    std::lock_guard<std::mutex> lock(this->store_mutex);
+    this->load_internal();
+
+    this->database_handler.insert_or_update_charging_profile(evse_id, profile, charging_limit_source);
+    this->generation++;
+    // Like INSERT OR REPLACE, a replaced profile is moved to the end
+    this->erase_internal(profile.id);
+    this->insert_internal(evse_id, profile, charging_limit_source);
+}
+
+std::optional<StoredChargingProfile>
+ChargingProfileStore::update_dynamic_schedule(const std::int32_t profile_id, const ChargingScheduleUpdate& update,
+                                              const DateTime& update_time) {
+    std::lock_guard<std::mutex> lock(this->store_mutex);
+    this->load_internal();
+
+    const auto it = this->profiles.find(profile_id);
+    if (it == this->profiles.end() or
+        it->second.stored.profile.chargingProfileKind != ChargingProfileKindEnum::Dynamic) {
+        return std::nullopt;
+    }
+    // The evse, purpose, stack level and transaction id do not change, so the indexes stay valid
+    auto& profile = it->second.stored.profile;
+    apply_charging_schedule_update(profile, update);
+    profile.dynUpdateTime = update_time;
+    this->generation++;
+    this->evse_generations[it->second.stored.evse_id] = this->generation;
+    return it->second.stored;
+}
+
+bool ChargingProfileStore::erase(const std::int32_t profile_id) {
+    std::lock_guard<std::mutex> lock(this->store_mutex);
+    this->load_internal();
+
+    const bool deleted = this->database_handler.delete_charging_profile(profile_id);
+    this->generation++;
+    this->erase_internal(profile_id);
+    return deleted;
+}
+
+void ChargingProfileStore::erase_by_transaction_id(const std::string& transaction_id) {
+    std::lock_guard<std::mutex> lock(this->store_mutex);
+    this->load_internal();
+
+    this->database_handler.delete_charging_profile_by_transaction_id(transaction_id);
+    this->generation++;
+    const auto it = this->by_transaction_id.find(transaction_id);
+    if (it == this->by_transaction_id.end()) {
+        return;
+    }
+    // Copy, erasing the last profile removes the index entry
+    const auto keys = it->second;
+    for (const auto& [sequence, profile_id] : keys) {
+        this->erase_internal(profile_id);
+    }
+}
+
+bool ChargingProfileStore::clear_matching_criteria(const std::optional<std::int32_t> profile_id,
+                                                   const std::optional<ClearChargingProfile>& criteria) {
+    std::lock_guard<std::mutex> lock(this->store_mutex);
+    this->load_internal();
+
+    const bool cleared = this->database_handler.clear_charging_profiles_matching_criteria(profile_id, criteria);
+    this->generation++;
+
+    // Same selection as the database query
+    if (profile_id.has_value()) {
+        this->erase_internal(profile_id.value());
+    } else if (!criteria.has_value()) {
+        this->erase_if_internal([](const StoredChargingProfile&) { return true; });
+    } else if (criteria->chargingProfilePurpose.has_value() or criteria->evseId.has_value() or
+               criteria->stackLevel.has_value()) {
+        this->erase_if_internal([&criteria](const StoredChargingProfile& stored) {
+            const auto& profile = stored.profile;
+            // K10.FR.04
+            if (profile.chargingProfilePurpose == ChargingProfilePurposeEnum::ChargingStationExternalConstraints) {
+                return false;
+            }
+            return (!criteria->chargingProfilePurpose.has_value() or
+                    profile.chargingProfilePurpose == criteria->chargingProfilePurpose.value()) and
+                   (!criteria->stackLevel.has_value() or profile.stackLevel == criteria->stackLevel.value()) and
+                   (!criteria->evseId.has_value() or stored.evse_id == criteria->evseId.value());
+        });
+    }
+
+    return cleared;
+}
+
+std::vector<ReportedChargingProfile>
+ChargingProfileStore::get_matching_criteria(const std::optional<std::int32_t> evse_id,
+                                            const ChargingProfileCriterion& criteria) {
+    std::lock_guard<std::mutex> lock(this->store_mutex);
+    this->load_internal();
+
+    const bool filter_ids = criteria.chargingProfileId.has_value() and !criteria.chargingProfileId->empty();
+    const bool filter_sources = criteria.chargingLimitSource.has_value() and !criteria.chargingLimitSource->empty();
+
+    std::set<ProfileKey> keys;
+    for (const auto& [profile_id, entry] : this->profiles) {
+        const auto& stored = entry.stored;
+        if (evse_id.has_value() and stored.evse_id != evse_id.value()) {
+            continue;
+        }
+        if (filter_ids) {
+            // Only the ids are used if they are given
+            const auto& ids = criteria.chargingProfileId.value();
+            if (std::find(ids.begin(), ids.end(), profile_id) == ids.end()) {
+                continue;
+            }
+        } else {
+            if (criteria.chargingProfilePurpose.has_value() and
+                stored.profile.chargingProfilePurpose != criteria.chargingProfilePurpose.value()) {
+                continue;
+            }
+            if (criteria.stackLevel.has_value() and stored.profile.stackLevel != criteria.stackLevel.value()) {
+                continue;
+            }
+            if (filter_sources) {
+                const auto& sources = criteria.chargingLimitSource.value();
+                if (std::none_of(sources.begin(), sources.end(), [&stored](const CiString<20>& source) {
+                        return source.get() == stored.charging_limit_source.get();
+                    })) {
+                    continue;
+                }
+            }
+        }
+        keys.emplace(entry.sequence, profile_id);
+    }
+
+    std::vector<ReportedChargingProfile> results;
+    results.reserve(keys.size());
+    for (const auto& [sequence, profile_id] : keys) {
+        const auto& stored = this->profiles.at(profile_id).stored;
+        results.emplace_back(stored.profile, stored.evse_id, stored.charging_limit_source);
+    }
+    return results;
+}
+
+std::vector<ChargingProfile> ChargingProfileStore::get_for_evse(const std::int32_t evse_id) {
+    std::lock_guard<std::mutex> lock(this->store_mutex);
+    this->load_internal();
+
+    std::vector<ChargingProfile> result;
+    const auto it = this->by_evse.find(evse_id);
+    if (it == this->by_evse.end()) {
+        return result;
+    }
+    result.reserve(it->second.size());
+    for (const auto& [sequence, profile_id] : it->second) {
+        result.push_back(this->profiles.at(profile_id).stored.profile);
+    }
+    return result;
+}
+
+std::vector<StoredChargingProfile> ChargingProfileStore::get_by_purpose(const ChargingProfilePurposeEnum purpose,
+                                                                        const std::optional<std::int32_t> evse_id,
+                                                                        const std::optional<std::int32_t> stack_level) {
+    std::lock_guard<std::mutex> lock(this->store_mutex);
+    this->load_internal();
+
+    std::set<ProfileKey> keys;
+    const auto add_keys = [&keys](const std::set<ProfileKey>& index_keys) {
+        keys.insert(index_keys.begin(), index_keys.end());
+    };
+
+    if (evse_id.has_value() and stack_level.has_value()) {
+        const auto it = this->by_evse_purpose_stack_level.find({evse_id.value(), purpose, stack_level.value()});
+        if (it != this->by_evse_purpose_stack_level.end()) {
+            add_keys(it->second);
+        }
+    } else if (evse_id.has_value()) {
+        const auto begin = this->by_evse_purpose_stack_level.lower_bound(
+            {evse_id.value(), purpose, std::numeric_limits<std::int32_t>::min()});
+        const auto end = this->by_evse_purpose_stack_level.upper_bound(
+            {evse_id.value(), purpose, std::numeric_limits<std::int32_t>::max()});
+        for (auto it = begin; it != end; ++it) {
+            add_keys(it->second);
+        }
+    } else {
+        for (const auto& [index, index_keys] : this->by_evse_purpose_stack_level) {
+            if (std::get<1>(index) == purpose and
+                (!stack_level.has_value() or std::get<2>(index) == stack_level.value())) {
+                add_keys(index_keys);
+            }
+        }
+    }
+
+    std::vector<StoredChargingProfile> result;
+    result.reserve(keys.size());
+    for (const auto& [sequence, profile_id] : keys) {
+        result.push_back(this->profiles.at(profile_id).stored);
+    }
+    return result;
+}
+
+std::vector<ChargingProfile> ChargingProfileStore::get_by_transaction_id(const std::string& transaction_id) {
+    std::lock_guard<std::mutex> lock(this->store_mutex);
+    this->load_internal();
+
+    std::vector<ChargingProfile> result;
+    const auto it = this->by_transaction_id.find(transaction_id);
+    if (it == this->by_transaction_id.end()) {
+        return result;
+    }
+    result.reserve(it->second.size());
+    for (const auto& [sequence, profile_id] : it->second) {
+        result.push_back(this->profiles.at(profile_id).stored.profile);
+    }
+    return result;
+}
+
+std::optional<StoredChargingProfile> ChargingProfileStore::get(const std::int32_t profile_id) {
+    std::lock_guard<std::mutex> lock(this->store_mutex);
+    this->load_internal();
+
+    const auto it = this->profiles.find(profile_id);
+    if (it == this->profiles.end()) {
+        return std::nullopt;
+    }
+    return it->second.stored;
+}
+
+std::uint64_t ChargingProfileStore::get_generation() {
+    std::lock_guard<std::mutex> lock(this->store_mutex);
+    return this->generation;
+}
+
+std::uint64_t ChargingProfileStore::get_generation(const std::int32_t evse_id) {
+    std::lock_guard<std::mutex> lock(this->store_mutex);
+    const auto it = this->evse_generations.find(evse_id);
+    return it != this->evse_generations.end() ? it->second : 0;
+}
+
+void ChargingProfileStore::load_internal() {
+    if (this->loaded) {
+        return;
+    }
+
+    // Without any criteria all profiles are returned, in the order they are stored in
+    const auto all_profiles = this->database_handler.get_charging_profiles_matching_criteria(std::nullopt, {});
+    for (const auto& reported : all_profiles) {
+        this->insert_internal(reported.evse_id, reported.profile, reported.source);
+    }
+    this->loaded = true;
+    EVLOG_debug << "Loaded " << this->profiles.size() << " charging profiles";
+}
+
+void ChargingProfileStore::insert_internal(const std::int32_t evse_id, const ChargingProfile& profile,
+                                           const CiString<20>& charging_limit_source) {
+    const ProfileKey key{this->next_sequence++, profile.id};
+    this->profiles.insert_or_assign(profile.id, Entry{{evse_id, profile, charging_limit_source}, key.first});
+    this->by_evse[evse_id].insert(key);
+    this->evse_generations[evse_id] = this->generation;
+    this->by_evse_purpose_stack_level[{evse_id, profile.chargingProfilePurpose, profile.stackLevel}].insert(key);
+    if (profile.transactionId.has_value()) {
+        this->by_transaction_id[profile.transactionId.value().get()].insert(key);
+    }
+}
+
+bool ChargingProfileStore::erase_internal(const std::int32_t profile_id) {
+    const auto it = this->profiles.find(profile_id);
+    if (it == this->profiles.end()) {
+        return false;
+    }
+
+    const auto& stored = it->second.stored;
+    const ProfileKey key{it->second.sequence, profile_id};
+    const auto erase_key = [&key](auto& index, const auto& index_key) {
+        const auto index_it = index.find(index_key);
+        if (index_it != index.end()) {
+            index_it->second.erase(key);
+            if (index_it->second.empty()) {
+                index.erase(index_it);
+            }
+        }
+    };
+
+    this->evse_generations[stored.evse_id] = this->generation;
+    erase_key(this->by_evse, stored.evse_id);
+    erase_key(this->by_evse_purpose_stack_level,
+              EvsePurposeStackLevel{stored.evse_id, stored.profile.chargingProfilePurpose, stored.profile.stackLevel});
+    if (stored.profile.transactionId.has_value()) {
+        erase_key(this->by_transaction_id, stored.profile.transactionId.value().get());
+    }
+
+    this->profiles.erase(it);
+    return true;
+}
+
+} // namespace ocpp::v2
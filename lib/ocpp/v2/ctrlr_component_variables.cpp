@@ -277,6 +277,24 @@ const ComponentVariable MonitorsProcessingInterval = {
         "MonitorsProcessingInterval",
     }),
 };
+const ComponentVariable MonitoringTimingEnabled = {
+    ControllerComponents::InternalCtrlr,
+    std::optional<Variable>({
+        "MonitoringTimingEnabled",
+    }),
+};
+const ComponentVariable NotifyEventCoalescingWindow = {
+    ControllerComponents::InternalCtrlr,
+    std::optional<Variable>({
+        "NotifyEventCoalescingWindow",
+    }),
+};
+const ComponentVariable NotifyEventCoalescingMaxEvents = {
+    ControllerComponents::InternalCtrlr,
+    std::optional<Variable>({
+        "NotifyEventCoalescingMaxEvents",
+    }),
+};
 const ComponentVariable MaxCustomerInformationDataLength = {
     ControllerComponents::InternalCtrlr,
     std::optional<Variable>({
@@ -325,6 +343,18 @@ const ComponentVariable ResumeTransactionsOnBoot = {
         "ResumeTransactionsOnBoot",
     }),
 };
+const ComponentVariable MeterValuesPersistBatchSize = {
+    ControllerComponents::InternalCtrlr,
+    std::optional<Variable>({
+        "MeterValuesPersistBatchSize",
+    }),
+};
+const ComponentVariable CompactMeterValueStorage = {
+    ControllerComponents::InternalCtrlr,
+    std::optional<Variable>({
+        "CompactMeterValueStorage",
+    }),
+};
 const ComponentVariable AllowCSMSRootCertInstallWithUnsecureConnection = {
     ControllerComponents::InternalCtrlr,
     std::optional<Variable>({
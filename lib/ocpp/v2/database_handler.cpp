@@ -7,12 +7,20 @@
 #include <boost/algorithm/string/join.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 #include <everest/database/sqlite/statement.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <limits>
 #include <numeric>
 #include <ocpp/common/message_queue.hpp>
 #include <ocpp/v2/database_handler.hpp>
 #include <ocpp/v2/types.hpp>
 #include <ocpp/v2/utils.hpp>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace everest::db;
@@ -30,6 +38,19 @@ std::int64_t to_unix_milliseconds(const DateTime& dt) {
 DateTime from_unix_milliseconds(std::int64_t ms_since_epoch) {
     return DateTime(date::utc_clock::time_point(std::chrono::milliseconds(ms_since_epoch)));
 }
+
+/// \brief Bytes of an AUTH_CACHE row in addition to the ID_TOKEN_HASH and ID_TOKEN_INFO columns: the record header and
+/// the LAST_USED and EXPIRY_DATE columns
+constexpr std::int64_t AUTH_CACHE_ROW_OVERHEAD = 16;
+
+/// \brief Estimated payload of an AUTH_CACHE row, must match estimate_auth_cache_row_size()
+const std::string AUTH_CACHE_ROW_SIZE =
+    "(LENGTH(CAST(ID_TOKEN_HASH AS BLOB)) + LENGTH(CAST(ID_TOKEN_INFO AS BLOB)) + " +
+    std::to_string(AUTH_CACHE_ROW_OVERHEAD) + ")";
+
+std::int64_t estimate_auth_cache_row_size(const std::string& id_token_hash, const std::string& id_token_info) {
+    return static_cast<std::int64_t>(id_token_hash.size() + id_token_info.size()) + AUTH_CACHE_ROW_OVERHEAD;
+}
 } // namespace
 
 namespace v2 {
@@ -44,20 +65,29 @@ void DatabaseHandler::init_sql() {
         throw std::logic_error("SQLite must be in serialized thread mode");
     }
 
-    auto get_stmt = this->database->new_statement("SELECT * FROM TRANSACTIONS");
+    auto get_stmt = this->statement_cache.get("SELECT * FROM TRANSACTIONS");
     if (get_stmt->step() == SQLITE_ROW) {
         EVLOG_info << "Not clearing tables as there is an ongoing transaction";
     } else {
         this->inintialize_enum_tables();
     }
+
+    this->local_authorization_list_index.load(this->get_authorization_index_keys("AUTH_LIST", "ID_TOKEN_HASH"));
+    this->authorization_cache_index.load(this->get_authorization_index_keys("AUTH_CACHE", "ID_TOKEN_HASH"));
+    try {
+        this->authorization_cache_reconcile_binary_size();
+    } catch (const QueryExecutionException& e) {
+        EVLOG_warning << "Could not measure the size of the authorization cache: " << e.what();
+    }
 }
 
 void DatabaseHandler::inintialize_enum_tables() {
 
     // TODO: Don't throw away all meter value items to allow resuming transactions
     // Also we should add functionality then to clean up old/unknown transactions from the database
-    if (!this->database->clear_table("METER_VALUE_ITEMS") or !this->database->clear_table("METER_VALUES")) {
-        EVLOG_error << "Could not clear tables METER_VALUE_ITEMS or METER_VALUES";
+    if (!this->database->clear_table("METER_VALUE_ITEMS") or !this->database->clear_table("METER_VALUES") or
+        !this->database->clear_table("METER_VALUE_RECORDS")) {
+        EVLOG_error << "Could not clear tables METER_VALUE_ITEMS, METER_VALUES or METER_VALUE_RECORDS";
         throw QueryExecutionException(this->database->get_error_message());
     }
 
@@ -114,10 +144,11 @@ void DatabaseHandler::authorization_cache_insert_entry(const std::string& id_tok
     const std::string sql =
         "INSERT OR REPLACE INTO AUTH_CACHE (ID_TOKEN_HASH, ID_TOKEN_INFO, LAST_USED, EXPIRY_DATE) VALUES "
         "(@id_token_hash, @id_token_info, @last_used, @expiry_date)";
-    auto insert_stmt = this->database->new_statement(sql);
+    auto insert_stmt = this->statement_cache.get(sql);
 
+    const auto id_token_info_json = json(id_token_info).dump();
     insert_stmt->bind_text("@id_token_hash", id_token_hash);
-    insert_stmt->bind_text("@id_token_info", json(id_token_info).dump(), SQLiteString::Transient);
+    insert_stmt->bind_text("@id_token_info", id_token_info_json, SQLiteString::Transient);
     insert_stmt->bind_int64("@last_used", to_unix_milliseconds(DateTime()));
     if (id_token_info.cacheExpiryDateTime.has_value()) {
         insert_stmt->bind_int64("@expiry_date", to_unix_milliseconds(id_token_info.cacheExpiryDateTime.value()));
@@ -125,27 +156,83 @@ void DatabaseHandler::authorization_cache_insert_entry(const std::string& id_tok
         insert_stmt->bind_null("@expiry_date");
     }
 
-    if (insert_stmt->step() != SQLITE_DONE) {
+    const auto previous_size = this->authorization_cache_get_row_size(id_token_hash);
+    {
+        // The row is written with a new LAST_USED
+        std::lock_guard<std::mutex> lock(this->authorization_cache_last_used_mutex);
+        this->authorization_cache_last_used.erase(id_token_hash);
+    }
+    this->authorization_cache_index.insert_key(id_token_hash);
+    const auto status = insert_stmt->step();
+    this->authorization_cache_index.erase_value(id_token_hash);
+    if (status != SQLITE_DONE) {
         throw QueryExecutionException(this->database->get_error_message());
     }
+    this->authorization_cache_binary_size +=
+        estimate_auth_cache_row_size(id_token_hash, id_token_info_json) - previous_size;
 }
 
 void DatabaseHandler::authorization_cache_update_last_used(const std::string& id_token_hash) {
+    if (!this->authorization_cache_index.may_contain(id_token_hash)) {
+        return;
+    }
+
+    const auto last_used = to_unix_milliseconds(DateTime());
+    {
+        std::lock_guard<std::mutex> lock(this->authorization_cache_last_used_mutex);
+        this->authorization_cache_last_used[id_token_hash] = last_used;
+    }
+    this->authorization_cache_index.update_value(id_token_hash, [last_used](AuthorizationCacheEntry& entry) {
+        entry.last_used = from_unix_milliseconds(last_used);
+    });
+}
+
+void DatabaseHandler::authorization_cache_flush_last_used() {
+    std::map<std::string, std::int64_t> last_used;
+    {
+        std::lock_guard<std::mutex> lock(this->authorization_cache_last_used_mutex);
+        last_used = this->authorization_cache_last_used;
+    }
+    if (last_used.empty()) {
+        return;
+    }
+
     const std::string sql = "UPDATE AUTH_CACHE SET LAST_USED = @last_used WHERE ID_TOKEN_HASH = @id_token_hash";
-    auto insert_stmt = this->database->new_statement(sql);
+    auto update_stmt = this->statement_cache.get(sql);
 
-    insert_stmt->bind_int64("@last_used", to_unix_milliseconds(DateTime()));
-    insert_stmt->bind_text("@id_token_hash", id_token_hash);
+    auto transaction = this->database->begin_transaction();
+    for (const auto& [id_token_hash, timestamp] : last_used) {
+        update_stmt->bind_int64("@last_used", timestamp);
+        update_stmt->bind_text("@id_token_hash", id_token_hash);
+        if (update_stmt->step() != SQLITE_DONE) {
+            throw QueryExecutionException(this->database->get_error_message());
+        }
+        update_stmt->reset();
+    }
+    transaction->commit();
 
-    if (insert_stmt->step() != SQLITE_DONE) {
-        throw QueryExecutionException(this->database->get_error_message());
+    // Entries that were used again in the meantime stay pending
+    std::lock_guard<std::mutex> lock(this->authorization_cache_last_used_mutex);
+    for (const auto& [id_token_hash, timestamp] : last_used) {
+        const auto it = this->authorization_cache_last_used.find(id_token_hash);
+        if (it != this->authorization_cache_last_used.end() and it->second == timestamp) {
+            this->authorization_cache_last_used.erase(it);
+        }
     }
 }
 
 std::optional<AuthorizationCacheEntry>
 DatabaseHandler::authorization_cache_get_entry(const std::string& id_token_hash) {
+    if (!this->authorization_cache_index.may_contain(id_token_hash)) {
+        return std::nullopt;
+    }
+    if (auto entry = this->authorization_cache_index.find(id_token_hash)) {
+        return entry;
+    }
+
+    const auto generation = this->authorization_cache_index.get_generation();
     const std::string sql = "SELECT ID_TOKEN_INFO, LAST_USED FROM AUTH_CACHE WHERE ID_TOKEN_HASH = @id_token_hash";
-    auto select_stmt = this->database->new_statement(sql);
+    auto select_stmt = this->statement_cache.get(sql);
 
     select_stmt->bind_text("@id_token_hash", id_token_hash);
 
@@ -156,8 +243,17 @@ DatabaseHandler::authorization_cache_get_entry(const std::string& id_token_hash)
     }
 
     if (status == SQLITE_ROW) {
-        return AuthorizationCacheEntry{json::parse(select_stmt->column_text(0)),
-                                       from_unix_milliseconds(select_stmt->column_int64(1))};
+        auto last_used = select_stmt->column_int64(1);
+        {
+            std::lock_guard<std::mutex> lock(this->authorization_cache_last_used_mutex);
+            const auto it = this->authorization_cache_last_used.find(id_token_hash);
+            if (it != this->authorization_cache_last_used.end()) {
+                last_used = it->second;
+            }
+        }
+        AuthorizationCacheEntry entry{json::parse(select_stmt->column_text(0)), from_unix_milliseconds(last_used)};
+        this->authorization_cache_index.cache_value(id_token_hash, entry, generation);
+        return entry;
     }
 
     throw QueryExecutionException(this->database->get_error_message());
@@ -165,63 +261,175 @@ DatabaseHandler::authorization_cache_get_entry(const std::string& id_token_hash)
 
 void DatabaseHandler::authorization_cache_delete_entry(const std::string& id_token_hash) {
     const std::string sql = "DELETE FROM AUTH_CACHE WHERE ID_TOKEN_HASH = @id_token_hash";
-    auto delete_stmt = this->database->new_statement(sql);
+    auto delete_stmt = this->statement_cache.get(sql);
 
     delete_stmt->bind_text("@id_token_hash", id_token_hash);
 
-    if (delete_stmt->step() != SQLITE_DONE) {
+    const auto size = this->authorization_cache_get_row_size(id_token_hash);
+    const auto status = delete_stmt->step();
+    this->authorization_cache_index.erase_value(id_token_hash);
+    if (status != SQLITE_DONE) {
         throw QueryExecutionException(this->database->get_error_message());
     }
+    this->authorization_cache_subtract_binary_size(size);
+    std::lock_guard<std::mutex> lock(this->authorization_cache_last_used_mutex);
+    this->authorization_cache_last_used.erase(id_token_hash);
 }
 
 void DatabaseHandler::authorization_cache_delete_nr_of_oldest_entries(size_t nr_to_remove) {
-    const std::string sql = "DELETE FROM AUTH_CACHE WHERE ID_TOKEN_HASH IN (SELECT ID_TOKEN_HASH FROM AUTH_CACHE ORDER "
-                            "BY LAST_USED ASC LIMIT @nr_to_remove)";
-    auto delete_stmt = this->database->new_statement(sql);
+    // The entries are selected by LAST_USED
+    this->authorization_cache_flush_last_used();
 
+    const std::string oldest_entries =
+        "SELECT ID_TOKEN_HASH FROM AUTH_CACHE ORDER BY LAST_USED ASC, ID_TOKEN_HASH ASC LIMIT @nr_to_remove";
+    auto size_stmt = this->statement_cache.get("SELECT SUM(" + AUTH_CACHE_ROW_SIZE +
+                                               ") FROM AUTH_CACHE WHERE ID_TOKEN_HASH IN (" + oldest_entries + ")");
+    auto delete_stmt =
+        this->statement_cache.get("DELETE FROM AUTH_CACHE WHERE ID_TOKEN_HASH IN (" + oldest_entries + ")");
+
+    size_stmt->bind_int("@nr_to_remove", clamp_to<int>(nr_to_remove));
     delete_stmt->bind_int("@nr_to_remove", clamp_to<int>(nr_to_remove));
 
-    if (delete_stmt->step() != SQLITE_DONE) {
+    auto transaction = this->database->begin_transaction();
+    if (size_stmt->step() != SQLITE_ROW) {
+        throw QueryExecutionException(this->database->get_error_message());
+    }
+    const auto size = size_stmt->column_int64(0);
+    size_stmt->reset();
+
+    const auto status = delete_stmt->step();
+    this->authorization_cache_index.clear_values();
+    if (status != SQLITE_DONE) {
         throw QueryExecutionException(this->database->get_error_message());
     }
+    transaction->commit();
+    this->authorization_cache_subtract_binary_size(size);
+}
+
+void DatabaseHandler::authorization_cache_delete_oldest_entries_exceeding(size_t max_binary_size) {
+    const auto binary_size = this->authorization_cache_get_binary_size();
+    if (binary_size <= max_binary_size) {
+        return;
+    }
+    this->authorization_cache_flush_last_used();
+
+    // Count the oldest entries that have to be removed, only the rows up to the last one of them are read
+    const std::string sql =
+        "SELECT " + AUTH_CACHE_ROW_SIZE + " FROM AUTH_CACHE ORDER BY LAST_USED ASC, ID_TOKEN_HASH ASC";
+    auto select_stmt = this->statement_cache.get(sql);
+
+    const auto size_to_remove = static_cast<std::int64_t>(binary_size - max_binary_size);
+    std::int64_t removed_size = 0;
+    size_t nr_to_remove = 0;
+    int status = SQLITE_ROW;
+    while (removed_size < size_to_remove and (status = select_stmt->step()) == SQLITE_ROW) {
+        removed_size += select_stmt->column_int64(0);
+        nr_to_remove++;
+    }
+    select_stmt->reset();
+    if (status != SQLITE_ROW and status != SQLITE_DONE) {
+        throw QueryExecutionException(this->database->get_error_message());
+    }
+
+    if (nr_to_remove > 0) {
+        this->authorization_cache_delete_nr_of_oldest_entries(nr_to_remove);
+    }
 }
 
 void DatabaseHandler::authorization_cache_delete_expired_entries(
     std::optional<std::chrono::seconds> auth_cache_lifetime) {
+    // The entries are selected by LAST_USED
+    this->authorization_cache_flush_last_used();
 
-    const std::string sql = "DELETE FROM AUTH_CACHE WHERE ID_TOKEN_HASH IN (SELECT ID_TOKEN_HASH FROM AUTH_CACHE WHERE "
-                            "EXPIRY_DATE < @before_date OR LAST_USED < @before_last_used)";
-    auto delete_stmt = this->database->new_statement(sql);
+    const std::string expired_entries = "SELECT ID_TOKEN_HASH FROM AUTH_CACHE WHERE EXPIRY_DATE < @before_date OR "
+                                        "LAST_USED < @before_last_used";
+    auto size_stmt = this->statement_cache.get("SELECT SUM(" + AUTH_CACHE_ROW_SIZE +
+                                               ") FROM AUTH_CACHE WHERE ID_TOKEN_HASH IN (" + expired_entries + ")");
+    auto delete_stmt =
+        this->statement_cache.get("DELETE FROM AUTH_CACHE WHERE ID_TOKEN_HASH IN (" + expired_entries + ")");
 
     const DateTime now;
-    delete_stmt->bind_int64("@before_date", to_unix_milliseconds(now));
-    if (auth_cache_lifetime.has_value()) {
-        delete_stmt->bind_int64("@before_last_used",
-                                to_unix_milliseconds(DateTime(now.to_time_point() - auth_cache_lifetime.value())));
-    } else {
-        delete_stmt->bind_null("@before_last_used");
+    const auto bind = [&now, &auth_cache_lifetime](auto& stmt) {
+        stmt->bind_int64("@before_date", to_unix_milliseconds(now));
+        if (auth_cache_lifetime.has_value()) {
+            stmt->bind_int64("@before_last_used",
+                             to_unix_milliseconds(DateTime(now.to_time_point() - auth_cache_lifetime.value())));
+        } else {
+            stmt->bind_null("@before_last_used");
+        }
+    };
+    bind(size_stmt);
+    bind(delete_stmt);
+
+    auto transaction = this->database->begin_transaction();
+    if (size_stmt->step() != SQLITE_ROW) {
+        throw QueryExecutionException(this->database->get_error_message());
     }
+    const auto size = size_stmt->column_int64(0);
+    size_stmt->reset();
 
-    if (delete_stmt->step() != SQLITE_DONE) {
+    const auto status = delete_stmt->step();
+    this->authorization_cache_index.clear_values();
+    if (status != SQLITE_DONE) {
         throw QueryExecutionException(this->database->get_error_message());
     }
+    transaction->commit();
+    this->authorization_cache_subtract_binary_size(size);
 }
 
 void DatabaseHandler::authorization_cache_clear() {
     if (!this->database->clear_table("AUTH_CACHE")) {
+        this->authorization_cache_index.clear_values();
         throw QueryExecutionException(this->database->get_error_message());
     }
+    this->authorization_cache_index.clear();
+    this->authorization_cache_binary_size = 0;
+    std::lock_guard<std::mutex> lock(this->authorization_cache_last_used_mutex);
+    this->authorization_cache_last_used.clear();
 }
 
 size_t DatabaseHandler::authorization_cache_get_binary_size() {
+    return static_cast<size_t>(std::max<std::int64_t>(0, this->authorization_cache_binary_size));
+}
+
+size_t DatabaseHandler::authorization_cache_reconcile_binary_size() {
     const std::string sql = "SELECT SUM(\"payload\") FROM \"dbstat\" WHERE name='AUTH_CACHE';";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     if (stmt->step() != SQLITE_ROW) {
         throw QueryExecutionException(this->database->get_error_message());
     }
 
-    return stmt->column_int(0);
+    const auto binary_size = stmt->column_int64(0);
+    this->authorization_cache_binary_size = binary_size;
+    return static_cast<size_t>(binary_size);
+}
+
+std::int64_t DatabaseHandler::authorization_cache_get_row_size(const std::string& id_token_hash) {
+    if (!this->authorization_cache_index.may_contain(id_token_hash)) {
+        return 0;
+    }
+
+    const std::string sql = "SELECT " + AUTH_CACHE_ROW_SIZE + " FROM AUTH_CACHE WHERE ID_TOKEN_HASH = @id_token_hash";
+    auto select_stmt = this->statement_cache.get(sql);
+
+    select_stmt->bind_text("@id_token_hash", id_token_hash);
+
+    const auto status = select_stmt->step();
+    if (status == SQLITE_DONE) {
+        return 0;
+    }
+    if (status != SQLITE_ROW) {
+        throw QueryExecutionException(this->database->get_error_message());
+    }
+    return select_stmt->column_int64(0);
+}
+
+void DatabaseHandler::authorization_cache_subtract_binary_size(std::int64_t size) {
+    auto binary_size = this->authorization_cache_binary_size.load();
+    while (!this->authorization_cache_binary_size.compare_exchange_weak(
+        binary_size, std::max<std::int64_t>(0, binary_size - size))) {
+    }
 }
 
 void DatabaseHandler::insert_availability(std::int32_t evse_id, std::int32_t connector_id,
@@ -236,7 +444,7 @@ void DatabaseHandler::insert_availability(std::int32_t evse_id, std::int32_t con
               "(@evse_id, @connector_id, @operational_status)";
     }
 
-    auto insert_stmt = this->database->new_statement(sql);
+    auto insert_stmt = this->statement_cache.get(sql);
 
     insert_stmt->bind_int("@evse_id", evse_id);
     insert_stmt->bind_int("@connector_id", connector_id);
@@ -252,7 +460,7 @@ void DatabaseHandler::insert_availability(std::int32_t evse_id, std::int32_t con
 OperationalStatusEnum DatabaseHandler::get_availability(std::int32_t evse_id, std::int32_t connector_id) {
     const std::string sql =
         "SELECT OPERATIONAL_STATUS FROM AVAILABILITY WHERE EVSE_ID = @evse_id AND CONNECTOR_ID = @connector_id;";
-    auto select_stmt = this->database->new_statement(sql);
+    auto select_stmt = this->statement_cache.get(sql);
 
     select_stmt->bind_int("@evse_id", evse_id);
     select_stmt->bind_int("@connector_id", connector_id);
@@ -271,7 +479,7 @@ OperationalStatusEnum DatabaseHandler::get_availability(std::int32_t evse_id, st
 
 void DatabaseHandler::insert_or_update_local_authorization_list_version(std::int32_t version) {
     const std::string sql = "INSERT OR REPLACE INTO AUTH_LIST_VERSION (ID, VERSION) VALUES (0, @version)";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_int("@version", version);
 
@@ -283,7 +491,7 @@ void DatabaseHandler::insert_or_update_local_authorization_list_version(std::int
 
 std::int32_t DatabaseHandler::get_local_authorization_list_version() {
     const std::string sql = "SELECT VERSION FROM AUTH_LIST_VERSION WHERE ID = 0";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     if (stmt->step() != SQLITE_ROW) {
         EVLOG_error << "Error selecting auth list version";
@@ -298,31 +506,98 @@ void DatabaseHandler::insert_or_update_local_authorization_list_entry(const IdTo
     // add or replace
     const std::string sql = "INSERT OR REPLACE INTO AUTH_LIST (ID_TOKEN_HASH, ID_TOKEN_INFO) "
                             "VALUES (@id_token_hash, @id_token_info)";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
-    stmt->bind_text("@id_token_hash", utils::generate_token_hash(id_token), SQLiteString::Transient);
+    const auto id_token_hash = utils::generate_token_hash(id_token);
+    stmt->bind_text("@id_token_hash", id_token_hash);
     stmt->bind_text("@id_token_info", json(id_token_info).dump(), SQLiteString::Transient);
 
-    if (stmt->step() != SQLITE_DONE) {
+    this->local_authorization_list_index.insert_key(id_token_hash);
+    const auto status = stmt->step();
+    this->local_authorization_list_index.erase_value(id_token_hash);
+    if (status != SQLITE_DONE) {
         throw QueryExecutionException(this->database->get_error_message());
     }
 }
 
+namespace {
+/// \brief Minimum number of entries of the local authorization list per thread that prepares the rows of AUTH_LIST
+constexpr std::size_t MIN_LOCAL_AUTHORIZATION_LIST_ENTRIES_PER_WORKER = 1000;
+
+/// \brief A row of AUTH_LIST, the entry is deleted if \p id_token_info is not set
+struct LocalAuthorizationListRow {
+    std::string id_token_hash;
+    std::optional<std::string> id_token_info;
+};
+
+/// \brief Hashes the tokens and serializes the token infos of \p local_authorization_list. Large lists are split
+/// into contiguous parts that are prepared in parallel.
+std::vector<LocalAuthorizationListRow>
+prepare_local_authorization_list_rows(const std::vector<AuthorizationData>& local_authorization_list) {
+    const std::size_t nr_of_entries = local_authorization_list.size();
+    const std::size_t nr_of_workers = std::max<std::size_t>(
+        1, std::min<std::size_t>(std::thread::hardware_concurrency(),
+                                 nr_of_entries / MIN_LOCAL_AUTHORIZATION_LIST_ENTRIES_PER_WORKER));
+    const std::size_t entries_per_worker = (nr_of_entries + nr_of_workers - 1) / nr_of_workers;
+
+    std::vector<LocalAuthorizationListRow> rows(nr_of_entries);
+    const auto prepare_rows = [&](const std::size_t begin, const std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const auto& authorization_data = local_authorization_list[i];
+            rows[i].id_token_hash = utils::generate_token_hash(authorization_data.idToken);
+            if (authorization_data.idTokenInfo.has_value()) {
+                rows[i].id_token_info = json(authorization_data.idTokenInfo.value()).dump();
+            }
+        }
+    };
+
+    std::vector<std::future<void>> workers;
+    workers.reserve(nr_of_workers - 1);
+    for (std::size_t worker = 1; worker < nr_of_workers; worker++) {
+        const auto begin = worker * entries_per_worker;
+        workers.push_back(std::async(std::launch::async, prepare_rows, begin,
+                                     std::min(begin + entries_per_worker, nr_of_entries)));
+    }
+    prepare_rows(0, std::min(entries_per_worker, nr_of_entries));
+
+    // Wait for all workers before rethrowing a possible exception, as they reference the local vectors.
+    for (auto& worker : workers) {
+        worker.wait();
+    }
+    for (auto& worker : workers) {
+        worker.get();
+    }
+    return rows;
+}
+} // namespace
+
 void DatabaseHandler::insert_or_update_local_authorization_list(
     const std::vector<AuthorizationData>& local_authorization_list) {
+    const auto rows = prepare_local_authorization_list_rows(local_authorization_list);
+
+    // All entries are written in one database transaction, so the list is committed (and synced) only once
+    auto transaction = this->database->begin_transaction();
+    auto insert_stmt = this->statement_cache.get("INSERT OR REPLACE INTO AUTH_LIST (ID_TOKEN_HASH, ID_TOKEN_INFO) "
+                                                 "VALUES (@id_token_hash, @id_token_info)");
+    auto delete_stmt = this->statement_cache.get("DELETE FROM AUTH_LIST WHERE ID_TOKEN_HASH = @id_token_hash;");
+
     bool success = true; // indicates if all database operations succeeded
-    for (const auto& authorization_data : local_authorization_list) {
-        try {
-            if (authorization_data.idTokenInfo.has_value()) {
-                this->insert_or_update_local_authorization_list_entry(authorization_data.idToken,
-                                                                      authorization_data.idTokenInfo.value());
-            } else {
-                this->delete_local_authorization_list_entry(authorization_data.idToken);
-            }
-        } catch (const QueryExecutionException& e) {
-            // catch but continue with remaining entries
+    for (const auto& row : rows) {
+        auto& stmt = row.id_token_info.has_value() ? insert_stmt : delete_stmt;
+        stmt->bind_text("@id_token_hash", row.id_token_hash);
+        if (row.id_token_info.has_value()) {
+            stmt->bind_text("@id_token_info", row.id_token_info.value());
+            this->local_authorization_list_index.insert_key(row.id_token_hash);
+        }
+        if (stmt->step() != SQLITE_DONE) {
+            // continue with remaining entries
             success = false;
         }
+        (*stmt).reset();
+    }
+    transaction->commit();
+    for (const auto& row : rows) {
+        this->local_authorization_list_index.erase_value(row.id_token_hash);
     }
 
     if (!success) {
@@ -332,21 +607,33 @@ void DatabaseHandler::insert_or_update_local_authorization_list(
 
 void DatabaseHandler::delete_local_authorization_list_entry(const IdToken& id_token) {
     const std::string sql = "DELETE FROM AUTH_LIST WHERE ID_TOKEN_HASH = @id_token_hash;";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
-    stmt->bind_text("@id_token_hash", utils::generate_token_hash(id_token), SQLiteString::Transient);
+    const auto id_token_hash = utils::generate_token_hash(id_token);
+    stmt->bind_text("@id_token_hash", id_token_hash);
 
-    if (stmt->step() != SQLITE_DONE) {
+    const auto status = stmt->step();
+    this->local_authorization_list_index.erase_value(id_token_hash);
+    if (status != SQLITE_DONE) {
         throw QueryExecutionException(this->database->get_error_message());
     }
 }
 
 std::optional<IdTokenInfo> DatabaseHandler::get_local_authorization_list_entry(const IdToken& id_token) {
+    const auto id_token_hash = utils::generate_token_hash(id_token);
+    // Unknown tokens are answered by the index without a query
+    if (!this->local_authorization_list_index.may_contain(id_token_hash)) {
+        return std::nullopt;
+    }
+    if (auto id_token_info = this->local_authorization_list_index.find(id_token_hash)) {
+        return id_token_info;
+    }
 
+    const auto generation = this->local_authorization_list_index.get_generation();
     const std::string sql = "SELECT ID_TOKEN_INFO FROM AUTH_LIST WHERE ID_TOKEN_HASH = @id_token_hash;";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
-    stmt->bind_text("@id_token_hash", utils::generate_token_hash(id_token), SQLiteString::Transient);
+    stmt->bind_text("@id_token_hash", id_token_hash);
 
     const int status = stmt->step();
 
@@ -355,7 +642,9 @@ std::optional<IdTokenInfo> DatabaseHandler::get_local_authorization_list_entry(c
     }
 
     if (status == SQLITE_ROW) {
-        return IdTokenInfo(json::parse(stmt->column_text(0)));
+        const IdTokenInfo id_token_info(json::parse(stmt->column_text(0)));
+        this->local_authorization_list_index.cache_value(id_token_hash, id_token_info, generation);
+        return id_token_info;
     }
 
     throw QueryExecutionException(this->database->get_error_message());
@@ -364,13 +653,15 @@ std::optional<IdTokenInfo> DatabaseHandler::get_local_authorization_list_entry(c
 void DatabaseHandler::clear_local_authorization_list() {
     const auto retval = this->database->clear_table("AUTH_LIST");
     if (retval == false) {
+        this->local_authorization_list_index.clear_values();
         throw QueryExecutionException(this->database->get_error_message());
     }
+    this->local_authorization_list_index.clear();
 }
 
 std::int32_t DatabaseHandler::get_local_authorization_list_number_of_entries() {
     const std::string sql = "SELECT COUNT(*) FROM AUTH_LIST;";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     if (stmt->step() != SQLITE_ROW) {
         throw QueryExecutionException(this->database->get_error_message());
@@ -379,14 +670,18 @@ std::int32_t DatabaseHandler::get_local_authorization_list_number_of_entries() {
     return stmt->column_int(0);
 }
 
-void DatabaseHandler::transaction_metervalues_insert(const std::string& transaction_id, const MeterValue& meter_value) {
+namespace {
+/// \brief Returns the reading context of all sampled values of \p meter_value, std::nullopt if the meter value is not
+/// stored because it has no sampled values or they have no context. Throws std::invalid_argument if the sampled
+/// values have different contexts.
+std::optional<ReadingContextEnum> get_reading_context(const MeterValue& meter_value) {
     if (meter_value.sampledValue.empty()) {
-        return;
+        return std::nullopt;
     }
 
     auto sampled_value_context = meter_value.sampledValue.at(0).context;
     if (!sampled_value_context.has_value()) {
-        return;
+        return std::nullopt;
     }
 
     auto context = sampled_value_context.value();
@@ -395,16 +690,172 @@ void DatabaseHandler::transaction_metervalues_insert(const std::string& transact
         }) != meter_value.sampledValue.end()) {
         throw std::invalid_argument("All metervalues must have the same context");
     }
+    return context;
+}
+
+/// \brief Returns the reading context of \p meter_value of transaction \p transaction_id like get_reading_context, but
+/// logs an invalid meter value and returns std::nullopt for it, so it is skipped instead of failing a whole batch
+std::optional<ReadingContextEnum> get_batch_reading_context(const std::string& transaction_id,
+                                                            const MeterValue& meter_value) {
+    try {
+        return get_reading_context(meter_value);
+    } catch (const std::invalid_argument& e) {
+        EVLOG_warning << "Skipping invalid meter value of transaction " << transaction_id << " at "
+                      << meter_value.timestamp << ": " << e.what();
+        return std::nullopt;
+    }
+}
+
+/// \brief Returns the shortest decimal representation of \p value that reads back as the same float. The json
+/// serializer prints a float converted to double with all digits of its binary representation otherwise.
+double to_shortest_decimal(const float value) {
+    if (!std::isfinite(value)) {
+        return value;
+    }
+    std::array<char, 32> buffer{};
+    for (int precision = std::numeric_limits<float>::digits10; precision < std::numeric_limits<float>::max_digits10;
+         precision++) {
+        std::snprintf(buffer.data(), buffer.size(), "%.*g", precision, value);
+        if (std::strtof(buffer.data(), nullptr) == value) {
+            return std::strtod(buffer.data(), nullptr);
+        }
+    }
+    std::snprintf(buffer.data(), buffer.size(), "%.*g", std::numeric_limits<float>::max_digits10, value);
+    return std::strtod(buffer.data(), nullptr);
+}
+
+json without_trailing_nulls(json array) {
+    while (!array.empty() and array.back().is_null()) {
+        array.erase(array.size() - 1);
+    }
+    return array;
+}
+
+bool has_field(const json& array, const std::size_t index) {
+    return index < array.size() and !array.at(index).is_null();
+}
+
+///
+/// \brief Encodes \p sampled_value for METER_VALUE_RECORDS as a json array without keys:
+/// [value, measurand, phase, location, customData, unitOfMeasure, signedMeterValue] with
+/// unitOfMeasure = [unit, multiplier, customData] and
+/// signedMeterValue = [signedMeterData, encodingMethod, signingMethod, publicKey, customData].
+/// Enums are stored as integers like in METER_VALUE_ITEMS and trailing nulls are omitted. The reading context is
+/// stored once per meter value.
+///
+json to_meter_value_record(const SampledValue& sampled_value) {
+    json record = json::array({to_shortest_decimal(sampled_value.value), nullptr, nullptr, nullptr, nullptr, nullptr,
+                               nullptr});
+    if (sampled_value.measurand.has_value()) {
+        record[1] = static_cast<int>(sampled_value.measurand.value());
+    }
+    if (sampled_value.phase.has_value()) {
+        record[2] = static_cast<int>(sampled_value.phase.value());
+    }
+    if (sampled_value.location.has_value()) {
+        record[3] = static_cast<int>(sampled_value.location.value());
+    }
+    if (sampled_value.customData.has_value()) {
+        record[4] = sampled_value.customData.value();
+    }
+    if (sampled_value.unitOfMeasure.has_value()) {
+        const auto& unit_of_measure = sampled_value.unitOfMeasure.value();
+        json unit = json::array({nullptr, nullptr, nullptr});
+        if (unit_of_measure.unit.has_value()) {
+            unit[0] = unit_of_measure.unit.value().get();
+        }
+        if (unit_of_measure.multiplier.has_value()) {
+            unit[1] = unit_of_measure.multiplier.value();
+        }
+        if (unit_of_measure.customData.has_value()) {
+            unit[2] = unit_of_measure.customData.value();
+        }
+        record[5] = without_trailing_nulls(std::move(unit));
+    }
+    if (sampled_value.signedMeterValue.has_value()) {
+        const auto& signed_meter_value = sampled_value.signedMeterValue.value();
+        json signed_value = json::array({signed_meter_value.signedMeterData.get(),
+                                         signed_meter_value.encodingMethod.get(), nullptr, nullptr, nullptr});
+        if (signed_meter_value.signingMethod.has_value()) {
+            signed_value[2] = signed_meter_value.signingMethod.value().get();
+        }
+        if (signed_meter_value.publicKey.has_value()) {
+            signed_value[3] = signed_meter_value.publicKey.value().get();
+        }
+        if (signed_meter_value.customData.has_value()) {
+            signed_value[4] = signed_meter_value.customData.value();
+        }
+        record[6] = without_trailing_nulls(std::move(signed_value));
+    }
+    return without_trailing_nulls(std::move(record));
+}
+
+SampledValue from_meter_value_record(const json& record, const std::optional<ReadingContextEnum> context) {
+    SampledValue sampled_value;
+    sampled_value.value =
+        record.at(0).is_number() ? record.at(0).get<float>() : std::numeric_limits<float>::quiet_NaN();
+    sampled_value.context = context;
+    if (has_field(record, 1)) {
+        sampled_value.measurand = static_cast<MeasurandEnum>(record.at(1).get<int>());
+    }
+    if (has_field(record, 2)) {
+        sampled_value.phase = static_cast<PhaseEnum>(record.at(2).get<int>());
+    }
+    if (has_field(record, 3)) {
+        sampled_value.location = static_cast<LocationEnum>(record.at(3).get<int>());
+    }
+    if (has_field(record, 4)) {
+        sampled_value.customData = record.at(4);
+    }
+    if (has_field(record, 5)) {
+        const auto& unit = record.at(5);
+        UnitOfMeasure unit_of_measure;
+        if (has_field(unit, 0)) {
+            unit_of_measure.unit = unit.at(0).get<std::string>();
+        }
+        if (has_field(unit, 1)) {
+            unit_of_measure.multiplier = unit.at(1).get<std::int32_t>();
+        }
+        if (has_field(unit, 2)) {
+            unit_of_measure.customData = unit.at(2);
+        }
+        sampled_value.unitOfMeasure.emplace(std::move(unit_of_measure));
+    }
+    if (has_field(record, 6)) {
+        const auto& signed_value = record.at(6);
+        SignedMeterValue signed_meter_value;
+        signed_meter_value.signedMeterData = signed_value.at(0).get<std::string>();
+        signed_meter_value.encodingMethod = signed_value.at(1).get<std::string>();
+        if (has_field(signed_value, 2)) {
+            signed_meter_value.signingMethod = signed_value.at(2).get<std::string>();
+        }
+        if (has_field(signed_value, 3)) {
+            signed_meter_value.publicKey = signed_value.at(3).get<std::string>();
+        }
+        if (has_field(signed_value, 4)) {
+            signed_meter_value.customData = signed_value.at(4);
+        }
+        sampled_value.signedMeterValue.emplace(std::move(signed_meter_value));
+    }
+    return sampled_value;
+}
+} // namespace
+
+void DatabaseHandler::transaction_metervalues_insert(const std::string& transaction_id, const MeterValue& meter_value) {
+    const auto context = get_reading_context(meter_value);
+    if (!context.has_value()) {
+        return;
+    }
 
     const std::string sql1 =
         "INSERT INTO METER_VALUES (TRANSACTION_ID, TIMESTAMP, READING_CONTEXT, CUSTOM_DATA) VALUES "
         "(@transaction_id, @timestamp, @context, @custom_data)";
 
-    auto stmt = this->database->new_statement(sql1);
+    auto stmt = this->statement_cache.get(sql1);
 
     stmt->bind_text("@transaction_id", transaction_id);
     stmt->bind_int64("@timestamp", to_unix_milliseconds(meter_value.timestamp));
-    stmt->bind_int("@context", static_cast<int>(context));
+    stmt->bind_int("@context", static_cast<int>(context.value()));
     stmt->bind_null("@custom_data");
 
     if (stmt->step() != SQLITE_DONE) {
@@ -415,18 +866,65 @@ void DatabaseHandler::transaction_metervalues_insert(const std::string& transact
     auto last_row_id = this->database->get_last_inserted_rowid();
     (*stmt).reset();
 
-    const std::string sql2 =
+    auto transaction = this->database->begin_transaction();
+    this->insert_meter_value_items(last_row_id, meter_value);
+    transaction->commit();
+}
+
+void DatabaseHandler::transaction_metervalues_insert_batch(const std::string& transaction_id,
+                                                           const std::vector<MeterValue>& meter_values,
+                                                           const bool compact) {
+    if (compact) {
+        this->insert_meter_value_records(transaction_id, meter_values);
+        return;
+    }
+
+    // A meter value that is already stored would fail the whole batch, so it is skipped instead
+    const std::string sql =
+        "INSERT OR IGNORE INTO METER_VALUES (TRANSACTION_ID, TIMESTAMP, READING_CONTEXT, CUSTOM_DATA) VALUES "
+        "(@transaction_id, @timestamp, @context, @custom_data)";
+
+    auto transaction = this->database->begin_transaction();
+    auto stmt = this->statement_cache.get(sql);
+    for (const auto& meter_value : meter_values) {
+        const auto context = get_batch_reading_context(transaction_id, meter_value);
+        if (!context.has_value()) {
+            continue;
+        }
+
+        stmt->bind_text("@transaction_id", transaction_id);
+        stmt->bind_int64("@timestamp", to_unix_milliseconds(meter_value.timestamp));
+        stmt->bind_int("@context", static_cast<int>(context.value()));
+        stmt->bind_null("@custom_data");
+
+        if (stmt->step() != SQLITE_DONE) {
+            throw QueryExecutionException(this->database->get_error_message());
+        }
+        const auto inserted = stmt->changes() > 0;
+        (*stmt).reset();
+
+        if (!inserted) {
+            EVLOG_warning << "Meter value of transaction " << transaction_id << " at " << meter_value.timestamp
+                          << " is already stored";
+            continue;
+        }
+        this->insert_meter_value_items(this->database->get_last_inserted_rowid(), meter_value);
+    }
+    transaction->commit();
+}
+
+void DatabaseHandler::insert_meter_value_items(const std::int64_t meter_value_id, const MeterValue& meter_value) {
+    const std::string sql =
         "INSERT INTO METER_VALUE_ITEMS (METER_VALUE_ID, VALUE, MEASURAND, PHASE, LOCATION, CUSTOM_DATA, "
         "UNIT_CUSTOM_DATA, UNIT_TEXT, UNIT_MULTIPLIER, SIGNED_METER_DATA, SIGNING_METHOD, "
         "ENCODING_METHOD, PUBLIC_KEY) VALUES (@meter_value_id, @value, @measurand, "
         "@phase, @location, @custom_data, @unit_custom_data, @unit_text, @unit_multiplier, "
         "@signed_meter_data, @signing_method, @encoding_method, @public_key);";
 
-    auto transaction = this->database->begin_transaction();
-    auto insert_stmt = this->database->new_statement(sql2);
+    auto insert_stmt = this->statement_cache.get(sql);
 
     for (const auto& item : meter_value.sampledValue) {
-        insert_stmt->bind_int("@meter_value_id", clamp_to<int>(last_row_id));
+        insert_stmt->bind_int("@meter_value_id", clamp_to<int>(meter_value_id));
         insert_stmt->bind_double("@value", item.value);
 
         if (item.measurand.has_value()) {
@@ -443,13 +941,21 @@ void DatabaseHandler::transaction_metervalues_insert(const std::string& transact
 
         if (item.location.has_value()) {
             insert_stmt->bind_int("@location", static_cast<int>(item.location.value()));
+        } else {
+            insert_stmt->bind_null("@location");
         }
 
         if (item.customData.has_value()) {
             insert_stmt->bind_text("@custom_data", item.customData.value().at("vendorId").get<std::string>(),
                                    SQLiteString::Transient);
+        } else {
+            insert_stmt->bind_null("@custom_data");
         }
 
+        // The statement is reused for every item and resetting it does not clear the bindings
+        insert_stmt->bind_null("@unit_custom_data");
+        insert_stmt->bind_null("@unit_text");
+        insert_stmt->bind_null("@unit_multiplier");
         if (item.unitOfMeasure.has_value()) {
             const auto& unitOfMeasure = item.unitOfMeasure.value();
 
@@ -497,16 +1003,120 @@ void DatabaseHandler::transaction_metervalues_insert(const std::string& transact
 
         (*insert_stmt).reset();
     }
+}
+
+void DatabaseHandler::insert_meter_value_records(const std::string& transaction_id,
+                                                 const std::vector<MeterValue>& meter_values) {
+    const std::lock_guard<std::mutex> lk(this->meter_value_records_mutex);
 
+    auto transaction = this->database->begin_transaction();
+
+    MeterValueRecordsPosition position{0, 0, {}};
+    auto it = this->meter_value_records_positions.find(transaction_id);
+    if (it != this->meter_value_records_positions.end()) {
+        position = it->second;
+    } else {
+        // Continue a transaction that was resumed after a restart
+        auto select_stmt = this->statement_cache.get("SELECT SEQ_NO, TIMESTAMP_DELTA, READING_CONTEXT FROM "
+                                                     "METER_VALUE_RECORDS WHERE TRANSACTION_ID = @transaction_id "
+                                                     "ORDER BY SEQ_NO");
+        select_stmt->bind_text("@transaction_id", transaction_id);
+        int status = SQLITE_ERROR;
+        while ((status = select_stmt->step()) == SQLITE_ROW) {
+            position.next_seq_no = select_stmt->column_int64(0) + 1;
+            position.last_timestamp += select_stmt->column_int64(1);
+            position.stored_readings.emplace(position.last_timestamp, select_stmt->column_int(2));
+        }
+        if (status != SQLITE_DONE) {
+            throw QueryExecutionException(this->database->get_error_message());
+        }
+    }
+
+    const std::string sql =
+        "INSERT INTO METER_VALUE_RECORDS (TRANSACTION_ID, SEQ_NO, TIMESTAMP_DELTA, READING_CONTEXT, SAMPLED_VALUES) "
+        "VALUES (@transaction_id, @seq_no, @timestamp_delta, @context, @sampled_values)";
+    auto insert_stmt = this->statement_cache.get(sql);
+    for (const auto& meter_value : meter_values) {
+        const auto context = get_batch_reading_context(transaction_id, meter_value);
+        if (!context.has_value()) {
+            continue;
+        }
+
+        const auto timestamp = to_unix_milliseconds(meter_value.timestamp);
+        if (!position.stored_readings.emplace(timestamp, static_cast<int>(context.value())).second) {
+            EVLOG_warning << "Meter value of transaction " << transaction_id << " at " << meter_value.timestamp
+                          << " is already stored";
+            continue;
+        }
+
+        json sampled_values = json::array();
+        for (const auto& item : meter_value.sampledValue) {
+            sampled_values.push_back(to_meter_value_record(item));
+        }
+
+        insert_stmt->bind_text("@transaction_id", transaction_id);
+        insert_stmt->bind_int64("@seq_no", position.next_seq_no);
+        insert_stmt->bind_int64("@timestamp_delta", timestamp - position.last_timestamp);
+        insert_stmt->bind_int("@context", static_cast<int>(context.value()));
+        insert_stmt->bind_text("@sampled_values", sampled_values.dump(), SQLiteString::Transient);
+
+        if (insert_stmt->step() != SQLITE_DONE) {
+            throw QueryExecutionException(this->database->get_error_message());
+        }
+        (*insert_stmt).reset();
+
+        position.next_seq_no++;
+        position.last_timestamp = timestamp;
+    }
     transaction->commit();
+
+    this->meter_value_records_positions[transaction_id] = position;
+}
+
+std::vector<MeterValue> DatabaseHandler::get_meter_value_records(const std::string& transaction_id) {
+    auto select_stmt =
+        this->statement_cache.get("SELECT TIMESTAMP_DELTA, READING_CONTEXT, SAMPLED_VALUES FROM METER_VALUE_RECORDS "
+                                  "WHERE TRANSACTION_ID = @transaction_id ORDER BY SEQ_NO");
+    select_stmt->bind_text("@transaction_id", transaction_id);
+
+    std::vector<MeterValue> result;
+    std::int64_t timestamp = 0;
+    int status = SQLITE_ERROR;
+    while ((status = select_stmt->step()) == SQLITE_ROW) {
+        timestamp += select_stmt->column_int64(0);
+
+        std::optional<ReadingContextEnum> context;
+        if (select_stmt->column_type(1) == SQLITE_INTEGER) {
+            context = static_cast<ReadingContextEnum>(select_stmt->column_int(1));
+        }
+
+        MeterValue value;
+        value.timestamp = from_unix_milliseconds(timestamp);
+        try {
+            for (const auto& record : json::parse(select_stmt->column_text(2))) {
+                value.sampledValue.push_back(from_meter_value_record(record, context));
+            }
+        } catch (const json::exception& e) {
+            EVLOG_error << "Could not read meter value of transaction " << transaction_id << " at " << value.timestamp
+                        << ": " << e.what();
+            continue;
+        }
+        result.push_back(std::move(value));
+    }
+
+    if (status != SQLITE_DONE) {
+        throw QueryExecutionException(this->database->get_error_message());
+    }
+
+    return result;
 }
 
 std::vector<MeterValue> DatabaseHandler::transaction_metervalues_get_all(const std::string& transaction_id) {
 
     const std::string sql1 = "SELECT * FROM METER_VALUES WHERE TRANSACTION_ID = @transaction_id;";
     const std::string sql2 = "SELECT * FROM METER_VALUE_ITEMS WHERE METER_VALUE_ID = @row_id;";
-    auto select_stmt = this->database->new_statement(sql1);
-    auto select_stmt2 = this->database->new_statement(sql2);
+    auto select_stmt = this->statement_cache.get(sql1);
+    auto select_stmt2 = this->statement_cache.get(sql2);
 
     select_stmt->bind_text("@transaction_id", transaction_id);
 
@@ -590,6 +1200,18 @@ std::vector<MeterValue> DatabaseHandler::transaction_metervalues_get_all(const s
         throw QueryExecutionException(this->database->get_error_message());
     }
 
+    // Both formats are only used for the same transaction if the storage format changed while it was resumed
+    auto records = this->get_meter_value_records(transaction_id);
+    if (result.empty()) {
+        return records;
+    }
+    if (!records.empty()) {
+        result.insert(result.end(), std::make_move_iterator(records.begin()), std::make_move_iterator(records.end()));
+        std::stable_sort(result.begin(), result.end(), [](const MeterValue& lhs, const MeterValue& rhs) {
+            return lhs.timestamp < rhs.timestamp;
+        });
+    }
+
     return result;
 }
 
@@ -597,12 +1219,12 @@ void DatabaseHandler::transaction_metervalues_clear(const std::string& transacti
 
     const std::string sql1 = "SELECT ROWID FROM METER_VALUES WHERE TRANSACTION_ID = @transaction_id;";
 
-    auto select_stmt = this->database->new_statement(sql1);
+    auto select_stmt = this->statement_cache.get(sql1);
 
     select_stmt->bind_text("@transaction_id", transaction_id);
 
     const std::string sql2 = "DELETE FROM METER_VALUE_ITEMS WHERE METER_VALUE_ID = @row_id";
-    auto delete_stmt = this->database->new_statement(sql2);
+    auto delete_stmt = this->statement_cache.get(sql2);
     int status = SQLITE_ERROR;
     while ((status = select_stmt->step()) == SQLITE_ROW) {
         auto row_id = select_stmt->column_int(0);
@@ -619,11 +1241,20 @@ void DatabaseHandler::transaction_metervalues_clear(const std::string& transacti
     }
 
     const std::string sql3 = "DELETE FROM METER_VALUES WHERE TRANSACTION_ID = @transaction_id";
-    auto delete_stmt2 = this->database->new_statement(sql3);
+    auto delete_stmt2 = this->statement_cache.get(sql3);
     delete_stmt2->bind_text("@transaction_id", transaction_id);
     if (delete_stmt2->step() != SQLITE_DONE) {
         throw QueryExecutionException(this->database->get_error_message());
     }
+
+    const std::lock_guard<std::mutex> lk(this->meter_value_records_mutex);
+    auto delete_stmt3 =
+        this->statement_cache.get("DELETE FROM METER_VALUE_RECORDS WHERE TRANSACTION_ID = @transaction_id");
+    delete_stmt3->bind_text("@transaction_id", transaction_id);
+    if (delete_stmt3->step() != SQLITE_DONE) {
+        throw QueryExecutionException(this->database->get_error_message());
+    }
+    this->meter_value_records_positions.erase(transaction_id);
 }
 
 void DatabaseHandler::insert_cs_availability(OperationalStatusEnum operational_status, bool replace) {
@@ -664,7 +1295,7 @@ void DatabaseHandler::transaction_insert(const EnhancedTransaction& transaction,
         "INSERT INTO TRANSACTIONS "
         "(TRANSACTION_ID, EVSE_ID, CONNECTOR_ID, TIME_START, SEQ_NO, CHARGING_STATE, ID_TAG_SENT) VALUES"
         "(@transaction_id, @evse_id, @connector_id, @time_start, @seq_no, @charging_state, @id_token_sent)";
-    auto insert_stmt = this->database->new_statement(sql);
+    auto insert_stmt = this->statement_cache.get(sql);
 
     insert_stmt->bind_text("@transaction_id", transaction.transactionId.get(), SQLiteString::Transient);
     insert_stmt->bind_int("@evse_id", evse_id);
@@ -685,7 +1316,7 @@ void DatabaseHandler::transaction_insert(const EnhancedTransaction& transaction,
 std::unique_ptr<EnhancedTransaction> DatabaseHandler::transaction_get(const std::int32_t evse_id) {
     const std::string sql = "SELECT TRANSACTION_ID, CONNECTOR_ID, TIME_START, SEQ_NO, CHARGING_STATE, ID_TAG_SENT FROM "
                             "TRANSACTIONS WHERE EVSE_ID = @evse_id";
-    auto get_stmt = this->database->new_statement(sql);
+    auto get_stmt = this->statement_cache.get(sql);
     get_stmt->bind_int("@evse_id", evse_id);
 
     if (get_stmt->step() != SQLITE_ROW) {
@@ -713,7 +1344,7 @@ std::unique_ptr<EnhancedTransaction> DatabaseHandler::transaction_get(const std:
 
 void DatabaseHandler::transaction_update_seq_no(const std::string& transaction_id, std::int32_t seq_no) {
     const std::string sql = "UPDATE TRANSACTIONS SET SEQ_NO = @seq_no WHERE TRANSACTION_ID = @transaction_id";
-    auto update_stmt = this->database->new_statement(sql);
+    auto update_stmt = this->statement_cache.get(sql);
 
     update_stmt->bind_int("@seq_no", seq_no);
     update_stmt->bind_text("@transaction_id", transaction_id);
@@ -727,7 +1358,7 @@ void DatabaseHandler::transaction_update_charging_state(const std::string& trans
                                                         const ChargingStateEnum charging_state) {
     const std::string sql =
         "UPDATE TRANSACTIONS SET CHARGING_STATE = @charging_state WHERE TRANSACTION_ID = @transaction_id";
-    auto update_stmt = this->database->new_statement(sql);
+    auto update_stmt = this->statement_cache.get(sql);
 
     update_stmt->bind_text("@charging_state", conversions::charging_state_enum_to_string(charging_state));
     update_stmt->bind_text("@transaction_id", transaction_id);
@@ -740,7 +1371,7 @@ void DatabaseHandler::transaction_update_charging_state(const std::string& trans
 void DatabaseHandler::transaction_update_id_token_sent(const std::string& transaction_id, bool id_token_sent) {
     const std::string sql =
         "UPDATE TRANSACTIONS SET ID_TAG_SENT = @id_token_sent WHERE TRANSACTION_ID = @transaction_id";
-    auto update_stmt = this->database->new_statement(sql);
+    auto update_stmt = this->statement_cache.get(sql);
 
     update_stmt->bind_int("@id_token_sent", id_token_sent ? 1 : 0);
     update_stmt->bind_text("@transaction_id", transaction_id);
@@ -752,7 +1383,7 @@ void DatabaseHandler::transaction_update_id_token_sent(const std::string& transa
 
 void DatabaseHandler::transaction_delete(const std::string& transaction_id) {
     const std::string sql = "DELETE FROM TRANSACTIONS WHERE TRANSACTION_ID = @transaction_id";
-    auto delete_stmt = this->database->new_statement(sql);
+    auto delete_stmt = this->statement_cache.get(sql);
     delete_stmt->bind_text("@transaction_id", transaction_id);
     if (delete_stmt->step() != SQLITE_DONE) {
         throw QueryExecutionException(this->database->get_error_message());
@@ -766,7 +1397,7 @@ void DatabaseHandler::insert_or_update_charging_profile(const int evse_id, const
         "INSERT OR REPLACE INTO CHARGING_PROFILES (ID, EVSE_ID, STACK_LEVEL, CHARGING_PROFILE_PURPOSE, "
         "TRANSACTION_ID, PROFILE, CHARGING_LIMIT_SOURCE) VALUES "
         "(@id, @evse_id, @stack_level, @charging_profile_purpose, @transaction_id, @profile, @charging_limit_source)";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     const json json_profile(profile);
 
@@ -792,7 +1423,7 @@ void DatabaseHandler::insert_or_update_charging_profile(const int evse_id, const
 
 bool DatabaseHandler::delete_charging_profile(const int profile_id) {
     const std::string sql = "DELETE FROM CHARGING_PROFILES WHERE ID = @profile_id;";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_int("@profile_id", profile_id);
     if (stmt->step() != SQLITE_DONE) {
@@ -804,7 +1435,7 @@ bool DatabaseHandler::delete_charging_profile(const int profile_id) {
 
 void DatabaseHandler::delete_charging_profile_by_transaction_id(const std::string& transaction_id) {
     const std::string sql = "DELETE FROM CHARGING_PROFILES WHERE TRANSACTION_ID = @transaction_id";
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_text("@transaction_id", transaction_id);
     if (stmt->step() != SQLITE_DONE) {
@@ -963,7 +1594,7 @@ std::vector<v2::ChargingProfile> DatabaseHandler::get_charging_profiles_for_evse
 
     const std::string sql = "SELECT PROFILE FROM CHARGING_PROFILES WHERE EVSE_ID = @evse_id";
 
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     stmt->bind_int("@evse_id", evse_id);
 
@@ -980,7 +1611,7 @@ std::vector<v2::ChargingProfile> DatabaseHandler::get_all_charging_profiles() {
 
     const std::string sql = "SELECT PROFILE FROM CHARGING_PROFILES";
 
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     while (stmt->step() != SQLITE_DONE) {
         auto profile = json::parse(stmt->column_text(0));
@@ -995,7 +1626,7 @@ std::map<std::int32_t, std::vector<v2::ChargingProfile>> DatabaseHandler::get_al
 
     const std::string sql = "SELECT EVSE_ID, PROFILE FROM CHARGING_PROFILES";
 
-    auto stmt = this->database->new_statement(sql);
+    auto stmt = this->statement_cache.get(sql);
 
     while (stmt->step() != SQLITE_DONE) {
         auto evse_id = stmt->column_int(0);
@@ -1013,7 +1644,7 @@ std::map<std::int32_t, std::vector<v2::ChargingProfile>> DatabaseHandler::get_al
 CiString<20> DatabaseHandler::get_charging_limit_source_for_profile(const int profile_id) {
     const std::string sql = "SELECT CHARGING_LIMIT_SOURCE FROM CHARGING_PROFILES WHERE ID = @profile_id;";
 
-    auto stmnt = this->database->new_statement(sql);
+    auto stmnt = this->statement_cache.get(sql);
 
     stmnt->bind_int("@profile_id", profile_id);
 
@@ -459,45 +459,44 @@ std::optional<VariableMetaData> DeviceModel::get_variable_meta_data(const Compon
 
 std::vector<ReportData> DeviceModel::get_base_report_data(const ReportBaseEnum& report_base) {
     std::vector<ReportData> report_data_vec;
+    this->get_base_report_data(report_base, [&report_data_vec](ReportData&& report_data) {
+        report_data_vec.push_back(std::move(report_data));
+    });
+    return report_data_vec;
+}
 
-    for (const auto& [component, variable_map] : this->device_model_map) {
-        for (const auto& [variable, variable_meta_data] : variable_map) {
-
-            ReportData report_data;
-            report_data.component = component;
-            report_data.variable = variable;
-
-            ComponentVariable cv;
-            cv.component = component;
-            cv.variable = variable;
-
-            // request the variable attribute from the device model
-            const auto variable_attributes = this->device_model->get_variable_attributes(component, variable);
-
-            // iterate over possibly (Actual, Target, MinSet, MaxSet)
-            for (const auto& variable_attribute : variable_attributes) {
-                if (report_base == ReportBaseEnum::FullInventory or
-                    (report_base == ReportBaseEnum::ConfigurationInventory and
-                     (variable_attribute.mutability == MutabilityEnum::ReadWrite or
-                      variable_attribute.mutability == MutabilityEnum::WriteOnly))) {
-                    report_data.variableAttribute.push_back(variable_attribute);
-                    // scrub WriteOnly value from report
-                    if (variable_attribute.mutability == MutabilityEnum::WriteOnly) {
-                        report_data.variableAttribute.back().value.reset();
-                    }
-                    report_data.variableCharacteristics = variable_map.at(variable).characteristics;
-                } else if (report_base == ReportBaseEnum::SummaryInventory) {
-                    if (include_in_summary_inventory(cv, variable_attribute)) {
-                        report_data.variableAttribute.push_back(variable_attribute);
-                    }
+void DeviceModel::get_base_report_data(const ReportBaseEnum& report_base, const ReportDataCallback& callback) {
+    this->device_model->for_each_report_data([&report_base, &callback](ReportData&& variable_data) {
+        ReportData report_data;
+        report_data.component = std::move(variable_data.component);
+        report_data.variable = std::move(variable_data.variable);
+
+        ComponentVariable cv;
+        cv.component = report_data.component;
+        cv.variable = report_data.variable;
+
+        // iterate over possibly (Actual, Target, MinSet, MaxSet)
+        for (auto& variable_attribute : variable_data.variableAttribute) {
+            if (report_base == ReportBaseEnum::FullInventory or
+                (report_base == ReportBaseEnum::ConfigurationInventory and
+                 (variable_attribute.mutability == MutabilityEnum::ReadWrite or
+                  variable_attribute.mutability == MutabilityEnum::WriteOnly))) {
+                // scrub WriteOnly value from report
+                if (variable_attribute.mutability == MutabilityEnum::WriteOnly) {
+                    variable_attribute.value.reset();
+                }
+                report_data.variableAttribute.push_back(std::move(variable_attribute));
+                report_data.variableCharacteristics = variable_data.variableCharacteristics;
+            } else if (report_base == ReportBaseEnum::SummaryInventory) {
+                if (include_in_summary_inventory(cv, variable_attribute)) {
+                    report_data.variableAttribute.push_back(std::move(variable_attribute));
                 }
-            }
-            if (!report_data.variableAttribute.empty()) {
-                report_data_vec.push_back(report_data);
             }
         }
-    }
-    return report_data_vec;
+        if (!report_data.variableAttribute.empty()) {
+            callback(std::move(report_data));
+        }
+    });
 }
 
 std::vector<ReportData>
@@ -831,8 +830,9 @@ std::vector<SetMonitoringResult> DeviceModel::set_monitors(const std::vector<Set
 
             if (monitor_meta.has_value()) {
                 // N07.FR.11
-                // In case of an existing monitor update
-                if (request_has_id && monitor_update_listener) {
+                // In case of an existing monitor update. New monitors are reported as well, so that listeners can
+                // keep track of all monitors without querying the device model
+                if (monitor_update_listener) {
                     auto attribute = this->device_model->get_variable_attribute(component_it->first, variable_it->first,
                                                                                 AttributeEnum::Actual);
 
@@ -842,7 +842,7 @@ std::vector<SetMonitoringResult> DeviceModel::set_monitors(const std::vector<Set
 
                         monitor_update_listener(monitor_meta.value(), component_it->first, variable_it->first,
                                                 characteristics, attribute.value(), current_value);
-                    } else {
+                    } else if (request_has_id) {
                         EVLOG_warning << "Could not notify monitor update listener, missing variable attribute: "
                                       << variable_it->first;
                     }
@@ -991,6 +991,10 @@ std::vector<ClearMonitoringResult> DeviceModel::clear_monitors(const std::vector
                         variable_metadata.monitors.erase(static_cast<std::int64_t>(id));
                     }
                 }
+
+                if (monitor_cleared_listener) {
+                    monitor_cleared_listener(id);
+                }
             }
 
             clear_monitor_res.status = clear_result;
@@ -1015,6 +1019,9 @@ std::int32_t DeviceModel::clear_custom_monitors() {
                 // Delete while iterating all custom monitors
                 for (auto it = variable_metadata.monitors.begin(); it != variable_metadata.monitors.end();) {
                     if (it->second.type == VariableMonitorType::CustomMonitor) {
+                        if (monitor_cleared_listener) {
+                            monitor_cleared_listener(it->second.monitor.id);
+                        }
                         it = variable_metadata.monitors.erase(it);
                     } else {
                         ++it;
@@ -0,0 +1,421 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <ocpp/v2/device_model_storage_in_memory.hpp>
+
+#include <algorithm>
+#include <future>
+
+#include <everest/logging.hpp>
+#include <ocpp/v2/device_model.hpp>
+
+namespace ocpp {
+namespace v2 {
+
+namespace {
+bool attribute_type_less(const VariableAttribute& attribute, const AttributeEnum type) {
+    return attribute.type.value_or(AttributeEnum::Actual) < type;
+}
+
+bool monitor_id_less(const VariableMonitoringMeta& monitor, const std::int32_t monitor_id) {
+    return monitor.monitor.id < monitor_id;
+}
+} // namespace
+
+DeviceModelStorageInMemory::DeviceModelStorageInMemory(
+    std::unique_ptr<DeviceModelStorageInterface> persistent_storage) :
+    persistent_storage(std::move(persistent_storage)), next_monitor_id(1), persisting(false), stop_persisting(false) {
+    if (this->persistent_storage == nullptr) {
+        EVLOG_AND_THROW(DeviceModelError("Can not initialize in memory device model storage without a storage"));
+    }
+
+    this->load(*this->persistent_storage);
+    this->persist_thread = std::thread(&DeviceModelStorageInMemory::persist_handler, this);
+}
+
+DeviceModelStorageInMemory::~DeviceModelStorageInMemory() {
+    {
+        std::lock_guard<std::mutex> lk(this->persist_mutex);
+        this->stop_persisting = true;
+    }
+    this->persist_cv.notify_all();
+    if (this->persist_thread.joinable()) {
+        this->persist_thread.join();
+    }
+}
+
+void DeviceModelStorageInMemory::load(DeviceModelStorageInterface& storage) {
+    const auto device_model = storage.get_device_model();
+
+    for (const auto& [component, variable_map] : device_model) {
+        const std::size_t component_index = this->components.size();
+        this->components.push_back(component);
+
+        for (const auto& [variable, meta_data] : variable_map) {
+            const std::size_t variable_index = this->variables.size();
+            StoredVariable stored_variable{component_index, variable, meta_data.characteristics, meta_data.source, {},
+                                           {}};
+            for (const auto& [monitor_id, monitor_meta] : meta_data.monitors) {
+                stored_variable.monitors.push_back(monitor_meta);
+                this->monitor_index[monitor_meta.monitor.id] = variable_index;
+                this->next_monitor_id = std::max(this->next_monitor_id, monitor_meta.monitor.id + 1);
+            }
+            std::sort(stored_variable.monitors.begin(), stored_variable.monitors.end(),
+                      [](const VariableMonitoringMeta& a, const VariableMonitoringMeta& b) {
+                          return a.monitor.id < b.monitor.id;
+                      });
+
+            this->variable_index[component][variable] = variable_index;
+            this->variables.push_back(std::move(stored_variable));
+        }
+    }
+
+    storage.for_each_report_data([this](ReportData&& report_data) {
+        StoredVariable* stored_variable = this->find_variable(report_data.component, report_data.variable);
+        if (stored_variable == nullptr) {
+            return;
+        }
+        stored_variable->attributes = std::move(report_data.variableAttribute);
+        std::sort(stored_variable->attributes.begin(), stored_variable->attributes.end(),
+                  [](const VariableAttribute& a, const VariableAttribute& b) {
+                      return a.type.value_or(AttributeEnum::Actual) < b.type.value_or(AttributeEnum::Actual);
+                  });
+    });
+
+    EVLOG_info << "Loaded " << this->variables.size() << " variables of " << this->components.size()
+               << " components into the in memory device model storage";
+}
+
+DeviceModelStorageInMemory::StoredVariable* DeviceModelStorageInMemory::find_variable(const Component& component_id,
+                                                                                      const Variable& variable_id) {
+    const auto component_it = this->variable_index.find(component_id);
+    if (component_it == this->variable_index.end()) {
+        return nullptr;
+    }
+    const auto variable_it = component_it->second.find(variable_id);
+    if (variable_it == component_it->second.end()) {
+        return nullptr;
+    }
+    return &this->variables.at(variable_it->second);
+}
+
+void DeviceModelStorageInMemory::remove_monitor(const std::int32_t monitor_id) {
+    const auto it = this->monitor_index.find(monitor_id);
+    if (it == this->monitor_index.end()) {
+        return;
+    }
+
+    auto& monitors = this->variables.at(it->second).monitors;
+    const auto monitor_it = std::lower_bound(monitors.begin(), monitors.end(), monitor_id, monitor_id_less);
+    if (monitor_it != monitors.end() and monitor_it->monitor.id == monitor_id) {
+        monitors.erase(monitor_it);
+    }
+    this->monitor_index.erase(it);
+}
+
+void DeviceModelStorageInMemory::persist(PersistOperation&& operation) {
+    {
+        std::lock_guard<std::mutex> lk(this->persist_mutex);
+        this->persist_queue.push_back(std::move(operation));
+    }
+    this->persist_cv.notify_all();
+}
+
+void DeviceModelStorageInMemory::persist_handler() {
+    std::unique_lock<std::mutex> lk(this->persist_mutex);
+    while (true) {
+        this->persist_cv.wait(lk, [this]() { return this->stop_persisting or !this->persist_queue.empty(); });
+        if (this->persist_queue.empty()) {
+            // Stop was requested and everything is persisted
+            return;
+        }
+
+        auto operation = std::move(this->persist_queue.front());
+        this->persist_queue.pop_front();
+        this->persisting = true;
+        lk.unlock();
+
+        try {
+            operation(*this->persistent_storage);
+        } catch (const std::exception& e) {
+            EVLOG_error << "Could not persist device model change: " << e.what();
+        }
+
+        lk.lock();
+        this->persisting = false;
+        this->persist_cv.notify_all();
+    }
+}
+
+void DeviceModelStorageInMemory::flush() {
+    std::unique_lock<std::mutex> lk(this->persist_mutex);
+    this->persist_cv.wait(lk, [this]() { return this->persist_queue.empty() and !this->persisting; });
+}
+
+DeviceModelMap DeviceModelStorageInMemory::get_device_model() {
+    std::lock_guard<std::mutex> lk(this->device_model_mutex);
+
+    DeviceModelMap device_model;
+    for (const auto& stored_variable : this->variables) {
+        VariableMetaData meta_data;
+        meta_data.characteristics = stored_variable.characteristics;
+        meta_data.source = stored_variable.source;
+        for (const auto& monitor_meta : stored_variable.monitors) {
+            meta_data.monitors.insert(std::pair{monitor_meta.monitor.id, monitor_meta});
+        }
+        device_model[this->components.at(stored_variable.component_index)][stored_variable.variable] =
+            std::move(meta_data);
+    }
+
+    return device_model;
+}
+
+std::optional<VariableAttribute>
+DeviceModelStorageInMemory::get_variable_attribute(const Component& component_id, const Variable& variable_id,
+                                                   const AttributeEnum& attribute_enum) {
+    const auto attributes = this->get_variable_attributes(component_id, variable_id, attribute_enum);
+    if (!attributes.empty()) {
+        return attributes.at(0);
+    }
+    return std::nullopt;
+}
+
+std::vector<VariableAttribute>
+DeviceModelStorageInMemory::get_variable_attributes(const Component& component_id, const Variable& variable_id,
+                                                    const std::optional<AttributeEnum>& attribute_enum) {
+    std::lock_guard<std::mutex> lk(this->device_model_mutex);
+
+    const StoredVariable* stored_variable = this->find_variable(component_id, variable_id);
+    if (stored_variable == nullptr) {
+        return {};
+    }
+
+    if (!attribute_enum.has_value()) {
+        return stored_variable->attributes;
+    }
+
+    const auto& attributes = stored_variable->attributes;
+    const auto it = std::lower_bound(attributes.begin(), attributes.end(), attribute_enum.value(), attribute_type_less);
+    if (it != attributes.end() and it->type.value_or(AttributeEnum::Actual) == attribute_enum.value()) {
+        return {*it};
+    }
+    return {};
+}
+
+void DeviceModelStorageInMemory::for_each_report_data(const ReportDataCallback& callback) {
+    // Variables are never added or removed after loading, so the lock only has to be held while copying a single
+    // variable. This allows the callback to read from this storage as well.
+    const std::size_t nr_of_variables = this->variables.size();
+    for (std::size_t i = 0; i < nr_of_variables; i++) {
+        ReportData report_data;
+        {
+            std::lock_guard<std::mutex> lk(this->device_model_mutex);
+            const auto& stored_variable = this->variables[i];
+            if (stored_variable.attributes.empty()) {
+                continue;
+            }
+            report_data.component = this->components.at(stored_variable.component_index);
+            report_data.variable = stored_variable.variable;
+            report_data.variableAttribute = stored_variable.attributes;
+            report_data.variableCharacteristics = stored_variable.characteristics;
+        }
+        callback(std::move(report_data));
+    }
+}
+
+SetVariableStatusEnum DeviceModelStorageInMemory::set_variable_attribute_value(const Component& component_id,
+                                                                               const Variable& variable_id,
+                                                                               const AttributeEnum& attribute_enum,
+                                                                               const std::string& value,
+                                                                               const std::string& source) {
+    std::lock_guard<std::mutex> lk(this->device_model_mutex);
+
+    StoredVariable* stored_variable = this->find_variable(component_id, variable_id);
+    if (stored_variable == nullptr) {
+        return SetVariableStatusEnum::Rejected;
+    }
+
+    auto& attributes = stored_variable->attributes;
+    const auto it = std::lower_bound(attributes.begin(), attributes.end(), attribute_enum, attribute_type_less);
+    if (it != attributes.end() and it->type.value_or(AttributeEnum::Actual) == attribute_enum) {
+        it->value = value;
+    }
+
+    this->persist([component_id, variable_id, attribute_enum, value, source](DeviceModelStorageInterface& storage) {
+        if (storage.set_variable_attribute_value(component_id, variable_id, attribute_enum, value, source) !=
+            SetVariableStatusEnum::Accepted) {
+            EVLOG_error << "Could not persist value of variable " << variable_id.name.get() << " of component "
+                        << component_id.name.get();
+        }
+    });
+
+    return SetVariableStatusEnum::Accepted;
+}
+
+std::optional<VariableMonitoringMeta> DeviceModelStorageInMemory::set_monitoring_data(const SetMonitoringData& data,
+                                                                                      const VariableMonitorType type) {
+    std::lock_guard<std::mutex> lk(this->device_model_mutex);
+
+    const StoredVariable* stored_variable = this->find_variable(data.component, data.variable);
+    if (stored_variable == nullptr) {
+        return std::nullopt;
+    }
+    const std::size_t variable_index = this->variable_index.at(data.component).at(data.variable);
+
+    std::optional<std::string> actual_value;
+
+    // For a delta monitor, the actual value is mandatory,
+    // since it is used as a reference value when triggering
+    if (data.type == MonitorEnum::Delta) {
+        const auto& attributes = stored_variable->attributes;
+        const auto it =
+            std::lower_bound(attributes.begin(), attributes.end(), AttributeEnum::Actual, attribute_type_less);
+        if (it == attributes.end() or it->type.value_or(AttributeEnum::Actual) != AttributeEnum::Actual or
+            !it->value.has_value()) {
+            return std::nullopt;
+        }
+        actual_value = it->value.value().get();
+    }
+
+    // The id is assigned here and handed to the persistent storage, so both use the same id.
+    const std::int32_t monitor_id = data.id.value_or(this->next_monitor_id);
+    this->remove_monitor(monitor_id);
+    this->next_monitor_id = std::max(this->next_monitor_id, monitor_id + 1);
+
+    VariableMonitoringMeta meta;
+    meta.monitor.id = monitor_id;
+    meta.monitor.severity = data.severity;
+    meta.monitor.transaction = data.transaction.value_or(false);
+    meta.monitor.type = data.type;
+    meta.monitor.value = data.value;
+    // this is a workaround to set the eventNotificationType which became a required property for the
+    // VariableMonitoringType in OCPP2.1
+    meta.monitor.eventNotificationType = conversions::variable_monitor_type_to_event_notification_type(type);
+    meta.type = type;
+    meta.reference_value = actual_value;
+
+    auto& monitors = this->variables.at(variable_index).monitors;
+    monitors.insert(std::lower_bound(monitors.begin(), monitors.end(), monitor_id, monitor_id_less), meta);
+    this->monitor_index[monitor_id] = variable_index;
+
+    SetMonitoringData persisted_data = data;
+    persisted_data.id = monitor_id;
+    this->persist([persisted_data, type](DeviceModelStorageInterface& storage) {
+        if (!storage.set_monitoring_data(persisted_data, type).has_value()) {
+            EVLOG_error << "Could not persist monitor " << persisted_data.id.value();
+        }
+    });
+
+    return meta;
+}
+
+bool DeviceModelStorageInMemory::update_monitoring_reference(const std::int32_t monitor_id,
+                                                             const std::string& reference_value) {
+    std::lock_guard<std::mutex> lk(this->device_model_mutex);
+
+    const auto it = this->monitor_index.find(monitor_id);
+    if (it == this->monitor_index.end()) {
+        return false;
+    }
+
+    auto& monitors = this->variables.at(it->second).monitors;
+    const auto monitor_it = std::lower_bound(monitors.begin(), monitors.end(), monitor_id, monitor_id_less);
+    if (monitor_it == monitors.end() or monitor_it->monitor.id != monitor_id) {
+        return false;
+    }
+    monitor_it->reference_value = reference_value;
+
+    this->persist([monitor_id, reference_value](DeviceModelStorageInterface& storage) {
+        if (!storage.update_monitoring_reference(monitor_id, reference_value)) {
+            EVLOG_error << "Could not persist reference value of monitor " << monitor_id;
+        }
+    });
+
+    return true;
+}
+
+std::vector<VariableMonitoringMeta>
+DeviceModelStorageInMemory::get_monitoring_data(const std::vector<MonitoringCriterionEnum>& criteria,
+                                                const Component& component_id, const Variable& variable_id) {
+    std::lock_guard<std::mutex> lk(this->device_model_mutex);
+
+    const StoredVariable* stored_variable = this->find_variable(component_id, variable_id);
+    if (stored_variable == nullptr) {
+        return {};
+    }
+
+    std::vector<VariableMonitoringMeta> monitors = stored_variable->monitors;
+    filter_criteria_monitors(criteria, monitors);
+    return monitors;
+}
+
+ClearMonitoringStatusEnum DeviceModelStorageInMemory::clear_variable_monitor(int monitor_id, bool allow_protected) {
+    std::lock_guard<std::mutex> lk(this->device_model_mutex);
+
+    const auto it = this->monitor_index.find(monitor_id);
+    if (it == this->monitor_index.end()) {
+        return ClearMonitoringStatusEnum::NotFound;
+    }
+
+    if (!allow_protected) {
+        const auto& monitors = this->variables.at(it->second).monitors;
+        const auto monitor_it = std::lower_bound(monitors.begin(), monitors.end(), monitor_id, monitor_id_less);
+        if (monitor_it == monitors.end() or monitor_it->monitor.id != monitor_id or
+            monitor_it->type != VariableMonitorType::CustomMonitor) {
+            return ClearMonitoringStatusEnum::Rejected;
+        }
+    }
+
+    this->remove_monitor(monitor_id);
+
+    this->persist([monitor_id, allow_protected](DeviceModelStorageInterface& storage) {
+        if (storage.clear_variable_monitor(monitor_id, allow_protected) != ClearMonitoringStatusEnum::Accepted) {
+            EVLOG_error << "Could not persist clearing monitor " << monitor_id;
+        }
+    });
+
+    return ClearMonitoringStatusEnum::Accepted;
+}
+
+std::int32_t DeviceModelStorageInMemory::clear_custom_variable_monitors() {
+    std::lock_guard<std::mutex> lk(this->device_model_mutex);
+
+    std::int32_t cleared = 0;
+    for (auto& stored_variable : this->variables) {
+        auto& monitors = stored_variable.monitors;
+        for (auto it = monitors.begin(); it != monitors.end();) {
+            if (it->type == VariableMonitorType::CustomMonitor) {
+                this->monitor_index.erase(it->monitor.id);
+                it = monitors.erase(it);
+                cleared++;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    if (cleared > 0) {
+        this->persist([](DeviceModelStorageInterface& storage) { storage.clear_custom_variable_monitors(); });
+    }
+
+    return cleared;
+}
+
+void DeviceModelStorageInMemory::check_integrity() {
+    // The data is loaded from the persistent storage, so check the integrity there. This is done on the persist thread
+    // to not access the persistent storage from two threads at the same time.
+    std::promise<void> checked;
+    auto result = checked.get_future();
+    this->persist([&checked](DeviceModelStorageInterface& storage) {
+        try {
+            storage.check_integrity();
+            checked.set_value();
+        } catch (...) {
+            checked.set_exception(std::current_exception());
+        }
+    });
+    result.get();
+}
+
+} // namespace v2
+} // namespace ocpp
@@ -22,9 +22,8 @@ DeviceModelStorageSqlite::DeviceModelStorageSqlite(const fs::path& db_path, cons
     if (db_path.empty() || migration_files_path.empty() || config_path.empty()) {
         EVLOG_AND_THROW(DeviceModelError("Can not initialize device model storage: one of the paths is empty."));
     }
-    const auto component_configs = get_all_component_configs(config_path);
     InitDeviceModelDb init_device_model_db(db_path, migration_files_path);
-    init_device_model_db.initialize_database(component_configs, false);
+    init_device_model_db.initialize_database(config_path, false);
 
     initialize_connection(db_path);
 }
@@ -225,6 +224,88 @@ DeviceModelStorageSqlite::get_variable_attributes(const Component& component_id,
     return attributes;
 }
 
+void DeviceModelStorageSqlite::for_each_report_data(const ReportDataCallback& callback) {
+    // One ordered pass over all variables and their attributes. Rows of the same variable are adjacent, so a
+    // ReportData is complete as soon as the variable id of the current row changes.
+    const std::string select_query =
+        "SELECT v.ID, c.NAME, c.EVSE_ID, c.CONNECTOR_ID, c.INSTANCE, v.NAME, v.INSTANCE, vc.DATATYPE_ID, "
+        "vc.SUPPORTS_MONITORING, vc.UNIT, vc.MIN_LIMIT, vc.MAX_LIMIT, vc.VALUES_LIST, va.VALUE, va.MUTABILITY_ID, "
+        "va.PERSISTENT, va.CONSTANT, va.TYPE_ID "
+        "FROM COMPONENT c "
+        "JOIN VARIABLE v ON c.ID = v.COMPONENT_ID "
+        "JOIN VARIABLE_CHARACTERISTICS vc ON vc.VARIABLE_ID = v.ID "
+        "JOIN VARIABLE_ATTRIBUTE va ON va.VARIABLE_ID = v.ID "
+        "ORDER BY c.ID, v.ID, va.TYPE_ID";
+
+    auto select_stmt = this->db->new_statement(select_query);
+
+    std::optional<ReportData> report_data;
+    int current_variable_id = -1;
+
+    while (select_stmt->step() == SQLITE_ROW) {
+        const int variable_id = select_stmt->column_int(0);
+
+        if (variable_id != current_variable_id) {
+            if (report_data.has_value()) {
+                callback(std::move(report_data.value()));
+            }
+            current_variable_id = variable_id;
+            report_data.emplace();
+
+            Component& component = report_data->component;
+            component.name = select_stmt->column_text(1);
+            if (select_stmt->column_type(2) != SQLITE_NULL) {
+                EVSE evse;
+                evse.id = select_stmt->column_int(2);
+                if (select_stmt->column_type(3) != SQLITE_NULL) {
+                    evse.connectorId = select_stmt->column_int(3);
+                }
+                component.evse = evse;
+            }
+            if (select_stmt->column_type(4) != SQLITE_NULL) {
+                component.instance = select_stmt->column_text(4);
+            }
+
+            Variable& variable = report_data->variable;
+            variable.name = select_stmt->column_text(5);
+            if (select_stmt->column_type(6) != SQLITE_NULL) {
+                variable.instance = select_stmt->column_text(6);
+            }
+
+            VariableCharacteristics characteristics;
+            characteristics.dataType = static_cast<DataEnum>(select_stmt->column_int(7));
+            characteristics.supportsMonitoring = select_stmt->column_int(8) != 0;
+            if (select_stmt->column_type(9) != SQLITE_NULL) {
+                characteristics.unit = select_stmt->column_text(9);
+            }
+            if (select_stmt->column_type(10) != SQLITE_NULL) {
+                characteristics.minLimit = select_stmt->column_double(10);
+            }
+            if (select_stmt->column_type(11) != SQLITE_NULL) {
+                characteristics.maxLimit = select_stmt->column_double(11);
+            }
+            if (select_stmt->column_type(12) != SQLITE_NULL) {
+                characteristics.valuesList = select_stmt->column_text(12);
+            }
+            report_data->variableCharacteristics = characteristics;
+        }
+
+        VariableAttribute attribute;
+        if (select_stmt->column_type(13) != SQLITE_NULL) {
+            attribute.value = select_stmt->column_text(13);
+        }
+        attribute.mutability = static_cast<MutabilityEnum>(select_stmt->column_int(14));
+        attribute.persistent = static_cast<bool>(select_stmt->column_int(15));
+        attribute.constant = static_cast<bool>(select_stmt->column_int(16));
+        attribute.type = static_cast<AttributeEnum>(select_stmt->column_int(17));
+        report_data->variableAttribute.push_back(std::move(attribute));
+    }
+
+    if (report_data.has_value()) {
+        callback(std::move(report_data.value()));
+    }
+}
+
 SetVariableStatusEnum DeviceModelStorageSqlite::set_variable_attribute_value(const Component& component_id,
                                                                              const Variable& variable_id,
                                                                              const AttributeEnum& attribute_enum,
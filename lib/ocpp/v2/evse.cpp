@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright 2020 - 2023 Pionix GmbH and Contributors to EVerest
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <optional>
@@ -72,6 +73,14 @@ Evse::Evse(const std::int32_t evse_id, const std::int32_t number_of_connectors,
 }
 
 Evse::~Evse() {
+    try {
+        // Keep the meter values of a transaction that is resumed on the next boot
+        const std::lock_guard<std::mutex> lk(this->pending_transaction_meter_values_mutex);
+        this->write_pending_transaction_meter_values();
+    } catch (...) {
+        EVLOG_error << "Exception during dtor call write pending transaction meter values";
+    }
+
     try {
         if (this->trigger_metervalue_at_time_timer != nullptr) {
             this->trigger_metervalue_at_time_timer->stop();
@@ -259,15 +268,7 @@ void Evse::open_transaction(const std::string& transaction_id, const std::int32_
     this->transaction->active_energy_import_start_value = this->get_active_import_register_meter_value();
     this->transaction->chargingState = charging_state;
 
-    try {
-        this->database_handler->transaction_metervalues_insert(this->transaction->transactionId.get(), meter_start);
-    } catch (const QueryExecutionException& e) {
-        EVLOG_warning << "Could not insert transaction meter values of transaction: "
-                      << this->transaction->transactionId.get() << " into database: " << e.what();
-    } catch (const std::invalid_argument& e) {
-        EVLOG_warning << "Could not insert transaction meter values of transaction: "
-                      << this->transaction->transactionId.get() << " into database: " << e.what();
-    }
+    this->store_transaction_meter_value(meter_start, true);
 
     this->start_metering_timers(timestamp);
 
@@ -297,15 +298,7 @@ void Evse::close_transaction(const DateTime& /*timestamp*/, const MeterValue& me
     this->transaction->aligned_tx_updated_meter_values_timer.stop();
     this->transaction->aligned_tx_ended_meter_values_timer.stop();
 
-    try {
-        this->database_handler->transaction_metervalues_insert(this->transaction->transactionId.get(), meter_stop);
-    } catch (const QueryExecutionException& e) {
-        EVLOG_warning << "Could not insert transaction meter values of transaction: "
-                      << this->transaction->transactionId.get() << " into database: " << e.what();
-    } catch (const std::invalid_argument& e) {
-        EVLOG_warning << "Could not insert transaction meter values of transaction: "
-                      << this->transaction->transactionId.get() << " into database: " << e.what();
-    }
+    this->store_transaction_meter_value(meter_stop, true);
     // Clear for non transaction aligned metervalues
     this->aligned_data_updated.clear_values();
 }
@@ -337,6 +330,10 @@ bool Evse::has_active_transaction(std::int32_t connector_id) const {
 }
 
 void Evse::release_transaction() {
+    {
+        const std::lock_guard<std::mutex> lk(this->pending_transaction_meter_values_mutex);
+        this->pending_transaction_meter_values.clear();
+    }
     try {
         this->database_handler->transaction_metervalues_clear(this->transaction->transactionId);
         this->database_handler->transaction_delete(this->transaction->transactionId);
@@ -432,18 +429,7 @@ void Evse::start_metering_timers(const DateTime& timestamp) {
 
     if (sampled_data_tx_ended_interval > 0s) {
         this->transaction->sampled_tx_ended_meter_values_timer.interval_starting_from(
-            [this] {
-                try {
-                    this->database_handler->transaction_metervalues_insert(this->transaction->transactionId.get(),
-                                                                           this->get_meter_value());
-                } catch (const QueryExecutionException& e) {
-                    EVLOG_warning << "Could not insert transaction meter values of transaction: "
-                                  << this->transaction->transactionId.get() << " into database: " << e.what();
-                } catch (const std::invalid_argument& e) {
-                    EVLOG_warning << "Could not insert transaction meter values of transaction: "
-                                  << this->transaction->transactionId.get() << " into database: " << e.what();
-                }
-            },
+            [this] { this->store_transaction_meter_value(this->get_meter_value(), false); },
             sampled_data_tx_ended_interval, date::utc_clock::to_sys(timestamp.to_time_point()));
     }
 
@@ -492,16 +478,7 @@ void Evse::start_metering_timers(const DateTime& timestamp) {
                     .value_or(false)) {
                 meter_value.timestamp = utils::align_timestamp(DateTime{}, aligned_data_tx_ended_interval);
             }
-            try {
-                this->database_handler->transaction_metervalues_insert(this->transaction->transactionId.get(),
-                                                                       meter_value);
-            } catch (const QueryExecutionException& e) {
-                EVLOG_warning << "Could not insert transaction meter values of transaction: "
-                              << this->transaction->transactionId.get() << " into database: " << e.what();
-            } catch (const std::invalid_argument& e) {
-                EVLOG_warning << "Could not insert transaction meter values of transaction: "
-                              << this->transaction->transactionId.get() << " into database: " << e.what();
-            }
+            this->store_transaction_meter_value(meter_value, false);
             this->aligned_data_tx_end.clear_values();
         };
 
@@ -586,6 +563,36 @@ void Evse::reset_pricing_triggers() {
     }
 }
 
+void Evse::store_transaction_meter_value(const MeterValue& meter_value, const bool flush) {
+    const std::lock_guard<std::mutex> lk(this->pending_transaction_meter_values_mutex);
+    this->pending_transaction_meter_values.push_back(meter_value);
+
+    const auto batch_size =
+        this->device_model.get_optional_value<int>(ControllerComponentVariables::MeterValuesPersistBatchSize)
+            .value_or(1);
+    if (flush or this->pending_transaction_meter_values.size() >= static_cast<std::size_t>(std::max(batch_size, 1))) {
+        this->write_pending_transaction_meter_values();
+    }
+}
+
+void Evse::write_pending_transaction_meter_values() {
+    if (this->pending_transaction_meter_values.empty() or this->transaction == nullptr) {
+        return;
+    }
+
+    const bool compact =
+        this->device_model.get_optional_value<bool>(ControllerComponentVariables::CompactMeterValueStorage)
+            .value_or(false);
+    try {
+        this->database_handler->transaction_metervalues_insert_batch(this->transaction->transactionId.get(),
+                                                                     this->pending_transaction_meter_values, compact);
+    } catch (const QueryExecutionException& e) {
+        EVLOG_warning << "Could not insert transaction meter values of transaction: "
+                      << this->transaction->transactionId.get() << " into database: " << e.what();
+    }
+    this->pending_transaction_meter_values.clear();
+}
+
 void Evse::send_meter_value_on_pricing_trigger(const MeterValue& meter_value) {
     bool meter_value_sent = false;
     // Check if there is a kwh trigger and if the value is exceeded.
@@ -3,6 +3,10 @@
 
 #include <ocpp/v2/functional_blocks/authorization.hpp>
 
+#include <unordered_set>
+
+#include <boost/algorithm/string/case_conv.hpp>
+
 #include <ocpp/common/constants.hpp>
 #include <ocpp/common/evse_security.hpp>
 #include <ocpp/v2/connectivity_manager.hpp>
@@ -18,6 +22,11 @@
 #include <ocpp/v2/messages/SendLocalList.hpp>
 
 namespace {
+/// \brief Time the last used timestamps of the authorization cache are collected before they are written
+constexpr std::chrono::seconds AUTH_CACHE_LAST_USED_FLUSH_DELAY(10);
+/// \brief Interval of the cleanup of the authorization cache that runs without being triggered
+constexpr std::chrono::minutes AUTH_CACHE_CLEANUP_INTERVAL(15);
+
 ///
 /// \brief Check if vector of authorization data has a duplicate id token.
 /// \param list List to check.
@@ -28,7 +37,10 @@ bool has_no_token_info(const ocpp::v2::AuthorizationData& item);
 } // namespace
 
 ocpp::v2::Authorization::Authorization(const FunctionalBlockContext& context) :
-    context(context), auth_cache_cleanup_handler_running(false) {
+    context(context),
+    auth_cache_cleanup_required(false),
+    auth_cache_last_used_flush_required(false),
+    auth_cache_cleanup_handler_running(false) {
 }
 
 ocpp::v2::Authorization::~Authorization() {
@@ -350,6 +362,7 @@ ocpp::v2::Authorization::validate_token(const IdToken id_token, const std::optio
                 } else if (id_token_info.status == AuthorizationStatusEnum::Accepted) {
                     EVLOG_info << "Found valid entry in AuthCache";
                     this->context.database_handler.authorization_cache_update_last_used(hashed_id_token);
+                    this->trigger_authorization_cache_last_used_flush();
                     response.idTokenInfo = id_token_info;
                     return response;
                 } else if (this->context.device_model
@@ -417,6 +430,28 @@ void ocpp::v2::Authorization::stop_auth_cache_cleanup_thread() {
     }
 }
 
+void ocpp::v2::Authorization::trigger_authorization_cache_last_used_flush() {
+    if (!this->auth_cache_cleanup_handler_running) {
+        this->flush_authorization_cache_last_used();
+        return;
+    }
+    {
+        const std::scoped_lock lk(this->auth_cache_cleanup_mutex);
+        this->auth_cache_last_used_flush_required = true;
+    }
+    this->auth_cache_cleanup_cv.notify_one();
+}
+
+void ocpp::v2::Authorization::flush_authorization_cache_last_used() {
+    try {
+        this->context.database_handler.authorization_cache_flush_last_used();
+    } catch (const everest::db::Exception& e) {
+        EVLOG_warning << "Could not write authorization cache last used timestamps to database: " << e.what();
+    } catch (const std::exception& e) {
+        EVLOG_warning << "Could not write authorization cache last used timestamps to database: " << e.what();
+    }
+}
+
 void ocpp::v2::Authorization::handle_clear_cache_req(Call<ClearCacheRequest> call) {
     ClearCacheResponse response;
     response.status = ClearCacheStatusEnum::Rejected;
@@ -442,27 +477,56 @@ void ocpp::v2::Authorization::cache_cleanup_handler() {
     // Run the update once so the ram variable gets initialized
     this->update_authorization_cache_size();
 
+    // Absolute, so that wakeups to flush the last used timestamps do not postpone the time based cleanup
+    auto time_based_cleanup_deadline = std::chrono::steady_clock::now() + AUTH_CACHE_CLEANUP_INTERVAL;
     while (true) {
+        bool time_based_cleanup = false;
+        bool cleanup_required = false;
         {
-            // Wait for next wakeup or timeout
+            // Wait for next wakeup or the time based cleanup
             std::unique_lock lk(this->auth_cache_cleanup_mutex);
-            if (this->auth_cache_cleanup_cv.wait_for(lk, std::chrono::minutes(15), [&]() {
-                    return !this->auth_cache_cleanup_handler_running or this->auth_cache_cleanup_required;
+            if (this->auth_cache_cleanup_cv.wait_until(lk, time_based_cleanup_deadline, [&]() {
+                    return !this->auth_cache_cleanup_handler_running or this->auth_cache_cleanup_required or
+                           this->auth_cache_last_used_flush_required;
                 })) {
-                EVLOG_debug << "Triggered authorization cache cleanup";
-            } else {
+                if (!this->auth_cache_cleanup_required) {
+                    // Only last used timestamps to write, collect more of them unless a cleanup is triggered
+                    this->auth_cache_cleanup_cv.wait_for(lk, AUTH_CACHE_LAST_USED_FLUSH_DELAY, [&]() {
+                        return !this->auth_cache_cleanup_handler_running or this->auth_cache_cleanup_required;
+                    });
+                }
+                if (this->auth_cache_cleanup_required) {
+                    EVLOG_debug << "Triggered authorization cache cleanup";
+                }
+            }
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= time_based_cleanup_deadline) {
                 EVLOG_debug << "Time based authorization cache cleanup";
+                time_based_cleanup = true;
+                time_based_cleanup_deadline = now + AUTH_CACHE_CLEANUP_INTERVAL;
             }
+            cleanup_required = this->auth_cache_cleanup_required or time_based_cleanup;
             this->auth_cache_cleanup_required = false;
+            this->auth_cache_last_used_flush_required = false;
         }
 
+        this->flush_authorization_cache_last_used();
+
         if (!this->auth_cache_cleanup_handler_running) {
             break;
         }
 
+        if (!cleanup_required) {
+            continue;
+        }
+
         auto lifetime =
             this->context.device_model.get_optional_value<int>(ControllerComponentVariables::AuthCacheLifeTime);
         try {
+            if (time_based_cleanup) {
+                // Correct the deviation of the tracked size from the size of the table
+                this->context.database_handler.authorization_cache_reconcile_binary_size();
+            }
             this->context.database_handler.authorization_cache_delete_expired_entries(
                 lifetime.has_value() ? std::optional<std::chrono::seconds>(*lifetime) : std::nullopt);
 
@@ -476,9 +540,10 @@ void ocpp::v2::Authorization::cache_cleanup_handler() {
             if (meta_data.has_value()) {
                 auto max_storage = meta_data.value().characteristics.maxLimit;
                 if (max_storage.has_value()) {
-                    while (this->context.database_handler.authorization_cache_get_binary_size() >
-                           convert_to_positive_size_t(max_storage.value())) {
-                        this->context.database_handler.authorization_cache_delete_nr_of_oldest_entries(1);
+                    const auto max_binary_size = convert_to_positive_size_t(max_storage.value());
+                    if (this->context.database_handler.authorization_cache_get_binary_size() > max_binary_size) {
+                        this->context.database_handler.authorization_cache_delete_oldest_entries_exceeding(
+                            max_binary_size);
                     }
                 }
             }
@@ -608,11 +673,15 @@ ocpp::v2::Authorization::apply_local_authorization_list(const SendLocalListReque
 
 namespace {
 bool has_duplicate_in_list(const std::vector<ocpp::v2::AuthorizationData>& list) {
-    for (auto it1 = list.begin(); it1 != list.end(); ++it1) {
-        for (auto it2 = it1 + 1; it2 != list.end(); ++it2) {
-            if (it1->idToken.idToken == it2->idToken.idToken and it1->idToken.type == it2->idToken.type) {
-                return true;
-            }
+    // Tokens are case insensitive like the CiString comparison, a list can have tens of thousands of entries
+    std::unordered_set<std::string> tokens;
+    tokens.reserve(list.size());
+    for (const auto& item : list) {
+        auto token = boost::algorithm::to_upper_copy(item.idToken.type.get());
+        token += '\0';
+        token += boost::algorithm::to_upper_copy(item.idToken.idToken.get());
+        if (!tokens.insert(std::move(token)).second) {
+            return true;
         }
     }
     return false;
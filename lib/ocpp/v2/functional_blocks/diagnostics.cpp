@@ -23,18 +23,94 @@
 #include <ocpp/v2/messages/SetMonitoringLevel.hpp>
 #include <ocpp/v2/messages/SetVariableMonitoring.hpp>
 
+#include <limits>
+
 const auto DEFAULT_MAX_CUSTOMER_INFORMATION_DATA_LENGTH = 51200;
+const auto DEFAULT_NOTIFY_EVENT_COALESCING_WINDOW_MS = 0;
+const auto DEFAULT_NOTIFY_EVENT_COALESCING_MAX_EVENTS = 100;
 
 namespace ocpp::v2 {
 
+namespace {
+/// \brief Dispatches \p elements as the \p array_field of one or more \p message_type calls that are based on
+/// \p request_json. A part is completed (with tbc set to true) when the next element would exceed
+/// \p max_message_size or the part already contains \p max_elements_per_part elements. Every part contains at least
+/// one element, even if it exceeds the size bound. The size of every element is counted once, nothing is serialized
+/// before sending.
+/// \return the number of dispatched parts
+std::size_t dispatch_split_call(MessageDispatcherInterface<MessageType>& message_dispatcher,
+                                const std::string& message_type, json request_json, const std::string& array_field,
+                                std::vector<json>&& elements, const size_t max_message_size,
+                                const size_t max_elements_per_part) {
+    request_json.erase(array_field);
+
+    // Size of [MessageTypeId::CALL, "<messageId>", "<message_type>", {<request>,"<array_field>":}], the quoted field
+    // name is preceded by a comma and followed by a colon
+    const size_t skeleton_size = utils::get_json_dump_size(json{MessageTypeId::CALL, "", message_type, request_json}) +
+                                 utils::get_json_dump_size(json(array_field)) + 2;
+
+    std::int32_t sequence_num = 0;
+    std::string message_id;
+    size_t remaining_size = 0;
+    json part_json = json::array();
+    size_t part_json_size = 0;
+
+    const auto dispatch_part = [&](const bool tbc) {
+        auto part_request_json = request_json;
+        part_request_json[array_field] = std::move(part_json);
+        part_request_json["tbc"] = tbc;
+        part_request_json["seqNo"] = sequence_num;
+        message_dispatcher.dispatch_call(
+            json{MessageTypeId::CALL, message_id, message_type, std::move(part_request_json)});
+
+        part_json = json::array();
+        sequence_num++;
+    };
+
+    for (auto& element_json : elements) {
+        const auto element_json_size = utils::get_json_dump_size(element_json);
+
+        if (!part_json.empty()) {
+            // a new element will increase the payload size by its dump + 1 (caused by the separating comma)
+            if (part_json.size() < max_elements_per_part and part_json_size + element_json_size + 1 <= remaining_size) {
+                part_json_size += element_json_size + 1;
+                part_json.emplace_back(std::move(element_json));
+                continue;
+            }
+            dispatch_part(true);
+        }
+
+        message_id = ocpp::create_message_id().get();
+        const size_t base_size = skeleton_size + message_id.size();
+        remaining_size = max_message_size >= base_size ? max_message_size - base_size : 0;
+        part_json_size = element_json_size + 2; // enclosing brackets of the array
+        part_json.emplace_back(std::move(element_json));
+    }
+
+    if (!part_json.empty()) {
+        dispatch_part(false);
+    }
+
+    return static_cast<std::size_t>(sequence_num);
+}
+} // namespace
+
 Diagnostics::Diagnostics(const FunctionalBlockContext& context, AuthorizationInterface& authorization,
                          GetLogRequestCallback get_log_request_callback,
                          std::optional<GetCustomerInformationCallback> get_customer_information_callback,
                          std::optional<ClearCustomerInformationCallback> clear_customer_information_callback) :
     context(context),
     authorization(authorization),
+    notify_event_coalescer(
+        [this](std::vector<EventData>&& events) { return this->send_notify_event_req(std::move(events)); },
+        std::chrono::milliseconds(
+            context.device_model.get_optional_value<int>(ControllerComponentVariables::NotifyEventCoalescingWindow)
+                .value_or(DEFAULT_NOTIFY_EVENT_COALESCING_WINDOW_MS)),
+        context.device_model.get_optional_value<int>(ControllerComponentVariables::NotifyEventCoalescingMaxEvents)
+            .value_or(DEFAULT_NOTIFY_EVENT_COALESCING_MAX_EVENTS)),
     monitoring_updater(
-        context.device_model, [this](const std::vector<EventData>& events) { this->notify_event_req(events); },
+        context.device_model,
+        [this](std::vector<SeverityEventData>&& events) { this->notify_event_coalescer.add(std::move(events)); },
         [this]() { return !this->context.connectivity_manager.is_websocket_connected(); }),
     get_log_request_callback(get_log_request_callback),
     get_customer_information_callback(get_customer_information_callback),
@@ -72,13 +148,33 @@ void Diagnostics::handle_message(const ocpp::EnhancedMessage<MessageType>& messa
 }
 
 void Diagnostics::notify_event_req(const std::vector<EventData>& events) {
+    // Events reported by the application are not related to a monitor, they are sent before any monitoring events
+    std::vector<SeverityEventData> severity_events;
+    severity_events.reserve(events.size());
+    for (const auto& event : events) {
+        severity_events.push_back({event, MonitoringLevelSeverity::Danger});
+    }
+    this->notify_event_coalescer.add(std::move(severity_events));
+}
+
+std::size_t Diagnostics::send_notify_event_req(std::vector<EventData>&& events) {
     NotifyEventRequest req;
-    req.eventData = events;
     req.generatedAt = DateTime();
     req.seqNo = 0;
+    req.tbc = false;
 
-    const ocpp::Call<NotifyEventRequest> call(req);
-    this->context.message_dispatcher.dispatch_call(call);
+    std::vector<json> event_data_json;
+    event_data_json.reserve(events.size());
+    for (auto& event : events) {
+        event_data_json.emplace_back(std::move(event));
+    }
+
+    return dispatch_split_call(
+        this->context.message_dispatcher, conversions::messagetype_to_string(MessageType::NotifyEvent), req,
+        "eventData", std::move(event_data_json),
+        this->context.device_model.get_optional_value<size_t>(ControllerComponentVariables::MaxMessageSize)
+            .value_or(DEFAULT_MAX_MESSAGE_SIZE),
+        std::numeric_limits<size_t>::max());
 }
 
 void Diagnostics::stop_monitoring() {
@@ -93,6 +189,14 @@ void Diagnostics::process_triggered_monitors() {
     monitoring_updater.process_triggered_monitors();
 }
 
+NotifyEventCoalescerStatistics Diagnostics::get_notify_event_statistics() {
+    return notify_event_coalescer.get_statistics();
+}
+
+MonitoringStatistics Diagnostics::get_monitoring_statistics() {
+    return monitoring_updater.get_statistics();
+}
+
 void Diagnostics::notify_customer_information_req(const std::string& data, const std::int32_t request_id) {
     size_t pos = 0;
     std::int32_t seq_no = 0;
@@ -140,33 +244,24 @@ void Diagnostics::notify_monitoring_report_req(const int request_id, std::vector
         this->context.message_dispatcher.dispatch_call(call);
     } else {
         // Split for larger message sizes
-        std::int32_t sequence_num = 0;
-        auto generated_at = ocpp::DateTime();
-
-        for (std::int32_t i = 0; i < montoring_data.size(); i += MAXIMUM_VARIABLE_SEND) {
-            // If our next index is >= than the last index then we're finished
-            const bool last_part = ((i + MAXIMUM_VARIABLE_SEND) >= montoring_data.size());
-
-            NotifyMonitoringReportRequest req;
-            req.requestId = request_id;
-            req.seqNo = sequence_num;
-            req.generatedAt = generated_at;
-            req.tbc = (!last_part);
-
-            // Construct sub-message part
-            std::vector<MonitoringData> sub_data;
-
-            for (std::int32_t j = i; j < MAXIMUM_VARIABLE_SEND and j < montoring_data.size(); ++j) {
-                sub_data.push_back(std::move(montoring_data[i + j]));
-            }
-
-            req.monitor = sub_data;
-
-            const ocpp::Call<NotifyMonitoringReportRequest> call(req);
-            this->context.message_dispatcher.dispatch_call(call);
+        NotifyMonitoringReportRequest req;
+        req.requestId = request_id;
+        req.seqNo = 0;
+        req.generatedAt = ocpp::DateTime();
+        req.tbc = false;
 
-            sequence_num++;
+        std::vector<json> monitor_json;
+        monitor_json.reserve(montoring_data.size());
+        for (const auto& element : montoring_data) {
+            monitor_json.emplace_back(element);
         }
+
+        dispatch_split_call(
+            this->context.message_dispatcher, conversions::messagetype_to_string(MessageType::NotifyMonitoringReport),
+            req, "monitor", std::move(monitor_json),
+            this->context.device_model.get_optional_value<size_t>(ControllerComponentVariables::MaxMessageSize)
+                .value_or(DEFAULT_MAX_MESSAGE_SIZE),
+            MAXIMUM_VARIABLE_SEND);
     }
 }
 
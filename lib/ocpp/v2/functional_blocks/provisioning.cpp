@@ -27,7 +27,6 @@
 #include <ocpp/v2/messages/SetNetworkProfile.hpp>
 #include <ocpp/v2/messages/SetVariables.hpp>
 
-const auto DEFAULT_MAX_MESSAGE_SIZE = 65000;
 const auto DEFAULT_BOOT_NOTIFICATION_RETRY_INTERVAL = std::chrono::seconds(30);
 
 namespace ocpp::v2 {
@@ -169,6 +168,39 @@ void Provisioning::notify_report_req(const int request_id, const std::vector<Rep
     }
 }
 
+void Provisioning::notify_base_report_req(const int request_id, const ReportBaseEnum& report_base) {
+    NotifyReportRequest req;
+    req.requestId = request_id;
+    req.seqNo = 0;
+    req.generatedAt = ocpp::DateTime();
+    req.tbc = false;
+
+    // The report is streamed from the device model and every completed NotifyReport.req is queued right away, so the
+    // ReportData of the whole report is never collected. There is no backpressure: like in notify_report_req, all
+    // parts are queued at once and held by the message queue until they are sent.
+    NotifyReportRequestsSplitter splitter{
+        req,
+        this->context.device_model.get_optional_value<size_t>(ControllerComponentVariables::MaxMessageSize)
+            .value_or(DEFAULT_MAX_MESSAGE_SIZE),
+        []() { return ocpp::create_message_id(); }};
+
+    bool split = false;
+    this->context.device_model.get_base_report_data(report_base, [this, &splitter, &split](ReportData&& report_data) {
+        const auto payload = splitter.add_report_data(report_data);
+        if (payload.has_value()) {
+            split = true;
+            this->message_queue.push_call(payload.value());
+        }
+    });
+
+    if (split) {
+        this->message_queue.push_call(splitter.finalize());
+    } else {
+        // A report that fits into one NotifyReport.req is dispatched like notify_report_req dispatches it
+        this->context.message_dispatcher.dispatch_call(splitter.finalize());
+    }
+}
+
 void Provisioning::handle_boot_notification_response(CallResult<BootNotificationResponse> call_result) {
     EVLOG_info << "Received BootNotificationResponse: " << call_result.msg
                << "\nwith messageId: " << call_result.uniqueId;
@@ -284,8 +316,7 @@ void Provisioning::handle_get_base_report_req(Call<GetBaseReportRequest> call) {
     this->context.message_dispatcher.dispatch_call_result(call_result);
 
     if (response.status == GenericDeviceModelStatusEnum::Accepted) {
-        const auto report_data = this->context.device_model.get_base_report_data(msg.reportBase);
-        this->notify_report_req(msg.requestId, report_data);
+        this->notify_base_report_req(msg.requestId, msg.reportBase);
     }
 }
 
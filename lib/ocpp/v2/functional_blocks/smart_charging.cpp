@@ -3,7 +3,9 @@
 
 #include <ocpp/v2/functional_blocks/smart_charging.hpp>
 
+#include <algorithm>
 #include <optional>
+#include <thread>
 
 #include <ocpp/common/constants.hpp>
 
@@ -21,8 +23,11 @@
 #include <ocpp/v2/messages/NotifyEVChargingNeeds.hpp>
 #include <ocpp/v2/messages/ReportChargingProfiles.hpp>
 #include <ocpp/v2/messages/SetChargingProfile.hpp>
+#include <ocpp/v21/messages/UpdateDynamicSchedule.hpp>
 
 const std::int32_t STATION_WIDE_ID = 0;
+/// \brief Upper limit of the threads used to calculate the composite schedules of multiple evses
+const std::size_t MAX_COMPOSITE_SCHEDULE_WORKERS = 4;
 
 using namespace std::chrono;
 
@@ -66,6 +71,73 @@ void conform_validity_periods(ChargingProfile& profile) {
         profile.validTo = validTo;
     }
 }
+
+/// \brief Returns the part of the cached composite \p schedule that starts \p offset seconds after \p schedule_start
+/// and lasts \p duration seconds
+CompositeSchedule slice_composite_schedule(const CompositeSchedule& schedule, const DateTime& schedule_start,
+                                           const std::int32_t offset, const std::int32_t duration) {
+    CompositeSchedule result{};
+    result.evseId = schedule.evseId;
+    result.scheduleStart = DateTime(schedule_start.to_time_point() + seconds(offset));
+    result.duration = duration;
+    result.chargingRateUnit = schedule.chargingRateUnit;
+    result.chargingSchedulePeriod = slice_schedule_periods(schedule.chargingSchedulePeriod, offset, duration);
+    return result;
+}
+
+/// \brief Returns the part of the cached intermediate \p profiles of an evse that starts \p offset seconds after the
+/// start of their calculation and lasts \p duration seconds
+EvseIntermediateProfiles slice_evse_intermediate_profiles(const EvseIntermediateProfiles& profiles,
+                                                          const DateTime& /*profiles_start*/,
+                                                          const std::int32_t offset, const std::int32_t duration) {
+    EvseIntermediateProfiles result;
+    result.intermediates.reserve(profiles.intermediates.size());
+    for (const auto& intermediate : profiles.intermediates) {
+        result.intermediates.push_back(slice_schedule_periods(intermediate, offset, duration));
+    }
+    result.lowest_limits = slice_schedule_periods(profiles.lowest_limits, offset, duration);
+    return result;
+}
+
+/// \brief Returns the capacity of the cache of the intermediate profiles per evse. An evse has an entry per combination
+/// of offline and simulated transaction, and the entries calculated from older profiles are only dropped when the
+/// cache is full.
+std::size_t get_evse_intermediate_profiles_cache_capacity(const std::size_t nr_of_evses) {
+    constexpr std::size_t ENTRIES_PER_EVSE = 8;
+    return std::max(DEFAULT_COMPOSITE_SCHEDULE_CACHE_CAPACITY, (nr_of_evses + 1) * ENTRIES_PER_EVSE);
+}
+
+/// \brief A Dynamic profile starts when it is calculated, so its limits only depend on that time if its schedule has a
+/// duration or more than one period
+bool is_dynamic_schedule_time_dependent(const ChargingProfile& profile) {
+    if (profile.chargingSchedule.empty()) {
+        return false;
+    }
+    // Like the calculation, only the first schedule is used
+    const auto& schedule = profile.chargingSchedule.front();
+    return schedule.duration.has_value() or schedule.chargingSchedulePeriod.size() > 1;
+}
+
+/// \brief The device model variables read by conform_and_validate_profile
+const std::vector<ComponentVariable>& get_profile_validation_variables() {
+    static const std::vector<ComponentVariable> variables = {
+        ControllerComponentVariables::ChargingStationSupplyPhases,
+        ControllerComponentVariables::ChargingScheduleChargingRateUnit,
+        ControllerComponentVariables::ACPhaseSwitchingSupported,
+        ControllerComponentVariables::MaxExternalConstraintsId,
+        ControllerComponentVariables::SupportedAdditionalPurposes,
+        ControllerComponentVariables::SupportsDynamicProfiles,
+        ControllerComponentVariables::SupportsUseLocalTime,
+        ControllerComponentVariables::SupportsRandomizedDelay,
+        ControllerComponentVariables::SupportsLimitAtSoC,
+        ControllerComponentVariables::SupportsEvseSleep};
+    return variables;
+}
+
+/// \brief Returns the number of threads used to calculate the composite schedules of multiple evses
+std::size_t get_composite_schedule_workers() {
+    return std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, MAX_COMPOSITE_SCHEDULE_WORKERS);
+}
 } // namespace
 namespace conversions {
 std::string profile_validation_result_to_string(ProfileValidationResultEnum e) {
@@ -271,10 +343,55 @@ const std::map<OperationModeEnum, LimitsSetpointsForOperationMode> limits_setpoi
 
 SmartCharging::SmartCharging(const FunctionalBlockContext& functional_block_context,
                              std::function<void()> set_charging_profiles_callback,
-                             StopTransactionCallback stop_transaction_callback) :
+                             StopTransactionCallback stop_transaction_callback,
+                             std::optional<EffectiveLimitChangedCallback> effective_limit_changed_callback) :
     context(functional_block_context),
     set_charging_profiles_callback(set_charging_profiles_callback),
-    stop_transaction_callback(stop_transaction_callback) {
+    stop_transaction_callback(stop_transaction_callback),
+    profile_store(functional_block_context.database_handler),
+    composite_schedule_cache(slice_composite_schedule),
+    evse_intermediate_profiles_cache(
+        slice_evse_intermediate_profiles,
+        get_evse_intermediate_profiles_cache_capacity(functional_block_context.evse_manager.get_number_of_evses())),
+    composite_schedule_workers(get_composite_schedule_workers()) {
+    if (effective_limit_changed_callback.has_value()) {
+        this->effective_limit_timeline = std::make_unique<EffectiveLimitTimeline<EffectiveLimit>>(
+            [this](const std::vector<std::int32_t>& evse_ids, const std::int32_t duration) {
+                return this->calculate_effective_limit_timelines(evse_ids, duration);
+            },
+            effective_limit_changed_callback.value(), seconds(SECONDS_PER_DAY));
+    }
+}
+
+bool EffectiveLimit::operator==(const EffectiveLimit& other) const {
+    const auto fields = [](const EffectiveLimit& limit) {
+        const auto& period = limit.period;
+        return std::tie(limit.charging_rate_unit, period.limit, period.limit_L2, period.limit_L3, period.numberPhases,
+                        period.phaseToUse, period.dischargeLimit, period.dischargeLimit_L2, period.dischargeLimit_L3,
+                        period.setpoint, period.setpoint_L2, period.setpoint_L3, period.setpointReactive,
+                        period.setpointReactive_L2, period.setpointReactive_L3, period.preconditioningRequest,
+                        period.evseSleep, period.v2xBaseline, period.operationMode);
+    };
+    return fields(*this) == fields(other);
+}
+
+bool CompositeScheduleInputs::operator==(const CompositeScheduleInputs& other) const {
+    return std::tie(this->profile_generation, this->transaction_ids, this->purposes_to_ignore, this->current_limit,
+                    this->power_limit, this->default_number_phases, this->supply_voltage) ==
+           std::tie(other.profile_generation, other.transaction_ids, other.purposes_to_ignore, other.current_limit,
+                    other.power_limit, other.default_number_phases, other.supply_voltage);
+}
+
+bool EvseIntermediateProfilesInputs::operator==(const EvseIntermediateProfilesInputs& other) const {
+    return std::tie(this->purposes_to_ignore, this->ocpp_version) ==
+           std::tie(other.purposes_to_ignore, other.ocpp_version);
+}
+
+bool ProfileValidationInputs::operator==(const ProfileValidationInputs& other) const {
+    return std::tie(this->profile_generation, this->ocpp_version, this->device_model_values, this->evse_exists,
+                    this->phase_type, this->dc_input_phase_control, this->transaction_id) ==
+           std::tie(other.profile_generation, other.ocpp_version, other.device_model_values, other.evse_exists,
+                    other.phase_type, other.dc_input_phase_control, other.transaction_id);
 }
 
 void SmartCharging::handle_message(const ocpp::EnhancedMessage<MessageType>& message) {
@@ -290,6 +407,9 @@ void SmartCharging::handle_message(const ocpp::EnhancedMessage<MessageType>& mes
         this->handle_get_composite_schedule_req(json_message);
     } else if (message.messageType == MessageType::NotifyEVChargingNeedsResponse) {
         this->handle_notify_ev_charging_needs_response(message);
+    } else if (message.messageType == MessageType::UpdateDynamicSchedule and
+               this->context.ocpp_version == OcppProtocolVersion::v21) {
+        this->handle_update_dynamic_schedule_req(json_message);
     } else {
         throw MessageTypeNotImplementedException(message.messageType);
     }
@@ -362,30 +482,101 @@ bool SmartCharging::evse_has_dc_input_phase_control(const std::int32_t evse_id)
 
 std::vector<CompositeSchedule> SmartCharging::get_all_composite_schedules(const std::int32_t duration_s,
                                                                           const ChargingRateUnitEnum& unit) {
-    std::vector<CompositeSchedule> composite_schedules;
+    if (!this->get_supported_charging_rate_unit(unit).has_value()) {
+        EVLOG_warning << "Could not internally retrieve composite schedules: "
+                      << ProfileValidationResultEnum::ChargingScheduleChargingRateUnitUnsupported;
+        return {};
+    }
 
+    // get all composite schedules including the one for evse_id == 0, together so the station wide profiles are only
+    // calculated once
+    std::vector<std::int32_t> evse_ids;
     const auto number_of_evses = this->context.evse_manager.get_number_of_evses();
-    // get all composite schedules including the one for evse_id == 0
     for (std::int32_t evse_id = 0; evse_id <= number_of_evses; evse_id++) {
-        GetCompositeScheduleRequest request;
-        request.duration = duration_s;
-        request.evseId = evse_id;
-        request.chargingRateUnit = unit;
-        auto composite_schedule_response = this->get_composite_schedule_internal(request);
-        if (composite_schedule_response.status == GenericStatusEnum::Accepted and
-            composite_schedule_response.schedule.has_value()) {
-            composite_schedules.push_back(composite_schedule_response.schedule.value());
-        } else {
-            EVLOG_warning << "Could not internally retrieve composite schedule for evse id " << evse_id << ": "
-                          << composite_schedule_response;
-        }
+        evse_ids.push_back(evse_id);
     }
 
-    return composite_schedules;
+    return this->get_cached_composite_schedules(evse_ids, duration_s, unit,
+                                                !this->context.connectivity_manager.is_websocket_connected(), true);
 }
 
 void SmartCharging::delete_transaction_tx_profiles(const std::string& transaction_id) {
-    this->context.database_handler.delete_charging_profile_by_transaction_id(transaction_id);
+    this->profile_store.erase_by_transaction_id(transaction_id);
+    this->update_effective_limits(STATION_WIDE_ID);
+}
+
+bool SmartCharging::delete_charging_profile(const std::int32_t profile_id) {
+    const auto erased = this->profile_store.erase(profile_id);
+    if (erased) {
+        this->update_effective_limits(STATION_WIDE_ID);
+    }
+    return erased;
+}
+
+void SmartCharging::update_effective_limits(const std::int32_t evse_id) {
+    if (this->effective_limit_timeline == nullptr) {
+        return;
+    }
+
+    // The limits of the station as a whole depend on the limits of every evse
+    std::vector<std::int32_t> evse_ids{STATION_WIDE_ID};
+    if (evse_id == STATION_WIDE_ID) {
+        for (std::int32_t evse = 1; evse <= this->context.evse_manager.get_number_of_evses(); evse++) {
+            evse_ids.push_back(evse);
+        }
+    } else {
+        evse_ids.push_back(evse_id);
+    }
+    this->effective_limit_timeline->update(evse_ids);
+}
+
+v21::UpdateDynamicScheduleResponse
+SmartCharging::update_dynamic_schedule(const v21::UpdateDynamicScheduleRequest& request) {
+    v21::UpdateDynamicScheduleResponse response;
+    response.status = ChargingProfileStatusEnum::Rejected;
+
+    auto stored = this->profile_store.get(request.chargingProfileId);
+    if (!stored.has_value()) {
+        response.statusInfo = StatusInfo();
+        response.statusInfo->reasonCode = "InvalidValue";
+        response.statusInfo->additionalInfo = "ChargingProfileNotFound";
+        return response;
+    }
+
+    // Only the schedule changes, so validating it is sufficient
+    auto result = ProfileValidationResultEnum::ChargingProfileNotDynamic;
+    auto& profile = stored->profile;
+    if (profile.chargingProfileKind == ChargingProfileKindEnum::Dynamic) {
+        apply_charging_schedule_update(profile, request.scheduleUpdate);
+        if (stored->evse_id != STATION_WIDE_ID) {
+            auto& evse = this->context.evse_manager.get_evse(stored->evse_id);
+            result = this->validate_profile_schedules(profile, &evse);
+        } else {
+            result = this->validate_profile_schedules(profile);
+        }
+    }
+
+    if (result != ProfileValidationResultEnum::Valid) {
+        response.statusInfo = StatusInfo();
+        response.statusInfo->reasonCode = conversions::profile_validation_result_to_reason_code(result);
+        response.statusInfo->additionalInfo = conversions::profile_validation_result_to_string(result);
+        return response;
+    }
+
+    // Fails if the profile was cleared meanwhile
+    if (!this->profile_store.update_dynamic_schedule(request.chargingProfileId, request.scheduleUpdate, DateTime())
+             .has_value()) {
+        response.statusInfo = StatusInfo();
+        response.statusInfo->reasonCode = "InvalidValue";
+        response.statusInfo->additionalInfo = "ChargingProfileNotFound";
+        return response;
+    }
+
+    response.status = ChargingProfileStatusEnum::Accepted;
+    // Only the profile generation of the evse of the profile changed, so only its intermediate profiles are calculated
+    // again and the station wide limit sums them with the cached ones of the other evses
+    this->update_effective_limits(stored->evse_id);
+    return response;
 }
 
 SetChargingProfileResponse SmartCharging::conform_validate_and_add_profile(ChargingProfile& profile,
@@ -513,41 +704,6 @@ struct CompositeScheduleConfig {
             device_model.get_optional_value<int>(ControllerComponentVariables::SupplyVoltage).value_or(LOW_VOLTAGE));
     }
 };
-
-std::vector<IntermediateProfile> generate_evse_intermediates(std::vector<ChargingProfile>&& evse_profiles,
-                                                             const std::vector<ChargingProfile>& station_wide_profiles,
-                                                             const ocpp::DateTime& start_time,
-                                                             const ocpp::DateTime& end_time,
-                                                             std::optional<ocpp::DateTime> session_start,
-                                                             bool simulate_transaction_active) {
-
-    // Combine the profiles with those from the station
-    evse_profiles.insert(evse_profiles.end(), station_wide_profiles.begin(), station_wide_profiles.end());
-
-    auto external_constraints_periods =
-        calculate_all_profiles(start_time, end_time, session_start, evse_profiles,
-                               ChargingProfilePurposeEnum::ChargingStationExternalConstraints);
-
-    std::vector<IntermediateProfile> output;
-    output.push_back(generate_profile_from_periods(external_constraints_periods, start_time, end_time));
-
-    // If there is a session active or we want to simulate, add the combined tx and tx_default to the output
-    if (session_start.has_value() || simulate_transaction_active) {
-        auto tx_default_periods = calculate_all_profiles(start_time, end_time, session_start, evse_profiles,
-                                                         ChargingProfilePurposeEnum::TxDefaultProfile);
-        auto tx_periods = calculate_all_profiles(start_time, end_time, session_start, evse_profiles,
-                                                 ChargingProfilePurposeEnum::TxProfile);
-
-        auto tx_default = generate_profile_from_periods(tx_default_periods, start_time, end_time);
-        auto tx = generate_profile_from_periods(tx_periods, start_time, end_time);
-
-        // Merges the TxProfile with the TxDefaultProfile, for every period preferring a tx period over a tx_default
-        // period
-        output.push_back(merge_tx_profile_with_tx_default_profile(tx, tx_default));
-    }
-
-    return output;
-}
 } // namespace
 
 CompositeSchedule SmartCharging::calculate_composite_schedule(const ocpp::DateTime& start_time,
@@ -555,75 +711,130 @@ CompositeSchedule SmartCharging::calculate_composite_schedule(const ocpp::DateTi
                                                               const std::int32_t evse_id,
                                                               ChargingRateUnitEnum charging_rate_unit, bool is_offline,
                                                               bool simulate_transaction_active) {
+    return this
+        ->calculate_composite_schedules(start_time, end_time, {evse_id}, charging_rate_unit, is_offline,
+                                        simulate_transaction_active)
+        .front();
+}
 
-    const CompositeScheduleConfig config{this->context.device_model, is_offline};
-
-    std::optional<ocpp::DateTime> session_start{};
-    if (this->context.evse_manager.does_evse_exist(evse_id) and evse_id != 0 and
-        this->context.evse_manager.get_evse(evse_id).get_transaction() != nullptr) {
-        const auto& transaction = this->context.evse_manager.get_evse(evse_id).get_transaction();
-        session_start = transaction->start_time;
-    }
-
-    const auto station_wide_profiles = get_valid_profiles_for_evse(STATION_WIDE_ID, config.purposes_to_ignore);
-
-    std::vector<IntermediateProfile> combined_profiles{};
+std::vector<CompositeSchedule> SmartCharging::calculate_composite_schedules(
+    const ocpp::DateTime& start_time, const ocpp::DateTime& end_time, const std::vector<std::int32_t>& evse_ids,
+    ChargingRateUnitEnum charging_rate_unit, bool is_offline, bool simulate_transaction_active,
+    bool use_evse_intermediate_profiles_cache) {
 
-    if (evse_id == STATION_WIDE_ID) {
-        auto nr_of_evses = this->context.evse_manager.get_number_of_evses();
-
-        // Get the ChargingStationExternalConstraints and Combined Tx(Default)Profiles per evse
-        std::vector<IntermediateProfile> evse_schedules{};
-        for (int evse = 1; evse <= nr_of_evses; evse++) {
-            session_start.reset();
-            auto& transaction = this->context.evse_manager.get_evse(evse).get_transaction();
-            if (this->context.evse_manager.get_evse(evse).get_transaction() != nullptr) {
-                session_start = this->context.evse_manager.get_evse(evse).get_transaction()->start_time;
+    const CompositeScheduleConfig config{this->context.device_model, is_offline};
+    const CompositeScheduleParameters parameters{start_time,
+                                                 end_time,
+                                                 charging_rate_unit,
+                                                 simulate_transaction_active,
+                                                 config.current_limit,
+                                                 config.power_limit,
+                                                 config.default_number_phases,
+                                                 config.supply_voltage,
+                                                 this->context.ocpp_version};
+
+    // The profiles and session starts are collected here, so only the calculation itself runs on the workers
+    std::vector<EvseCompositeScheduleInput> evses;
+    const auto add_evse = [this, &evses](const std::int32_t evse_id) {
+        std::optional<ocpp::DateTime> session_start;
+        if (this->context.evse_manager.does_evse_exist(evse_id)) {
+            const auto& transaction = this->context.evse_manager.get_evse(evse_id).get_transaction();
+            if (transaction != nullptr) {
+                session_start = transaction->start_time;
             }
-
-            auto intermediates = generate_evse_intermediates(
-                get_valid_profiles_for_evse(evse, config.purposes_to_ignore), station_wide_profiles, start_time,
-                end_time, session_start, simulate_transaction_active);
-
-            // Determine the lowest limits per evse
-            evse_schedules.push_back(merge_profiles_by_lowest_limit(intermediates, this->context.ocpp_version));
         }
-
-        // Add all the limits of all the evse's together since that will be the max the whole charging station can
-        // consume at any point in time
-        combined_profiles.push_back(merge_profiles_by_summing_limits(evse_schedules, config.current_limit,
-                                                                     config.power_limit, this->context.ocpp_version));
-
-    } else {
-        combined_profiles = generate_evse_intermediates(get_valid_profiles_for_evse(evse_id, config.purposes_to_ignore),
-                                                        station_wide_profiles, start_time, end_time, session_start,
-                                                        simulate_transaction_active);
+        evses.push_back({evse_id, {}, session_start, std::nullopt});
+    };
+
+    const bool station_wide_requested =
+        std::find(evse_ids.begin(), evse_ids.end(), STATION_WIDE_ID) != evse_ids.end();
+    const std::int32_t nr_of_evses = clamp_to<std::int32_t>(this->context.evse_manager.get_number_of_evses());
+    if (station_wide_requested) {
+        for (std::int32_t evse = 1; evse <= nr_of_evses; evse++) {
+            add_evse(evse);
+        }
+    }
+    for (const auto evse_id : evse_ids) {
+        const bool added = station_wide_requested and evse_id >= 1 and evse_id <= nr_of_evses;
+        if (evse_id != STATION_WIDE_ID and !added and
+            std::none_of(evses.begin(), evses.end(),
+                         [evse_id](const EvseCompositeScheduleInput& input) { return input.evse_id == evse_id; })) {
+            add_evse(evse_id);
+        }
     }
 
-    // ChargingStationMaxProfile is always station wide
-    auto charge_point_max_periods = calculate_all_profiles(start_time, end_time, session_start, station_wide_profiles,
-                                                           ChargingProfilePurposeEnum::ChargingStationMaxProfile);
-    auto charge_point_max = generate_profile_from_periods(charge_point_max_periods, start_time, end_time);
-
-    // Add the ChargingStationMaxProfile limits to the other profiles
-    combined_profiles.push_back(std::move(charge_point_max));
-
-    // Calculate the final limit of all the combined profiles
-    auto retval = merge_profiles_by_lowest_limit(combined_profiles, this->context.ocpp_version);
-
-    CompositeSchedule composite{};
-    composite.evseId = evse_id;
-    composite.scheduleStart = floor_seconds(start_time);
-    composite.duration = elapsed_seconds(floor_seconds(end_time), floor_seconds(start_time));
-    composite.chargingRateUnit = charging_rate_unit;
+    const auto station_wide_profiles = this->complete_evse_inputs(parameters, config.purposes_to_ignore, is_offline,
+                                                                  use_evse_intermediate_profiles_cache, evses);
+    return ocpp::v2::calculate_composite_schedules(parameters, station_wide_profiles, evses, evse_ids,
+                                                   this->composite_schedule_workers);
+}
 
-    // Convert the intermediate result into a proper schedule. Will fill in the periods with no limits with the default
-    // one
-    const auto limit = charging_rate_unit == ChargingRateUnitEnum::A ? config.current_limit : config.power_limit;
-    composite.chargingSchedulePeriod = convert_intermediate_into_schedule(
-        retval, charging_rate_unit, limit, config.default_number_phases, config.supply_voltage);
+CompositeScheduleCacheStatistics SmartCharging::get_evse_intermediate_profiles_cache_statistics() {
+    return this->evse_intermediate_profiles_cache.get_statistics();
+}
 
-    return composite;
+std::vector<ChargingProfile>
+SmartCharging::complete_evse_inputs(const CompositeScheduleParameters& parameters,
+                                    const std::vector<ChargingProfilePurposeEnum>& purposes_to_ignore,
+                                    const bool is_offline, const bool use_cache,
+                                    std::vector<EvseCompositeScheduleInput>& evses) {
+    const EvseIntermediateProfilesInputs inputs{purposes_to_ignore, parameters.ocpp_version};
+    const auto start_time = floor_seconds(parameters.start_time);
+    const auto duration = elapsed_seconds(floor_seconds(parameters.end_time), start_time);
+    // The generations are taken before the profiles, so a concurrent change never ends up in the cache with the
+    // generation from before it
+    const auto station_wide_generation = this->profile_store.get_generation(STATION_WIDE_ID);
+    auto station_wide_profiles = get_valid_profiles_for_evse(STATION_WIDE_ID, purposes_to_ignore);
+
+    std::vector<std::size_t> missing;
+    std::vector<EvseIntermediateProfilesKey> missing_keys;
+    for (std::size_t i = 0; i < evses.size(); i++) {
+        auto& evse = evses[i];
+        if (use_cache and !this->depends_on_calculation_time(evse.evse_id)) {
+            std::string transaction_id;
+            if (this->context.evse_manager.does_evse_exist(evse.evse_id)) {
+                const auto& transaction = this->context.evse_manager.get_evse(evse.evse_id).get_transaction();
+                if (transaction != nullptr) {
+                    transaction_id = transaction->transactionId.get();
+                }
+            }
+            EvseIntermediateProfilesKey key{evse.evse_id,
+                                            is_offline,
+                                            parameters.simulate_transaction_active,
+                                            this->profile_store.get_generation(evse.evse_id),
+                                            station_wide_generation,
+                                            std::move(transaction_id),
+                                            evse.session_start};
+            evse.intermediate_profiles = this->evse_intermediate_profiles_cache.get(key, inputs, start_time, duration);
+            if (evse.intermediate_profiles.has_value()) {
+                continue;
+            }
+            missing.push_back(i);
+            missing_keys.push_back(std::move(key));
+        }
+        evse.profiles = get_valid_profiles_for_evse(evse.evse_id, purposes_to_ignore);
+    }
+    if (missing.empty()) {
+        return station_wide_profiles;
+    }
+
+    // Calculated for twice the duration, so that the following calculations within the duration only slice them
+    const auto calculated_duration = clamp_to<std::int32_t>(static_cast<std::int64_t>(duration) * 2);
+    auto calculated_parameters = parameters;
+    calculated_parameters.start_time = start_time;
+    calculated_parameters.end_time = DateTime(start_time.to_time_point() + seconds(calculated_duration));
+    std::vector<EvseIntermediateProfiles> calculated(missing.size());
+    this->composite_schedule_workers.run(missing.size(), [&](const std::size_t m) {
+        calculated[m] =
+            calculate_evse_intermediate_profiles(calculated_parameters, station_wide_profiles, evses[missing[m]]);
+    });
+    for (std::size_t m = 0; m < missing.size(); m++) {
+        evses[missing[m]].intermediate_profiles =
+            slice_evse_intermediate_profiles(calculated[m], start_time, 0, duration);
+        this->evse_intermediate_profiles_cache.put(missing_keys[m], inputs, start_time, calculated_duration,
+                                                   std::move(calculated[m]));
+    }
+    return station_wide_profiles;
 }
 
 ProfileValidationResultEnum SmartCharging::validate_evse_exists(std::int32_t evse_id) const {
@@ -704,19 +915,12 @@ ProfileValidationResultEnum SmartCharging::validate_tx_profile(const ChargingPro
 
     // K01.FR.39: There can not be a stackLevel - transactionId combination that already exists in another
     // ChargingProfile with different id.
-    auto conflicts_stmt =
-        this->context.database_handler.new_statement("SELECT PROFILE FROM CHARGING_PROFILES WHERE TRANSACTION_ID = "
-                                                     "@transaction_id AND STACK_LEVEL = @stack_level AND ID != @id");
-    conflicts_stmt->bind_int("@stack_level", profile.stackLevel);
-    conflicts_stmt->bind_int("@id", profile.id);
-    if (profile.transactionId.has_value()) {
-        conflicts_stmt->bind_text("@transaction_id", profile.transactionId.value().get(),
-                                  everest::db::sqlite::SQLiteString::Transient);
-    } else {
-        conflicts_stmt->bind_null("@transaction_id");
-    }
-
-    if (conflicts_stmt->step() == SQLITE_ROW) {
+    const auto transaction_profiles = this->profile_store.get_by_transaction_id(profile.transactionId.value().get());
+    const bool has_conflicting_stack_level =
+        std::any_of(transaction_profiles.begin(), transaction_profiles.end(), [&profile](const ChargingProfile& other) {
+            return other.stackLevel == profile.stackLevel and other.id != profile.id;
+        });
+    if (has_conflicting_stack_level) {
         return ProfileValidationResultEnum::TxProfileConflictingStackLevel;
     }
 
@@ -973,12 +1177,9 @@ SmartCharging::verify_no_conflicting_external_constraints_id(const ChargingProfi
     }
 
     auto result = ProfileValidationResultEnum::Valid;
-    auto conflicts_stmt =
-        this->context.database_handler.new_statement("SELECT PROFILE FROM CHARGING_PROFILES WHERE ID = @profile_id AND "
-                                                     "CHARGING_PROFILE_PURPOSE = 'ChargingStationExternalConstraints'");
-
-    conflicts_stmt->bind_int("@profile_id", profile.id);
-    if (conflicts_stmt->step() == SQLITE_ROW) {
+    const auto existing_profile = this->profile_store.get(profile.id);
+    if (existing_profile.has_value() and existing_profile->profile.chargingProfilePurpose ==
+                                             ChargingProfilePurposeEnum::ChargingStationExternalConstraints) {
         result = ProfileValidationResultEnum::ExistingChargingStationExternalConstraints;
     }
 
@@ -995,14 +1196,16 @@ SetChargingProfileResponse SmartCharging::add_profile(ChargingProfile& profile,
         // K01.FR.27 - add profiles to database when valid. Currently we store all profiles. For 2.1 it is allowed to
         // only store ChargingStationMaxProfile, TxDefaultProfile and PriorityCharging, but currently we store
         // everything here.
-        this->context.database_handler.insert_or_update_charging_profile(evse_id, profile, charging_limit_source);
+        this->profile_store.insert_or_update(evse_id, profile, charging_limit_source);
     } catch (const everest::db::QueryExecutionException& e) {
         EVLOG_error << "Could not store ChargingProfile in the database: " << e.what();
         response.status = ChargingProfileStatusEnum::Rejected;
         response.statusInfo = StatusInfo();
         response.statusInfo->reasonCode = "InternalError";
+        return response;
     }
 
+    this->update_effective_limits(evse_id);
     return response;
 }
 
@@ -1010,9 +1213,9 @@ ClearChargingProfileResponse SmartCharging::clear_profiles(const ClearChargingPr
     ClearChargingProfileResponse response;
     response.status = ClearChargingProfileStatusEnum::Unknown;
 
-    if (this->context.database_handler.clear_charging_profiles_matching_criteria(request.chargingProfileId,
-                                                                                 request.chargingProfileCriteria)) {
+    if (this->profile_store.clear_matching_criteria(request.chargingProfileId, request.chargingProfileCriteria)) {
         response.status = ClearChargingProfileStatusEnum::Accepted;
+        this->update_effective_limits(STATION_WIDE_ID);
     }
 
     return response;
@@ -1020,8 +1223,7 @@ ClearChargingProfileResponse SmartCharging::clear_profiles(const ClearChargingPr
 
 std::vector<ReportedChargingProfile>
 SmartCharging::get_reported_profiles(const GetChargingProfilesRequest& request) const {
-    return this->context.database_handler.get_charging_profiles_matching_criteria(request.evseId,
-                                                                                  request.chargingProfile);
+    return this->profile_store.get_matching_criteria(request.evseId, request.chargingProfile);
 }
 
 std::vector<ChargingProfile>
@@ -1268,40 +1470,91 @@ void SmartCharging::handle_get_composite_schedule_req(Call<GetCompositeScheduleR
     this->context.message_dispatcher.dispatch_call_result(call_result);
 }
 
-GetCompositeScheduleResponse SmartCharging::get_composite_schedule_internal(const GetCompositeScheduleRequest& request,
-                                                                            bool simulate_transaction_active) {
-    GetCompositeScheduleResponse response;
-    response.status = GenericStatusEnum::Rejected;
+void SmartCharging::handle_update_dynamic_schedule_req(Call<v21::UpdateDynamicScheduleRequest> call) {
+    EVLOG_debug << "Received UpdateDynamicScheduleRequest: " << call.msg << "\nwith messageId: " << call.uniqueId;
+
+    const bool is_smart_charging_available =
+        this->context.device_model.get_optional_value<bool>(ControllerComponentVariables::SmartChargingCtrlrAvailable)
+            .value_or(false);
+    if (!is_smart_charging_available) {
+        const auto call_error =
+            CallError(call.uniqueId, "NotSupported", "Charging Station does not support smart charging", json({}));
+        this->context.message_dispatcher.dispatch_call_error(call_error);
+        return;
+    }
+
+    // The effective limits are updated before responding, so the application applies the new limit without delay
+    const auto response = this->update_dynamic_schedule(call.msg);
+    if (response.status == ChargingProfileStatusEnum::Accepted) {
+        this->set_charging_profiles_callback();
+    }
+
+    const ocpp::CallResult<v21::UpdateDynamicScheduleResponse> call_result(response, call.uniqueId);
+    this->context.message_dispatcher.dispatch_call_result(call_result);
+}
 
+std::vector<std::vector<EffectiveLimitTimelineEntry<EffectiveLimit>>>
+SmartCharging::calculate_effective_limit_timelines(const std::vector<std::int32_t>& evse_ids,
+                                                   const std::int32_t duration) {
+    std::vector<std::vector<EffectiveLimitTimelineEntry<EffectiveLimit>>> timelines(evse_ids.size());
+    const auto charging_rate_unit = this->get_supported_charging_rate_unit(std::nullopt);
+    if (!charging_rate_unit.has_value()) {
+        return timelines;
+    }
+
+    // Tx(Default)Profiles only apply to evses with a transaction, like the limits the evses have to apply right now
+    const auto schedules = this->get_cached_composite_schedules(
+        evse_ids, duration, charging_rate_unit.value(), !this->context.connectivity_manager.is_websocket_connected(),
+        false);
+    for (std::size_t i = 0; i < schedules.size(); i++) {
+        const auto& schedule = schedules[i];
+        for (const auto& period : schedule.chargingSchedulePeriod) {
+            EffectiveLimit limit{schedule.chargingRateUnit, period};
+            limit.period.startPeriod = 0;
+            timelines[i].push_back(
+                {DateTime(schedule.scheduleStart.to_time_point() + seconds(period.startPeriod)), std::move(limit)});
+        }
+    }
+    return timelines;
+}
+
+std::optional<ChargingRateUnitEnum>
+SmartCharging::get_supported_charging_rate_unit(const std::optional<ChargingRateUnitEnum>& requested_unit) const {
     std::vector<std::string> supported_charging_rate_units =
         ocpp::split_string(this->context.device_model.get_value<std::string>(
                                ControllerComponentVariables::ChargingScheduleChargingRateUnit),
                            ',', true);
 
     std::optional<ChargingRateUnitEnum> charging_rate_unit = std::nullopt;
-    if (request.chargingRateUnit.has_value()) {
-        const bool unit_supported = std::any_of(
-            supported_charging_rate_units.begin(), supported_charging_rate_units.end(), [&request](std::string item) {
-                return conversions::string_to_charging_rate_unit_enum(item) == request.chargingRateUnit.value();
-            });
+    if (requested_unit.has_value()) {
+        const bool unit_supported =
+            std::any_of(supported_charging_rate_units.begin(), supported_charging_rate_units.end(),
+                        [&requested_unit](std::string item) {
+                            return conversions::string_to_charging_rate_unit_enum(item) == requested_unit.value();
+                        });
 
         if (unit_supported) {
-            charging_rate_unit = request.chargingRateUnit;
+            charging_rate_unit = requested_unit;
         }
     } else if (!supported_charging_rate_units.empty()) {
         charging_rate_unit = conversions::string_to_charging_rate_unit_enum(supported_charging_rate_units.at(0));
     }
+    return charging_rate_unit;
+}
+
+GetCompositeScheduleResponse SmartCharging::get_composite_schedule_internal(const GetCompositeScheduleRequest& request,
+                                                                            bool simulate_transaction_active) {
+    GetCompositeScheduleResponse response;
+    response.status = GenericStatusEnum::Rejected;
+
+    const auto charging_rate_unit = this->get_supported_charging_rate_unit(request.chargingRateUnit);
 
     // K01.FR.05 & K01.FR.07
     if (this->context.evse_manager.does_evse_exist(request.evseId) and charging_rate_unit.has_value()) {
-        auto start_time = ocpp::DateTime();
-        auto end_time = ocpp::DateTime(start_time.to_time_point() + std::chrono::seconds(request.duration));
-
-        auto schedule = this->calculate_composite_schedule(
-            start_time, end_time, request.evseId, charging_rate_unit.value(),
+        auto schedules = this->get_cached_composite_schedules(
+            {request.evseId}, request.duration, charging_rate_unit.value(),
             !this->context.connectivity_manager.is_websocket_connected(), simulate_transaction_active);
-
-        response.schedule = schedule;
+        response.schedule = std::move(schedules.front());
         response.status = GenericStatusEnum::Accepted;
     } else {
         auto reason = charging_rate_unit.has_value()
@@ -1316,6 +1569,92 @@ GetCompositeScheduleResponse SmartCharging::get_composite_schedule_internal(cons
     return response;
 }
 
+std::vector<CompositeSchedule>
+SmartCharging::get_cached_composite_schedules(const std::vector<std::int32_t>& evse_ids, const std::int32_t duration,
+                                              const ChargingRateUnitEnum charging_rate_unit, const bool is_offline,
+                                              const bool simulate_transaction_active) {
+    const CompositeScheduleConfig config{this->context.device_model, is_offline};
+    CompositeScheduleInputs inputs{this->profile_store.get_generation(),
+                                   {},
+                                   config.purposes_to_ignore,
+                                   config.current_limit,
+                                   config.power_limit,
+                                   config.default_number_phases,
+                                   config.supply_voltage};
+    const auto nr_of_evses = this->context.evse_manager.get_number_of_evses();
+    for (int evse = 1; evse <= nr_of_evses; evse++) {
+        const auto& transaction = this->context.evse_manager.get_evse(evse).get_transaction();
+        inputs.transaction_ids.push_back(transaction != nullptr ? transaction->transactionId.get() : std::string{});
+    }
+
+    const auto start_time = floor_seconds(ocpp::DateTime());
+    const auto get_key = [&](const std::int32_t evse_id) {
+        return CompositeScheduleKey{evse_id, charging_rate_unit, duration, is_offline, simulate_transaction_active};
+    };
+
+    std::vector<CompositeSchedule> composite_schedules(evse_ids.size());
+    std::vector<std::size_t> missing;
+    for (std::size_t i = 0; i < evse_ids.size(); i++) {
+        auto cached = this->composite_schedule_cache.get(get_key(evse_ids[i]), inputs, start_time, duration);
+        if (cached.has_value()) {
+            composite_schedules[i] = std::move(cached.value());
+        } else {
+            missing.push_back(i);
+        }
+    }
+    if (missing.empty()) {
+        return composite_schedules;
+    }
+
+    std::vector<std::int32_t> missing_evse_ids;
+    bool cacheable = true;
+    for (const auto i : missing) {
+        missing_evse_ids.push_back(evse_ids[i]);
+        cacheable = cacheable and !this->depends_on_calculation_time(evse_ids[i]);
+    }
+
+    // Calculated for twice the duration, so that the following requests within the duration are answered by slicing it
+    const auto calculated_duration =
+        cacheable ? clamp_to<std::int32_t>(static_cast<std::int64_t>(duration) * 2) : duration;
+    const DateTime end_time(start_time.to_time_point() + seconds(calculated_duration));
+    auto calculated = this->calculate_composite_schedules(start_time, end_time, missing_evse_ids, charging_rate_unit,
+                                                          is_offline, simulate_transaction_active, true);
+    for (std::size_t m = 0; m < missing.size(); m++) {
+        auto& schedule = calculated[m];
+        composite_schedules[missing[m]] = slice_composite_schedule(schedule, start_time, 0, duration);
+        if (cacheable) {
+            this->composite_schedule_cache.put(get_key(missing_evse_ids[m]), inputs, start_time, calculated_duration,
+                                               std::move(schedule));
+        }
+    }
+    return composite_schedules;
+}
+
+bool SmartCharging::depends_on_calculation_time(const std::int32_t evse_id) {
+    std::vector<std::int32_t> evse_ids{STATION_WIDE_ID};
+    if (evse_id == STATION_WIDE_ID) {
+        for (int evse = 1; evse <= this->context.evse_manager.get_number_of_evses(); evse++) {
+            evse_ids.push_back(evse);
+        }
+    } else {
+        evse_ids.push_back(evse_id);
+    }
+
+    // Relative profiles start when the transaction started, or now if there is none
+    const bool has_transaction = evse_id != STATION_WIDE_ID and this->context.evse_manager.does_evse_exist(evse_id) and
+                                 this->context.evse_manager.get_evse(evse_id).get_transaction() != nullptr;
+    for (const auto id : evse_ids) {
+        for (const auto& profile : this->profile_store.get_for_evse(id)) {
+            if ((profile.chargingProfileKind == ChargingProfileKindEnum::Dynamic and
+                 is_dynamic_schedule_time_dependent(profile)) or
+                (profile.chargingProfileKind == ChargingProfileKindEnum::Relative and !has_transaction)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 bool SmartCharging::is_overlapping_validity_period(const ChargingProfile& candidate_profile,
                                                    std::int32_t candidate_evse_id) const {
     if (candidate_profile.chargingProfilePurpose == ChargingProfilePurposeEnum::TxProfile) {
@@ -1323,18 +1662,13 @@ bool SmartCharging::is_overlapping_validity_period(const ChargingProfile& candid
         return false;
     }
 
-    auto overlap_stmt = this->context.database_handler.new_statement(
-        "SELECT PROFILE FROM CHARGING_PROFILES WHERE CHARGING_PROFILE_PURPOSE = @purpose AND EVSE_ID = "
-        "@evse_id AND ID != @profile_id AND CHARGING_PROFILES.STACK_LEVEL = @stack_level");
-
-    overlap_stmt->bind_int("@evse_id", candidate_evse_id);
-    overlap_stmt->bind_int("@profile_id", candidate_profile.id);
-    overlap_stmt->bind_int("@stack_level", candidate_profile.stackLevel);
-    overlap_stmt->bind_text(
-        "@purpose", conversions::charging_profile_purpose_enum_to_string(candidate_profile.chargingProfilePurpose),
-        everest::db::sqlite::SQLiteString::Transient);
-    while (overlap_stmt->step() != SQLITE_DONE) {
-        const ChargingProfile existing_profile = json::parse(overlap_stmt->column_text(0));
+    const auto existing_profiles = this->profile_store.get_by_purpose(candidate_profile.chargingProfilePurpose,
+                                                                      candidate_evse_id, candidate_profile.stackLevel);
+    for (const auto& existing : existing_profiles) {
+        const auto& existing_profile = existing.profile;
+        if (existing_profile.id == candidate_profile.id) {
+            continue;
+        }
         if (candidate_profile.validFrom <= existing_profile.validTo &&
             candidate_profile.validTo >= existing_profile.validFrom) {
             return true;
@@ -1347,12 +1681,10 @@ bool SmartCharging::is_overlapping_validity_period(const ChargingProfile& candid
 std::vector<ChargingProfile> SmartCharging::get_evse_specific_tx_default_profiles() const {
     std::vector<ChargingProfile> evse_specific_tx_default_profiles;
 
-    auto stmt =
-        this->context.database_handler.new_statement("SELECT PROFILE FROM CHARGING_PROFILES WHERE "
-                                                     "EVSE_ID != 0 AND CHARGING_PROFILE_PURPOSE = 'TxDefaultProfile'");
-    while (stmt->step() != SQLITE_DONE) {
-        const ChargingProfile profile = json::parse(stmt->column_text(0));
-        evse_specific_tx_default_profiles.push_back(profile);
+    for (auto& stored : this->profile_store.get_by_purpose(ChargingProfilePurposeEnum::TxDefaultProfile)) {
+        if (stored.evse_id != STATION_WIDE_ID) {
+            evse_specific_tx_default_profiles.push_back(std::move(stored.profile));
+        }
     }
 
     return evse_specific_tx_default_profiles;
@@ -1361,11 +1693,9 @@ std::vector<ChargingProfile> SmartCharging::get_evse_specific_tx_default_profile
 std::vector<ChargingProfile> SmartCharging::get_station_wide_tx_default_profiles() const {
     std::vector<ChargingProfile> station_wide_tx_default_profiles;
 
-    auto stmt = this->context.database_handler.new_statement(
-        "SELECT PROFILE FROM CHARGING_PROFILES WHERE EVSE_ID = 0 AND CHARGING_PROFILE_PURPOSE = 'TxDefaultProfile'");
-    while (stmt->step() != SQLITE_DONE) {
-        const ChargingProfile profile = json::parse(stmt->column_text(0));
-        station_wide_tx_default_profiles.push_back(profile);
+    for (auto& stored :
+         this->profile_store.get_by_purpose(ChargingProfilePurposeEnum::TxDefaultProfile, STATION_WIDE_ID)) {
+        station_wide_tx_default_profiles.push_back(std::move(stored.profile));
     }
 
     return station_wide_tx_default_profiles;
@@ -1373,12 +1703,10 @@ std::vector<ChargingProfile> SmartCharging::get_station_wide_tx_default_profiles
 
 std::vector<ChargingProfile> SmartCharging::get_charging_station_max_profiles() const {
     std::vector<ChargingProfile> charging_station_max_profiles;
-    auto stmt =
-        this->context.database_handler.new_statement("SELECT PROFILE FROM CHARGING_PROFILES WHERE EVSE_ID = 0 AND "
-                                                     "CHARGING_PROFILE_PURPOSE = 'ChargingStationMaxProfile'");
-    while (stmt->step() != SQLITE_DONE) {
-        const ChargingProfile profile = json::parse(stmt->column_text(0));
-        charging_station_max_profiles.push_back(profile);
+
+    for (auto& stored :
+         this->profile_store.get_by_purpose(ChargingProfilePurposeEnum::ChargingStationMaxProfile, STATION_WIDE_ID)) {
+        charging_station_max_profiles.push_back(std::move(stored.profile));
     }
 
     return charging_station_max_profiles;
@@ -1387,13 +1715,25 @@ std::vector<ChargingProfile> SmartCharging::get_charging_station_max_profiles()
 std::vector<ChargingProfile>
 SmartCharging::get_valid_profiles_for_evse(std::int32_t evse_id,
                                            const std::vector<ChargingProfilePurposeEnum>& purposes_to_ignore) {
-    std::vector<ChargingProfile> valid_profiles;
+    // Read before the profiles, so a profile that is added meanwhile invalidates the result
+    auto inputs = this->get_profile_validation_inputs(evse_id);
+
+    std::lock_guard<std::mutex> lock(this->validated_profiles_mutex);
+    auto it = this->validated_profiles.find(evse_id);
+    if (it == this->validated_profiles.end() or !(it->second.inputs == inputs)) {
+        ValidatedProfiles validated{std::move(inputs), {}};
+        for (auto& profile : this->profile_store.get_for_evse(evse_id)) {
+            if (this->conform_and_validate_profile(profile, evse_id) == ProfileValidationResultEnum::Valid) {
+                validated.profiles.push_back(std::move(profile));
+            }
+        }
+        it = this->validated_profiles.insert_or_assign(evse_id, std::move(validated)).first;
+    }
 
-    auto evse_profiles = this->context.database_handler.get_charging_profiles_for_evse(evse_id);
-    for (auto profile : evse_profiles) {
-        if (this->conform_and_validate_profile(profile, evse_id) == ProfileValidationResultEnum::Valid and
-            std::find(std::begin(purposes_to_ignore), std::end(purposes_to_ignore), profile.chargingProfilePurpose) ==
-                std::end(purposes_to_ignore)) {
+    std::vector<ChargingProfile> valid_profiles;
+    for (const auto& profile : it->second.profiles) {
+        if (std::find(std::begin(purposes_to_ignore), std::end(purposes_to_ignore), profile.chargingProfilePurpose) ==
+            std::end(purposes_to_ignore)) {
             valid_profiles.push_back(profile);
         }
     }
@@ -1401,6 +1741,35 @@ SmartCharging::get_valid_profiles_for_evse(std::int32_t evse_id,
     return valid_profiles;
 }
 
+ProfileValidationInputs SmartCharging::get_profile_validation_inputs(const std::int32_t evse_id) const {
+    ProfileValidationInputs inputs{};
+    inputs.profile_generation = this->profile_store.get_generation();
+    inputs.ocpp_version = this->context.ocpp_version;
+    for (const auto& component_variable : get_profile_validation_variables()) {
+        inputs.device_model_values.push_back(
+            this->context.device_model.get_optional_value<std::string>(component_variable));
+    }
+
+    inputs.evse_exists = evse_id == STATION_WIDE_ID or this->context.evse_manager.does_evse_exist(evse_id);
+    if (!inputs.evse_exists) {
+        // The validation fails before anything else is checked
+        return inputs;
+    }
+
+    if (evse_id == STATION_WIDE_ID) {
+        inputs.phase_type = this->get_current_phase_type(std::nullopt);
+    } else {
+        auto& evse = this->context.evse_manager.get_evse(evse_id);
+        inputs.phase_type = evse.get_current_phase_type();
+        if (evse.has_active_transaction()) {
+            const auto& transaction = evse.get_transaction();
+            inputs.transaction_id = transaction != nullptr ? transaction->transactionId.get() : std::string{};
+        }
+    }
+    inputs.dc_input_phase_control = this->has_dc_input_phase_control(evse_id);
+    return inputs;
+}
+
 CurrentPhaseType SmartCharging::get_current_phase_type(const std::optional<EvseInterface*> evse_opt) const {
     if (evse_opt.has_value()) {
         return evse_opt.value()->get_current_phase_type();
@@ -72,6 +72,7 @@ void TransactionBlock::on_transaction_started(const std::int32_t evse_id, const
     transaction.chargingState = charging_state;
     transaction.remoteStartId = remote_start_id;
     enhanced_transaction->remoteStartId = remote_start_id;
+    this->smart_charging.update_effective_limits(evse_id);
 
     EVSE evse{evse_id};
     evse.connectorId.emplace(connector_id);
@@ -137,6 +138,7 @@ void TransactionBlock::on_transaction_finished(const std::int32_t evse_id, const
     // K02.FR.05 The transaction is over, so delete the TxProfiles associated with the transaction.
     smart_charging.delete_transaction_tx_profiles(enhanced_transaction->get_transaction().transactionId);
     evse_handle.release_transaction();
+    smart_charging.update_effective_limits(evse_id);
 
     bool send_reset = false;
     if (this->reset_scheduled) {
@@ -3,13 +3,18 @@
 
 #include <ocpp/v2/init_device_model_db.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <fstream>
+#include <future>
+#include <iterator>
 #include <map>
 #include <string>
+#include <thread>
 
 #include <everest/logging.hpp>
 #include <ocpp/v2/enums.hpp>
+#include <ocpp/v2/utils.hpp>
 
 const static std::string STANDARDIZED_COMPONENT_CONFIG_DIR = "standardized";
 const static std::string CUSTOM_COMPONENT_CONFIG_DIR = "custom";
@@ -78,25 +83,43 @@ void InitDeviceModelDb::initialize_database(
     const std::map<ComponentKey, std::vector<DeviceModelVariable>>& component_configs,
     bool delete_db_if_exists = true) {
     execute_init_sql(delete_db_if_exists);
+    apply_component_configs(component_configs, std::nullopt);
+}
 
-    // Get existing components from the database.
-    std::map<ComponentKey, std::vector<DeviceModelVariable>> existing_components;
-    if (this->database_exists) {
-        existing_components = get_all_components_from_db();
+void InitDeviceModelDb::initialize_database(const std::filesystem::path& config_path, bool delete_db_if_exists) {
+    execute_init_sql(delete_db_if_exists);
+
+    const std::string fingerprint = get_component_config_fingerprint(config_path);
+    if (this->database_exists && get_component_config_fingerprint_from_db() == fingerprint) {
+        EVLOG_info << "Component config did not change, device model database is up to date";
+        return;
     }
 
+    apply_component_configs(get_all_component_configs(config_path), fingerprint);
+}
+
+void InitDeviceModelDb::apply_component_configs(
+    const std::map<ComponentKey, std::vector<DeviceModelVariable>>& component_configs,
+    const std::optional<std::string>& fingerprint) {
     // Check if the config is consistent.
     check_integrity(component_configs);
 
-    // Remove components from db if they do not exist in the component config
+    // Starting a transaction makes this a lot faster (inserting all components takes a few seconds without it and a
+    // few milliseconds if it is done inside a transaction). Everything is done in the same transaction, so the
+    // database is never left half updated.
+    std::unique_ptr<TransactionInterface> transaction = database->begin_transaction();
+
+    // Get existing components from the database.
+    std::map<ComponentKey, std::vector<DeviceModelVariable>> existing_components;
     if (this->database_exists) {
+        existing_components = get_all_components_from_db();
+
+        // Remove components from db if they do not exist in the component config
         remove_not_existing_components_from_db(component_configs, existing_components);
     }
 
-    // Starting a transaction makes this a lot faster (inserting all components takes a few seconds without it and a
-    // few milliseconds if it is done inside a transaction).
-    std::unique_ptr<TransactionInterface> transaction = database->begin_transaction();
     insert_components(component_configs, existing_components);
+    set_component_config_fingerprint(fingerprint);
     transaction->commit();
 }
 
@@ -159,35 +182,92 @@ std::vector<DeviceModelVariable> get_all_component_properties(const json& compon
     return variables;
 }
 
+///
+/// \brief Read a single component config file.
+/// \param path The path to the component config file.
+/// \return The component with its variables, characteristics and attributes or std::nullopt if the component does not
+///         contain any properties.
+///
+std::optional<std::pair<ComponentKey, std::vector<DeviceModelVariable>>>
+read_component_config_file(const std::filesystem::path& path) {
+    std::ifstream config_file(path);
+    try {
+        json data = json::parse(config_file);
+        const ComponentKey p = data;
+        if (!data.contains("properties")) {
+            EVLOG_warning << "Component " << data.at("name") << " does not contain any properties";
+            return std::nullopt;
+        }
+        return std::make_pair(p, get_all_component_properties(data.at("properties")));
+    } catch (const json::parse_error& e) {
+        EVLOG_error << "Error while parsing config file: " << path;
+        throw;
+    }
+}
+
 ///
 /// \brief Read component config from given files.
+///
+/// The files are parsed in parallel, but the components are added to the map in the order of the given paths.
+///
 /// \param components_config_path   The paths to the component config files.
 /// \return A map holding the components with its variables, characteristics and attributes.
 ///
 std::map<ComponentKey, std::vector<DeviceModelVariable>>
 read_component_config(const std::vector<std::filesystem::path>& components_config_path) {
-    std::map<ComponentKey, std::vector<DeviceModelVariable>> components;
-    for (const auto& path : components_config_path) {
-        std::ifstream config_file(path);
-        try {
-            json data = json::parse(config_file);
-            const ComponentKey p = data;
-            if (data.contains("properties")) {
-                const std::vector<DeviceModelVariable> variables = get_all_component_properties(data.at("properties"));
-                components.insert({p, variables});
-            } else {
-                EVLOG_warning << "Component " << data.at("name") << " does not contain any properties";
-                continue;
+    using ComponentConfig = std::optional<std::pair<ComponentKey, std::vector<DeviceModelVariable>>>;
+
+    const std::size_t nr_of_files = components_config_path.size();
+    const std::size_t nr_of_workers =
+        std::max<std::size_t>(1, std::min<std::size_t>(std::thread::hardware_concurrency(), nr_of_files));
+
+    std::vector<ComponentConfig> component_configs(nr_of_files);
+    std::vector<std::future<void>> workers;
+    workers.reserve(nr_of_workers);
+    for (std::size_t worker = 0; worker < nr_of_workers; worker++) {
+        workers.push_back(std::async(std::launch::async, [&, worker]() {
+            for (std::size_t i = worker; i < nr_of_files; i += nr_of_workers) {
+                component_configs[i] = read_component_config_file(components_config_path[i]);
             }
-        } catch (const json::parse_error& e) {
-            EVLOG_error << "Error while parsing config file: " << path;
-            throw;
+        }));
+    }
+
+    // Wait for all workers before rethrowing a possible parse error, as they reference the local vectors.
+    for (auto& worker : workers) {
+        worker.wait();
+    }
+    for (auto& worker : workers) {
+        worker.get();
+    }
+
+    std::map<ComponentKey, std::vector<DeviceModelVariable>> components;
+    for (auto& component_config : component_configs) {
+        if (component_config.has_value()) {
+            components.insert(std::move(component_config.value()));
         }
     }
 
     return components;
 }
 
+///
+/// \brief Append the name and content of the given component config files to the fingerprint input.
+/// \param files    The component config files.
+/// \param prefix   Prefix to add to the file names, to distinguish standardized from custom component configs.
+/// \param input    The fingerprint input to append to.
+///
+void append_fingerprint_input(std::vector<std::filesystem::path> files, const std::string& prefix, std::string& input) {
+    // The directory iterator order is unspecified, sort to get a stable fingerprint.
+    std::sort(files.begin(), files.end());
+    for (const auto& file : files) {
+        std::ifstream config_file(file, std::ios::binary);
+        const std::string content{std::istreambuf_iterator<char>(config_file), std::istreambuf_iterator<char>()};
+        input.append(prefix).append(file.filename().string()).push_back('\n');
+        input.append(std::to_string(content.size())).push_back('\n');
+        input.append(content);
+    }
+}
+
 } // namespace
 
 std::map<ComponentKey, std::vector<DeviceModelVariable>>
@@ -217,6 +297,22 @@ get_all_component_configs(const std::filesystem::path& directory) {
     return components;
 }
 
+std::string get_component_config_fingerprint(const std::filesystem::path& directory) {
+    const auto standardized_dir = directory / STANDARDIZED_COMPONENT_CONFIG_DIR;
+    const auto custom_dir = directory / CUSTOM_COMPONENT_CONFIG_DIR;
+
+    // Include the database version, so the component config is applied again after a migration.
+    std::string input = std::to_string(MIGRATION_DEVICE_MODEL_FILE_VERSION_V2) + "\n";
+    append_fingerprint_input(get_component_config_from_directory(standardized_dir),
+                             STANDARDIZED_COMPONENT_CONFIG_DIR + "/", input);
+    if (std::filesystem::exists(custom_dir)) {
+        append_fingerprint_input(get_component_config_from_directory(custom_dir), CUSTOM_COMPONENT_CONFIG_DIR + "/",
+                                 input);
+    }
+
+    return utils::sha256(input);
+}
+
 void InitDeviceModelDb::insert_components(
     const std::map<ComponentKey, std::vector<DeviceModelVariable>>& components,
     const std::map<ComponentKey, std::vector<DeviceModelVariable>>& existing_components) {
@@ -1169,6 +1265,53 @@ std::vector<VariableMonitoringMeta> InitDeviceModelDb::get_variable_monitors_fro
     return monitors;
 }
 
+std::optional<std::string> InitDeviceModelDb::get_component_config_fingerprint_from_db() {
+    static const std::string select_fingerprint_statement =
+        "SELECT FINGERPRINT FROM COMPONENT_CONFIG_FINGERPRINT WHERE ID = 1";
+
+    std::unique_ptr<StatementInterface> select_statement;
+    try {
+        select_statement = this->database->new_statement(select_fingerprint_statement);
+    } catch (const QueryExecutionException&) {
+        throw InitDeviceModelDbError("Could not create statement " + select_fingerprint_statement);
+    }
+
+    const int status = select_statement->step();
+    if (status == SQLITE_DONE) {
+        return std::nullopt;
+    }
+    if (status != SQLITE_ROW) {
+        throw InitDeviceModelDbError("Could not get component config fingerprint from db: " +
+                                     std::string(this->database->get_error_message()));
+    }
+
+    return select_statement->column_text(0);
+}
+
+void InitDeviceModelDb::set_component_config_fingerprint(const std::optional<std::string>& fingerprint) {
+    static const std::string insert_fingerprint_statement =
+        "INSERT OR REPLACE INTO COMPONENT_CONFIG_FINGERPRINT (ID, FINGERPRINT) VALUES (1, @fingerprint)";
+    static const std::string delete_fingerprint_statement = "DELETE FROM COMPONENT_CONFIG_FINGERPRINT";
+
+    const std::string& statement =
+        fingerprint.has_value() ? insert_fingerprint_statement : delete_fingerprint_statement;
+    std::unique_ptr<StatementInterface> fingerprint_statement;
+    try {
+        fingerprint_statement = this->database->new_statement(statement);
+    } catch (const QueryExecutionException&) {
+        throw InitDeviceModelDbError("Could not create statement " + statement);
+    }
+
+    if (fingerprint.has_value()) {
+        fingerprint_statement->bind_text("@fingerprint", fingerprint.value(), SQLiteString::Transient);
+    }
+
+    if (fingerprint_statement->step() != SQLITE_DONE) {
+        throw InitDeviceModelDbError("Could not store component config fingerprint: " +
+                                     std::string(this->database->get_error_message()));
+    }
+}
+
 void InitDeviceModelDb::init_sql() {
     static const std::string foreign_keys_on_statement = "PRAGMA foreign_keys = ON;";
 
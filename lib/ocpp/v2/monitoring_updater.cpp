@@ -3,7 +3,10 @@
 
 #include <ocpp/v2/monitoring_updater.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <limits>
 
 #include <ocpp/v2/ctrlr_component_variables.hpp>
 #include <ocpp/v2/device_model.hpp>
@@ -132,15 +135,94 @@ EventData create_notify_event(std::int32_t unique_id, const std::string& reporte
 
     return notify_event;
 }
+
+bool is_periodic_monitor(const VariableMonitoringMeta& monitor_meta) {
+    return monitor_meta.monitor.type == MonitorEnum::Periodic ||
+           monitor_meta.monitor.type == MonitorEnum::PeriodicClockAligned;
+}
 } // namespace
 
+VariableMonitorEvaluation
+create_monitor_evaluation(const std::unordered_map<std::int64_t, VariableMonitoringMeta>& monitors,
+                          const VariableCharacteristics& characteristics) {
+    VariableMonitorEvaluation evaluation;
+    evaluation.nr_of_monitors = monitors.size();
+    evaluation.is_numeric =
+        characteristics.dataType == DataEnum::decimal || characteristics.dataType == DataEnum::integer;
+
+    for (const auto& [id, monitor_meta] : monitors) {
+        const auto& monitor = monitor_meta.monitor;
+        if (monitor.type != MonitorEnum::Delta && monitor.type != MonitorEnum::LowerThreshold &&
+            monitor.type != MonitorEnum::UpperThreshold) {
+            continue;
+        }
+
+        double reference = 0.0;
+        if (evaluation.is_numeric && monitor.type == MonitorEnum::Delta) {
+            reference = std::numeric_limits<double>::quiet_NaN();
+            if (monitor_meta.reference_value.has_value()) {
+                reference = characteristics.dataType == DataEnum::decimal
+                                ? to_specific_type_auto<DataEnum::decimal>(monitor_meta.reference_value.value())
+                                : to_specific_type_auto<DataEnum::integer>(monitor_meta.reference_value.value());
+            } else {
+                EVLOG_error << "Invalid reference value for monitor: " << monitor;
+            }
+        }
+
+        evaluation.monitor_ids.push_back(monitor.id);
+        if (monitor.type == MonitorEnum::UpperThreshold) {
+            evaluation.threshold_factors.push_back(1.0);
+        } else if (monitor.type == MonitorEnum::LowerThreshold) {
+            evaluation.threshold_factors.push_back(-1.0);
+        } else {
+            evaluation.threshold_factors.push_back(0.0);
+        }
+        evaluation.delta_factors.push_back(monitor.type == MonitorEnum::Delta ? 1.0 : 0.0);
+        evaluation.values.push_back(monitor.value);
+        evaluation.references.push_back(reference);
+    }
+    evaluation.triggered.resize(evaluation.monitor_ids.size());
+
+    return evaluation;
+}
+
+void evaluate_monitors(VariableMonitorEvaluation& evaluation, const DataEnum data_type,
+                       const std::string& value_previous, const std::string& value_current) {
+    const auto nr_of_monitors = evaluation.monitor_ids.size();
+
+    // N07.FR.19 - Non numeric values trigger on every change, regardless of the monitor
+    if (!evaluation.is_numeric) {
+        std::fill_n(evaluation.triggered.data(), nr_of_monitors, value_previous != value_current);
+        return;
+    }
+
+    const double value = data_type == DataEnum::decimal ? to_specific_type_auto<DataEnum::decimal>(value_current)
+                                                        : to_specific_type_auto<DataEnum::integer>(value_current);
+
+    const double* threshold_factors = evaluation.threshold_factors.data();
+    const double* delta_factors = evaluation.delta_factors.data();
+    const double* values = evaluation.values.data();
+    const double* references = evaluation.references.data();
+    std::uint8_t* triggered = evaluation.triggered.data();
+
+    // UpperThreshold: value - threshold > 0, LowerThreshold: threshold - value > 0 and
+    // Delta: |reference - value| - delta > 0. The factors select the term that applies to a monitor
+    for (std::size_t i = 0; i < nr_of_monitors; i++) {
+        const double distance = threshold_factors[i] * (value - values[i]) +
+                                delta_factors[i] * (std::abs(references[i] - value) - values[i]);
+        triggered[i] = static_cast<std::uint8_t>(distance > 0.0);
+    }
+}
+
 MonitoringUpdater::MonitoringUpdater(DeviceModel& device_model, notify_events notify_csms_events,
                                      is_offline is_chargepoint_offline) :
     device_model(device_model),
     monitors_timer([this]() { this->process_monitors_internal(true, true); }),
     unique_id(0),
     notify_csms_events(std::move(notify_csms_events)),
-    is_chargepoint_offline(std::move(is_chargepoint_offline)) {
+    is_chargepoint_offline(std::move(is_chargepoint_offline)),
+    next_schedule_id(0),
+    timing_enabled(false) {
 }
 
 MonitoringUpdater::~MonitoringUpdater() {
@@ -169,6 +251,19 @@ void MonitoringUpdater::start_monitoring() {
         this->on_monitor_updated(updated_monitor, component, variable, characteristics, attribute, current_value);
     };
     device_model.register_monitor_listener(std::move(fn_monitor));
+    device_model.register_monitor_cleared_listener(
+        [this](const std::int32_t monitor_id) { this->on_monitor_cleared(monitor_id); });
+
+    // From now on the periodic monitors are kept up to date by the listeners
+    {
+        std::lock_guard<std::mutex> lock(this->monitors_mutex);
+        load_periodic_monitors_internal();
+    }
+
+    const bool timing_enabled =
+        this->device_model.get_optional_value<bool>(ControllerComponentVariables::MonitoringTimingEnabled)
+            .value_or(false);
+    set_timing_enabled(timing_enabled);
 
     // No point in starting the monitor if this variable does not exist. It will never start to exist later on.
     if (this->device_model.get_optional_value<bool>(ControllerComponentVariables::MonitoringCtrlrEnabled)
@@ -192,9 +287,48 @@ void MonitoringUpdater::process_triggered_monitors() {
     this->process_monitors_internal(false, true);
 }
 
+void MonitoringUpdater::process_monitors() {
+    this->process_monitors_internal(true, true);
+}
+
+void MonitoringUpdater::set_timing_enabled(const bool enabled) {
+    this->timing_enabled = enabled;
+}
+
+MonitoringStatistics MonitoringUpdater::get_statistics() {
+    MonitoringStatistics statistics;
+    statistics.processing_runs = this->statistics.processing_runs;
+    statistics.idle_processing_runs = this->statistics.idle_processing_runs;
+    statistics.processing_time = std::chrono::nanoseconds(this->statistics.processing_time_ns);
+    statistics.events_generated = this->statistics.events_generated;
+    statistics.variable_changes = this->statistics.variable_changes;
+    statistics.monitor_evaluations = this->statistics.monitor_evaluations;
+    statistics.evaluation_time = std::chrono::nanoseconds(this->statistics.evaluation_time_ns);
+    return statistics;
+}
+
+std::chrono::nanoseconds
+MonitoringUpdater::get_elapsed_time(const std::chrono::time_point<std::chrono::steady_clock> start) const {
+    // The start time is not taken if timing was disabled when the measurement started
+    if (!this->timing_enabled or start == std::chrono::steady_clock::time_point{}) {
+        return std::chrono::nanoseconds(0);
+    }
+    return std::chrono::steady_clock::now() - start;
+}
+
 void MonitoringUpdater::on_monitor_updated(const VariableMonitoringMeta& updated_monitor, const Component& component,
                                            const Variable& variable, const VariableCharacteristics& characteristics,
                                            const VariableAttribute& attribute, const std::string& current_value) {
+    std::lock_guard<std::mutex> lock(this->monitors_mutex);
+
+    // Rebuilt with the new monitor data on the next variable change
+    monitor_evaluation_index.clear();
+
+    if (is_periodic_monitor(updated_monitor)) {
+        add_periodic_monitor_internal(component, variable, updated_monitor);
+        return;
+    }
+
     auto it = updater_monitors_meta.find(updated_monitor.monitor.id);
 
     // Not contained, ignored
@@ -204,6 +338,13 @@ void MonitoringUpdater::on_monitor_updated(const VariableMonitoringMeta& updated
 
     auto& meta = it->second;
 
+    // The monitor is not periodic anymore
+    if (meta.type == UpdateMonitorMetaType::PERIODIC) {
+        updater_monitors_meta.erase(it);
+        pending_monitors.erase(updated_monitor.monitor.id);
+        return;
+    }
+
     // Refresh monitor
     meta.monitor_meta = updated_monitor;
 
@@ -217,6 +358,19 @@ void MonitoringUpdater::on_monitor_updated(const VariableMonitoringMeta& updated
     }
 }
 
+void MonitoringUpdater::on_monitor_cleared(const std::int32_t monitor_id) {
+    std::lock_guard<std::mutex> lock(this->monitors_mutex);
+    monitor_evaluation_index.clear();
+
+    auto it = updater_monitors_meta.find(monitor_id);
+
+    // Triggers are kept, so that their current state can still be reported
+    if (it != std::end(updater_monitors_meta) && it->second.type == UpdateMonitorMetaType::PERIODIC) {
+        updater_monitors_meta.erase(it);
+        pending_monitors.erase(monitor_id);
+    }
+}
+
 void MonitoringUpdater::evaluate_monitor(const VariableMonitoringMeta& monitor_meta, const Component& component,
                                          const Variable& variable, const VariableCharacteristics& characteristics,
                                          const VariableAttribute& attribute, const std::string& value_previous,
@@ -227,6 +381,9 @@ void MonitoringUpdater::evaluate_monitor(const VariableMonitoringMeta& monitor_m
         return;
     }
 
+    const auto start =
+        this->timing_enabled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+
     bool monitor_triggered = false;
     bool monitor_trivial = false;
 
@@ -250,6 +407,20 @@ void MonitoringUpdater::evaluate_monitor(const VariableMonitoringMeta& monitor_m
     EVLOG_debug << "Monitor: " << monitor_meta.monitor << " was triggered on var change: [" << monitor_triggered
                 << "] with previous value: [" << value_previous << "] and current: [" << value_current << "]";
 
+    apply_monitor_evaluation(monitor_meta, component, variable, attribute, value_previous, value_current,
+                             monitor_triggered, monitor_trivial);
+
+    this->statistics.monitor_evaluations.fetch_add(1, std::memory_order_relaxed);
+    const auto elapsed = get_elapsed_time(start);
+    if (elapsed.count() > 0) {
+        this->statistics.evaluation_time_ns.fetch_add(elapsed.count(), std::memory_order_relaxed);
+    }
+}
+
+void MonitoringUpdater::apply_monitor_evaluation(const VariableMonitoringMeta& monitor_meta, const Component& component,
+                                                 const Variable& variable, const VariableAttribute& attribute,
+                                                 const std::string& value_previous, const std::string& value_current,
+                                                 bool monitor_triggered, bool monitor_trivial) {
     auto monitor_id = monitor_meta.monitor.id;
     auto it = updater_monitors_meta.find(monitor_id);
 
@@ -334,6 +505,8 @@ void MonitoringUpdater::evaluate_monitor(const VariableMonitoringMeta& monitor_m
             EVLOG_debug << "Variable: " << variable.name.get() << " triggered delta monitor: " << monitor_meta.monitor
                         << ". Requesting CSMS send";
         }
+
+        pending_monitors.insert(monitor_id);
     } else {
         // If the monitor is not triggered and we already have the data
         // in our triggered list it means that we have returned to normal
@@ -345,6 +518,7 @@ void MonitoringUpdater::evaluate_monitor(const VariableMonitoringMeta& monitor_m
             if (in_triggered_state) {
                 // Mark it as cleared, a.k.a normal
                 triggered_data.set_trigger_clear_state(true);
+                pending_monitors.insert(monitor_id);
                 EVLOG_debug << "Variable: " << variable.name.get()
                             << " marked monitor as cleared: " << monitor_meta.monitor;
             }
@@ -365,88 +539,129 @@ void MonitoringUpdater::on_variable_changed(const std::unordered_map<std::int64_
         return;
     }
 
-    // Iterate monitors and search for a triggered monitor
-    for (const auto& [monitor_id, monitor_meta] : monitors) {
-        // Evaluate the monitor
-        evaluate_monitor(monitor_meta, component, variable, characteristics, attribute, value_previous, value_current);
+    const auto start =
+        this->timing_enabled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+    std::unique_lock<std::mutex> monitors_lock(this->monitors_mutex);
+    auto& evaluation = get_monitor_evaluation(monitors, component, variable, characteristics);
+    if (evaluation.monitor_ids.empty()) {
+        return;
     }
-}
 
-void MonitoringUpdater::update_periodic_monitors_internal() {
-    // Update the list of periodic monitors
-    auto periodic_monitors = this->device_model.get_periodic_monitors();
+    evaluate_monitors(evaluation, characteristics.dataType, value_previous, value_current);
 
-    for (auto& component_variable_monitors : periodic_monitors) {
-        for (auto& periodic_monitor_meta : component_variable_monitors.monitors) {
-            // See if we already have the local monitor
-            auto it = this->updater_monitors_meta.find(periodic_monitor_meta.monitor.id);
+    // Only the monitors that triggered or that have a state already need further processing
+    for (std::size_t i = 0; i < evaluation.monitor_ids.size(); i++) {
+        const auto monitor_id = evaluation.monitor_ids[i];
+        const bool monitor_triggered = evaluation.triggered[i] != 0;
 
-            if (it != std::end(this->updater_monitors_meta)) {
-                // If we already contain it inside, skip
-                continue;
-            }
+        if (!monitor_triggered && updater_monitors_meta.find(monitor_id) == std::end(updater_monitors_meta)) {
+            continue;
+        }
 
-            // If it is not found, add a new entry to our managed monitor list
-            UpdaterMonitorMeta periodic_meta;
-
-            periodic_meta.type = UpdateMonitorMetaType::PERIODIC;
-            periodic_meta.monitor_id = periodic_monitor_meta.monitor.id;
-            periodic_meta.component = component_variable_monitors.component;
-            periodic_meta.variable = component_variable_monitors.variable;
-            periodic_meta.monitor_meta = periodic_monitor_meta;
-            periodic_meta.is_writeonly = 0;
-
-            if (periodic_monitor_meta.monitor.type == MonitorEnum::Periodic) {
-                // Set the trigger to the current time
-                periodic_meta.meta_periodic.last_trigger_steady = std::chrono::steady_clock::now();
-            } else if (periodic_monitor_meta.monitor.type == MonitorEnum::PeriodicClockAligned) {
-                // Snap to the closest monitor multiple
-                periodic_meta.meta_periodic.next_trigger_clock_aligned =
-                    get_next_clock_aligned_point(periodic_meta.monitor_meta.monitor.value);
-                EVLOG_debug << "First aligned timepoint for monitor ID: " << periodic_monitor_meta.monitor.id;
-            } else {
-                EVLOG_AND_THROW(std::runtime_error("Invalid type in periodic monitor list, should never happen!"));
-            }
+        const auto monitor_it = monitors.find(monitor_id);
+        if (monitor_it == std::end(monitors)) {
+            continue;
+        }
 
-            auto res = this->updater_monitors_meta.insert(
-                std::pair{periodic_monitor_meta.monitor.id, std::move(periodic_meta)});
+        apply_monitor_evaluation(monitor_it->second, component, variable, attribute, value_previous, value_current,
+                                 monitor_triggered, !evaluation.is_numeric);
+    }
+    const auto nr_of_evaluations = evaluation.monitor_ids.size();
+    monitors_lock.unlock();
+
+    this->statistics.variable_changes.fetch_add(1, std::memory_order_relaxed);
+    this->statistics.monitor_evaluations.fetch_add(nr_of_evaluations, std::memory_order_relaxed);
+    const auto elapsed = get_elapsed_time(start);
+    if (elapsed.count() > 0) {
+        this->statistics.evaluation_time_ns.fetch_add(elapsed.count(), std::memory_order_relaxed);
+    }
+}
 
-            if (!res.second) {
-                EVLOG_warning << "Could not insert periodic monitor to internal monitor map!";
+VariableMonitorEvaluation&
+MonitoringUpdater::get_monitor_evaluation(const std::unordered_map<std::int64_t, VariableMonitoringMeta>& monitors,
+                                          const Component& component, const Variable& variable,
+                                          const VariableCharacteristics& characteristics) {
+    auto& variable_evaluations = monitor_evaluation_index[component];
+    auto it = variable_evaluations.find(variable);
+
+    if (it == std::end(variable_evaluations) || it->second.nr_of_monitors != monitors.size()) {
+        it = variable_evaluations.insert_or_assign(variable, create_monitor_evaluation(monitors, characteristics))
+                 .first;
+    }
+
+    return it->second;
+}
+
+void MonitoringUpdater::load_periodic_monitors_internal() {
+    for (const auto& component_variable_monitors : this->device_model.get_periodic_monitors()) {
+        for (const auto& periodic_monitor_meta : component_variable_monitors.monitors) {
+            // If we already contain it inside, skip
+            if (this->updater_monitors_meta.find(periodic_monitor_meta.monitor.id) !=
+                std::end(this->updater_monitors_meta)) {
                 continue;
             }
+
+            add_periodic_monitor_internal(component_variable_monitors.component, component_variable_monitors.variable,
+                                          periodic_monitor_meta);
         }
     }
+}
 
-    // Remove the monitors in our list that don't exist any more in the database
-    for (auto it = std::begin(updater_monitors_meta); it != std::end(updater_monitors_meta);) {
-        std::int32_t updater_meta_id = it->first;
-        auto updater_meta_data = it->second;
+void MonitoringUpdater::add_periodic_monitor_internal(const Component& component, const Variable& variable,
+                                                      const VariableMonitoringMeta& monitor_meta) {
+    auto it = this->updater_monitors_meta.find(monitor_meta.monitor.id);
 
-        // Ignore triggers
-        if (updater_meta_data.type == UpdateMonitorMetaType::TRIGGER) {
-            ++it;
-            continue;
-        }
+    if (it == std::end(this->updater_monitors_meta) || it->second.type != UpdateMonitorMetaType::PERIODIC) {
+        // Add a new entry to our managed monitor list, replacing a trigger if the monitor type changed
+        UpdaterMonitorMeta periodic_meta;
 
-        const bool found_in_new_periodics =
-            std::find_if(std::begin(periodic_monitors), std::end(periodic_monitors),
-                         [&updater_meta_id](const auto& periodic_monitor) {
-                             const auto& monitors = periodic_monitor.monitors;
+        periodic_meta.type = UpdateMonitorMetaType::PERIODIC;
+        periodic_meta.monitor_id = monitor_meta.monitor.id;
+        periodic_meta.is_writeonly = 0;
 
-                             return std::find_if(std::begin(monitors), std::end(monitors),
-                                                 [&updater_meta_id](const auto& monitor_meta) {
-                                                     return (updater_meta_id == monitor_meta.monitor.id);
-                                                 }) != std::end(monitors);
-                         }) != std::end(periodic_monitors);
+        this->pending_monitors.erase(monitor_meta.monitor.id);
+        it = this->updater_monitors_meta.insert_or_assign(monitor_meta.monitor.id, std::move(periodic_meta)).first;
+    }
 
-        // If not found, erse from our list as not being relevant
-        if (!found_in_new_periodics) {
-            it = updater_monitors_meta.erase(it);
-        } else {
-            ++it;
-        }
+    // Events that were already generated for this monitor are kept
+    auto& periodic_meta = it->second;
+    periodic_meta.component = component;
+    periodic_meta.variable = variable;
+    periodic_meta.monitor_meta = monitor_meta;
+
+    if (monitor_meta.monitor.type == MonitorEnum::Periodic) {
+        // Set the trigger to the current time
+        periodic_meta.meta_periodic.last_trigger_steady = std::chrono::steady_clock::now();
+    } else if (monitor_meta.monitor.type == MonitorEnum::PeriodicClockAligned) {
+        // Snap to the closest monitor multiple
+        periodic_meta.meta_periodic.next_trigger_clock_aligned =
+            get_next_clock_aligned_point(periodic_meta.monitor_meta.monitor.value);
+        EVLOG_debug << "First aligned timepoint for monitor ID: " << monitor_meta.monitor.id;
+    } else {
+        EVLOG_AND_THROW(std::runtime_error("Invalid type in periodic monitor list, should never happen!"));
+    }
+
+    schedule_periodic_monitor_internal(periodic_meta);
+}
+
+void MonitoringUpdater::schedule_periodic_monitor_internal(UpdaterMonitorMeta& updater_meta_data) {
+    const auto& monitor = updater_meta_data.monitor_meta.monitor;
+    std::chrono::time_point<std::chrono::steady_clock> due;
+
+    if (monitor.type == MonitorEnum::Periodic) {
+        due = updater_meta_data.meta_periodic.last_trigger_steady +
+              std::chrono::duration_cast<std::chrono::seconds>(std::chrono::duration<float>(monitor.value));
+    } else {
+        // The schedule runs on the steady clock, convert the remaining time until the aligned point
+        const auto remaining = std::max(std::chrono::system_clock::duration::zero(),
+                                        updater_meta_data.meta_periodic.next_trigger_clock_aligned -
+                                            std::chrono::system_clock::now());
+        due = std::chrono::steady_clock::now() +
+              std::chrono::duration_cast<std::chrono::steady_clock::duration>(remaining);
     }
+
+    updater_meta_data.meta_periodic.schedule_id = this->next_schedule_id++;
+    this->periodic_schedule.push({due, updater_meta_data.monitor_id, updater_meta_data.meta_periodic.schedule_id});
 }
 
 void MonitoringUpdater::process_monitor_meta_internal(UpdaterMonitorMeta& updater_meta_data) {
@@ -466,7 +681,7 @@ void MonitoringUpdater::process_monitor_meta_internal(UpdaterMonitorMeta& update
             auto current_time = std::chrono::steady_clock::now();
             auto delta = current_time - updater_meta_data.meta_periodic.last_trigger_steady;
 
-            if (delta > monitor_seconds) {
+            if (delta >= monitor_seconds) {
                 // Update last time
                 updater_meta_data.meta_periodic.last_trigger_steady = current_time;
                 matches_time = true;
@@ -479,7 +694,7 @@ void MonitoringUpdater::process_monitor_meta_internal(UpdaterMonitorMeta& update
             // trigger event notices at 0, 15, 30 and 45 minutes after the hour, every hour.
             auto current_time = std::chrono::system_clock::now();
 
-            if (current_time > updater_meta_data.meta_periodic.next_trigger_clock_aligned) {
+            if (current_time >= updater_meta_data.meta_periodic.next_trigger_clock_aligned) {
                 auto distance = std::chrono::duration_cast<std::chrono::seconds>(
                                     current_time - updater_meta_data.meta_periodic.next_trigger_clock_aligned)
                                     .count();
@@ -580,7 +795,18 @@ bool should_remove_monitor_meta_internal(const UpdaterMonitorMeta& updater_meta_
 } // namespace
 
 void MonitoringUpdater::process_monitors_internal(bool allow_periodics, bool allow_trigger) {
+    const auto now = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> monitors_lock(this->monitors_mutex);
+    const bool has_due_periodics = allow_periodics && !periodic_schedule.empty() && periodic_schedule.top().due <= now;
+
+    // Idle tick, nothing is due and nothing is waiting to be reported
+    if (!has_due_periodics && pending_monitors.empty()) {
+        this->statistics.idle_processing_runs.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
     if (!is_monitoring_enabled()) {
+        this->statistics.processing_runs.fetch_add(1, std::memory_order_relaxed);
         return;
     }
 
@@ -594,16 +820,41 @@ void MonitoringUpdater::process_monitors_internal(bool allow_periodics, bool all
     EVLOG_debug << "Processing internal monitors with periodics: " << allow_periodics
                 << " and triggers: " << allow_trigger;
 
-    if (allow_periodics) {
-        // Rebuild the periodic monitor information
-        update_periodic_monitors_internal();
+    // Take all due periodic monitors from the schedule, they are added again after processing. Entries of
+    // monitors that were removed or rescheduled in the meantime are dropped here
+    std::set<std::int32_t> due_periodic_monitors;
+    while (has_due_periodics && !periodic_schedule.empty() && periodic_schedule.top().due <= now) {
+        const auto entry = periodic_schedule.top();
+        periodic_schedule.pop();
+
+        const auto it = updater_monitors_meta.find(entry.monitor_id);
+        if (it != std::end(updater_monitors_meta) && it->second.type == UpdateMonitorMetaType::PERIODIC &&
+            it->second.meta_periodic.schedule_id == entry.schedule_id) {
+            due_periodic_monitors.insert(entry.monitor_id);
+        }
     }
 
-    // Iterate all internal monitors and process them
-    for (auto it = std::begin(updater_monitors_meta); it != std::end(updater_monitors_meta);) {
+    std::vector<std::int32_t> monitor_ids(std::begin(pending_monitors), std::end(pending_monitors));
+    for (const auto monitor_id : due_periodic_monitors) {
+        if (pending_monitors.find(monitor_id) == std::end(pending_monitors)) {
+            monitor_ids.push_back(monitor_id);
+        }
+    }
+
+    // Events of all monitors are sent together after processing
+    std::vector<SeverityEventData> events_to_send;
+
+    // Process the due and pending monitors
+    for (const auto meta_monitor_id : monitor_ids) {
+        auto it = updater_monitors_meta.find(meta_monitor_id);
+        if (it == std::end(updater_monitors_meta)) {
+            pending_monitors.erase(meta_monitor_id);
+            continue;
+        }
+
         auto& updater_monitor_meta = it->second;
-        const auto& meta_monitor_id = it->first;
         const auto& monitor_meta = updater_monitor_meta.monitor_meta;
+        const bool is_due = due_periodic_monitors.find(meta_monitor_id) != std::end(due_periodic_monitors);
 
         if (((allow_periodics == false) && (updater_monitor_meta.type == UpdateMonitorMetaType::PERIODIC)) ||
             ((allow_trigger == false) && (updater_monitor_meta.type == UpdateMonitorMetaType::TRIGGER))) {
@@ -619,12 +870,12 @@ void MonitoringUpdater::process_monitors_internal(bool allow_periodics, bool all
 
         if (is_offline) {
             // If we are offline, just discard triggers that have a severity > than 'offline_severity'
-            if (it->second.monitor_meta.monitor.severity > offline_severity) {
+            if (monitor_meta.monitor.severity > offline_severity) {
                 should_process = false;
             }
         } else {
             // If we are online, discard the triggers that have a severity > than 'active_monitoring_level'
-            if (it->second.monitor_meta.monitor.severity > active_monitoring_level) {
+            if (monitor_meta.monitor.severity > active_monitoring_level) {
                 should_process = false;
             }
         }
@@ -634,25 +885,43 @@ void MonitoringUpdater::process_monitors_internal(bool allow_periodics, bool all
         if (!should_process) {
             if (updater_monitor_meta.type == UpdateMonitorMetaType::TRIGGER) {
                 // The triggers that are not active, should simply pe discarded
-                it = updater_monitors_meta.erase(it);
+                updater_monitors_meta.erase(it);
             } else if (updater_monitor_meta.type == UpdateMonitorMetaType::PERIODIC) {
                 // Just clear the events, since we don't require them cached
                 updater_monitor_meta.generated_monitor_events.clear();
+
+                // Skip this interval, the monitor is checked again when its next interval is due
+                if (is_due) {
+                    if (monitor_meta.monitor.type == MonitorEnum::Periodic) {
+                        updater_monitor_meta.meta_periodic.last_trigger_steady = now;
+                    } else {
+                        updater_monitor_meta.meta_periodic.next_trigger_clock_aligned =
+                            get_next_clock_aligned_point(monitor_meta.monitor.value);
+                    }
+                    schedule_periodic_monitor_internal(updater_monitor_meta);
+                }
             }
 
+            pending_monitors.erase(meta_monitor_id);
             continue;
         }
 
         // As a result of this function, the meta should have in it all the generated
         process_monitor_meta_internal(updater_monitor_meta);
 
+        if (is_due) {
+            schedule_periodic_monitor_internal(updater_monitor_meta);
+        }
+
         // If we are not offline, send the queued events generated by this meta
         if (!is_offline) {
             if (!updater_monitor_meta.generated_monitor_events.empty()) {
                 EVLOG_debug << "Sent data for monitor: " << updater_monitor_meta.monitor_meta.monitor;
 
-                // Send the events
-                notify_csms_events(updater_monitor_meta.generated_monitor_events);
+                // Queue the events for sending
+                for (auto& event : updater_monitor_meta.generated_monitor_events) {
+                    events_to_send.push_back({std::move(event), monitor_meta.monitor.severity});
+                }
                 updater_monitor_meta.generated_monitor_events.clear();
 
                 if (updater_monitor_meta.type == UpdateMonitorMetaType::TRIGGER) {
@@ -675,11 +944,31 @@ void MonitoringUpdater::process_monitors_internal(bool allow_periodics, bool all
         }
 
         if (should_remove_monitor_meta_internal(updater_monitor_meta)) {
-            it = updater_monitors_meta.erase(it);
+            updater_monitors_meta.erase(it);
+            pending_monitors.erase(meta_monitor_id);
+        } else if (!updater_monitor_meta.generated_monitor_events.empty()) {
+            // Events cached while offline are sent on the next processing
+            pending_monitors.insert(meta_monitor_id);
         } else {
-            ++it;
+            // A trigger is pending again as soon as its state changes
+            pending_monitors.erase(meta_monitor_id);
         }
     }
+
+    // The events are sent without the lock, the callback may modify the device model
+    monitors_lock.unlock();
+
+    const auto nr_of_events = events_to_send.size();
+    if (!events_to_send.empty()) {
+        notify_csms_events(std::move(events_to_send));
+    }
+
+    this->statistics.processing_runs.fetch_add(1, std::memory_order_relaxed);
+    this->statistics.events_generated.fetch_add(nr_of_events, std::memory_order_relaxed);
+    const auto elapsed = get_elapsed_time(now);
+    if (elapsed.count() > 0) {
+        this->statistics.processing_time_ns.fetch_add(elapsed.count(), std::memory_order_relaxed);
+    }
 }
 
 bool MonitoringUpdater::is_monitoring_enabled() {
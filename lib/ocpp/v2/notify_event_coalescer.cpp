@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <ocpp/v2/notify_event_coalescer.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+#include <everest/logging.hpp>
+
+namespace ocpp::v2 {
+
+NotifyEventCoalescer::NotifyEventCoalescer(SendCallback send_callback, std::chrono::milliseconds window,
+                                           std::size_t max_events) :
+    send_callback(std::move(send_callback)), window(window), max_events(std::max<std::size_t>(max_events, 1)) {
+}
+
+NotifyEventCoalescer::~NotifyEventCoalescer() {
+    this->window_timer.stop();
+    this->flush();
+}
+
+void NotifyEventCoalescer::add(std::vector<SeverityEventData>&& events) {
+    if (events.empty()) {
+        return;
+    }
+
+    bool send_now = false;
+    {
+        std::lock_guard<std::mutex> lock(this->batch_mutex);
+        std::move(std::begin(events), std::end(events), std::back_inserter(this->batch));
+
+        send_now = this->window.count() <= 0 or this->batch.size() >= this->max_events;
+        if (!send_now and !this->window_timer_running) {
+            this->window_timer_running = true;
+            this->window_timer.timeout([this]() { this->flush(); }, this->window);
+        }
+    }
+
+    if (send_now) {
+        this->flush();
+    }
+}
+
+void NotifyEventCoalescer::flush() {
+    std::lock_guard<std::mutex> send_lock(this->send_mutex);
+
+    std::vector<SeverityEventData> events;
+    {
+        std::lock_guard<std::mutex> lock(this->batch_mutex);
+        events.swap(this->batch);
+        if (this->window_timer_running) {
+            this->window_timer_running = false;
+            this->window_timer.stop();
+        }
+    }
+
+    if (events.empty()) {
+        return;
+    }
+
+    std::stable_sort(std::begin(events), std::end(events),
+                     [](const SeverityEventData& a, const SeverityEventData& b) { return a.severity < b.severity; });
+
+    std::vector<EventData> event_data;
+    event_data.reserve(events.size());
+    for (auto& event : events) {
+        event_data.push_back(std::move(event.event));
+    }
+
+    const auto nr_of_events = event_data.size();
+    const auto nr_of_messages = this->send_callback(std::move(event_data));
+
+    std::lock_guard<std::mutex> lock(this->batch_mutex);
+    if (nr_of_events > 1) {
+        this->statistics.events_coalesced += nr_of_events;
+    }
+    if (nr_of_events > nr_of_messages) {
+        this->statistics.messages_saved += nr_of_events - nr_of_messages;
+    }
+    EVLOG_debug << "Sent " << nr_of_events << " events in " << nr_of_messages << " NotifyEvent message(s)";
+}
+
+NotifyEventCoalescerStatistics NotifyEventCoalescer::get_statistics() {
+    std::lock_guard<std::mutex> lock(this->batch_mutex);
+    return this->statistics;
+}
+
+} // namespace ocpp::v2
@@ -3,6 +3,7 @@
 
 #include <everest/logging.hpp>
 #include <ocpp/v2/notify_report_requests_splitter.hpp>
+#include <ocpp/v2/utils.hpp>
 
 namespace ocpp {
 namespace v2 {
@@ -20,73 +21,86 @@ std::vector<json> NotifyReportRequestsSplitter::create_call_payloads() {
 
     // Loop along reportData and create payloads
     std::vector<json> payloads{};
-    int seq_no = 0;
-
-    auto report_data_iterator = original_request.reportData->begin();
-    while (seq_no == 0 || report_data_iterator != original_request.reportData->end()) {
-        payloads.emplace_back(create_next_payload(seq_no, report_data_iterator, original_request.reportData->end(),
-                                                  message_id_generator_callback().get()));
-        seq_no++;
-    }
-
-    if (seq_no > 1) {
-        EVLOG_info << "Split NotifyReportRequest '" << original_request.requestId << "' into " << seq_no
-                   << " messages.";
+    for (const auto& report_data : original_request.reportData.value()) {
+        auto payload = this->add_report_data(report_data);
+        if (payload.has_value()) {
+            payloads.emplace_back(std::move(payload.value()));
+        }
     }
+    payloads.emplace_back(this->finalize());
 
     return payloads;
 }
 
-json NotifyReportRequestsSplitter::create_next_report_data_json(
-    std::vector<ocpp::v2::ReportData>::const_iterator& report_data_iterator,
-    const std::vector<ocpp::v2::ReportData>::const_iterator& report_data_end, const size_t& remaining_size) {
+std::optional<json> NotifyReportRequestsSplitter::add_report_data(const ReportData& report_data) {
+    // The report data is converted to json exactly once: its serialized size is only counted here and the json is
+    // moved into the payload, which is serialized when it is sent
+    json current_json = report_data;
+    const auto current_json_size = utils::get_json_dump_size(current_json);
 
-    if (report_data_iterator == report_data_end) {
-        return json::array();
+    std::optional<json> completed_payload;
+    if (this->payload_open) {
+        // new report data object will increase payload size by its dump + 1 (caused by the separating comma)
+        const auto additional_json_size = current_json_size + 1;
+        if (this->report_data_size + additional_json_size <= this->remaining_size) {
+            this->report_data_size += additional_json_size;
+            this->report_data_json.emplace_back(std::move(current_json));
+            return std::nullopt;
+        }
+        completed_payload = this->close_payload(true);
     }
 
-    json report_data_json{*report_data_iterator};
-    report_data_iterator++;
-    if (report_data_iterator == report_data_end) {
-        return report_data_json;
+    // Each payload contains at least one report data object, even if it exceeds the size bound
+    this->open_payload();
+    this->report_data_size = current_json_size + 2; // enclosing brackets of the array
+    this->report_data_json.emplace_back(std::move(current_json));
+
+    return completed_payload;
+}
+
+json NotifyReportRequestsSplitter::finalize() {
+    if (!this->payload_open) {
+        this->open_payload();
     }
 
-    auto size = report_data_json.dump().size();
+    auto payload = this->close_payload(false);
 
-    for (; report_data_iterator != report_data_end; report_data_iterator++) {
-        json current_json = *report_data_iterator;
-        // new report data object will increase payload size by its dump + 1 (caused by the separating comma)
-        auto additional_json_size = current_json.dump().size() + 1;
-        if (size + additional_json_size <= remaining_size) {
-            size += additional_json_size;
-            report_data_json.emplace_back(std::move(current_json));
-        } else {
-            break;
-        }
+    if (this->seq_no > 1) {
+        EVLOG_info << "Split NotifyReportRequest '" << original_request.requestId << "' into " << this->seq_no
+                   << " messages.";
     }
+    this->seq_no = 0;
 
-    return report_data_json;
+    return payload;
 }
 
-json NotifyReportRequestsSplitter::create_next_payload(
-    const int& seq_no, std::vector<ocpp::v2::ReportData>::const_iterator& report_data_iterator,
-    const std::vector<ocpp::v2::ReportData>::const_iterator& report_data_end, const std::string& message_id) {
+void NotifyReportRequestsSplitter::open_payload() {
+    this->message_id = this->message_id_generator_callback().get();
 
-    json call_base{MessageTypeId::CALL, message_id, MESSAGE_TYPE};
+    const size_t base_json_string_length = this->json_skeleton_size + this->message_id.size();
+    this->remaining_size = this->max_size >= base_json_string_length ? this->max_size - base_json_string_length : 0;
+    this->report_data_json = json::array();
+    this->report_data_size = 2;
+    this->payload_open = true;
+}
 
-    const size_t base_json_string_length = this->json_skeleton_size + message_id.size();
-    const size_t remaining_size =
-        this->max_size >= base_json_string_length ? this->max_size - base_json_string_length : 0;
+json NotifyReportRequestsSplitter::close_payload(const bool tbc) {
+    json call_base{MessageTypeId::CALL, this->message_id, MESSAGE_TYPE};
 
     auto request_json = request_json_template;
-    request_json["reportData"] = create_next_report_data_json(report_data_iterator, report_data_end, remaining_size);
-    request_json["tbc"] = report_data_iterator != report_data_end;
-    request_json["seqNo"] = seq_no;
+    request_json["reportData"] = std::move(this->report_data_json);
+    request_json["tbc"] = tbc;
+    request_json["seqNo"] = this->seq_no;
 
-    call_base.emplace_back(request_json);
+    call_base.emplace_back(std::move(request_json));
+
+    this->report_data_json = json::array();
+    this->payload_open = false;
+    this->seq_no++;
 
     return call_base;
 }
+
 NotifyReportRequestsSplitter::NotifyReportRequestsSplitter(const NotifyReportRequest& originalRequest, size_t max_size,
                                                            std::function<MessageId()>&& message_id_generator_callback) :
     original_request(originalRequest),
@@ -105,7 +119,7 @@ size_t NotifyReportRequestsSplitter::create_request_template_json_and_return_ske
 
     // Skeleton json sizeof( [MessageTypeId::CALL, "", "NotifyReport", {<json of request without
     // reportData>,"reportData":}] )
-    return json{MessageTypeId::CALL, "", MESSAGE_TYPE, request_json_template}.dump().size() +
+    return utils::get_json_dump_size(json{MessageTypeId::CALL, "", MESSAGE_TYPE, request_json_template}) +
            std::string{R"(,"reportData":)"}.size();
 }
 
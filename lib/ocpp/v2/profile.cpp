@@ -6,6 +6,11 @@
 #include <ocpp/common/constants.hpp>
 #include <ocpp/v2/ocpp_types.hpp>
 
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+
 using std::chrono::duration_cast;
 using std::chrono::seconds;
 
@@ -137,22 +142,24 @@ bool period_entry_t::validate(const ChargingProfile& profile, const ocpp::DateTi
     return b_valid;
 }
 
-/// \brief calculate the start times for the profile
-/// \param in_now the current date and time
-/// \param in_end the end of the composite schedule
-/// \param in_session_start optional when the charging session started
-/// \param in_profile the charging profile
-/// \return a list of the start times of the profile
-std::vector<DateTime> calculate_start(const DateTime& in_now, const DateTime& in_end,
-                                      const std::optional<DateTime>& in_session_start,
-                                      const ChargingProfile& in_profile) {
+namespace {
+/// \brief The first start of the schedule of a profile and the time between its recurrences
+struct ScheduleRecurrence {
+    /// \brief Not set when the schedule never starts, e.g. a Recurring profile without a startSchedule
+    std::optional<DateTime> first_start;
+    /// \brief Zero when the profile is not Recurring
+    seconds interval{0};
+};
+
+ScheduleRecurrence get_schedule_recurrence(const DateTime& in_now, const std::optional<DateTime>& in_session_start,
+                                           const ChargingProfile& in_profile) {
     /*
      * Absolute schedules start at the defined startSchedule
      * Relative schedules start at session start
      * Recurring schedules start based on startSchedule and the current date/time
      * start can be affected by the profile validFrom. See period_entry_t::validate()
      */
-    std::vector<DateTime> start_times;
+    ScheduleRecurrence recurrence;
     DateTime start = floor_seconds(in_now); // fallback when a better value can't be found
 
     switch (in_profile.chargingProfileKind) {
@@ -169,13 +176,12 @@ std::vector<DateTime> calculate_start(const DateTime& in_now, const DateTime& in
                 start = in_profile.validFrom.value();
             }
         }
-        start_times.push_back(floor_seconds(start));
+        recurrence.first_start = floor_seconds(start);
         break;
     case ChargingProfileKindEnum::Recurring:
         // TODO how to deal with multible ChargingSchedules?
         if (in_profile.recurrencyKind && in_profile.chargingSchedule.front().startSchedule) {
             const auto start_schedule = floor_seconds(in_profile.chargingSchedule.front().startSchedule.value());
-            const auto end = floor_seconds(in_end);
             const auto now_tp = start.to_time_point();
             int seconds_to_go_back{0};
             int seconds_to_go_forward{0};
@@ -217,12 +223,8 @@ std::vector<DateTime> calculate_start(const DateTime& in_now, const DateTime& in
                 break;
             }
 
-            start = DateTime(now_tp - seconds(seconds_to_go_back));
-
-            while (start <= end) {
-                start_times.push_back(start);
-                start = DateTime(start.to_time_point() + seconds(seconds_to_go_forward));
-            }
+            recurrence.first_start = DateTime(now_tp - seconds(seconds_to_go_back));
+            recurrence.interval = seconds(seconds_to_go_forward);
         }
         break;
     case ChargingProfileKindEnum::Relative:
@@ -230,124 +232,174 @@ std::vector<DateTime> calculate_start(const DateTime& in_now, const DateTime& in
         if (in_session_start) {
             start = floor_seconds(in_session_start.value());
         }
-        start_times.push_back(start);
+        recurrence.first_start = start;
         break;
     case ChargingProfileKindEnum::Dynamic:
         // FIXME: check if other requirements for dynamic exist
-        start_times.push_back(floor_seconds(start));
+        recurrence.first_start = floor_seconds(start);
         break;
     }
-    return start_times;
+    return recurrence;
 }
 
-std::vector<period_entry_t> calculate_profile_entry(const DateTime& in_now, const DateTime& in_end,
-                                                    const std::optional<DateTime>& in_session_start,
-                                                    const ChargingProfile& in_profile, std::size_t in_period_index) {
-    std::vector<period_entry_t> entries;
-
-    if (in_period_index >= in_profile.chargingSchedule.front().chargingSchedulePeriod.size()) {
-        EVLOG_error << "Invalid schedule period index [" << static_cast<int>(in_period_index)
-                    << "] (too large) for profile " << in_profile.id;
-    } else {
-        const auto& this_period = in_profile.chargingSchedule.front().chargingSchedulePeriod[in_period_index];
+/// \brief Checks that the period \p in_period_index of the schedule can be used: the first period must start at 0 and
+/// the periods must be in increasing order
+bool is_valid_schedule_period(const ChargingProfile& in_profile, const std::size_t in_period_index,
+                              const bool log_errors) {
+    const auto& periods = in_profile.chargingSchedule.front().chargingSchedulePeriod;
+    if (in_period_index >= periods.size()) {
+        if (log_errors) {
+            EVLOG_error << "Invalid schedule period index [" << static_cast<int>(in_period_index)
+                        << "] (too large) for profile " << in_profile.id;
+        }
+        return false;
+    }
 
-        if ((in_period_index == 0) && (this_period.startPeriod != 0)) {
-            // invalid profile - first period must be 0
+    const auto& this_period = periods[in_period_index];
+    if ((in_period_index == 0) && (this_period.startPeriod != 0)) {
+        // invalid profile - first period must be 0
+        if (log_errors) {
             EVLOG_error << "Invalid schedule period index [0] startPeriod " << this_period.startPeriod
                         << " for profile " << in_profile.id;
-        } else if ((in_period_index > 0) &&
-                   (in_profile.chargingSchedule.front().chargingSchedulePeriod[in_period_index - 1].startPeriod >=
-                    this_period.startPeriod)) {
-            // invalid profile - periods must be in order and with increasing startPeriod values
+        }
+        return false;
+    }
+    if ((in_period_index > 0) && (periods[in_period_index - 1].startPeriod >= this_period.startPeriod)) {
+        // invalid profile - periods must be in order and with increasing startPeriod values
+        if (log_errors) {
             EVLOG_error << "Invalid schedule period index [" << static_cast<int>(in_period_index) << "] startPeriod "
                         << this_period.startPeriod << " for profile " << in_profile.id;
-        } else {
-            const bool has_next_period =
-                (in_period_index + 1) < in_profile.chargingSchedule.front().chargingSchedulePeriod.size();
-
-            // start time(s) of the schedule
-            // the start time of this period is calculated in period_entry_t::init()
-            const auto schedule_start = calculate_start(in_now, in_end, in_session_start, in_profile);
-
-            for (std::size_t i = 0; i < schedule_start.size(); i++) {
-                const bool has_next_occurrance = (i + 1) < schedule_start.size();
-                const auto& entry_start = schedule_start[i];
-
-                /*
-                 * The duration of this period (from the start of the schedule) is the sooner of
-                 * - forever
-                 * - next period start time
-                 * - optional duration
-                 * - the start of the next recurrence
-                 * - optional validTo
-                 */
-
-                int duration = std::numeric_limits<int>::max(); // forever
-
-                if (has_next_period) {
-                    duration =
-                        in_profile.chargingSchedule.front().chargingSchedulePeriod[in_period_index + 1].startPeriod;
-                }
+        }
+        return false;
+    }
+    return true;
+}
 
-                // check optional chargingSchedule duration field
-                if (in_profile.chargingSchedule.front().duration &&
-                    (in_profile.chargingSchedule.front().duration.value() < duration)) {
-                    duration = in_profile.chargingSchedule.front().duration.value();
-                }
+/// \brief Creates the entry of the period \p in_period_index of the occurrence of the schedule that starts at
+/// \p entry_start. \p next_start is the start of the next occurrence of a Recurring schedule, if there is one.
+/// \return the entry if it is valid
+std::optional<period_entry_t> create_period_entry(const DateTime& in_now, const ChargingProfile& in_profile,
+                                                  const std::size_t in_period_index, const DateTime& entry_start,
+                                                  const std::optional<DateTime>& next_start) {
+    const auto& schedule = in_profile.chargingSchedule.front();
+    const bool has_next_period = (in_period_index + 1) < schedule.chargingSchedulePeriod.size();
 
-                // check duration doesn't extend into the next recurrence
-                if (has_next_occurrance) {
-                    const auto next_start = clamp_to<int>(
-                        duration_cast<seconds>(schedule_start[i + 1].to_time_point() - entry_start.to_time_point())
-                            .count());
-                    if (next_start < duration) {
-                        duration = next_start;
-                    }
-                }
+    /*
+     * The duration of this period (from the start of the schedule) is the sooner of
+     * - forever
+     * - next period start time
+     * - optional duration
+     * - the start of the next recurrence
+     * - optional validTo
+     */
 
-                // check duration doesn't extend beyond profile validity
-                if (in_profile.validTo) {
-                    // note can be negative
-                    const auto valid_to = floor_seconds(in_profile.validTo.value());
-                    const auto valid_to_seconds = clamp_to<int>(
-                        duration_cast<seconds>(valid_to.to_time_point() - entry_start.to_time_point()).count());
-                    if (valid_to_seconds < duration) {
-                        duration = valid_to_seconds;
-                    }
-                }
+    int duration = std::numeric_limits<int>::max(); // forever
 
-                period_entry_t entry;
-                entry.init(entry_start, duration, this_period, in_profile);
-                const auto now = floor_seconds(in_now);
+    if (has_next_period) {
+        duration = schedule.chargingSchedulePeriod[in_period_index + 1].startPeriod;
+    }
 
-                if (entry.validate(in_profile, now)) {
-                    entries.push_back(std::move(entry));
-                }
-            }
+    // check optional chargingSchedule duration field
+    if (schedule.duration && (schedule.duration.value() < duration)) {
+        duration = schedule.duration.value();
+    }
+
+    // check duration doesn't extend into the next recurrence
+    if (next_start.has_value()) {
+        const auto next_start_seconds = clamp_to<int>(
+            duration_cast<seconds>(next_start.value().to_time_point() - entry_start.to_time_point()).count());
+        if (next_start_seconds < duration) {
+            duration = next_start_seconds;
         }
     }
 
-    return entries;
+    // check duration doesn't extend beyond profile validity
+    if (in_profile.validTo) {
+        // note can be negative
+        const auto valid_to = floor_seconds(in_profile.validTo.value());
+        const auto valid_to_seconds =
+            clamp_to<int>(duration_cast<seconds>(valid_to.to_time_point() - entry_start.to_time_point()).count());
+        if (valid_to_seconds < duration) {
+            duration = valid_to_seconds;
+        }
+    }
+
+    period_entry_t entry;
+    entry.init(entry_start, duration, schedule.chargingSchedulePeriod[in_period_index], in_profile);
+    if (!entry.validate(in_profile, floor_seconds(in_now))) {
+        return std::nullopt;
+    }
+    return entry;
 }
 
-namespace {
-std::vector<period_entry_t> calculate_profile_unsorted(const DateTime& now, const DateTime& end,
-                                                       const std::optional<DateTime>& session_start,
-                                                       const ChargingProfile& profile) {
-    std::vector<period_entry_t> entries;
+///
+/// \brief Generates the valid period entries of a profile that start before the end, one occurrence of its schedule
+/// after the other.
+///
+/// The entries of an occurrence end before the next occurrence starts, so for a profile with increasing periods they
+/// are generated in date order. Only the current occurrence is kept, instead of all occurrences until the end.
+///
+class ProfilePeriodGenerator {
+public:
+    ProfilePeriodGenerator(const DateTime& now, const DateTime& end, const std::optional<DateTime>& session_start,
+                           const ChargingProfile& profile) :
+        profile(profile), now(now), end(end), last_start(floor_seconds(end)) {
+        const auto recurrence = get_schedule_recurrence(now, session_start, profile);
+        this->interval = recurrence.interval;
+        // Recurring schedules only start until the end, the others always start
+        if (recurrence.first_start.has_value() and
+            (this->interval == seconds(0) or recurrence.first_start.value() <= this->last_start)) {
+            this->occurrence_start = recurrence.first_start;
+        }
+        this->update_next_start();
+    }
 
-    const auto nr_of_entries = profile.chargingSchedule.front().chargingSchedulePeriod.size();
-    for (std::size_t i = 0; i < nr_of_entries; i++) {
-        const auto results = calculate_profile_entry(now, end, session_start, profile, i);
-        for (const auto& entry : results) {
-            if (entry.start <= end) {
-                entries.push_back(entry);
+    /// \brief Returns the next entry, std::nullopt when all entries have been generated
+    std::optional<period_entry_t> next() {
+        const auto nr_of_periods = this->profile.get().chargingSchedule.front().chargingSchedulePeriod.size();
+        while (this->occurrence_start.has_value()) {
+            while (this->period_index < nr_of_periods) {
+                const auto index = this->period_index++;
+                // Invalid periods are only logged once
+                if (!is_valid_schedule_period(this->profile, index, this->first_occurrence)) {
+                    continue;
+                }
+                auto entry = create_period_entry(this->now, this->profile, index, this->occurrence_start.value(),
+                                                 this->next_start);
+                if (entry.has_value() and entry->start <= this->end) {
+                    return entry;
+                }
             }
+
+            this->occurrence_start = this->next_start;
+            this->period_index = 0;
+            this->first_occurrence = false;
+            this->update_next_start();
         }
+        return std::nullopt;
     }
 
-    return entries;
-}
+private:
+    std::reference_wrapper<const ChargingProfile> profile;
+    DateTime now;
+    DateTime end;
+    DateTime last_start;
+    seconds interval{0};
+    std::optional<DateTime> occurrence_start;
+    std::optional<DateTime> next_start;
+    std::size_t period_index{0};
+    bool first_occurrence{true};
+
+    void update_next_start() {
+        this->next_start.reset();
+        if (this->occurrence_start.has_value() and this->interval > seconds(0)) {
+            DateTime next(this->occurrence_start->to_time_point() + this->interval);
+            if (next <= this->last_start) {
+                this->next_start = next;
+            }
+        }
+    }
+};
 
 void sort_periods_into_date_order(std::vector<period_entry_t>& periods) {
     // sort into date order
@@ -357,16 +409,80 @@ void sort_periods_into_date_order(std::vector<period_entry_t>& periods) {
             return a.start < b.start;
         }
     } less_than;
-    std::sort(periods.begin(), periods.end(), less_than);
+    std::stable_sort(periods.begin(), periods.end(), less_than);
+}
+
+/// \brief Only a profile with periods that are not in increasing order can generate its entries out of order
+void ensure_date_order(std::vector<period_entry_t>& periods) {
+    if (!std::is_sorted(periods.begin(), periods.end(),
+                        [](const period_entry_t& a, const period_entry_t& b) { return a.start < b.start; })) {
+        sort_periods_into_date_order(periods);
+    }
 }
 } // namespace
 
+/// \brief calculate the start times for the profile
+/// \param in_now the current date and time
+/// \param in_end the end of the composite schedule
+/// \param in_session_start optional when the charging session started
+/// \param in_profile the charging profile
+/// \return a list of the start times of the profile
+std::vector<DateTime> calculate_start(const DateTime& in_now, const DateTime& in_end,
+                                      const std::optional<DateTime>& in_session_start,
+                                      const ChargingProfile& in_profile) {
+    std::vector<DateTime> start_times;
+    const auto recurrence = get_schedule_recurrence(in_now, in_session_start, in_profile);
+    if (!recurrence.first_start.has_value()) {
+        return start_times;
+    }
+    if (recurrence.interval == seconds(0)) {
+        start_times.push_back(recurrence.first_start.value());
+        return start_times;
+    }
+
+    const auto end = floor_seconds(in_end);
+    for (auto start = recurrence.first_start.value(); start <= end;
+         start = DateTime(start.to_time_point() + recurrence.interval)) {
+        start_times.push_back(start);
+    }
+    return start_times;
+}
+
+std::vector<period_entry_t> calculate_profile_entry(const DateTime& in_now, const DateTime& in_end,
+                                                    const std::optional<DateTime>& in_session_start,
+                                                    const ChargingProfile& in_profile, std::size_t in_period_index) {
+    std::vector<period_entry_t> entries;
+    if (!is_valid_schedule_period(in_profile, in_period_index, true)) {
+        return entries;
+    }
+
+    // start time(s) of the schedule
+    // the start time of this period is calculated in period_entry_t::init()
+    const auto schedule_start = calculate_start(in_now, in_end, in_session_start, in_profile);
+    for (std::size_t i = 0; i < schedule_start.size(); i++) {
+        std::optional<DateTime> next_start;
+        if ((i + 1) < schedule_start.size()) {
+            next_start = schedule_start[i + 1];
+        }
+        auto entry = create_period_entry(in_now, in_profile, in_period_index, schedule_start[i], next_start);
+        if (entry.has_value()) {
+            entries.push_back(std::move(entry.value()));
+        }
+    }
+
+    return entries;
+}
+
 std::vector<period_entry_t> calculate_profile(const DateTime& now, const DateTime& end,
                                               const std::optional<DateTime>& session_start,
                                               const ChargingProfile& profile) {
-    std::vector<period_entry_t> entries = calculate_profile_unsorted(now, end, session_start, profile);
+    std::vector<period_entry_t> entries;
+    ProfilePeriodGenerator generator(now, end, session_start, profile);
+    for (auto entry = generator.next(); entry.has_value(); entry = generator.next()) {
+        entries.push_back(std::move(entry.value()));
+    }
 
-    sort_periods_into_date_order(entries);
+    ensure_date_order(entries);
     return entries;
 }
 
@@ -374,15 +490,36 @@ std::vector<period_entry_t> calculate_all_profiles(const DateTime& now, const Da
                                                    const std::optional<DateTime>& session_start,
                                                    const std::vector<ChargingProfile>& profiles,
                                                    ChargingProfilePurposeEnum purpose) {
-    std::vector<period_entry_t> output;
+    std::vector<ProfilePeriodGenerator> generators;
     for (const auto& profile : profiles) {
         if (profile.chargingProfilePurpose == purpose) {
-            std::vector<period_entry_t> periods = calculate_profile_unsorted(now, end, session_start, profile);
-            output.insert(output.end(), periods.begin(), periods.end());
+            generators.emplace_back(now, end, session_start, profile);
+        }
+    }
+
+    // k-way merge of the entries of all profiles, on an equal start the entry of the earlier profile comes first
+    using HeapEntry = std::pair<period_entry_t, std::size_t>;
+    const auto later = [](const HeapEntry& a, const HeapEntry& b) {
+        return a.first.start > b.first.start or (a.first.start == b.first.start and a.second > b.second);
+    };
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, decltype(later)> heap(later);
+    for (std::size_t i = 0; i < generators.size(); i++) {
+        if (auto entry = generators[i].next()) {
+            heap.emplace(std::move(entry.value()), i);
         }
     }
 
-    sort_periods_into_date_order(output);
+    std::vector<period_entry_t> output;
+    while (!heap.empty()) {
+        const auto index = heap.top().second;
+        output.push_back(heap.top().first);
+        heap.pop();
+        if (auto entry = generators[index].next()) {
+            heap.emplace(std::move(entry.value()), index);
+        }
+    }
+
+    ensure_date_order(output);
     return output;
 }
 
@@ -403,7 +540,7 @@ IntermediateProfile generate_profile_from_periods(std::vector<period_entry_t>& p
             return a.stack_level > b.stack_level;
         }
     } less_than;
-    std::sort(periods.begin(), periods.end(), less_than);
+    std::stable_sort(periods.begin(), periods.end(), less_than);
 
     IntermediateProfile combined{};
     DateTime current = now;
@@ -485,7 +622,7 @@ IntermediateProfile generate_profile_from_periods(std::vector<period_entry_t>& p
 namespace {
 
 using period_iterator = IntermediateProfile::const_iterator;
-using period_pair_vector = std::vector<std::pair<period_iterator, period_iterator>>;
+using active_period_vector = std::vector<const IntermediatePeriod*>;
 using IntermediateProfileRef = std::reference_wrapper<const IntermediateProfile>;
 
 inline std::vector<IntermediateProfileRef> convert_to_ref_vector(const std::vector<IntermediateProfile>& profiles) {
@@ -497,31 +634,50 @@ inline std::vector<IntermediateProfileRef> convert_to_ref_vector(const std::vect
     return references;
 }
 
+/// \brief Combines the \p profiles in a single sweep over the sorted start times of all their periods. At every start
+/// time \p combinator is called with the active period of every non empty profile, in the order of \p profiles. A
+/// combined period is only added when it differs from the previous one.
+template <typename Combinator>
 IntermediateProfile combine_list_of_profiles(const std::vector<IntermediateProfileRef>& profiles,
-                                             std::function<IntermediatePeriod(const period_pair_vector&)> combinator) {
-    if (profiles.empty()) {
-        // We should never get here as there are always profiles, otherwise there is a mistake in the calling
-        // function Return an empty profile to be safe
-        return {default_intermediate_period()};
-    }
-
-    IntermediateProfile combined{};
+                                             const Combinator& combinator) {
+    // Cursors into the profiles, stored as separate arrays so the combinator only gets the active periods
+    std::vector<period_iterator> positions;
+    std::vector<period_iterator> ends;
+    active_period_vector active_periods;
+    std::vector<std::int32_t> boundaries;
+    positions.reserve(profiles.size());
+    ends.reserve(profiles.size());
+    active_periods.reserve(profiles.size());
 
-    period_pair_vector profile_iterators{};
     for (const auto& wrapped_profile : profiles) {
-        auto& profile = wrapped_profile.get();
-        if (!profile.empty()) {
-            profile_iterators.emplace_back(std::make_pair(profile.begin(), profile.end()));
+        const auto& profile = wrapped_profile.get();
+        if (profile.empty()) {
+            continue;
+        }
+        positions.push_back(profile.begin());
+        ends.push_back(profile.end());
+        active_periods.push_back(&profile.front());
+        // The first period of a profile is active from the start
+        for (auto it = profile.begin() + 1; it != profile.end(); ++it) {
+            if (it->startPeriod > 0) {
+                boundaries.push_back(it->startPeriod);
+            }
         }
     }
 
-    std::int32_t current_period = 0;
-    while (std::any_of(profile_iterators.begin(), profile_iterators.end(),
-                       [](const std::pair<period_iterator, period_iterator>& it) { return it.first != it.second; })) {
+    if (active_periods.empty()) {
+        // We should never get here as there are always profiles, otherwise there is a mistake in the calling
+        // function Return an empty profile to be safe
+        return {default_intermediate_period()};
+    }
 
-        IntermediatePeriod period = combinator(profile_iterators);
-        period.startPeriod = current_period;
+    std::sort(boundaries.begin(), boundaries.end());
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
 
+    IntermediateProfile combined{};
+    combined.reserve(boundaries.size() + 1);
+    const auto add_period = [&combined, &combinator, &active_periods](const std::int32_t start_period) {
+        IntermediatePeriod period = combinator(active_periods);
         if (combined.empty() || (period.current_limit != combined.back().current_limit) ||
             (period.power_limit != combined.back().power_limit) ||
             (period.current_discharge_limit != combined.back().current_discharge_limit) ||
@@ -529,36 +685,21 @@ IntermediateProfile combine_list_of_profiles(const std::vector<IntermediateProfi
             (period.current_setpoint != combined.back().current_setpoint) ||
             (period.power_setpoint != combined.back().power_setpoint) ||
             (period.numberPhases != combined.back().numberPhases)) {
-            combined.push_back(period);
-        }
-
-        // Determine the next earliest period
-        std::int32_t next_lowest_period = std::numeric_limits<std::int32_t>::max();
-
-        for (const auto& [it, end] : profile_iterators) {
-            auto next = it + 1;
-            if (next != end && next->startPeriod > current_period && next->startPeriod < next_lowest_period) {
-                next_lowest_period = next->startPeriod;
-            }
-        }
-
-        // If there is none, we are done
-        if (next_lowest_period == std::numeric_limits<std::int32_t>::max()) {
-            break;
+            period.startPeriod = start_period;
+            combined.push_back(std::move(period));
         }
+    };
 
-        // Otherwise update to next earliest period
-        for (auto& [it, end] : profile_iterators) {
-            auto next = it + 1;
-            if (next != end && next->startPeriod == next_lowest_period) {
-                it++;
+    add_period(0);
+    for (const auto boundary : boundaries) {
+        for (std::size_t i = 0; i < positions.size(); i++) {
+            auto& position = positions[i];
+            for (auto next = position + 1; next != ends[i] && next->startPeriod <= boundary; ++next) {
+                position = next;
             }
+            active_periods[i] = &*position;
         }
-        current_period = next_lowest_period;
-    }
-
-    if (combined.empty()) {
-        combined.push_back(default_intermediate_period());
+        add_period(boundary);
     }
 
     return combined;
@@ -568,7 +709,7 @@ IntermediateProfile combine_list_of_profiles(const std::vector<IntermediateProfi
 
 IntermediateProfile merge_tx_profile_with_tx_default_profile(const IntermediateProfile& tx_profile,
                                                              const IntermediateProfile& tx_default_profile) {
-    auto combinator = [](const period_pair_vector& periods) {
+    auto combinator = [](const active_period_vector& periods) {
         const IntermediatePeriod default_period = default_intermediate_period();
         IntermediatePeriod period{};
         period.current_limit = {NO_LIMIT_SPECIFIED, NO_LIMIT_SPECIFIED, NO_LIMIT_SPECIFIED};
@@ -580,7 +721,7 @@ IntermediateProfile merge_tx_profile_with_tx_default_profile(const IntermediateP
         period.current_setpoint = {NO_SETPOINT_SPECIFIED, NO_SETPOINT_SPECIFIED, NO_SETPOINT_SPECIFIED};
         period.power_setpoint = {NO_SETPOINT_SPECIFIED, NO_SETPOINT_SPECIFIED, NO_SETPOINT_SPECIFIED};
 
-        for (const auto& [it, end] : periods) {
+        for (const auto* it : periods) {
             if (it->current_limit != default_period.current_limit || it->power_limit != default_period.power_limit ||
                 it->current_discharge_limit != default_period.current_discharge_limit ||
                 it->power_discharge_limit != default_period.power_discharge_limit ||
@@ -608,7 +749,7 @@ IntermediateProfile merge_tx_profile_with_tx_default_profile(const IntermediateP
 
 IntermediateProfile merge_profiles_by_lowest_limit(const std::vector<IntermediateProfile>& profiles,
                                                    const OcppProtocolVersion ocpp_version) {
-    auto combinator = [ocpp_version](const period_pair_vector& periods) {
+    auto combinator = [ocpp_version](const active_period_vector& periods) {
         IntermediatePeriod period;
         period.current_limit = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
                                 std::numeric_limits<float>::max()};
@@ -625,7 +766,7 @@ IntermediateProfile merge_profiles_by_lowest_limit(const std::vector<Intermediat
 
         bool three_phases_used = false;
         // Get number of phases for this period (the lowest of the number of phases).
-        for (const auto& [it, end] : periods) {
+        for (const auto* it : periods) {
             if (!period.numberPhases || (it->numberPhases && it->numberPhases.value() < period.numberPhases.value())) {
                 period.numberPhases = it->numberPhases;
             }
@@ -635,28 +776,33 @@ IntermediateProfile merge_profiles_by_lowest_limit(const std::vector<Intermediat
             }
         }
 
-        for (const auto& [it, end] : periods) {
-            IntermediatePeriod new_period = *it;
+        for (const auto* it : periods) {
+            // Only copied when the phase values have to be filled in
+            const IntermediatePeriod* new_period = it;
+            IntermediatePeriod phase_period;
             if (three_phases_used) {
-                set_setpoint_limit_phase_values(new_period.current_limit, new_period.power_limit, NO_LIMIT_SPECIFIED,
+                phase_period = *it;
+                set_setpoint_limit_phase_values(phase_period.current_limit, phase_period.power_limit,
+                                                NO_LIMIT_SPECIFIED, period.numberPhases, ocpp_version);
+                set_setpoint_limit_phase_values(phase_period.current_discharge_limit,
+                                                phase_period.power_discharge_limit, NO_DISCHARGE_LIMIT_SPECIFIED,
                                                 period.numberPhases, ocpp_version);
-                set_setpoint_limit_phase_values(new_period.current_discharge_limit, new_period.power_discharge_limit,
-                                                NO_DISCHARGE_LIMIT_SPECIFIED, period.numberPhases, ocpp_version);
-                set_setpoint_limit_phase_values(new_period.current_setpoint, new_period.power_setpoint,
+                set_setpoint_limit_phase_values(phase_period.current_setpoint, phase_period.power_setpoint,
                                                 NO_SETPOINT_SPECIFIED, period.numberPhases, ocpp_version);
+                new_period = &phase_period;
             }
 
-            period.current_limit = get_min_limit(period.current_limit, new_period.current_limit);
-            period.power_limit = get_min_limit(period.power_limit, new_period.power_limit);
+            period.current_limit = get_min_limit(period.current_limit, new_period->current_limit);
+            period.power_limit = get_min_limit(period.power_limit, new_period->power_limit);
             period.current_discharge_limit =
-                get_max_limit(period.current_discharge_limit, new_period.current_discharge_limit);
+                get_max_limit(period.current_discharge_limit, new_period->current_discharge_limit);
             period.power_discharge_limit =
-                get_max_limit(period.power_discharge_limit, new_period.power_discharge_limit);
+                get_max_limit(period.power_discharge_limit, new_period->power_discharge_limit);
 
             // Only check value of first phase, as this one should be set as first.
-            get_set_setpoint_limit(period.current_setpoint, new_period.current_setpoint, period.current_limit,
+            get_set_setpoint_limit(period.current_setpoint, new_period->current_setpoint, period.current_limit,
                                    period.current_discharge_limit);
-            get_set_setpoint_limit(period.power_setpoint, new_period.power_setpoint, period.power_limit,
+            get_set_setpoint_limit(period.power_setpoint, new_period->power_setpoint, period.power_limit,
                                    period.power_discharge_limit);
         }
 
@@ -690,7 +836,7 @@ IntermediateProfile merge_profiles_by_lowest_limit(const std::vector<Intermediat
 IntermediateProfile merge_profiles_by_summing_limits(const std::vector<IntermediateProfile>& profiles,
                                                      float current_default, float power_default,
                                                      const OcppProtocolVersion ocpp_version) {
-    auto combinator = [current_default, power_default, ocpp_version](const period_pair_vector& periods) {
+    auto combinator = [current_default, power_default, ocpp_version](const active_period_vector& periods) {
         IntermediatePeriod period{};
 
         // summing limits dont have a setpoint, so set to default values
@@ -699,7 +845,7 @@ IntermediateProfile merge_profiles_by_summing_limits(const std::vector<Intermedi
 
         bool three_phases_used = false;
         // Get number of phases for this period (the lowest of the number of phases).
-        for (const auto& [it, end] : periods) {
+        for (const auto* it : periods) {
             // Copy number of phases if higher
             if (!period.numberPhases.has_value() ||
                 (it->numberPhases.has_value() && it->numberPhases.value() > period.numberPhases.value())) {
@@ -711,37 +857,42 @@ IntermediateProfile merge_profiles_by_summing_limits(const std::vector<Intermedi
             }
         }
 
-        for (const auto& [it, end] : periods) {
-            IntermediatePeriod new_period = *it;
+        for (const auto* it : periods) {
+            // Only copied when the phase values have to be filled in
+            const IntermediatePeriod* new_period = it;
+            IntermediatePeriod phase_period;
             if (three_phases_used) {
-                set_setpoint_limit_phase_values(new_period.current_limit, new_period.power_limit, NO_LIMIT_SPECIFIED,
+                phase_period = *it;
+                set_setpoint_limit_phase_values(phase_period.current_limit, phase_period.power_limit,
+                                                NO_LIMIT_SPECIFIED, period.numberPhases, ocpp_version);
+                set_setpoint_limit_phase_values(phase_period.current_discharge_limit,
+                                                phase_period.power_discharge_limit, NO_DISCHARGE_LIMIT_SPECIFIED,
                                                 period.numberPhases, ocpp_version);
-                set_setpoint_limit_phase_values(new_period.current_discharge_limit, new_period.power_discharge_limit,
-                                                NO_DISCHARGE_LIMIT_SPECIFIED, period.numberPhases, ocpp_version);
-                set_setpoint_limit_phase_values(new_period.current_setpoint, new_period.power_setpoint,
+                set_setpoint_limit_phase_values(phase_period.current_setpoint, phase_period.power_setpoint,
                                                 NO_SETPOINT_SPECIFIED, period.numberPhases, ocpp_version);
+                new_period = &phase_period;
             }
 
             period.current_limit.limit +=
-                new_period.current_limit.limit >= 0.0F ? new_period.current_limit.limit : current_default;
+                new_period->current_limit.limit >= 0.0F ? new_period->current_limit.limit : current_default;
             if (three_phases_used) {
                 period.current_limit.limit_L2 +=
-                    new_period.current_limit.limit_L2 >= 0.0F ? new_period.current_limit.limit_L2 : current_default;
+                    new_period->current_limit.limit_L2 >= 0.0F ? new_period->current_limit.limit_L2 : current_default;
                 period.current_limit.limit_L3 +=
-                    new_period.current_limit.limit_L3 >= 0.0F ? new_period.current_limit.limit_L3 : current_default;
+                    new_period->current_limit.limit_L3 >= 0.0F ? new_period->current_limit.limit_L3 : current_default;
             } else {
                 period.current_limit.limit_L2 = NO_LIMIT_SPECIFIED;
                 period.current_limit.limit_L3 = NO_LIMIT_SPECIFIED;
             }
 
             period.power_limit.limit +=
-                new_period.power_limit.limit >= 0.0F ? new_period.power_limit.limit : power_default;
+                new_period->power_limit.limit >= 0.0F ? new_period->power_limit.limit : power_default;
 
             if (three_phases_used) {
                 period.power_limit.limit_L2 +=
-                    new_period.power_limit.limit_L2 >= 0.0F ? new_period.power_limit.limit_L2 : power_default;
+                    new_period->power_limit.limit_L2 >= 0.0F ? new_period->power_limit.limit_L2 : power_default;
                 period.power_limit.limit_L3 +=
-                    new_period.power_limit.limit_L3 >= 0.0F ? new_period.power_limit.limit_L3 : power_default;
+                    new_period->power_limit.limit_L3 >= 0.0F ? new_period->power_limit.limit_L3 : power_default;
             } else {
                 period.power_limit.limit_L2 = NO_LIMIT_SPECIFIED;
                 period.power_limit.limit_L3 = NO_LIMIT_SPECIFIED;
@@ -829,6 +980,164 @@ convert_intermediate_into_schedule(const IntermediateProfile& profile, ChargingR
     return output;
 }
 
+namespace {
+const std::int32_t STATION_WIDE_ID = 0;
+
+std::vector<IntermediateProfile> generate_evse_intermediates(const std::vector<ChargingProfile>& evse_profiles,
+                                                             const std::vector<ChargingProfile>& station_wide_profiles,
+                                                             const CompositeScheduleParameters& parameters,
+                                                             const std::optional<ocpp::DateTime>& session_start) {
+    const auto& start_time = parameters.start_time;
+    const auto& end_time = parameters.end_time;
+
+    // Combine the profiles with those from the station
+    std::vector<ChargingProfile> profiles;
+    profiles.reserve(evse_profiles.size() + station_wide_profiles.size());
+    profiles.insert(profiles.end(), evse_profiles.begin(), evse_profiles.end());
+    profiles.insert(profiles.end(), station_wide_profiles.begin(), station_wide_profiles.end());
+
+    auto external_constraints_periods = calculate_all_profiles(
+        start_time, end_time, session_start, profiles, ChargingProfilePurposeEnum::ChargingStationExternalConstraints);
+
+    std::vector<IntermediateProfile> output;
+    output.push_back(generate_profile_from_periods(external_constraints_periods, start_time, end_time));
+
+    // If there is a session active or we want to simulate, add the combined tx and tx_default to the output
+    if (session_start.has_value() || parameters.simulate_transaction_active) {
+        auto tx_default_periods = calculate_all_profiles(start_time, end_time, session_start, profiles,
+                                                         ChargingProfilePurposeEnum::TxDefaultProfile);
+        auto tx_periods = calculate_all_profiles(start_time, end_time, session_start, profiles,
+                                                 ChargingProfilePurposeEnum::TxProfile);
+
+        auto tx_default = generate_profile_from_periods(tx_default_periods, start_time, end_time);
+        auto tx = generate_profile_from_periods(tx_periods, start_time, end_time);
+
+        // Merges the TxProfile with the TxDefaultProfile, for every period preferring a tx period over a tx_default
+        // period
+        output.push_back(merge_tx_profile_with_tx_default_profile(tx, tx_default));
+    }
+
+    return output;
+}
+} // namespace
+
+EvseIntermediateProfiles calculate_evse_intermediate_profiles(const CompositeScheduleParameters& parameters,
+                                                              const std::vector<ChargingProfile>& station_wide_profiles,
+                                                              const EvseCompositeScheduleInput& evse) {
+    EvseIntermediateProfiles result;
+    result.intermediates =
+        generate_evse_intermediates(evse.profiles, station_wide_profiles, parameters, evse.session_start);
+    result.lowest_limits = merge_profiles_by_lowest_limit(result.intermediates, parameters.ocpp_version);
+    return result;
+}
+
+std::vector<CompositeSchedule> calculate_composite_schedules(const CompositeScheduleParameters& parameters,
+                                                             const std::vector<ChargingProfile>& station_wide_profiles,
+                                                             const std::vector<EvseCompositeScheduleInput>& evses,
+                                                             const std::vector<std::int32_t>& evse_ids,
+                                                             WorkerPool& workers) {
+    const auto& start_time = parameters.start_time;
+    const auto& end_time = parameters.end_time;
+    const bool station_wide_requested =
+        std::find(evse_ids.begin(), evse_ids.end(), STATION_WIDE_ID) != evse_ids.end();
+
+    // ChargingStationMaxProfile is always station wide and only depends on the session start if it is Relative, if it
+    // is not it is calculated once for all evses
+    const auto calculate_charging_station_max = [&](const std::optional<DateTime>& session_start) {
+        auto periods = calculate_all_profiles(start_time, end_time, session_start, station_wide_profiles,
+                                              ChargingProfilePurposeEnum::ChargingStationMaxProfile);
+        return generate_profile_from_periods(periods, start_time, end_time);
+    };
+    const bool charging_station_max_uses_session =
+        std::any_of(station_wide_profiles.begin(), station_wide_profiles.end(), [](const ChargingProfile& profile) {
+            return profile.chargingProfilePurpose == ChargingProfilePurposeEnum::ChargingStationMaxProfile and
+                   profile.chargingProfileKind == ChargingProfileKindEnum::Relative;
+        });
+    std::optional<IntermediateProfile> charging_station_max;
+    if (!charging_station_max_uses_session) {
+        charging_station_max = calculate_charging_station_max(std::nullopt);
+    }
+
+    // Get the ChargingStationExternalConstraints and Combined Tx(Default)Profiles per evse, unless they are given
+    std::vector<std::size_t> missing;
+    for (std::size_t i = 0; i < evses.size(); i++) {
+        if (!evses[i].intermediate_profiles.has_value()) {
+            missing.push_back(i);
+        }
+    }
+    std::vector<EvseIntermediateProfiles> calculated(missing.size());
+    workers.run(missing.size(), [&](const std::size_t m) {
+        calculated[m] = calculate_evse_intermediate_profiles(parameters, station_wide_profiles, evses[missing[m]]);
+    });
+    std::vector<const EvseIntermediateProfiles*> evse_intermediates(evses.size());
+    for (std::size_t i = 0; i < evses.size(); i++) {
+        evse_intermediates[i] = evses[i].intermediate_profiles.has_value() ? &evses[i].intermediate_profiles.value()
+                                                                           : nullptr;
+    }
+    for (std::size_t m = 0; m < missing.size(); m++) {
+        evse_intermediates[missing[m]] = &calculated[m];
+    }
+
+    // The lowest limits per evse
+    std::vector<IntermediateProfile> evse_schedules;
+    if (station_wide_requested) {
+        evse_schedules.reserve(evses.size());
+        for (const auto* intermediate_profiles : evse_intermediates) {
+            evse_schedules.push_back(intermediate_profiles->lowest_limits);
+        }
+    }
+
+    std::vector<CompositeSchedule> composite_schedules(evse_ids.size());
+    workers.run(evse_ids.size(), [&](const std::size_t i) {
+        const auto evse_id = evse_ids[i];
+        std::vector<IntermediateProfile> combined_profiles;
+        std::optional<DateTime> session_start;
+
+        if (evse_id == STATION_WIDE_ID) {
+            // Add all the limits of all the evse's together since that will be the max the whole charging station can
+            // consume at any point in time
+            combined_profiles.push_back(merge_profiles_by_summing_limits(
+                evse_schedules, parameters.current_limit, parameters.power_limit, parameters.ocpp_version));
+            if (!evses.empty()) {
+                session_start = evses.back().session_start;
+            }
+        } else {
+            const auto evse = std::find_if(evses.begin(), evses.end(),
+                                           [evse_id](const EvseCompositeScheduleInput& input) {
+                                               return input.evse_id == evse_id;
+                                           });
+            if (evse == evses.end()) {
+                throw std::out_of_range("No composite schedule input for evse " + std::to_string(evse_id));
+            }
+            combined_profiles = evse_intermediates[static_cast<std::size_t>(evse - evses.begin())]->intermediates;
+            session_start = evse->session_start;
+        }
+
+        // Add the ChargingStationMaxProfile limits to the other profiles
+        combined_profiles.push_back(charging_station_max.has_value() ? charging_station_max.value()
+                                                                     : calculate_charging_station_max(session_start));
+
+        // Calculate the final limit of all the combined profiles
+        const auto retval = merge_profiles_by_lowest_limit(combined_profiles, parameters.ocpp_version);
+
+        auto& composite = composite_schedules[i];
+        composite.evseId = evse_id;
+        composite.scheduleStart = floor_seconds(start_time);
+        composite.duration = elapsed_seconds(floor_seconds(end_time), floor_seconds(start_time));
+        composite.chargingRateUnit = parameters.charging_rate_unit;
+
+        // Convert the intermediate result into a proper schedule. Will fill in the periods with no limits with the
+        // default one
+        const auto limit = parameters.charging_rate_unit == ChargingRateUnitEnum::A ? parameters.current_limit
+                                                                                    : parameters.power_limit;
+        composite.chargingSchedulePeriod =
+            convert_intermediate_into_schedule(retval, parameters.charging_rate_unit, limit,
+                                               parameters.default_number_phases, parameters.supply_voltage);
+    });
+
+    return composite_schedules;
+}
+
 // Helper functions
 namespace {
 ///
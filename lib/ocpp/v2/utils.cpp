@@ -4,6 +4,11 @@
 #include <everest/logging.hpp>
 
 #include <algorithm>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+
 #include <openssl/evp.h>
 #include <openssl/sha.h>
 
@@ -111,19 +116,88 @@ MeterValue set_meter_value_reading_context(const MeterValue& meter_value, const
     return return_value;
 }
 
+namespace {
+struct EvpMdCtxDeleter {
+    void operator()(EVP_MD_CTX* context) const {
+        EVP_MD_CTX_free(context);
+    }
+};
+
+/// \brief Returns the digest context of the calling thread, which is reused for every hash
+EVP_MD_CTX* get_digest_context() {
+    thread_local const std::unique_ptr<EVP_MD_CTX, EvpMdCtxDeleter> context(EVP_MD_CTX_new());
+    return context.get();
+}
+} // namespace
+
 std::string sha256(const std::string& str) {
+    const auto hex = sha256_hex({str});
+    return std::string(hex.data(), hex.size());
+}
+
+static_assert(SHA256_HEX_LENGTH == 2 * SHA256_DIGEST_LENGTH);
+
+Sha256Hex sha256_hex(std::initializer_list<std::string_view> parts) {
+    auto* context = get_digest_context();
     std::array<unsigned char, SHA256_DIGEST_LENGTH> hash;
-    EVP_Digest(str.c_str(), str.size(), hash.data(), nullptr, EVP_sha256(), nullptr);
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0');
-    for (const auto& byte : hash) {
-        ss << std::setw(2) << (int)byte;
+    bool success = context != nullptr and EVP_DigestInit_ex(context, EVP_sha256(), nullptr) == 1;
+    for (const auto part : parts) {
+        success = success and EVP_DigestUpdate(context, part.data(), part.size()) == 1;
+    }
+    success = success and EVP_DigestFinal_ex(context, hash.data(), nullptr) == 1;
+    if (!success) {
+        throw std::runtime_error("Could not calculate SHA256 hash");
+    }
+
+    static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+    Sha256Hex hex;
+    for (std::size_t i = 0; i < hash.size(); i++) {
+        hex[2 * i] = HEX_DIGITS[hash[i] >> 4];
+        hex[2 * i + 1] = HEX_DIGITS[hash[i] & 0x0F];
     }
-    return ss.str();
+    return hex;
 }
 
 std::string generate_token_hash(const IdToken& token) {
-    return sha256(token.type.get() + token.idToken.get());
+    // Same hash as of the concatenated type and id, which is stored in existing databases
+    const auto hex = sha256_hex({token.type.get(), token.idToken.get()});
+    return std::string(hex.data(), hex.size());
+}
+
+namespace {
+/// \brief Stream buffer that discards everything written to it and only counts the number of characters
+class CountingStreamBuffer : public std::streambuf {
+public:
+    std::size_t get_count() const {
+        return this->count;
+    }
+
+protected:
+    std::streamsize xsputn(const char* /*s*/, std::streamsize n) override {
+        this->count += static_cast<std::size_t>(n);
+        return n;
+    }
+
+    int_type overflow(int_type ch) override {
+        if (traits_type::eq_int_type(ch, traits_type::eof())) {
+            return traits_type::not_eof(ch);
+        }
+        this->count++;
+        return ch;
+    }
+
+private:
+    std::size_t count = 0;
+};
+} // namespace
+
+std::size_t get_json_dump_size(const json& j) {
+    CountingStreamBuffer buffer;
+    std::ostream os(&buffer);
+    // width 0 results in the same compact serialization as json::dump()
+    os.width(0);
+    os << j;
+    return buffer.get_count();
 }
 
 ocpp::DateTime align_timestamp(const DateTime timestamp, std::chrono::seconds align_interval) {
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <ocpp/common/database/authorization_index.hpp>
+
+using ocpp::common::AuthorizationIndex;
+using ocpp::common::BloomFilter;
+
+TEST(BloomFilterTest, InsertedKeysAreContainedAfterGrowing) {
+    // More keys than the filter was created for, so it has to grow several times
+    BloomFilter filter(100);
+    for (int i = 0; i < 10000; i++) {
+        filter.insert("TOKEN" + std::to_string(i));
+    }
+
+    EXPECT_EQ(filter.size(), 10000);
+    for (int i = 0; i < 10000; i++) {
+        ASSERT_TRUE(filter.may_contain("TOKEN" + std::to_string(i))) << i;
+    }
+}
+
+TEST(BloomFilterTest, FalsePositiveRateIsLow) {
+    BloomFilter filter;
+    for (int i = 0; i < 10000; i++) {
+        filter.insert("TOKEN" + std::to_string(i));
+    }
+
+    int false_positives = 0;
+    for (int i = 0; i < 10000; i++) {
+        false_positives += filter.may_contain("UNKNOWN" + std::to_string(i)) ? 1 : 0;
+    }
+    EXPECT_LT(false_positives, 200);
+}
+
+TEST(BloomFilterTest, ClearRemovesAllKeys) {
+    BloomFilter filter;
+    filter.insert("TOKEN");
+    filter.clear();
+
+    EXPECT_EQ(filter.size(), 0);
+    EXPECT_FALSE(filter.may_contain("TOKEN"));
+}
+
+TEST(AuthorizationIndexTest, MayContainEveryKeyUntilLoaded) {
+    AuthorizationIndex<int> index;
+    EXPECT_TRUE(index.may_contain("TOKEN"));
+
+    index.load({"KNOWN"});
+    EXPECT_TRUE(index.may_contain("KNOWN"));
+    EXPECT_FALSE(index.may_contain("TOKEN"));
+
+    index.insert_key("TOKEN");
+    EXPECT_TRUE(index.may_contain("TOKEN"));
+
+    index.clear();
+    EXPECT_FALSE(index.may_contain("KNOWN"));
+    EXPECT_FALSE(index.may_contain("TOKEN"));
+}
+
+TEST(AuthorizationIndexTest, RepeatedKeysDoNotGrowTheFilter) {
+    AuthorizationIndex<int> index;
+    index.load({"KNOWN", "KNOWN"});
+    EXPECT_EQ(index.get_nr_of_keys(), 1);
+
+    for (int i = 0; i < 10000; i++) {
+        index.insert_key("KNOWN");
+        index.insert_key("TOKEN" + std::to_string(i % 10));
+    }
+    EXPECT_EQ(index.get_nr_of_keys(), 11);
+}
+
+TEST(AuthorizationIndexTest, ValueReadBeforeModificationIsNotCached) {
+    AuthorizationIndex<int> index;
+    index.load({"TOKEN"});
+
+    const auto generation = index.get_generation();
+    index.erase_value("TOKEN");
+    index.cache_value("TOKEN", 1, generation);
+    EXPECT_FALSE(index.find("TOKEN").has_value());
+
+    index.cache_value("TOKEN", 2, index.get_generation());
+    EXPECT_EQ(index.find("TOKEN"), 2);
+
+    index.update_value("TOKEN", [](int& value) { value = 3; });
+    EXPECT_EQ(index.find("TOKEN"), 3);
+}
+
+TEST(AuthorizationIndexTest, LeastRecentlyUsedValueIsEvicted) {
+    AuthorizationIndex<int> index(2);
+    index.load({"A", "B", "C"});
+
+    index.cache_value("A", 1, index.get_generation());
+    index.cache_value("B", 2, index.get_generation());
+    EXPECT_EQ(index.find("A"), 1);
+    index.cache_value("C", 3, index.get_generation());
+
+    EXPECT_EQ(index.get_nr_of_values(), 2);
+    EXPECT_EQ(index.find("A"), 1);
+    EXPECT_FALSE(index.find("B").has_value());
+    EXPECT_EQ(index.find("C"), 3);
+
+    // Keys stay in the filter when their values are removed
+    index.clear_values();
+    EXPECT_EQ(index.get_nr_of_values(), 0);
+    EXPECT_TRUE(index.may_contain("B"));
+}
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <ocpp/common/composite_schedule_cache.hpp>
+
+using ocpp::CompositeScheduleCache;
+using ocpp::DateTime;
+
+namespace {
+/// \brief The schedule is the offset it was sliced at, so the tests can check which part was returned
+using TestCache = CompositeScheduleCache<int, int, std::int32_t>;
+
+TestCache::SliceFunction offset_slice() {
+    return [](const std::int32_t& schedule, const DateTime&, const std::int32_t offset, const std::int32_t) {
+        return schedule + offset;
+    };
+}
+
+DateTime seconds_after(const DateTime& start, const int seconds) {
+    return DateTime(start.to_time_point() + std::chrono::seconds(seconds));
+}
+} // namespace
+
+TEST(CompositeScheduleCacheTest, ReturnsSliceOfCachedSchedule) {
+    TestCache cache(offset_slice());
+    const DateTime start;
+    cache.put(1, 0, start, 100, 1000);
+
+    EXPECT_EQ(cache.get(1, 0, start, 50), 1000);
+    EXPECT_EQ(cache.get(1, 0, seconds_after(start, 30), 50), 1030);
+    // Passes the end of the cached schedule
+    EXPECT_FALSE(cache.get(1, 0, seconds_after(start, 60), 50).has_value());
+    // Other inputs
+    EXPECT_FALSE(cache.get(1, 1, start, 50).has_value());
+
+    const auto statistics = cache.get_statistics();
+    EXPECT_EQ(statistics.hits, 2);
+    EXPECT_EQ(statistics.misses, 2);
+}
+
+TEST(CompositeScheduleCacheTest, PutDropsSchedulesWithOtherInputs) {
+    TestCache cache(offset_slice());
+    const DateTime start;
+    cache.put(1, 0, start, 100, 1000);
+    cache.put(2, 0, start, 100, 2000);
+    EXPECT_EQ(cache.size(), 2);
+
+    cache.put(3, 1, start, 100, 3000);
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_FALSE(cache.get(1, 0, start, 50).has_value());
+    EXPECT_EQ(cache.get(3, 1, start, 50), 3000);
+}
+
+TEST(CompositeScheduleCacheTest, PutDropsEndedSchedules) {
+    TestCache cache(offset_slice());
+    const DateTime start;
+    cache.put(1, 0, start, 100, 1000);
+    cache.put(2, 0, seconds_after(start, 50), 100, 2000);
+    EXPECT_EQ(cache.size(), 2);
+
+    cache.put(3, 0, seconds_after(start, 100), 100, 3000);
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_FALSE(cache.get(1, 0, start, 10).has_value());
+    EXPECT_EQ(cache.get(2, 0, seconds_after(start, 100), 50), 2050);
+}
+
+TEST(CompositeScheduleCacheTest, LeastRecentlyUsedScheduleIsDropped) {
+    TestCache cache(offset_slice(), 2);
+    const DateTime start;
+    cache.put(1, 0, start, 100, 1000);
+    cache.put(2, 0, start, 100, 2000);
+    EXPECT_EQ(cache.get(1, 0, start, 50), 1000);
+
+    cache.put(3, 0, start, 100, 3000);
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_EQ(cache.get(1, 0, start, 50), 1000);
+    EXPECT_FALSE(cache.get(2, 0, start, 50).has_value());
+    EXPECT_EQ(cache.get(3, 0, start, 50), 3000);
+
+    // Replacing a schedule does not drop another one
+    cache.put(3, 0, start, 100, 4000);
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_EQ(cache.get(3, 0, start, 50), 4000);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+}
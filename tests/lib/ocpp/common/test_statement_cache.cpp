@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include "database_testing_utils.hpp"
+
+#include <ocpp/common/database/statement_cache.hpp>
+
+using ocpp::common::StatementCache;
+
+class StatementCacheTest : public DatabaseTestingUtils {
+protected:
+    StatementCache cache{*this->database};
+    const std::string select_sql = "SELECT VALUE FROM STATEMENT_CACHE_TEST ORDER BY VALUE";
+
+public:
+    StatementCacheTest() {
+        EXPECT_TRUE(this->database->execute_statement("DROP TABLE IF EXISTS STATEMENT_CACHE_TEST"));
+        EXPECT_TRUE(this->database->execute_statement("CREATE TABLE STATEMENT_CACHE_TEST (VALUE INT)"));
+        EXPECT_TRUE(this->database->execute_statement("INSERT INTO STATEMENT_CACHE_TEST VALUES (1), (2)"));
+    }
+
+    ~StatementCacheTest() override {
+        this->cache.clear();
+    }
+};
+
+TEST_F(StatementCacheTest, ReturnedStatementIsReused) {
+    everest::db::sqlite::StatementInterface* first = nullptr;
+    {
+        auto stmt = this->cache.get(this->select_sql);
+        first = &*stmt;
+        EXPECT_EQ(this->cache.size(), 0);
+    }
+    EXPECT_EQ(this->cache.size(), 1);
+
+    auto stmt = this->cache.get(this->select_sql);
+    EXPECT_EQ(&*stmt, first);
+    EXPECT_EQ(this->cache.size(), 0);
+}
+
+TEST_F(StatementCacheTest, ReturnedStatementIsReset) {
+    {
+        auto stmt = this->cache.get(this->select_sql);
+        ASSERT_EQ(stmt->step(), SQLITE_ROW);
+        EXPECT_EQ(stmt->column_int(0), 1);
+    }
+
+    auto stmt = this->cache.get(this->select_sql);
+    ASSERT_EQ(stmt->step(), SQLITE_ROW);
+    EXPECT_EQ(stmt->column_int(0), 1);
+}
+
+TEST_F(StatementCacheTest, StatementInUseIsNotHandedOutTwice) {
+    {
+        auto outer = this->cache.get(this->select_sql);
+        ASSERT_EQ(outer->step(), SQLITE_ROW);
+
+        auto inner = this->cache.get(this->select_sql);
+        EXPECT_NE(&*inner, &*outer);
+        ASSERT_EQ(inner->step(), SQLITE_ROW);
+        EXPECT_EQ(inner->column_int(0), 1);
+
+        ASSERT_EQ(outer->step(), SQLITE_ROW);
+        EXPECT_EQ(outer->column_int(0), 2);
+    }
+    EXPECT_EQ(this->cache.size(), 2);
+}
+
+TEST_F(StatementCacheTest, BindingsAreKeptUntilRebound) {
+    const std::string sql = "SELECT COUNT(*) FROM STATEMENT_CACHE_TEST WHERE VALUE = @value";
+    {
+        auto stmt = this->cache.get(sql);
+        stmt->bind_int("@value", 2);
+        ASSERT_EQ(stmt->step(), SQLITE_ROW);
+        EXPECT_EQ(stmt->column_int(0), 1);
+    }
+
+    auto stmt = this->cache.get(sql);
+    stmt->bind_null("@value");
+    ASSERT_EQ(stmt->step(), SQLITE_ROW);
+    EXPECT_EQ(stmt->column_int(0), 0);
+}
+
+TEST_F(StatementCacheTest, ClearFinalizesStatements) {
+    {
+        auto stmt = this->cache.get(this->select_sql);
+    }
+    EXPECT_EQ(this->cache.size(), 1);
+
+    {
+        auto checked_out = this->cache.get(this->select_sql);
+        this->cache.clear();
+        EXPECT_EQ(this->cache.size(), 0);
+    }
+    // Statements checked out before the cache was cleared are not returned to it
+    EXPECT_EQ(this->cache.size(), 0);
+
+    auto stmt = this->cache.get(this->select_sql);
+    EXPECT_EQ(stmt->step(), SQLITE_ROW);
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <ocpp/common/worker_pool.hpp>
+
+using ocpp::WorkerPool;
+
+TEST(WorkerPoolTest, RunsEveryIndexOnce) {
+    for (const std::size_t nr_of_workers : {1, 4}) {
+        WorkerPool pool(nr_of_workers);
+        EXPECT_EQ(pool.get_nr_of_workers(), nr_of_workers);
+
+        // The same pool runs several times
+        for (const std::size_t count : {0, 1, 3, 100}) {
+            std::vector<std::atomic<int>> runs(count);
+            pool.run(count, [&runs](const std::size_t index) { runs[index]++; });
+            for (const auto& nr_of_runs : runs) {
+                EXPECT_EQ(nr_of_runs, 1);
+            }
+        }
+    }
+}
+
+TEST(WorkerPoolTest, RethrowsExceptionOfTask) {
+    WorkerPool pool(4);
+    std::atomic<int> done{0};
+    EXPECT_THROW(pool.run(20,
+                          [&done](const std::size_t index) {
+                              if (index == 7) {
+                                  throw std::runtime_error("task failed");
+                              }
+                              done++;
+                          }),
+                 std::runtime_error);
+    // The other tasks still run
+    EXPECT_EQ(done, 19);
+
+    // The pool can be used again afterwards
+    done = 0;
+    pool.run(20, [&done](const std::size_t) { done++; });
+    EXPECT_EQ(done, 20);
+}
+
+TEST(WorkerPoolTest, ConcurrentRunsComplete) {
+    WorkerPool pool(4);
+    std::vector<std::thread> callers;
+    std::vector<std::atomic<int>> sums(4);
+    for (std::size_t caller = 0; caller < sums.size(); caller++) {
+        callers.emplace_back([&pool, &sums, caller]() {
+            for (int i = 0; i < 50; i++) {
+                pool.run(10, [&sums, caller](const std::size_t index) { sums[caller] += static_cast<int>(index); });
+            }
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    for (const auto& sum : sums) {
+        EXPECT_EQ(sum, 50 * 45);
+    }
+}
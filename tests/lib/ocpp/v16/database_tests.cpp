@@ -124,6 +124,25 @@ TEST_F(DatabaseTest, test_local_authorization_list_entry_2) {
     ASSERT_EQ(exp_id_tag_info.parentIdTag.value().get(), parent_id_tag.get());
 }
 
+TEST_F(DatabaseTest, test_local_authorization_list_entry_update_after_lookup) {
+
+    const auto id_tag = CiString<20>("DEADBEEF");
+
+    IdTagInfo exp_id_tag_info;
+    exp_id_tag_info.status = AuthorizationStatus::Accepted;
+
+    this->db_handler->insert_or_update_local_authorization_list_entry(id_tag, exp_id_tag_info);
+    ASSERT_EQ(AuthorizationStatus::Accepted, this->db_handler->get_local_authorization_list_entry(id_tag)->status);
+
+    // the entry that was looked up before must not be returned after it changed
+    exp_id_tag_info.status = AuthorizationStatus::Blocked;
+    this->db_handler->insert_or_update_local_authorization_list_entry(id_tag, exp_id_tag_info);
+    ASSERT_EQ(AuthorizationStatus::Blocked, this->db_handler->get_local_authorization_list_entry(id_tag)->status);
+
+    this->db_handler->delete_local_authorization_list_entry(id_tag.get());
+    ASSERT_EQ(std::nullopt, this->db_handler->get_local_authorization_list_entry(id_tag));
+}
+
 TEST_F(DatabaseTest, test_local_authorization_list) {
 
     std::vector<LocalAuthorizationList> local_authorization_list;
@@ -1540,5 +1540,46 @@ TEST_F(ChargepointTestFixture, ClearingExpiredProfilesStartTime) {
     EXPECT_EQ(valid_profiles.size(), 0);
 }
 
+TEST_F(ChargepointTestFixture, GetCompositeSchedule__CachedUntilProfilesChange) {
+    auto handler = createSmartChargingHandler(1);
+    const auto now = ocpp::DateTime();
+    const auto start_schedule = ocpp::DateTime(now.to_time_point() - std::chrono::hours(1));
+    const auto create_profile = [&start_schedule](const int id, const int stack_level, const float limit) {
+        auto profile =
+            ChargingProfile{id,
+                            stack_level,
+                            ChargingProfilePurposeType::TxDefaultProfile,
+                            ChargingProfileKindType::Absolute,
+                            ChargingSchedule{ChargingRateUnit::A, {ChargingSchedulePeriod{0, limit, 1}}, std::nullopt,
+                                             start_schedule, std::nullopt},
+                            {}, // transactionId
+                            std::nullopt,
+                            ocpp::DateTime("2024-01-01T00:00:00"),
+                            ocpp::DateTime("2099-01-01T00:00:00")};
+        return profile;
+    };
+
+    handler->add_tx_default_profile(create_profile(1, 1, 16.0F), connector_id);
+    const auto schedule = handler->get_composite_schedule(connector_id, 3600, ChargingRateUnit::A, false, true);
+    ASSERT_EQ(schedule.chargingSchedulePeriod.size(), 1);
+    EXPECT_EQ(schedule.chargingSchedulePeriod.at(0).limit, 16.0F);
+    EXPECT_EQ(schedule.duration, 3600);
+
+    const auto cached = handler->get_composite_schedule(connector_id, 3600, ChargingRateUnit::A, false, true);
+    ASSERT_EQ(cached.chargingSchedulePeriod.size(), 1);
+    EXPECT_EQ(cached.chargingSchedulePeriod.at(0).limit, 16.0F);
+
+    // A new profile invalidates the cached schedule
+    handler->add_tx_default_profile(create_profile(2, 2, 10.0F), connector_id);
+    const auto changed = handler->get_composite_schedule(connector_id, 3600, ChargingRateUnit::A, false, true);
+    ASSERT_EQ(changed.chargingSchedulePeriod.size(), 1);
+    EXPECT_EQ(changed.chargingSchedulePeriod.at(0).limit, 10.0F);
+
+    EXPECT_TRUE(handler->clear_all_profiles_with_filter(2, std::nullopt, std::nullopt, std::nullopt, true));
+    const auto cleared = handler->get_composite_schedule(connector_id, 3600, ChargingRateUnit::A, false, true);
+    ASSERT_EQ(cleared.chargingSchedulePeriod.size(), 1);
+    EXPECT_EQ(cleared.chargingSchedulePeriod.at(0).limit, 16.0F);
+}
+
 } // namespace v16
 } // namespace ocpp
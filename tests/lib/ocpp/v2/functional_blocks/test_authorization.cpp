@@ -25,6 +25,7 @@
 
 using namespace ocpp::v2;
 using ::testing::_;
+using ::testing::DoAll;
 using ::testing::InSequence;
 using ::testing::Invoke;
 using ::testing::Return;
@@ -50,7 +51,7 @@ protected: // Members
 
     std::atomic<std::uint32_t> delete_expired_entries_count = 0;
     std::atomic<std::uint32_t> get_binary_size_count = 0;
-    std::atomic<std::uint32_t> delete_nr_of_oldest_entries_count = 0;
+    std::atomic<std::uint32_t> delete_oldest_entries_exceeding_count = 0;
     std::mutex call_mutex;
     std::condition_variable call_condition_variable;
 
@@ -93,15 +94,15 @@ protected: // Functions
 
     void wait_for_calls(const std::uint32_t expected_delete_expired_entries_count,
                         const std::uint32_t expected_binary_size_count,
-                        const std::uint32_t expected_delete_nr_of_oldest_entries_count) {
+                        const std::uint32_t expected_delete_oldest_entries_exceeding_count) {
         std::unique_lock<std::mutex> lock(this->call_mutex);
         EXPECT_TRUE(call_condition_variable.wait_for(
             lock, std::chrono::seconds(3),
             [this, expected_delete_expired_entries_count, expected_binary_size_count,
-             expected_delete_nr_of_oldest_entries_count] {
+             expected_delete_oldest_entries_exceeding_count] {
                 return this->delete_expired_entries_count >= expected_delete_expired_entries_count &&
                        this->get_binary_size_count >= expected_binary_size_count &&
-                       this->delete_nr_of_oldest_entries_count >= expected_delete_nr_of_oldest_entries_count;
+                       this->delete_oldest_entries_exceeding_count >= expected_delete_oldest_entries_exceeding_count;
             }));
     }
 
@@ -879,6 +880,9 @@ TEST_F(AuthorizationTest, validate_token_auth_cache_accepted) {
 
     EXPECT_CALL(this->database_handler_mock, authorization_cache_get_entry(_))
         .WillOnce(Return(authorization_cache_entry));
+    // Without the cache cleanup thread the last used timestamp is written immediately
+    EXPECT_CALL(this->database_handler_mock, authorization_cache_update_last_used(_));
+    EXPECT_CALL(this->database_handler_mock, authorization_cache_flush_last_used());
 
     IdToken id_token;
     id_token.type = IdTokenEnumStringType::ISO14443;
@@ -888,6 +892,41 @@ TEST_F(AuthorizationTest, validate_token_auth_cache_accepted) {
               AuthorizationStatusEnum::Accepted);
 }
 
+TEST_F(AuthorizationTest, validate_token_auth_cache_accepted_last_used_flushed_by_cleanup_thread) {
+    this->set_auth_cache_enabled(this->device_model, true);
+    this->set_local_auth_list_ctrlr_enabled(this->device_model, false);
+    this->set_auth_cache_lifetime(this->device_model, 5000);
+    this->set_local_pre_authorize(this->device_model, true);
+
+    AuthorizationCacheEntry authorization_cache_entry =
+        create_authorization_cache_entry(AuthorizationStatusEnum::Accepted, true, false, false, 5000);
+
+    EXPECT_CALL(this->database_handler_mock, authorization_cache_get_entry(_))
+        .WillRepeatedly(Return(authorization_cache_entry));
+    EXPECT_CALL(this->database_handler_mock, authorization_cache_update_last_used(_)).Times(2);
+
+    std::atomic<std::uint32_t> flush_count = 0;
+    ON_CALL(this->database_handler_mock, authorization_cache_flush_last_used())
+        .WillByDefault(update_count_and_notify(flush_count));
+
+    this->authorization->start_auth_cache_cleanup_thread();
+
+    IdToken id_token;
+    id_token.type = IdTokenEnumStringType::ISO14443;
+    id_token.idToken = "test_token";
+
+    EXPECT_EQ(authorization->validate_token(id_token, std::nullopt, std::nullopt).idTokenInfo.status,
+              AuthorizationStatusEnum::Accepted);
+    EXPECT_EQ(authorization->validate_token(id_token, std::nullopt, std::nullopt).idTokenInfo.status,
+              AuthorizationStatusEnum::Accepted);
+    // The timestamps are collected for a while, so they are not written by validate_token
+    EXPECT_EQ(flush_count, 0);
+
+    // Both timestamps are written at once when the thread is stopped
+    this->authorization = nullptr;
+    EXPECT_EQ(flush_count, 1);
+}
+
 TEST_F(AuthorizationTest, validate_token_auth_local_pre_authorize_disabled) {
     EXPECT_CALL(this->connectivity_manager, is_websocket_connected()).WillRepeatedly(Return(true));
     // Enable auth cache.
@@ -1484,6 +1523,26 @@ TEST_F(AuthorizationTest, handle_send_local_authorization_list_duplicate) {
     authorization->handle_message(request);
 }
 
+TEST_F(AuthorizationTest, handle_send_local_authorization_list_duplicate_case_insensitive) {
+    // Enable auth list ctrlr.
+    this->set_local_auth_list_ctrlr_enabled(this->device_model, true);
+
+    // Id tokens are case insensitive, so these tokens are duplicates.
+    auto list = create_example_authorization_data_local_list(false, true);
+    list.push_back(list.at(0));
+    list.back().idToken = get_id_token("test_token_1");
+    const auto request = create_send_local_list_request(1, UpdateEnum::Full, list);
+
+    // There are duplicates in the list, so the request has failed. Nothing is inserted.
+    EXPECT_CALL(this->database_handler_mock, insert_or_update_local_authorization_list(_)).Times(0);
+
+    EXPECT_CALL(mock_dispatcher, dispatch_call_result(_)).WillOnce(Invoke([](const json& call_result) {
+        auto response = call_result[ocpp::CALLRESULT_PAYLOAD].get<SendLocalListResponse>();
+        EXPECT_EQ(response.status, SendLocalListStatusEnum::Failed);
+    }));
+    authorization->handle_message(request);
+}
+
 TEST_F(AuthorizationTest, handle_send_local_authorization_list_no_token_info) {
     // Enable auth list ctrlr.
     this->set_local_auth_list_ctrlr_enabled(this->device_model, true);
@@ -1765,8 +1824,8 @@ TEST_F(AuthorizationTest, cache_cleanup_handler) {
 }
 
 TEST_F(AuthorizationTest, cache_cleanup_handler_exceeds_max_storage) {
-    // Test cleanup handler where the authorization cache exceeds the max storage for a few times. It will then
-    // cleanup, the binary size count will be increased by the test (otherwise it will spin forever).
+    // Test cleanup handler where the authorization cache exceeds the max storage. The oldest entries exceeding the max
+    // storage are then removed at once.
     auto component_variable = ControllerComponentVariables::AuthCacheStorage;
 
     VariableCharacteristics characteristics;
@@ -1794,41 +1853,31 @@ TEST_F(AuthorizationTest, cache_cleanup_handler_exceeds_max_storage) {
         EXPECT_CALL(this->database_handler_mock, authorization_cache_get_binary_size())
             .WillOnce(update_count_and_notify(0, this->get_binary_size_count))
             .RetiresOnSaturation();
-        // Increase size once (which is strange but this is a test...)
-        EXPECT_CALL(this->database_handler_mock, authorization_cache_get_binary_size())
-            .WillOnce(update_count_and_notify(600, this->get_binary_size_count))
-            .RetiresOnSaturation();
         EXPECT_CALL(this->database_handler_mock, authorization_cache_get_binary_size())
             .WillOnce(update_count_and_notify(650, this->get_binary_size_count))
             .RetiresOnSaturation();
-        // Decrease size from now on with every get binary size read.
-        EXPECT_CALL(this->database_handler_mock, authorization_cache_get_binary_size())
-            .WillOnce(update_count_and_notify(550, this->get_binary_size_count))
-            .RetiresOnSaturation();
-        EXPECT_CALL(this->database_handler_mock, authorization_cache_get_binary_size())
-            .WillOnce(update_count_and_notify(300, this->get_binary_size_count))
-            .RetiresOnSaturation();
         EXPECT_CALL(this->database_handler_mock, authorization_cache_get_binary_size())
-            .WillRepeatedly(update_count_and_notify(0, this->get_binary_size_count));
+            .WillRepeatedly(update_count_and_notify(450, this->get_binary_size_count));
     }
 
     EXPECT_CALL(this->database_handler_mock, authorization_cache_delete_expired_entries(_))
         .WillRepeatedly(update_count_and_notify(this->delete_expired_entries_count));
-    EXPECT_CALL(this->database_handler_mock, authorization_cache_delete_nr_of_oldest_entries(1))
-        .WillRepeatedly(update_count_and_notify(this->delete_nr_of_oldest_entries_count));
+    EXPECT_CALL(this->database_handler_mock, authorization_cache_delete_oldest_entries_exceeding(500))
+        .WillOnce(update_count_and_notify(this->delete_oldest_entries_exceeding_count));
+    EXPECT_CALL(this->database_handler_mock, authorization_cache_delete_nr_of_oldest_entries(_)).Times(0);
 
     this->authorization->start_auth_cache_cleanup_thread();
 
     this->delete_expired_entries_count = 0;
-    this->delete_nr_of_oldest_entries_count = 0;
+    this->delete_oldest_entries_exceeding_count = 0;
     this->get_binary_size_count = 0;
 
     this->authorization->trigger_authorization_cache_cleanup();
-    this->wait_for_calls(1, 6, 3);
+    this->wait_for_calls(1, 2, 1);
 }
 
 TEST_F(AuthorizationTest, cache_cleanup_handler_exceeds_max_storage_database_exception) {
-    // Test cleanup handler with an exception thrown when trying to get the binary size from the database handler.
+    // Test cleanup handler with an exception thrown when trying to remove the oldest entries from the database handler.
     auto component_variable = ControllerComponentVariables::AuthCacheStorage;
 
     VariableCharacteristics characteristics;
@@ -1861,10 +1910,6 @@ TEST_F(AuthorizationTest, cache_cleanup_handler_exceeds_max_storage_database_exc
         EXPECT_CALL(this->database_handler_mock, authorization_cache_get_binary_size())
             .WillOnce(update_count_and_notify(600, this->get_binary_size_count))
             .RetiresOnSaturation();
-        // One of the calls will throw an exception.
-        EXPECT_CALL(this->database_handler_mock, authorization_cache_get_binary_size())
-            .WillOnce(Throw(everest::db::Exception("Oops!")))
-            .RetiresOnSaturation();
         // After that, it is still called once at the end of the function (after catching the exception)
         EXPECT_CALL(this->database_handler_mock, authorization_cache_get_binary_size())
             .WillOnce(update_count_and_notify(550, this->get_binary_size_count))
@@ -1873,11 +1918,13 @@ TEST_F(AuthorizationTest, cache_cleanup_handler_exceeds_max_storage_database_exc
 
     EXPECT_CALL(this->database_handler_mock, authorization_cache_delete_expired_entries(_))
         .WillRepeatedly(update_count_and_notify(this->delete_expired_entries_count));
-    EXPECT_CALL(this->database_handler_mock, authorization_cache_delete_nr_of_oldest_entries(1))
-        .WillRepeatedly(update_count_and_notify(this->delete_nr_of_oldest_entries_count));
+    // Removing the oldest entries throws an exception.
+    EXPECT_CALL(this->database_handler_mock, authorization_cache_delete_oldest_entries_exceeding(500))
+        .WillOnce(DoAll(update_count_and_notify(this->delete_oldest_entries_exceeding_count),
+                        Throw(everest::db::Exception("Oops!"))));
 
     this->delete_expired_entries_count = 0;
-    this->delete_nr_of_oldest_entries_count = 0;
+    this->delete_oldest_entries_exceeding_count = 0;
     this->get_binary_size_count = 0;
 
     this->authorization->start_auth_cache_cleanup_thread();
@@ -1894,11 +1941,10 @@ TEST_F(AuthorizationTest, cache_cleanup_handler_database_exception) {
 
     EXPECT_CALL(this->database_handler_mock, authorization_cache_delete_expired_entries(_))
         .WillRepeatedly(Throw(std::out_of_range("expired entries out of range! (?)")));
-    EXPECT_CALL(this->database_handler_mock, authorization_cache_delete_nr_of_oldest_entries(1))
-        .WillRepeatedly(update_count_and_notify(this->delete_nr_of_oldest_entries_count));
+    EXPECT_CALL(this->database_handler_mock, authorization_cache_delete_oldest_entries_exceeding(_)).Times(0);
 
     this->delete_expired_entries_count = 0;
-    this->delete_nr_of_oldest_entries_count = 0;
+    this->delete_oldest_entries_exceeding_count = 0;
     this->get_binary_size_count = 0;
 
     this->authorization->start_auth_cache_cleanup_thread();
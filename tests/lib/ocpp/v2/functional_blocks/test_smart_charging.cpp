@@ -41,6 +41,7 @@
 #include <ocpp/v2/messages/GetChargingProfiles.hpp>
 #include <ocpp/v2/messages/GetCompositeSchedule.hpp>
 #include <ocpp/v2/messages/SetChargingProfile.hpp>
+#include <ocpp/v21/messages/UpdateDynamicSchedule.hpp>
 
 using ::testing::_;
 using ::testing::ByMove;
@@ -1501,6 +1502,143 @@ TEST_F(SmartChargingTest, K08_GetValidProfiles_IfInvalidProfileExists_ThenThatPr
     EXPECT_THAT(profiles, testing::Not(testing::Contains(invalid_station_wide_profile)));
 }
 
+TEST_F(SmartChargingTest, K08_GetValidProfiles_IfTransactionChanges_ThenProfilesAreValidatedAgain) {
+    this->evse_manager->open_transaction(DEFAULT_EVSE_ID, DEFAULT_TX_ID);
+    auto profile = create_charging_profile(DEFAULT_PROFILE_ID, ChargingProfilePurposeEnum::TxProfile,
+                                           create_charge_schedule(ChargingRateUnitEnum::A,
+                                                                  create_charging_schedule_periods({0, 1, 2}),
+                                                                  ocpp::DateTime("2024-01-17T17:00:00")),
+                                           DEFAULT_TX_ID);
+    auto response = smart_charging.conform_validate_and_add_profile(profile, DEFAULT_EVSE_ID);
+    ASSERT_THAT(response.status, testing::Eq(ChargingProfileStatusEnum::Accepted));
+    ASSERT_THAT(smart_charging.get_valid_profiles(DEFAULT_EVSE_ID), testing::Contains(profile));
+
+    this->evse_manager->open_transaction(DEFAULT_EVSE_ID, uuid());
+    EXPECT_THAT(smart_charging.get_valid_profiles(DEFAULT_EVSE_ID), testing::Not(testing::Contains(profile)));
+
+    this->evse_manager->open_transaction(DEFAULT_EVSE_ID, DEFAULT_TX_ID);
+    EXPECT_THAT(smart_charging.get_valid_profiles(DEFAULT_EVSE_ID), testing::Contains(profile));
+}
+
+TEST_F(SmartChargingTest, K08_EffectiveLimitChangedCallback_IsOnlyCalledWhenTheEffectiveLimitChanges) {
+    std::map<std::int32_t, std::vector<EffectiveLimit>> limits;
+    TestSmartCharging sut(*functional_block_context, set_charging_profiles_callback_mock.AsStdFunction(),
+                          stop_transaction_callback_mock.AsStdFunction(),
+                          [&limits](const std::int32_t evse_id, const EffectiveLimit& limit) {
+                              limits[evse_id].push_back(limit);
+                          });
+
+    // Starts at the current hour and never ends, so the limits do not change while the test runs
+    const ocpp::DateTime start(std::chrono::floor<std::chrono::hours>(ocpp::DateTime().to_time_point()));
+    auto profile = create_charging_profile(
+        DEFAULT_PROFILE_ID, ChargingProfilePurposeEnum::ChargingStationMaxProfile,
+        create_charge_schedule(ChargingRateUnitEnum::A,
+                               create_charging_schedule_periods(0, std::nullopt, std::nullopt, 20.0F), start));
+    sut.add_profile(profile, STATION_WIDE_ID);
+
+    ASSERT_THAT(limits[DEFAULT_EVSE_ID].size(), testing::Eq(1));
+    EXPECT_THAT(limits[DEFAULT_EVSE_ID].at(0).charging_rate_unit, testing::Eq(ChargingRateUnitEnum::A));
+    EXPECT_THAT(limits[DEFAULT_EVSE_ID].at(0).period.limit, testing::Optional(20.0F));
+
+    sut.add_profile(profile, STATION_WIDE_ID);
+    EXPECT_THAT(limits[DEFAULT_EVSE_ID].size(), testing::Eq(1));
+
+    profile.chargingSchedule.at(0).chargingSchedulePeriod.at(0).limit = 10.0F;
+    sut.add_profile(profile, STATION_WIDE_ID);
+    ASSERT_THAT(limits[DEFAULT_EVSE_ID].size(), testing::Eq(2));
+    EXPECT_THAT(limits[DEFAULT_EVSE_ID].at(1).period.limit, testing::Optional(10.0F));
+}
+
+TEST_F(SmartChargingTest, K29_UpdateDynamicSchedule_UpdatesOnlyDynamicProfiles) {
+    auto dynamic_profile = create_charging_profile(
+        DEFAULT_PROFILE_ID, ChargingProfilePurposeEnum::TxDefaultProfile,
+        create_charge_schedule(ChargingRateUnitEnum::A,
+                               create_charging_schedule_periods(0, std::nullopt, std::nullopt, 16.0F)),
+        std::nullopt, ChargingProfileKindEnum::Dynamic);
+    smart_charging.add_profile(dynamic_profile, DEFAULT_EVSE_ID);
+    auto absolute_profile = create_charging_profile(
+        DEFAULT_PROFILE_ID + 1, ChargingProfilePurposeEnum::ChargingStationMaxProfile,
+        create_charge_schedule(ChargingRateUnitEnum::A,
+                               create_charging_schedule_periods(0, std::nullopt, std::nullopt, 32.0F),
+                               ocpp::DateTime("2024-01-17T17:00:00")));
+    smart_charging.add_profile(absolute_profile, STATION_WIDE_ID);
+
+    ocpp::v21::UpdateDynamicScheduleRequest request;
+    request.chargingProfileId = DEFAULT_PROFILE_ID;
+    request.scheduleUpdate.limit = 8.0F;
+    auto response = smart_charging.update_dynamic_schedule(request);
+    EXPECT_THAT(response.status, testing::Eq(ChargingProfileStatusEnum::Accepted));
+
+    const auto profiles = smart_charging.get_valid_profiles(DEFAULT_EVSE_ID);
+    const auto updated = std::find_if(profiles.begin(), profiles.end(),
+                                      [](const ChargingProfile& profile) { return profile.id == DEFAULT_PROFILE_ID; });
+    ASSERT_THAT(updated, testing::Ne(profiles.end()));
+    EXPECT_THAT(updated->chargingSchedule.at(0).chargingSchedulePeriod.at(0).limit, testing::Optional(8.0F));
+    EXPECT_THAT(updated->dynUpdateTime.has_value(), testing::IsTrue());
+
+    request.chargingProfileId = DEFAULT_PROFILE_ID + 1;
+    response = smart_charging.update_dynamic_schedule(request);
+    EXPECT_THAT(response.status, testing::Eq(ChargingProfileStatusEnum::Rejected));
+    EXPECT_THAT(response.statusInfo->reasonCode.get(), testing::Eq("InvalidProfile"));
+
+    request.chargingProfileId = DEFAULT_PROFILE_ID + 2;
+    response = smart_charging.update_dynamic_schedule(request);
+    EXPECT_THAT(response.status, testing::Eq(ChargingProfileStatusEnum::Rejected));
+}
+
+TEST_F(SmartChargingTest, K29_UpdateDynamicSchedule_OnlyCalculatesTheEvseOfTheProfileAgain) {
+    constexpr std::int32_t OTHER_EVSE_ID = DEFAULT_EVSE_ID + 1;
+    std::map<std::int32_t, std::vector<EffectiveLimit>> limits;
+    TestSmartCharging sut(*functional_block_context, set_charging_profiles_callback_mock.AsStdFunction(),
+                          stop_transaction_callback_mock.AsStdFunction(),
+                          [&limits](const std::int32_t evse_id, const EffectiveLimit& limit) {
+                              limits[evse_id].push_back(limit);
+                          });
+    this->evse_manager->open_transaction(DEFAULT_EVSE_ID, DEFAULT_TX_ID);
+    this->evse_manager->open_transaction(OTHER_EVSE_ID, uuid());
+
+    const auto create_dynamic_profile = [](const std::int32_t profile_id) {
+        return create_charging_profile(
+            profile_id, ChargingProfilePurposeEnum::TxDefaultProfile,
+            create_charge_schedule(ChargingRateUnitEnum::A,
+                                   create_charging_schedule_periods(0, std::nullopt, std::nullopt, 16.0F)),
+            std::nullopt, ChargingProfileKindEnum::Dynamic);
+    };
+    auto profile = create_dynamic_profile(DEFAULT_PROFILE_ID);
+    sut.add_profile(profile, DEFAULT_EVSE_ID);
+    auto other_profile = create_dynamic_profile(DEFAULT_PROFILE_ID + 1);
+    sut.add_profile(other_profile, OTHER_EVSE_ID);
+    ASSERT_THAT(limits[STATION_WIDE_ID].empty(), testing::IsFalse());
+    EXPECT_THAT(limits[STATION_WIDE_ID].back().period.limit, testing::Optional(32.0F));
+
+    ocpp::v21::UpdateDynamicScheduleRequest request;
+    request.chargingProfileId = DEFAULT_PROFILE_ID;
+    request.scheduleUpdate.limit = 8.0F;
+    const auto before = sut.get_evse_intermediate_profiles_cache_statistics();
+    ASSERT_THAT(sut.update_dynamic_schedule(request).status, testing::Eq(ChargingProfileStatusEnum::Accepted));
+
+    // The other evse is taken from the cache and the station wide limit is summed again
+    const auto after = sut.get_evse_intermediate_profiles_cache_statistics();
+    EXPECT_THAT(after.misses - before.misses, testing::Eq(1));
+    EXPECT_THAT(after.hits - before.hits, testing::Eq(1));
+    EXPECT_THAT(limits[DEFAULT_EVSE_ID].back().period.limit, testing::Optional(8.0F));
+    EXPECT_THAT(limits[STATION_WIDE_ID].back().period.limit, testing::Optional(24.0F));
+    const auto other_evse_limits = limits[OTHER_EVSE_ID].size();
+
+    // Dynamic profiles with a single period do not disable the composite schedule cache
+    sut.update_effective_limits(DEFAULT_EVSE_ID);
+    const auto cached = sut.get_evse_intermediate_profiles_cache_statistics();
+    EXPECT_THAT(cached.misses, testing::Eq(after.misses));
+    EXPECT_THAT(cached.hits, testing::Eq(after.hits));
+
+    request.chargingProfileId = DEFAULT_PROFILE_ID + 1;
+    request.scheduleUpdate.limit = 4.0F;
+    ASSERT_THAT(sut.update_dynamic_schedule(request).status, testing::Eq(ChargingProfileStatusEnum::Accepted));
+    EXPECT_THAT(limits[OTHER_EVSE_ID].size(), testing::Eq(other_evse_limits + 1));
+    EXPECT_THAT(limits[OTHER_EVSE_ID].back().period.limit, testing::Optional(4.0F));
+    EXPECT_THAT(limits[STATION_WIDE_ID].back().period.limit, testing::Optional(12.0F));
+}
+
 TEST_F(SmartChargingTest, K02FR05_SmartChargingTransactionEnds_DeletesTxProfilesByTransactionId) {
     auto transaction_id = uuid();
     EVLOG_debug << "TRANSACTION ID: " << transaction_id;
@@ -1806,6 +1944,46 @@ TEST_F(SmartChargingTest, K08FR07_GetCompositeSchedule_DoesNotCalculateComposite
     smart_charging.handle_message(get_composite_schedule_req);
 }
 
+TEST_F(SmartChargingTest, K08_GetCompositeSchedule_CachedScheduleFollowsProfileChanges) {
+    const auto start_schedule = ocpp::DateTime(ocpp::DateTime().to_time_point() - std::chrono::hours(1));
+    const auto create_max_profile = [&start_schedule](std::int32_t profile_id, std::int32_t stack_level, float limit) {
+        return create_charging_profile(
+            profile_id, ChargingProfilePurposeEnum::ChargingStationMaxProfile,
+            create_charge_schedule(ChargingRateUnitEnum::A,
+                                   create_charging_schedule_periods(0, 1, std::nullopt, limit), start_schedule),
+            std::nullopt, ChargingProfileKindEnum::Absolute, stack_level);
+    };
+    const auto get_schedule = [this]() {
+        return this->smart_charging.get_composite_schedule(DEFAULT_EVSE_ID, std::chrono::seconds(3600),
+                                                           ChargingRateUnitEnum::A);
+    };
+
+    auto profile = create_max_profile(DEFAULT_PROFILE_ID, 1, 16.0F);
+    smart_charging.add_profile(profile, STATION_WIDE_ID);
+    const auto schedule = get_schedule();
+    ASSERT_TRUE(schedule.has_value());
+    ASSERT_EQ(schedule->chargingSchedulePeriod.size(), 1);
+    EXPECT_EQ(schedule->chargingSchedulePeriod.at(0).limit, 16.0F);
+    EXPECT_EQ(schedule->duration, 3600);
+
+    const auto cached = get_schedule();
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(cached->chargingSchedulePeriod, schedule->chargingSchedulePeriod);
+
+    // Adding and removing a profile invalidates the cached schedule
+    auto lower_profile = create_max_profile(DEFAULT_PROFILE_ID + 1, 2, 10.0F);
+    smart_charging.add_profile(lower_profile, STATION_WIDE_ID);
+    const auto lowered = get_schedule();
+    ASSERT_TRUE(lowered.has_value());
+    ASSERT_EQ(lowered->chargingSchedulePeriod.size(), 1);
+    EXPECT_EQ(lowered->chargingSchedulePeriod.at(0).limit, 10.0F);
+
+    EXPECT_TRUE(smart_charging.delete_charging_profile(DEFAULT_PROFILE_ID + 1));
+    const auto restored = get_schedule();
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(restored->chargingSchedulePeriod, schedule->chargingSchedulePeriod);
+}
+
 TEST_F(SmartChargingTest, K01_ValidateTxProfile_EmptyChargingSchedule) {
     auto profile = create_charging_profile(DEFAULT_PROFILE_ID, ChargingProfilePurposeEnum::ChargingStationMaxProfile,
                                            std::vector<ChargingSchedule>{}, ocpp::DateTime("2024-01-17T17:00:00"));
@@ -13,14 +13,17 @@ public:
     MOCK_METHOD(void, authorization_cache_insert_entry,
                 (const std::string& id_token_hash, const IdTokenInfo& id_token_info));
     MOCK_METHOD(void, authorization_cache_update_last_used, (const std::string& id_token_hash));
+    MOCK_METHOD(void, authorization_cache_flush_last_used, ());
     MOCK_METHOD(std::optional<AuthorizationCacheEntry>, authorization_cache_get_entry,
                 (const std::string& id_token_hash));
     MOCK_METHOD(void, authorization_cache_delete_entry, (const std::string& id_token_hash));
     MOCK_METHOD(void, authorization_cache_delete_nr_of_oldest_entries, (size_t nr_to_remove));
+    MOCK_METHOD(void, authorization_cache_delete_oldest_entries_exceeding, (size_t max_binary_size));
     MOCK_METHOD(void, authorization_cache_delete_expired_entries,
                 (std::optional<std::chrono::seconds> auth_cache_lifetime));
     MOCK_METHOD(void, authorization_cache_clear, ());
     MOCK_METHOD(size_t, authorization_cache_get_binary_size, ());
+    MOCK_METHOD(size_t, authorization_cache_reconcile_binary_size, ());
     MOCK_METHOD(void, insert_cs_availability, (OperationalStatusEnum operational_status, bool replace));
     MOCK_METHOD(OperationalStatusEnum, get_cs_availability, ());
     MOCK_METHOD(void, insert_evse_availability,
@@ -43,6 +46,8 @@ public:
     MOCK_METHOD(std::int32_t, get_local_authorization_list_number_of_entries, ());
     MOCK_METHOD(void, transaction_metervalues_insert,
                 (const std::string& transaction_id, const MeterValue& meter_value));
+    MOCK_METHOD(void, transaction_metervalues_insert_batch,
+                (const std::string& transaction_id, const std::vector<MeterValue>& meter_values, bool compact));
     MOCK_METHOD(std::vector<MeterValue>, transaction_metervalues_get_all, (const std::string& transaction_id),
                 (override));
     MOCK_METHOD(void, transaction_metervalues_clear, (const std::string& transaction_id));
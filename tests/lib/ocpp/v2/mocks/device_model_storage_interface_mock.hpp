@@ -15,6 +15,7 @@ public:
                 (const Component&, const Variable&, const AttributeEnum&));
     MOCK_METHOD(std::vector<VariableAttribute>, get_variable_attributes,
                 (const Component&, const Variable&, const std::optional<AttributeEnum>&));
+    MOCK_METHOD(void, for_each_report_data, (const ReportDataCallback&));
     MOCK_METHOD(SetVariableStatusEnum, set_variable_attribute_value,
                 (const Component&, const Variable&, const AttributeEnum&, const std::string&, const std::string&));
     MOCK_METHOD(std::optional<VariableMonitoringMeta>, set_monitoring_data,
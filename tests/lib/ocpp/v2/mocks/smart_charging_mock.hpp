@@ -7,6 +7,7 @@
 
 #include <ocpp/v2/functional_blocks/smart_charging.hpp>
 #include <ocpp/v2/messages/SetChargingProfile.hpp>
+#include <ocpp/v21/messages/UpdateDynamicSchedule.hpp>
 
 namespace ocpp::v2 {
 class SmartChargingMock : public SmartChargingInterface {
@@ -15,10 +16,14 @@ public:
     MOCK_METHOD(std::vector<CompositeSchedule>, get_all_composite_schedules,
                 (const std::int32_t duration, const ChargingRateUnitEnum& unit));
     MOCK_METHOD(void, delete_transaction_tx_profiles, (const std::string& transaction_id));
+    MOCK_METHOD(bool, delete_charging_profile, (std::int32_t profile_id));
     MOCK_METHOD(SetChargingProfileResponse, conform_validate_and_add_profile,
                 (ChargingProfile & profile, std::int32_t evse_id, CiString<20> charging_limit_source,
                  AddChargingProfileSource source_of_request));
     MOCK_METHOD(ProfileValidationResultEnum, conform_and_validate_profile,
                 (ChargingProfile & profile, std::int32_t evse_id, AddChargingProfileSource source_of_request));
+    MOCK_METHOD(void, update_effective_limits, (std::int32_t evse_id));
+    MOCK_METHOD(v21::UpdateDynamicScheduleResponse, update_dynamic_schedule,
+                (const v21::UpdateDynamicScheduleRequest& request));
 };
 } // namespace ocpp::v2
@@ -129,7 +129,9 @@ class TestSmartCharging : public SmartCharging {
 public:
     using SmartCharging::add_profile;
     using SmartCharging::calculate_composite_schedule;
+    using SmartCharging::calculate_composite_schedules;
     using SmartCharging::clear_profiles;
+    using SmartCharging::get_evse_intermediate_profiles_cache_statistics;
     using SmartCharging::get_reported_profiles;
     using SmartCharging::get_valid_profiles;
     using SmartCharging::SmartCharging;
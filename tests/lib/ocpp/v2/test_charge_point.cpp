@@ -639,6 +639,49 @@ TEST_F(ChargePointConstructorTestFixtureV2, CreateChargePoint_CallbacksNotValid_
                  std::invalid_argument);
 }
 
+/// \brief Sets a monitor on AlignedDataInterval and changes the variable, so the monitor is evaluated once
+MonitoringStatistics evaluate_monitor_and_get_statistics(ChargePoint& charge_point, DeviceModel& device_model) {
+    const auto cv = ControllerComponentVariables::AlignedDataInterval;
+    SetMonitoringData request;
+    request.value = 1000.0f;
+    request.type = MonitorEnum::UpperThreshold;
+    request.severity = 0;
+    request.component = cv.component;
+    request.variable = cv.variable.value();
+    const auto results = device_model.set_monitors({request});
+    EXPECT_EQ(results.size(), 1);
+
+    device_model.set_value(cv.component, cv.variable.value(), AttributeEnum::Actual, "1500", "test");
+    const auto statistics = charge_point.get_monitoring_statistics();
+    device_model.clear_custom_monitors();
+    return statistics;
+}
+
+TEST_F(ChargePointConstructorTestFixtureV2, MonitoringStatistics_TimingDisabled_OnlyCountsEvaluations) {
+    configure_callbacks_with_mocks();
+    ocpp::v2::ChargePoint charge_point(evse_connector_structure, device_model, database_handler,
+                                       create_message_queue(database_handler), "/tmp", evse_security, callbacks);
+
+    const auto statistics = evaluate_monitor_and_get_statistics(charge_point, *device_model);
+    EXPECT_EQ(statistics.variable_changes, 1);
+    EXPECT_EQ(statistics.monitor_evaluations, 1);
+    EXPECT_EQ(statistics.evaluation_time.count(), 0);
+}
+
+TEST_F(ChargePointConstructorTestFixtureV2, MonitoringStatistics_TimingEnabled_MeasuresEvaluationTime) {
+    configure_callbacks_with_mocks();
+    const auto timing_cv = ControllerComponentVariables::MonitoringTimingEnabled;
+    device_model->set_value(timing_cv.component, timing_cv.variable.value(), AttributeEnum::Actual, "true", "test",
+                            true);
+    ocpp::v2::ChargePoint charge_point(evse_connector_structure, device_model, database_handler,
+                                       create_message_queue(database_handler), "/tmp", evse_security, callbacks);
+
+    const auto statistics = evaluate_monitor_and_get_statistics(charge_point, *device_model);
+    EXPECT_EQ(statistics.variable_changes, 1);
+    EXPECT_EQ(statistics.monitor_evaluations, 1);
+    EXPECT_GT(statistics.evaluation_time.count(), 0);
+}
+
 class TestChargePoint : public ChargePoint {
 public:
     using ChargePoint::handle_message;
@@ -787,4 +830,30 @@ TEST_F(ChargePointFunctionalityTestFixtureV2, K02FR05_TransactionEnds_WillDelete
     charge_point->on_transaction_finished(DEFAULT_EVSE_ID, timestamp, MeterValue(), ReasonEnum::StoppedByEV,
                                           TriggerReasonEnum::StopAuthorized, {}, {}, ChargingStateEnum::EVConnected);
 }
+
+TEST_F(ChargePointFunctionalityTestFixtureV2, OnEvent_EventsReportedTogether_AreCountedAsCoalesced) {
+    const auto create_event = [](const std::int32_t event_id) {
+        EventData event;
+        event.eventId = event_id;
+        event.timestamp = ocpp::DateTime();
+        event.trigger = EventTriggerEnum::Alerting;
+        event.actualValue = "true";
+        event.component.name = "Component";
+        event.variable.name = "Variable";
+        event.eventNotificationType = EventNotificationEnum::CustomMonitor;
+        return event;
+    };
+
+    auto statistics = charge_point->get_notify_event_statistics();
+    EXPECT_EQ(statistics.events_coalesced, 0);
+    EXPECT_EQ(statistics.messages_saved, 0);
+
+    // Without a coalescing window the events of one call are sent together in one NotifyEvent.req
+    charge_point->on_event({create_event(1), create_event(2), create_event(3)});
+    charge_point->on_event({create_event(4)});
+
+    statistics = charge_point->get_notify_event_statistics();
+    EXPECT_EQ(statistics.events_coalesced, 3);
+    EXPECT_EQ(statistics.messages_saved, 2);
+}
 } // namespace ocpp::v2
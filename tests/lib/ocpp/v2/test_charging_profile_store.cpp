@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <ocpp/v2/charging_profile_store.hpp>
+#include <ocpp/v2/database_handler.hpp>
+
+#include "smart_charging_test_utils.hpp"
+
+namespace ocpp::v2 {
+
+class ChargingProfileStoreTest : public DatabaseTestingUtils {
+protected:
+    DatabaseHandler database_handler{std::make_unique<everest::db::sqlite::Connection>("file::memory:?cache=shared"),
+                                     std::filesystem::path(MIGRATION_FILES_LOCATION_V2)};
+
+    ChargingProfileStoreTest() {
+        this->database_handler.open_connection();
+    }
+
+    static ChargingProfile create_profile(const std::int32_t profile_id, const ChargingProfilePurposeEnum purpose,
+                                          const std::int32_t stack_level = DEFAULT_STACK_LEVEL,
+                                          const std::optional<std::string>& transaction_id = std::nullopt) {
+        return create_charging_profile(profile_id, purpose, create_charge_schedule(ChargingRateUnitEnum::A),
+                                       transaction_id, ChargingProfileKindEnum::Absolute, stack_level);
+    }
+
+    static std::vector<std::int32_t> get_ids(const std::vector<ChargingProfile>& profiles) {
+        std::vector<std::int32_t> ids;
+        for (const auto& profile : profiles) {
+            ids.push_back(profile.id);
+        }
+        return ids;
+    }
+};
+
+/// \brief Tests that profiles stored before the store is used are loaded and that changes are written through
+TEST_F(ChargingProfileStoreTest, test_load_and_write_through) {
+    this->database_handler.insert_or_update_charging_profile(
+        DEFAULT_EVSE_ID, create_profile(1, ChargingProfilePurposeEnum::TxDefaultProfile));
+
+    ChargingProfileStore store(this->database_handler);
+    EXPECT_THAT(get_ids(store.get_for_evse(DEFAULT_EVSE_ID)), testing::ElementsAre(1));
+
+    store.insert_or_update(STATION_WIDE_ID, create_profile(2, ChargingProfilePurposeEnum::ChargingStationMaxProfile),
+                           ChargingLimitSourceEnumStringType::EMS);
+    EXPECT_THAT(get_ids(this->database_handler.get_charging_profiles_for_evse(STATION_WIDE_ID)),
+                testing::ElementsAre(2));
+    EXPECT_EQ(store.get(2)->charging_limit_source, ChargingLimitSourceEnumStringType::EMS);
+
+    EXPECT_TRUE(store.erase(1));
+    EXPECT_FALSE(store.erase(1));
+    EXPECT_TRUE(store.get_for_evse(DEFAULT_EVSE_ID).empty());
+    EXPECT_TRUE(this->database_handler.get_charging_profiles_for_evse(DEFAULT_EVSE_ID).empty());
+}
+
+/// \brief Tests the lookups by purpose, stack level and transaction id, including moving a profile to another evse
+TEST_F(ChargingProfileStoreTest, test_indexes) {
+    ChargingProfileStore store(this->database_handler);
+    store.insert_or_update(DEFAULT_EVSE_ID, create_profile(1, ChargingProfilePurposeEnum::TxDefaultProfile, 1),
+                           ChargingLimitSourceEnumStringType::CSO);
+    store.insert_or_update(DEFAULT_EVSE_ID, create_profile(2, ChargingProfilePurposeEnum::TxDefaultProfile, 2),
+                           ChargingLimitSourceEnumStringType::CSO);
+    store.insert_or_update(DEFAULT_EVSE_ID, create_profile(3, ChargingProfilePurposeEnum::TxProfile, 1, DEFAULT_TX_ID),
+                           ChargingLimitSourceEnumStringType::CSO);
+    store.insert_or_update(STATION_WIDE_ID, create_profile(4, ChargingProfilePurposeEnum::TxDefaultProfile, 1),
+                           ChargingLimitSourceEnumStringType::CSO);
+
+    EXPECT_EQ(store.get_by_purpose(ChargingProfilePurposeEnum::TxDefaultProfile).size(), 3);
+    EXPECT_EQ(store.get_by_purpose(ChargingProfilePurposeEnum::TxDefaultProfile, DEFAULT_EVSE_ID).size(), 2);
+    const auto stack_level_2 = store.get_by_purpose(ChargingProfilePurposeEnum::TxDefaultProfile, DEFAULT_EVSE_ID, 2);
+    ASSERT_EQ(stack_level_2.size(), 1);
+    EXPECT_EQ(stack_level_2[0].profile.id, 2);
+    EXPECT_THAT(get_ids(store.get_by_transaction_id(DEFAULT_TX_ID)), testing::ElementsAre(3));
+
+    // Replacing a profile moves it to the end and to its new evse
+    store.insert_or_update(STATION_WIDE_ID, create_profile(1, ChargingProfilePurposeEnum::TxDefaultProfile, 1),
+                           ChargingLimitSourceEnumStringType::CSO);
+    EXPECT_THAT(get_ids(store.get_for_evse(DEFAULT_EVSE_ID)), testing::ElementsAre(2, 3));
+    EXPECT_THAT(get_ids(store.get_for_evse(STATION_WIDE_ID)), testing::ElementsAre(4, 1));
+
+    store.erase_by_transaction_id(DEFAULT_TX_ID);
+    EXPECT_TRUE(store.get_by_transaction_id(DEFAULT_TX_ID).empty());
+    EXPECT_THAT(get_ids(store.get_for_evse(DEFAULT_EVSE_ID)), testing::ElementsAre(2));
+}
+
+/// \brief Tests that clearing and reporting by criteria selects the same profiles as the database does
+TEST_F(ChargingProfileStoreTest, test_criteria) {
+    ChargingProfileStore store(this->database_handler);
+    store.insert_or_update(DEFAULT_EVSE_ID, create_profile(1, ChargingProfilePurposeEnum::TxDefaultProfile),
+                           ChargingLimitSourceEnumStringType::CSO);
+    store.insert_or_update(DEFAULT_EVSE_ID,
+                           create_profile(2, ChargingProfilePurposeEnum::ChargingStationExternalConstraints),
+                           ChargingLimitSourceEnumStringType::EMS);
+    store.insert_or_update(STATION_WIDE_ID, create_profile(3, ChargingProfilePurposeEnum::ChargingStationMaxProfile),
+                           ChargingLimitSourceEnumStringType::CSO);
+
+    const std::vector<CiString<20>> ems_source = {ChargingLimitSourceEnumStringType::EMS};
+    const auto ems_profiles = store.get_matching_criteria(std::nullopt, create_charging_profile_criteria(ems_source));
+    ASSERT_EQ(ems_profiles.size(), 1);
+    EXPECT_EQ(ems_profiles[0].profile.id, 2);
+    EXPECT_EQ(ems_profiles[0].evse_id, DEFAULT_EVSE_ID);
+    EXPECT_EQ(store.get_matching_criteria(DEFAULT_EVSE_ID, create_charging_profile_criteria()).size(), 2);
+
+    // K10.FR.04: ChargingStationExternalConstraints are not cleared by criteria
+    EXPECT_TRUE(store.clear_matching_criteria(std::nullopt, create_clear_charging_profile(DEFAULT_EVSE_ID)));
+    EXPECT_THAT(get_ids(store.get_for_evse(DEFAULT_EVSE_ID)), testing::ElementsAre(2));
+    EXPECT_EQ(store.get_matching_criteria(std::nullopt, create_charging_profile_criteria()).size(),
+              this->database_handler.get_all_charging_profiles().size());
+
+    EXPECT_TRUE(store.clear_matching_criteria(std::nullopt, std::nullopt));
+    EXPECT_TRUE(store.get_matching_criteria(std::nullopt, create_charging_profile_criteria()).empty());
+    EXPECT_TRUE(this->database_handler.get_all_charging_profiles().empty());
+}
+
+/// \brief Tests that Dynamic profiles are updated in memory only and that other profiles are not updated
+TEST_F(ChargingProfileStoreTest, test_update_dynamic_schedule) {
+    ChargingProfileStore store(this->database_handler);
+    auto dynamic_profile = create_charging_profile(
+        1, ChargingProfilePurposeEnum::TxDefaultProfile,
+        create_charge_schedule(ChargingRateUnitEnum::A,
+                               create_charging_schedule_periods(0, std::nullopt, std::nullopt, 16.0F)),
+        std::nullopt, ChargingProfileKindEnum::Dynamic);
+    store.insert_or_update(DEFAULT_EVSE_ID, dynamic_profile, ChargingLimitSourceEnumStringType::CSO);
+    store.insert_or_update(DEFAULT_EVSE_ID, create_profile(2, ChargingProfilePurposeEnum::TxDefaultProfile, 2),
+                           ChargingLimitSourceEnumStringType::CSO);
+
+    ChargingScheduleUpdate update;
+    update.limit = 8.0F;
+    const DateTime update_time("2024-01-17T17:00:00Z");
+    const auto generation = store.get_generation();
+    const auto updated = store.update_dynamic_schedule(1, update, update_time);
+    ASSERT_TRUE(updated.has_value());
+    EXPECT_EQ(updated->evse_id, DEFAULT_EVSE_ID);
+    EXPECT_EQ(updated->profile.chargingSchedule.at(0).chargingSchedulePeriod.at(0).limit, 8.0F);
+    EXPECT_EQ(updated->profile.dynUpdateTime, update_time);
+    EXPECT_NE(store.get_generation(), generation);
+    EXPECT_EQ(store.get_generation(DEFAULT_EVSE_ID), store.get_generation());
+    EXPECT_EQ(store.get(1)->profile.chargingSchedule.at(0).chargingSchedulePeriod.at(0).limit, 8.0F);
+    EXPECT_THAT(get_ids(store.get_for_evse(DEFAULT_EVSE_ID)), testing::ElementsAre(1, 2));
+
+    const auto stored = this->database_handler.get_charging_profiles_for_evse(DEFAULT_EVSE_ID);
+    ASSERT_EQ(stored.size(), 2);
+    EXPECT_EQ(stored.at(0).chargingSchedule.at(0).chargingSchedulePeriod.at(0).limit, 16.0F);
+
+    EXPECT_FALSE(store.update_dynamic_schedule(2, update, update_time).has_value());
+    EXPECT_FALSE(store.update_dynamic_schedule(3, update, update_time).has_value());
+}
+
+/// \brief Tests that the generation of an evse only changes with the profiles installed on it
+TEST_F(ChargingProfileStoreTest, test_evse_generation) {
+    constexpr std::int32_t OTHER_EVSE_ID = DEFAULT_EVSE_ID + 1;
+    ChargingProfileStore store(this->database_handler);
+    EXPECT_EQ(store.get_generation(DEFAULT_EVSE_ID), 0);
+
+    store.insert_or_update(DEFAULT_EVSE_ID, create_profile(1, ChargingProfilePurposeEnum::TxDefaultProfile),
+                           ChargingLimitSourceEnumStringType::CSO);
+    const auto generation = store.get_generation(DEFAULT_EVSE_ID);
+    EXPECT_NE(generation, 0);
+
+    store.insert_or_update(OTHER_EVSE_ID, create_profile(2, ChargingProfilePurposeEnum::TxDefaultProfile),
+                           ChargingLimitSourceEnumStringType::CSO);
+    EXPECT_EQ(store.get_generation(DEFAULT_EVSE_ID), generation);
+    EXPECT_EQ(store.get_generation(OTHER_EVSE_ID), store.get_generation());
+
+    // Moving a profile changes both evses
+    store.insert_or_update(OTHER_EVSE_ID, create_profile(1, ChargingProfilePurposeEnum::TxDefaultProfile),
+                           ChargingLimitSourceEnumStringType::CSO);
+    EXPECT_EQ(store.get_generation(DEFAULT_EVSE_ID), store.get_generation());
+    EXPECT_EQ(store.get_generation(OTHER_EVSE_ID), store.get_generation());
+
+    EXPECT_TRUE(store.erase(2));
+    EXPECT_NE(store.get_generation(DEFAULT_EVSE_ID), store.get_generation());
+    EXPECT_EQ(store.get_generation(OTHER_EVSE_ID), store.get_generation());
+}
+
+} // namespace ocpp::v2
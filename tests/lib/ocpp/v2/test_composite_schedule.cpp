@@ -1201,4 +1201,26 @@ TEST_F(CompositeScheduleTestFixtureV2, TxDefaultConnector0) {
                                      PeriodEquals(350, 10000.0F)));
 }
 
+TEST_F(CompositeScheduleTestFixtureV2, CalculateCompositeSchedulesForAllEvsesMatchesSingleCalculations) {
+    this->load_charging_profiles_for_evse("singles/ChargingStationMaxProfile_401.json", STATION_WIDE_ID);
+    this->load_charging_profiles_for_evse("singles/Recurring_Daily_301.json", DEFAULT_EVSE_ID);
+    this->load_charging_profiles_for_evse("singles/Relative_303.json", 2);
+    this->reconfigure_for_nr_of_evses(2);
+    this->evse_manager->open_transaction(2, "TX_ID_12345", ocpp::DateTime("2024-01-02T08:00:00"));
+
+    const DateTime start_time = ocpp::DateTime("2024-01-02T08:01:00");
+    const DateTime end_time = ocpp::DateTime("2024-01-02T09:01:00");
+
+    const std::vector<std::int32_t> evse_ids = {2, STATION_WIDE_ID, DEFAULT_EVSE_ID};
+    const auto results =
+        handler->calculate_composite_schedules(start_time, end_time, evse_ids, ChargingRateUnitEnum::A, false, true);
+
+    ASSERT_EQ(results.size(), evse_ids.size());
+    for (std::size_t i = 0; i < evse_ids.size(); i++) {
+        const auto expected = handler->calculate_composite_schedule(start_time, end_time, evse_ids[i],
+                                                                    ChargingRateUnitEnum::A, false, true);
+        EXPECT_EQ(results[i], expected) << "evse " << evse_ids[i];
+    }
+}
+
 } // namespace ocpp::v2
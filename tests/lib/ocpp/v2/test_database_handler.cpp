@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 #include <ocpp/v2/database_handler.hpp>
 #include <optional>
+#include <thread>
 
 using namespace ocpp;
 using namespace ocpp::v2;
@@ -167,6 +168,285 @@ TEST_F(DatabaseHandlerTest, TransactionDeleteNotFound) {
     EXPECT_NO_THROW(this->database_handler.transaction_delete("txIdNotFound"));
 }
 
+TEST_F(DatabaseHandlerTest, InsertOrUpdateLocalAuthorizationList_LargeList) {
+    IdTokenInfo accepted;
+    accepted.status = AuthorizationStatusEnum::Accepted;
+    IdTokenInfo blocked;
+    blocked.status = AuthorizationStatusEnum::Blocked;
+
+    // Large enough to be prepared by several threads
+    constexpr std::int32_t nr_of_entries = 5000;
+    std::vector<AuthorizationData> list;
+    for (std::int32_t i = 0; i < nr_of_entries; i++) {
+        list.push_back(AuthorizationData{IdToken{"TOKEN" + std::to_string(i), IdTokenEnumStringType::ISO14443},
+                                         i % 2 == 0 ? accepted : blocked});
+    }
+    this->database_handler.insert_or_update_local_authorization_list(list);
+
+    EXPECT_EQ(this->database_handler.get_local_authorization_list_number_of_entries(), nr_of_entries);
+    EXPECT_EQ(this->database_handler.get_local_authorization_list_entry(list.at(4000).idToken)->status,
+              AuthorizationStatusEnum::Accepted);
+    EXPECT_EQ(this->database_handler.get_local_authorization_list_entry(list.at(4001).idToken)->status,
+              AuthorizationStatusEnum::Blocked);
+
+    // A differential update with entries to update and to delete
+    std::vector<AuthorizationData> update = {AuthorizationData{list.at(4000).idToken, blocked},
+                                             AuthorizationData{list.at(4001).idToken, std::nullopt}};
+    this->database_handler.insert_or_update_local_authorization_list(update);
+
+    EXPECT_EQ(this->database_handler.get_local_authorization_list_number_of_entries(), nr_of_entries - 1);
+    EXPECT_EQ(this->database_handler.get_local_authorization_list_entry(list.at(4000).idToken)->status,
+              AuthorizationStatusEnum::Blocked);
+    EXPECT_FALSE(this->database_handler.get_local_authorization_list_entry(list.at(4001).idToken).has_value());
+}
+
+TEST_F(DatabaseHandlerTest, LocalAuthorizationListEntry_LookupFollowsUpdates) {
+    const IdToken id_token{"DEADBEEF", IdTokenEnumStringType::ISO14443};
+    const IdToken unknown_id_token{"BEEFBEEF", IdTokenEnumStringType::ISO14443};
+    IdTokenInfo id_token_info;
+    id_token_info.status = AuthorizationStatusEnum::Accepted;
+
+    EXPECT_FALSE(this->database_handler.get_local_authorization_list_entry(id_token).has_value());
+    this->database_handler.insert_or_update_local_authorization_list_entry(id_token, id_token_info);
+    EXPECT_EQ(this->database_handler.get_local_authorization_list_entry(id_token)->status,
+              AuthorizationStatusEnum::Accepted);
+    EXPECT_FALSE(this->database_handler.get_local_authorization_list_entry(unknown_id_token).has_value());
+
+    // The entry that was read before must not be returned after it changed
+    id_token_info.status = AuthorizationStatusEnum::Blocked;
+    this->database_handler.insert_or_update_local_authorization_list_entry(id_token, id_token_info);
+    EXPECT_EQ(this->database_handler.get_local_authorization_list_entry(id_token)->status,
+              AuthorizationStatusEnum::Blocked);
+
+    this->database_handler.delete_local_authorization_list_entry(id_token);
+    EXPECT_FALSE(this->database_handler.get_local_authorization_list_entry(id_token).has_value());
+
+    this->database_handler.insert_or_update_local_authorization_list_entry(id_token, id_token_info);
+    EXPECT_TRUE(this->database_handler.get_local_authorization_list_entry(id_token).has_value());
+    this->database_handler.clear_local_authorization_list();
+    EXPECT_FALSE(this->database_handler.get_local_authorization_list_entry(id_token).has_value());
+}
+
+TEST_F(DatabaseHandlerTest, AuthorizationCache_LookupFollowsUpdates) {
+    const std::string id_token_hash = "DEADBEEF";
+    IdTokenInfo id_token_info;
+    id_token_info.status = AuthorizationStatusEnum::Accepted;
+
+    this->database_handler.authorization_cache_insert_entry(id_token_hash, id_token_info);
+    const auto inserted = this->database_handler.authorization_cache_get_entry(id_token_hash);
+    ASSERT_TRUE(inserted.has_value());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    this->database_handler.authorization_cache_update_last_used(id_token_hash);
+    const auto updated = this->database_handler.authorization_cache_get_entry(id_token_hash);
+    ASSERT_TRUE(updated.has_value());
+    EXPECT_GT(updated->last_used, inserted->last_used);
+
+    this->database_handler.authorization_cache_delete_nr_of_oldest_entries(1);
+    EXPECT_FALSE(this->database_handler.authorization_cache_get_entry(id_token_hash).has_value());
+}
+
+TEST_F(DatabaseHandlerTest, AuthorizationIndex_LoadedWhenConnectionIsOpened) {
+    const IdToken id_token{"DEADBEEF", IdTokenEnumStringType::ISO14443};
+    IdTokenInfo id_token_info;
+    id_token_info.status = AuthorizationStatusEnum::Accepted;
+    this->database_handler.insert_or_update_local_authorization_list_entry(id_token, id_token_info);
+    this->database_handler.authorization_cache_insert_entry("DEADBEEF", id_token_info);
+
+    // Entries written by a previous run are only known from the database
+    DatabaseHandler handler{std::make_unique<everest::db::sqlite::Connection>("file::memory:?cache=shared"),
+                            std::filesystem::path(MIGRATION_FILES_LOCATION_V2)};
+    handler.open_connection();
+    EXPECT_TRUE(handler.get_local_authorization_list_entry(id_token).has_value());
+    EXPECT_TRUE(handler.authorization_cache_get_entry("DEADBEEF").has_value());
+    handler.close_connection();
+
+    this->database_handler.clear_local_authorization_list();
+    this->database_handler.authorization_cache_clear();
+}
+
+TEST_F(DatabaseHandlerTest, AuthorizationCache_BinarySizeFollowsInsertAndDelete) {
+    IdTokenInfo id_token_info;
+    id_token_info.status = AuthorizationStatusEnum::Accepted;
+
+    const auto initial_size = this->database_handler.authorization_cache_get_binary_size();
+    this->database_handler.authorization_cache_insert_entry("DEADBEEF", id_token_info);
+    const auto size = this->database_handler.authorization_cache_get_binary_size();
+    EXPECT_GT(size, initial_size);
+
+    // Replacing an entry by an entry of the same size does not change the size
+    this->database_handler.authorization_cache_insert_entry("DEADBEEF", id_token_info);
+    EXPECT_EQ(this->database_handler.authorization_cache_get_binary_size(), size);
+
+    this->database_handler.authorization_cache_delete_entry("DEADBEEF");
+    EXPECT_EQ(this->database_handler.authorization_cache_get_binary_size(), initial_size);
+}
+
+TEST_F(DatabaseHandlerTest, AuthorizationCache_DeleteOldestEntriesExceeding) {
+    IdTokenInfo id_token_info;
+    id_token_info.status = AuthorizationStatusEnum::Accepted;
+
+    for (const std::string id_token_hash : {"AAAA", "BBBB", "CCCC"}) {
+        this->database_handler.authorization_cache_insert_entry(id_token_hash, id_token_info);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    // Makes BBBB the least recently used entry
+    this->database_handler.authorization_cache_update_last_used("AAAA");
+
+    const auto size = this->database_handler.authorization_cache_get_binary_size();
+    this->database_handler.authorization_cache_delete_oldest_entries_exceeding(size);
+    EXPECT_EQ(this->database_handler.authorization_cache_get_binary_size(), size);
+
+    this->database_handler.authorization_cache_delete_oldest_entries_exceeding(size - 1);
+    EXPECT_LT(this->database_handler.authorization_cache_get_binary_size(), size);
+    EXPECT_TRUE(this->database_handler.authorization_cache_get_entry("AAAA").has_value());
+    EXPECT_FALSE(this->database_handler.authorization_cache_get_entry("BBBB").has_value());
+    EXPECT_TRUE(this->database_handler.authorization_cache_get_entry("CCCC").has_value());
+
+    this->database_handler.authorization_cache_clear();
+    EXPECT_EQ(this->database_handler.authorization_cache_get_binary_size(), 0);
+}
+
+TEST_F(DatabaseHandlerTest, AuthorizationCache_LastUsedWrittenByFlush) {
+    const std::string id_token_hash = "DEADBEEF";
+    IdTokenInfo id_token_info;
+    id_token_info.status = AuthorizationStatusEnum::Accepted;
+    this->database_handler.authorization_cache_insert_entry(id_token_hash, id_token_info);
+    const auto inserted = this->database_handler.authorization_cache_get_entry(id_token_hash);
+    ASSERT_TRUE(inserted.has_value());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    this->database_handler.authorization_cache_update_last_used(id_token_hash);
+
+    const auto get_last_used_from_database = [&id_token_hash]() {
+        DatabaseHandler handler{std::make_unique<everest::db::sqlite::Connection>("file::memory:?cache=shared"),
+                                std::filesystem::path(MIGRATION_FILES_LOCATION_V2)};
+        handler.open_connection();
+        const auto entry = handler.authorization_cache_get_entry(id_token_hash);
+        handler.close_connection();
+        return entry.value().last_used;
+    };
+    EXPECT_EQ(get_last_used_from_database(), inserted->last_used);
+
+    this->database_handler.authorization_cache_flush_last_used();
+    const auto updated = this->database_handler.authorization_cache_get_entry(id_token_hash);
+    ASSERT_TRUE(updated.has_value());
+    EXPECT_EQ(get_last_used_from_database(), updated->last_used);
+    EXPECT_GT(updated->last_used, inserted->last_used);
+
+    this->database_handler.authorization_cache_clear();
+}
+
+MeterValue create_meter_value(const std::string& timestamp, const float energy, const ReadingContextEnum context) {
+    SampledValue energy_value;
+    energy_value.value = energy;
+    energy_value.measurand = MeasurandEnum::Energy_Active_Import_Register;
+    energy_value.context = context;
+    energy_value.unitOfMeasure = UnitOfMeasure{"kWh", 3};
+
+    SampledValue current_value;
+    current_value.value = 15.7F;
+    current_value.measurand = MeasurandEnum::Current_Import;
+    current_value.phase = PhaseEnum::L2;
+    current_value.location = LocationEnum::Outlet;
+    current_value.context = context;
+
+    MeterValue meter_value;
+    meter_value.timestamp = DateTime{timestamp};
+    meter_value.sampledValue = {energy_value, current_value};
+    return meter_value;
+}
+
+TEST_F(DatabaseHandlerTest, TransactionMetervaluesInsertBatch_GetAllReturnsMeterValuesInOrder) {
+    const std::vector<MeterValue> meter_values = {
+        create_meter_value("2024-07-15T08:01:02Z", 1.0F, ReadingContextEnum::Transaction_Begin),
+        create_meter_value("2024-07-15T08:02:02Z", 1.25F, ReadingContextEnum::Sample_Periodic),
+        create_meter_value("2024-07-15T08:03:02Z", 1.5F, ReadingContextEnum::Sample_Periodic)};
+
+    this->database_handler.transaction_metervalues_insert_batch("txId", meter_values, false);
+
+    EXPECT_EQ(json(this->database_handler.transaction_metervalues_get_all("txId")), json(meter_values));
+}
+
+TEST_F(DatabaseHandlerTest, TransactionMetervaluesInsertBatch_CompactRoundTrip) {
+    auto signed_meter_value = create_meter_value("2024-07-15T08:03:02Z", 1.5F, ReadingContextEnum::Sample_Periodic);
+    signed_meter_value.sampledValue.at(0).signedMeterValue = SignedMeterValue{"data", "OCMF", "ECDSA", std::nullopt};
+    signed_meter_value.sampledValue.at(1).customData = json{{"vendorId", "vendor"}};
+
+    const std::vector<MeterValue> first_batch = {
+        create_meter_value("2024-07-15T08:01:02Z", 1.0F, ReadingContextEnum::Transaction_Begin),
+        create_meter_value("2024-07-15T08:02:02Z", 1.1F, ReadingContextEnum::Sample_Periodic)};
+    const std::vector<MeterValue> second_batch = {
+        signed_meter_value, create_meter_value("2024-07-15T08:03:00Z", 1.7F, ReadingContextEnum::Sample_Clock)};
+
+    this->database_handler.transaction_metervalues_insert_batch("txId", first_batch, true);
+    this->database_handler.transaction_metervalues_insert_batch("txId", second_batch, true);
+
+    // The timestamps are stored relative to the previous meter value, which can also be later
+    std::vector<MeterValue> expected = first_batch;
+    expected.insert(expected.end(), second_batch.begin(), second_batch.end());
+    EXPECT_EQ(json(this->database_handler.transaction_metervalues_get_all("txId")), json(expected));
+    EXPECT_TRUE(this->database_handler.transaction_metervalues_get_all("otherTxId").empty());
+}
+
+TEST_F(DatabaseHandlerTest, TransactionMetervaluesInsertBatch_InvalidMeterValueIsSkipped) {
+    auto invalid_meter_value = create_meter_value("2024-07-15T08:02:02Z", 1.1F, ReadingContextEnum::Sample_Periodic);
+    invalid_meter_value.sampledValue.at(1).context = ReadingContextEnum::Sample_Clock;
+    const std::vector<MeterValue> valid_meter_values = {
+        create_meter_value("2024-07-15T08:01:02Z", 1.0F, ReadingContextEnum::Transaction_Begin),
+        create_meter_value("2024-07-15T08:03:02Z", 1.2F, ReadingContextEnum::Sample_Periodic)};
+    const std::vector<MeterValue> meter_values = {valid_meter_values.at(0), invalid_meter_value,
+                                                  valid_meter_values.at(1)};
+
+    for (const bool compact : {false, true}) {
+        const std::string transaction_id = compact ? "compactTxId" : "txId";
+        EXPECT_NO_THROW(this->database_handler.transaction_metervalues_insert_batch(transaction_id, meter_values,
+                                                                                    compact));
+        EXPECT_EQ(json(this->database_handler.transaction_metervalues_get_all(transaction_id)),
+                  json(valid_meter_values));
+    }
+}
+
+TEST_F(DatabaseHandlerTest, TransactionMetervaluesInsertBatch_StoredMeterValueIsSkipped) {
+    const std::vector<MeterValue> first_batch = {
+        create_meter_value("2024-07-15T08:01:02Z", 1.0F, ReadingContextEnum::Transaction_Begin),
+        create_meter_value("2024-07-15T08:02:02Z", 1.1F, ReadingContextEnum::Sample_Periodic)};
+    // Same timestamp as a stored meter value, but another context
+    const auto clock_aligned = create_meter_value("2024-07-15T08:02:02Z", 1.1F, ReadingContextEnum::Sample_Clock);
+    const auto sample = create_meter_value("2024-07-15T08:03:02Z", 1.2F, ReadingContextEnum::Sample_Periodic);
+    const std::vector<MeterValue> second_batch = {first_batch.at(1), clock_aligned, sample, sample};
+
+    for (const bool compact : {false, true}) {
+        const std::string transaction_id = compact ? "compactTxId" : "txId";
+        this->database_handler.transaction_metervalues_insert_batch(transaction_id, first_batch, compact);
+        this->database_handler.transaction_metervalues_insert_batch(transaction_id, second_batch, compact);
+        EXPECT_EQ(json(this->database_handler.transaction_metervalues_get_all(transaction_id)),
+                  json(std::vector<MeterValue>{first_batch.at(0), first_batch.at(1), clock_aligned, sample}));
+    }
+}
+
+TEST_F(DatabaseHandlerTest, TransactionMetervaluesClear_ClearsBothFormats) {
+    const auto meter_start = create_meter_value("2024-07-15T08:01:02Z", 1.0F, ReadingContextEnum::Transaction_Begin);
+    const auto sample = create_meter_value("2024-07-15T08:02:02Z", 1.1F, ReadingContextEnum::Sample_Periodic);
+    const auto meter_stop = create_meter_value("2024-07-15T08:03:02Z", 1.2F, ReadingContextEnum::Transaction_End);
+
+    this->database_handler.transaction_metervalues_insert("txId", meter_start);
+    this->database_handler.transaction_metervalues_insert_batch("txId", {meter_stop}, true);
+    this->database_handler.transaction_metervalues_insert_batch("txId", {sample}, false);
+
+    // Meter values of both formats are returned in timestamp order
+    EXPECT_EQ(json(this->database_handler.transaction_metervalues_get_all("txId")),
+              json(std::vector<MeterValue>{meter_start, sample, meter_stop}));
+
+    this->database_handler.transaction_metervalues_clear("txId");
+    EXPECT_TRUE(this->database_handler.transaction_metervalues_get_all("txId").empty());
+
+    // A new transaction with the same id starts with absolute timestamps again
+    this->database_handler.transaction_metervalues_insert_batch("txId", {sample}, true);
+    EXPECT_EQ(json(this->database_handler.transaction_metervalues_get_all("txId")),
+              json(std::vector<MeterValue>{sample}));
+}
+
 TEST_F(DatabaseHandlerTest, KO1_FR27_DatabaseWithNoData_InsertProfile) {
     ChargingProfile profile;
     profile.id = 1;
@@ -347,6 +347,66 @@ TEST_F(DeviceModelTest, test_clear_monitors) {
     dm->clear_monitors(hardwired_monitor_ids, true);
 }
 
+/// \brief Tests the monitor listeners are called for new, updated and cleared monitors
+TEST_F(DeviceModelTest, test_monitor_listeners) {
+    EVSE evse;
+    evse.id = 1;
+    evse.connectorId = 1;
+
+    Component component;
+    component.name = "Connector";
+    component.evse = evse;
+    Variable variable;
+    variable.name = "SupplyPhases";
+
+    std::vector<std::int32_t> updated_monitors;
+    std::vector<std::int32_t> cleared_monitors;
+    dm->register_monitor_listener([&updated_monitors](const VariableMonitoringMeta& updated_monitor, const Component&,
+                                                      const Variable&, const VariableCharacteristics&,
+                                                      const VariableAttribute&, const std::string&) {
+        updated_monitors.push_back(updated_monitor.monitor.id);
+    });
+    dm->register_monitor_cleared_listener(
+        [&cleared_monitors](const std::int32_t monitor_id) { cleared_monitors.push_back(monitor_id); });
+
+    SetMonitoringData request;
+    request.value = 60.0;
+    request.type = MonitorEnum::Periodic;
+    request.severity = 7;
+    request.component = component;
+    request.variable = variable;
+
+    // New monitor
+    auto results = dm->set_monitors({request});
+    ASSERT_EQ(results.size(), 1);
+    ASSERT_EQ(results[0].status, SetMonitoringStatusEnum::Accepted);
+    const auto monitor_id = results[0].id.value();
+    ASSERT_EQ(updated_monitors.size(), 1);
+    EXPECT_EQ(updated_monitors[0], monitor_id);
+
+    // Updated monitor
+    request.id = monitor_id;
+    request.value = 120.0;
+    results = dm->set_monitors({request});
+    ASSERT_EQ(results[0].status, SetMonitoringStatusEnum::Accepted);
+    ASSERT_EQ(updated_monitors.size(), 2);
+    EXPECT_EQ(updated_monitors[1], monitor_id);
+
+    EXPECT_EQ(dm->clear_custom_monitors(), 1);
+    ASSERT_EQ(cleared_monitors.size(), 1);
+    EXPECT_EQ(cleared_monitors[0], monitor_id);
+
+    // Set again and clear by id
+    request.id.reset();
+    results = dm->set_monitors({request});
+    ASSERT_EQ(results[0].status, SetMonitoringStatusEnum::Accepted);
+    const auto clear_results = dm->clear_monitors({results[0].id.value()});
+    ASSERT_EQ(clear_results.size(), 1);
+    EXPECT_EQ(clear_results[0].status, ClearMonitoringStatusEnum::Accepted);
+    ASSERT_EQ(cleared_monitors.size(), 2);
+    EXPECT_EQ(cleared_monitors[1], results[0].id.value());
+}
+
 /// \brief Tests check_integrity does not raise error for valid database
 TEST_F(DeviceModelTest, test_check_integrity_valid) {
     EXPECT_NO_THROW(dm->check_integrity(evse_connector_structure));
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <device_model_test_helper.hpp>
+
+#include <ocpp/v2/device_model.hpp>
+#include <ocpp/v2/device_model_storage_in_memory.hpp>
+#include <ocpp/v2/device_model_storage_sqlite.hpp>
+
+namespace ocpp {
+namespace v2 {
+
+class DeviceModelStorageInMemoryTest : public ::testing::Test {
+protected:
+    const std::string DATABASE_PATH = "file::memory:?cache=shared";
+    DeviceModelTestHelper device_model_test_helper;
+    Component component;
+    Variable variable;
+
+public:
+    DeviceModelStorageInMemoryTest() : device_model_test_helper(DATABASE_PATH) {
+        EVSE evse;
+        evse.id = 1;
+        evse.connectorId = 1;
+        component.name = "Connector";
+        component.evse = evse;
+        variable.name = "SupplyPhases";
+    }
+
+    std::unique_ptr<DeviceModelStorageInMemory> create_storage() {
+        return std::make_unique<DeviceModelStorageInMemory>(std::make_unique<DeviceModelStorageSqlite>(DATABASE_PATH));
+    }
+};
+
+/// \brief Tests the in memory storage returns the same device model and attributes as the persistent storage
+TEST_F(DeviceModelStorageInMemoryTest, test_load) {
+    DeviceModelStorageSqlite sqlite(DATABASE_PATH);
+    auto storage = create_storage();
+
+    const auto device_model = sqlite.get_device_model();
+    ASSERT_EQ(storage->get_device_model().size(), device_model.size());
+
+    size_t nr_of_report_data = 0;
+    storage->for_each_report_data([&](ReportData&& report_data) {
+        nr_of_report_data++;
+        const auto attributes =
+            sqlite.get_variable_attributes(report_data.component, report_data.variable, std::nullopt);
+        EXPECT_EQ(json(report_data.variableAttribute).size(), json(attributes).size());
+        for (const auto& attribute : attributes) {
+            const auto in_memory_attribute =
+                storage->get_variable_attribute(report_data.component, report_data.variable, attribute.type.value());
+            ASSERT_TRUE(in_memory_attribute.has_value());
+            EXPECT_EQ(json(in_memory_attribute.value()), json(attribute));
+        }
+    });
+
+    size_t nr_of_report_data_sqlite = 0;
+    sqlite.for_each_report_data([&](ReportData&&) { nr_of_report_data_sqlite++; });
+    EXPECT_EQ(nr_of_report_data, nr_of_report_data_sqlite);
+}
+
+/// \brief Tests a set value is available immediately and written through to the persistent storage
+TEST_F(DeviceModelStorageInMemoryTest, test_set_variable_attribute_value) {
+    auto storage = create_storage();
+
+    EXPECT_EQ(storage->set_variable_attribute_value(component, variable, AttributeEnum::Actual, "2", "test"),
+              SetVariableStatusEnum::Accepted);
+    EXPECT_EQ(storage->get_variable_attribute(component, variable, AttributeEnum::Actual).value().value.value(), "2");
+
+    Variable unknown_variable;
+    unknown_variable.name = "UnknownVariable";
+    EXPECT_EQ(storage->set_variable_attribute_value(component, unknown_variable, AttributeEnum::Actual, "2", "test"),
+              SetVariableStatusEnum::Rejected);
+
+    storage->flush();
+    DeviceModelStorageSqlite sqlite(DATABASE_PATH);
+    EXPECT_EQ(sqlite.get_variable_attribute(component, variable, AttributeEnum::Actual).value().value.value(), "2");
+}
+
+/// \brief Tests monitors get the same id in memory and in the persistent storage
+TEST_F(DeviceModelStorageInMemoryTest, test_monitors) {
+    auto storage = create_storage();
+    storage->clear_custom_variable_monitors();
+
+    SetMonitoringData data;
+    data.value = 0.0;
+    data.type = MonitorEnum::PeriodicClockAligned;
+    data.severity = 7;
+    data.component = component;
+    data.variable = variable;
+
+    const auto monitor = storage->set_monitoring_data(data, VariableMonitorType::CustomMonitor);
+    ASSERT_TRUE(monitor.has_value());
+    const auto monitors = storage->get_monitoring_data({}, component, variable);
+    ASSERT_EQ(monitors.size(), 1);
+    EXPECT_EQ(monitors.at(0).monitor.id, monitor.value().monitor.id);
+
+    storage->flush();
+    {
+        DeviceModelStorageSqlite sqlite(DATABASE_PATH);
+        const auto persisted_monitors = sqlite.get_monitoring_data({}, component, variable);
+        ASSERT_EQ(persisted_monitors.size(), 1);
+        EXPECT_EQ(persisted_monitors.at(0).monitor.id, monitor.value().monitor.id);
+    }
+
+    EXPECT_EQ(storage->clear_variable_monitor(monitor.value().monitor.id, false), ClearMonitoringStatusEnum::Accepted);
+    EXPECT_EQ(storage->clear_variable_monitor(monitor.value().monitor.id, false), ClearMonitoringStatusEnum::NotFound);
+    EXPECT_TRUE(storage->get_monitoring_data({}, component, variable).empty());
+
+    storage->flush();
+    DeviceModelStorageSqlite sqlite(DATABASE_PATH);
+    EXPECT_TRUE(sqlite.get_monitoring_data({}, component, variable).empty());
+}
+
+} // namespace v2
+} // namespace ocpp
@@ -4,6 +4,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <map>
+#include <set>
+
 #include <device_model_test_helper.hpp>
 
 #include <ocpp/v2/device_model.hpp>
@@ -43,5 +46,64 @@ TEST_F(DeviceModelStorageSQLiteTest, test_check_integrity_invalid) {
     EXPECT_NO_THROW(dm.check_integrity());
 }
 
+/// \brief Tests that streaming the report data returns every variable with the same attributes as querying them one by
+/// one
+TEST_F(DeviceModelStorageSQLiteTest, test_for_each_report_data) {
+    DeviceModelStorageSqlite dm(DATABASE_PATH);
+    const auto device_model = dm.get_device_model();
+
+    size_t nr_of_report_data = 0;
+    dm.for_each_report_data([&](ReportData&& report_data) {
+        nr_of_report_data++;
+        ASSERT_EQ(device_model.count(report_data.component), 1);
+        const auto& variable_map = device_model.at(report_data.component);
+        ASSERT_EQ(variable_map.count(report_data.variable), 1);
+        ASSERT_TRUE(report_data.variableCharacteristics.has_value());
+        EXPECT_EQ(json(report_data.variableCharacteristics.value()),
+                  json(variable_map.at(report_data.variable).characteristics));
+
+        const auto attributes = dm.get_variable_attributes(report_data.component, report_data.variable, std::nullopt);
+        const json streamed_attributes = report_data.variableAttribute;
+        ASSERT_EQ(streamed_attributes.size(), attributes.size());
+        for (const auto& attribute : attributes) {
+            EXPECT_NE(std::find(streamed_attributes.begin(), streamed_attributes.end(), json(attribute)),
+                      streamed_attributes.end());
+        }
+    });
+
+    size_t nr_of_variables = 0;
+    for (const auto& [component, variable_map] : device_model) {
+        nr_of_variables += variable_map.size();
+    }
+    EXPECT_EQ(nr_of_report_data, nr_of_variables);
+}
+
+/// \brief Tests that the default implementation of the interface, which storages that do not override it use, streams
+/// the same report data as the single query of the SQLite storage
+TEST_F(DeviceModelStorageSQLiteTest, test_for_each_report_data_default_implementation) {
+    DeviceModelStorageSqlite dm(DATABASE_PATH);
+
+    using ReportDataSet = std::map<std::string, std::set<std::string>>;
+    const auto collect = [](ReportDataSet& report_data_set) {
+        return [&report_data_set](ReportData&& report_data) {
+            const auto key = json(report_data.component).dump() + json(report_data.variable).dump() +
+                             json(report_data.variableCharacteristics.value()).dump();
+            EXPECT_EQ(report_data_set.count(key), 0);
+            auto& attributes = report_data_set[key];
+            for (const auto& attribute : report_data.variableAttribute) {
+                attributes.insert(json(attribute).dump());
+            }
+        };
+    };
+
+    ReportDataSet streamed;
+    dm.for_each_report_data(collect(streamed));
+    ReportDataSet queried;
+    dm.DeviceModelStorageInterface::for_each_report_data(collect(queried));
+
+    EXPECT_FALSE(queried.empty());
+    EXPECT_EQ(streamed, queried);
+}
+
 } // namespace v2
 } // namespace ocpp
@@ -457,6 +457,38 @@ TEST_F(InitDeviceModelDbTest, wrong_type) {
     }
 }
 
+TEST_F(InitDeviceModelDbTest, component_config_fingerprint) {
+    const std::string fingerprint = get_component_config_fingerprint(CONFIGS_PATH);
+    EXPECT_EQ(fingerprint, get_component_config_fingerprint(CONFIGS_PATH));
+    EXPECT_NE(fingerprint, get_component_config_fingerprint(CONFIGS_PATH_CHANGED));
+    EXPECT_THROW(get_component_config_fingerprint("/tmp/thisdoesnotexisthopefully"),
+                 std::filesystem::filesystem_error);
+}
+
+TEST_F(InitDeviceModelDbTest, init_db_skipped_when_component_config_unchanged) {
+    InitDeviceModelDb db(DATABASE_PATH, MIGRATION_FILES_PATH);
+    db.database_exists = false;
+    ASSERT_NO_THROW(db.initialize_database(std::filesystem::path(CONFIGS_PATH), false));
+    EXPECT_TRUE(component_exists("EVSE", std::nullopt, 2, std::nullopt));
+
+    // Remove a component from the database only. As the component config files did not change, the component config
+    // is not applied again and the component stays removed.
+    ASSERT_TRUE(this->database->execute_statement("DELETE FROM COMPONENT WHERE NAME='EVSE' AND EVSE_ID=2"));
+
+    InitDeviceModelDb db2(DATABASE_PATH, MIGRATION_FILES_PATH);
+    db2.database_exists = true;
+    ASSERT_NO_THROW(db2.initialize_database(std::filesystem::path(CONFIGS_PATH), false));
+    EXPECT_FALSE(component_exists("EVSE", std::nullopt, 2, std::nullopt));
+
+    // Changed component config files are applied.
+    InitDeviceModelDb db3(DATABASE_PATH, MIGRATION_FILES_PATH);
+    db3.database_exists = true;
+    ASSERT_NO_THROW(db3.initialize_database(std::filesystem::path(CONFIGS_PATH_CHANGED), false));
+    EXPECT_TRUE(component_exists("EVSE", std::nullopt, 2, std::nullopt));
+    EXPECT_TRUE(component_exists("EVSE", std::nullopt, 3, std::nullopt));
+    EXPECT_TRUE(variable_exists("Connector", std::nullopt, 1, 1, "Enabled", std::nullopt));
+}
+
 // Helper functions
 
 bool InitDeviceModelDbTest::check_all_tables_exist(const std::vector<std::string>& tables, const bool exist) {
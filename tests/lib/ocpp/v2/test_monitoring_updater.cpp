@@ -0,0 +1,263 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <mutex>
+
+#include <device_model_test_helper.hpp>
+
+#include <ocpp/v2/ctrlr_component_variables.hpp>
+#include <ocpp/v2/device_model.hpp>
+#include <ocpp/v2/monitoring_updater.hpp>
+
+namespace ocpp {
+namespace v2 {
+
+namespace {
+VariableMonitoringMeta create_monitor(const std::int32_t id, const MonitorEnum type, const float value,
+                                      const std::optional<std::string>& reference_value = std::nullopt) {
+    VariableMonitoringMeta monitor_meta;
+    monitor_meta.monitor.id = id;
+    monitor_meta.monitor.transaction = false;
+    monitor_meta.monitor.value = value;
+    monitor_meta.monitor.type = type;
+    monitor_meta.monitor.severity = 0;
+    monitor_meta.type = VariableMonitorType::CustomMonitor;
+    monitor_meta.reference_value = reference_value;
+    return monitor_meta;
+}
+
+VariableCharacteristics create_characteristics(const DataEnum data_type) {
+    VariableCharacteristics characteristics;
+    characteristics.dataType = data_type;
+    characteristics.supportsMonitoring = true;
+    return characteristics;
+}
+
+bool is_triggered(const VariableMonitorEvaluation& evaluation, const std::int32_t monitor_id) {
+    for (std::size_t i = 0; i < evaluation.monitor_ids.size(); i++) {
+        if (evaluation.monitor_ids[i] == monitor_id) {
+            return evaluation.triggered[i] != 0;
+        }
+    }
+    ADD_FAILURE() << "Monitor " << monitor_id << " is not part of the evaluation";
+    return false;
+}
+} // namespace
+
+/// \brief Tests that only trigger monitors are part of the evaluation
+TEST(MonitorEvaluationTest, test_create_skips_periodic_monitors) {
+    const std::unordered_map<std::int64_t, VariableMonitoringMeta> monitors{
+        {1, create_monitor(1, MonitorEnum::UpperThreshold, 10.0f)},
+        {2, create_monitor(2, MonitorEnum::Periodic, 60.0f)},
+        {3, create_monitor(3, MonitorEnum::PeriodicClockAligned, 60.0f)},
+        {4, create_monitor(4, MonitorEnum::Delta, 1.0f, "5")},
+    };
+
+    const auto evaluation = create_monitor_evaluation(monitors, create_characteristics(DataEnum::integer));
+    EXPECT_EQ(evaluation.nr_of_monitors, 4);
+    EXPECT_TRUE(evaluation.is_numeric);
+    ASSERT_EQ(evaluation.monitor_ids.size(), 2);
+    EXPECT_EQ(evaluation.triggered.size(), 2);
+}
+
+/// \brief Tests the threshold and delta monitors of a decimal variable
+TEST(MonitorEvaluationTest, test_decimal_monitors) {
+    const std::unordered_map<std::int64_t, VariableMonitoringMeta> monitors{
+        {1, create_monitor(1, MonitorEnum::UpperThreshold, 10.5f)},
+        {2, create_monitor(2, MonitorEnum::LowerThreshold, 2.5f)},
+        {3, create_monitor(3, MonitorEnum::Delta, 1.5f, "6.0")},
+    };
+    auto evaluation = create_monitor_evaluation(monitors, create_characteristics(DataEnum::decimal));
+
+    evaluate_monitors(evaluation, DataEnum::decimal, "6.0", "7.0");
+    EXPECT_FALSE(is_triggered(evaluation, 1));
+    EXPECT_FALSE(is_triggered(evaluation, 2));
+    EXPECT_FALSE(is_triggered(evaluation, 3));
+
+    evaluate_monitors(evaluation, DataEnum::decimal, "7.0", "10.75");
+    EXPECT_TRUE(is_triggered(evaluation, 1));
+    EXPECT_FALSE(is_triggered(evaluation, 2));
+    EXPECT_TRUE(is_triggered(evaluation, 3));
+
+    evaluate_monitors(evaluation, DataEnum::decimal, "10.75", "2.25");
+    EXPECT_FALSE(is_triggered(evaluation, 1));
+    EXPECT_TRUE(is_triggered(evaluation, 2));
+    EXPECT_TRUE(is_triggered(evaluation, 3));
+
+    // Values equal to the threshold or delta do not trigger
+    evaluate_monitors(evaluation, DataEnum::decimal, "2.25", "4.5");
+    EXPECT_FALSE(is_triggered(evaluation, 1));
+    EXPECT_FALSE(is_triggered(evaluation, 2));
+    EXPECT_FALSE(is_triggered(evaluation, 3));
+}
+
+/// \brief Tests the threshold and delta monitors of an integer variable
+TEST(MonitorEvaluationTest, test_integer_monitors) {
+    const std::unordered_map<std::int64_t, VariableMonitoringMeta> monitors{
+        {1, create_monitor(1, MonitorEnum::UpperThreshold, 100.0f)},
+        {2, create_monitor(2, MonitorEnum::LowerThreshold, 10.0f)},
+        {3, create_monitor(3, MonitorEnum::Delta, 20.0f, "50")},
+    };
+    auto evaluation = create_monitor_evaluation(monitors, create_characteristics(DataEnum::integer));
+
+    evaluate_monitors(evaluation, DataEnum::integer, "50", "70");
+    EXPECT_FALSE(is_triggered(evaluation, 1));
+    EXPECT_FALSE(is_triggered(evaluation, 2));
+    EXPECT_FALSE(is_triggered(evaluation, 3));
+
+    evaluate_monitors(evaluation, DataEnum::integer, "70", "101");
+    EXPECT_TRUE(is_triggered(evaluation, 1));
+    EXPECT_FALSE(is_triggered(evaluation, 2));
+    EXPECT_TRUE(is_triggered(evaluation, 3));
+
+    evaluate_monitors(evaluation, DataEnum::integer, "101", "9");
+    EXPECT_FALSE(is_triggered(evaluation, 1));
+    EXPECT_TRUE(is_triggered(evaluation, 2));
+    EXPECT_TRUE(is_triggered(evaluation, 3));
+}
+
+/// \brief Tests that the monitors of non numeric variables trigger on every value change, regardless of their type
+TEST(MonitorEvaluationTest, test_non_numeric_monitors) {
+    const std::unordered_map<std::int64_t, VariableMonitoringMeta> monitors{
+        {1, create_monitor(1, MonitorEnum::UpperThreshold, 1.0f)},
+        {2, create_monitor(2, MonitorEnum::LowerThreshold, 1.0f)},
+        {3, create_monitor(3, MonitorEnum::Delta, 1.0f)},
+    };
+
+    for (const auto data_type : {DataEnum::string, DataEnum::boolean, DataEnum::OptionList}) {
+        auto evaluation = create_monitor_evaluation(monitors, create_characteristics(data_type));
+        EXPECT_FALSE(evaluation.is_numeric);
+        ASSERT_EQ(evaluation.monitor_ids.size(), 3);
+
+        evaluate_monitors(evaluation, data_type, "A", "B");
+        EXPECT_TRUE(is_triggered(evaluation, 1));
+        EXPECT_TRUE(is_triggered(evaluation, 2));
+        EXPECT_TRUE(is_triggered(evaluation, 3));
+
+        evaluate_monitors(evaluation, data_type, "B", "B");
+        EXPECT_FALSE(is_triggered(evaluation, 1));
+        EXPECT_FALSE(is_triggered(evaluation, 2));
+        EXPECT_FALSE(is_triggered(evaluation, 3));
+    }
+}
+
+/// \brief Tests that a numeric delta monitor without a reference value never triggers
+TEST(MonitorEvaluationTest, test_delta_without_reference) {
+    const std::unordered_map<std::int64_t, VariableMonitoringMeta> monitors{
+        {1, create_monitor(1, MonitorEnum::Delta, 1.0f)},
+        {2, create_monitor(2, MonitorEnum::UpperThreshold, 5.0f)},
+    };
+    auto evaluation = create_monitor_evaluation(monitors, create_characteristics(DataEnum::decimal));
+    ASSERT_EQ(evaluation.monitor_ids.size(), 2);
+
+    evaluate_monitors(evaluation, DataEnum::decimal, "0.0", "1000.0");
+    EXPECT_FALSE(is_triggered(evaluation, 1));
+    EXPECT_TRUE(is_triggered(evaluation, 2));
+
+    evaluate_monitors(evaluation, DataEnum::decimal, "1000.0", "-1000.0");
+    EXPECT_FALSE(is_triggered(evaluation, 1));
+    EXPECT_FALSE(is_triggered(evaluation, 2));
+}
+
+class MonitoringUpdaterTest : public ::testing::Test {
+protected:
+    DeviceModelTestHelper device_model_test_helper;
+    DeviceModel* dm;
+    std::mutex events_mutex;
+    std::vector<SeverityEventData> events;
+    MonitoringUpdater monitoring_updater;
+    const RequiredComponentVariable cv = ControllerComponentVariables::AlignedDataInterval;
+
+    MonitoringUpdaterTest() :
+        device_model_test_helper(),
+        dm(device_model_test_helper.get_device_model()),
+        monitoring_updater(
+            *dm,
+            [this](std::vector<SeverityEventData>&& new_events) {
+                std::lock_guard<std::mutex> lock(events_mutex);
+                events.insert(events.end(), new_events.begin(), new_events.end());
+            },
+            []() { return false; }) {
+        // Started while monitoring is disabled, so that only the listeners are registered and the monitors are only
+        // processed when the test asks for it
+        monitoring_updater.start_monitoring();
+        dm->set_value(ControllerComponentVariables::MonitoringCtrlrEnabled.component,
+                      ControllerComponentVariables::MonitoringCtrlrEnabled.variable.value(), AttributeEnum::Actual,
+                      "true", "test");
+    }
+
+    ~MonitoringUpdaterTest() override {
+        monitoring_updater.stop_monitoring();
+        dm->clear_custom_monitors();
+    }
+
+    std::vector<SeverityEventData> take_events() {
+        monitoring_updater.process_monitors();
+        std::lock_guard<std::mutex> lock(events_mutex);
+        return std::move(events);
+    }
+
+    void set_interval(const std::string& value) {
+        ASSERT_EQ(dm->set_value(cv.component, cv.variable.value(), AttributeEnum::Actual, value, "test"),
+                  SetVariableStatusEnum::Accepted);
+    }
+};
+
+/// \brief Tests that a monitor that is replaced in place, keeping its id and the number of monitors of the variable,
+/// is evaluated with its new value
+TEST_F(MonitoringUpdaterTest, test_monitor_replaced_in_place) {
+    SetMonitoringData request;
+    request.value = 2000.0f;
+    request.type = MonitorEnum::UpperThreshold;
+    request.severity = 0;
+    request.component = cv.component;
+    request.variable = cv.variable.value();
+
+    auto results = dm->set_monitors({request});
+    ASSERT_EQ(results.size(), 1);
+    ASSERT_EQ(results[0].status, SetMonitoringStatusEnum::Accepted);
+
+    // Builds the evaluation of the variable with the threshold of 2000
+    set_interval("1500");
+    EXPECT_TRUE(take_events().empty());
+
+    request.id = results[0].id;
+    request.value = 1000.0f;
+    results = dm->set_monitors({request});
+    ASSERT_EQ(results[0].status, SetMonitoringStatusEnum::Accepted);
+
+    set_interval("1600");
+    const auto triggered_events = take_events();
+    ASSERT_EQ(triggered_events.size(), 1);
+    EXPECT_EQ(triggered_events[0].event.variableMonitoringId, results[0].id.value());
+    EXPECT_EQ(triggered_events[0].event.actualValue.get(), "1600");
+    EXPECT_EQ(triggered_events[0].event.trigger, EventTriggerEnum::Alerting);
+}
+
+/// \brief Tests that a cleared monitor is no longer evaluated
+TEST_F(MonitoringUpdaterTest, test_monitor_cleared) {
+    SetMonitoringData request;
+    request.value = 1000.0f;
+    request.type = MonitorEnum::UpperThreshold;
+    request.severity = 0;
+    request.component = cv.component;
+    request.variable = cv.variable.value();
+
+    auto results = dm->set_monitors({request});
+    ASSERT_EQ(results[0].status, SetMonitoringStatusEnum::Accepted);
+
+    set_interval("1500");
+    EXPECT_EQ(take_events().size(), 1);
+
+    dm->clear_monitors({results[0].id.value()});
+
+    set_interval("500");
+    set_interval("1600");
+    EXPECT_TRUE(take_events().empty());
+}
+
+} // namespace v2
+} // namespace ocpp
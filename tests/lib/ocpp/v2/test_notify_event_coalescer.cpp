@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <ocpp/v2/notify_event_coalescer.hpp>
+
+namespace ocpp {
+namespace v2 {
+
+class NotifyEventCoalescerTest : public ::testing::Test {
+protected:
+    std::vector<std::vector<EventData>> sent_batches;
+    std::size_t messages_per_batch = 1;
+
+    NotifyEventCoalescer::SendCallback send_callback() {
+        return [this](std::vector<EventData>&& events) {
+            sent_batches.push_back(std::move(events));
+            return messages_per_batch;
+        };
+    }
+
+    static SeverityEventData create_event(const std::int32_t event_id, const std::int32_t severity) {
+        EventData event;
+        event.eventId = event_id;
+        event.trigger = EventTriggerEnum::Alerting;
+        event.actualValue = std::to_string(event_id);
+        event.component.name = "Component";
+        event.variable.name = "Variable";
+        return {event, severity};
+    }
+};
+
+/// \brief Tests that without a window every added group of events is sent immediately as one batch
+TEST_F(NotifyEventCoalescerTest, test_no_window) {
+    NotifyEventCoalescer coalescer(send_callback(), std::chrono::milliseconds(0), 100);
+
+    coalescer.add({create_event(1, 5), create_event(2, 1), create_event(3, 5)});
+    coalescer.add({create_event(4, 3)});
+
+    ASSERT_EQ(sent_batches.size(), 2);
+    ASSERT_EQ(sent_batches[0].size(), 3);
+    // Ordered by severity, equal severities keep their order
+    EXPECT_EQ(sent_batches[0][0].eventId, 2);
+    EXPECT_EQ(sent_batches[0][1].eventId, 1);
+    EXPECT_EQ(sent_batches[0][2].eventId, 3);
+    ASSERT_EQ(sent_batches[1].size(), 1);
+    EXPECT_EQ(sent_batches[1][0].eventId, 4);
+
+    const auto statistics = coalescer.get_statistics();
+    EXPECT_EQ(statistics.events_coalesced, 3);
+    EXPECT_EQ(statistics.messages_saved, 2);
+}
+
+/// \brief Tests that events are collected within the window until the batch is full or it is flushed
+TEST_F(NotifyEventCoalescerTest, test_window) {
+    NotifyEventCoalescer coalescer(send_callback(), std::chrono::hours(1), 4);
+
+    coalescer.add({create_event(1, 7)});
+    coalescer.add({create_event(2, 0), create_event(3, 9)});
+    EXPECT_TRUE(sent_batches.empty());
+
+    // The batch is full
+    coalescer.add({create_event(4, 7)});
+    ASSERT_EQ(sent_batches.size(), 1);
+    ASSERT_EQ(sent_batches[0].size(), 4);
+    EXPECT_EQ(sent_batches[0][0].eventId, 2);
+    EXPECT_EQ(sent_batches[0][1].eventId, 1);
+    EXPECT_EQ(sent_batches[0][2].eventId, 4);
+    EXPECT_EQ(sent_batches[0][3].eventId, 3);
+
+    coalescer.add({create_event(5, 7)});
+    EXPECT_EQ(sent_batches.size(), 1);
+    coalescer.flush();
+    ASSERT_EQ(sent_batches.size(), 2);
+    ASSERT_EQ(sent_batches[1].size(), 1);
+
+    // Nothing left to send
+    coalescer.flush();
+    EXPECT_EQ(sent_batches.size(), 2);
+
+    const auto statistics = coalescer.get_statistics();
+    EXPECT_EQ(statistics.events_coalesced, 4);
+    EXPECT_EQ(statistics.messages_saved, 3);
+}
+
+/// \brief Tests that a batch split into several messages is accounted for in the statistics
+TEST_F(NotifyEventCoalescerTest, test_statistics_split_batch) {
+    messages_per_batch = 2;
+    NotifyEventCoalescer coalescer(send_callback(), std::chrono::milliseconds(0), 100);
+
+    coalescer.add({create_event(1, 1), create_event(2, 1), create_event(3, 1)});
+
+    const auto statistics = coalescer.get_statistics();
+    EXPECT_EQ(statistics.events_coalesced, 3);
+    EXPECT_EQ(statistics.messages_saved, 1);
+}
+
+/// \brief Tests that the events collected within the window are sent when the coalescer is destroyed
+TEST_F(NotifyEventCoalescerTest, test_destruction_sends_collected_events) {
+    {
+        NotifyEventCoalescer coalescer(send_callback(), std::chrono::hours(1), 4);
+        coalescer.add({create_event(1, 2), create_event(2, 1)});
+        EXPECT_TRUE(sent_batches.empty());
+    }
+
+    ASSERT_EQ(sent_batches.size(), 1);
+    ASSERT_EQ(sent_batches[0].size(), 2);
+    EXPECT_EQ(sent_batches[0][0].eventId, 2);
+    EXPECT_EQ(sent_batches[0][1].eventId, 1);
+}
+
+} // namespace v2
+} // namespace ocpp
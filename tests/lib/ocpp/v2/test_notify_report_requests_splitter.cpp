@@ -160,5 +160,61 @@ TEST_F(NotifyReportRequestsSplitterTest, test_splits_contains_at_least_one_repor
     }
 }
 
+/// \brief Test that adding report data one by one results in the same payloads as splitting the complete request
+TEST_F(NotifyReportRequestsSplitterTest, test_incremental_split_matches_full_split) {
+    // Setup
+    NotifyReportRequest req{};
+    req.requestId = 42;
+    req.reportData = {ReportData{{"component_name"}, {"variable_name"}, {}, {}, {}},
+                      ReportData{{"component_name2"}, {"variable_name2"}, {}, {}, {}},
+                      ReportData{{"component_name3"}, {"variable_name3"}, {}, {}, {}}};
+    req.tbc = false;
+
+    const size_t max_size = json{2, "test_message_0", "NotifyReport", req}.dump().size() - 1;
+
+    NotifyReportRequestsSplitter full_splitter{req, max_size, [this]() { return this->generate_message_id(); }};
+    const auto expected = full_splitter.create_call_payloads();
+    ASSERT_EQ(expected.size(), 2);
+
+    // Act: feed the report data one by one
+    NotifyReportRequest streamed_req{};
+    streamed_req.requestId = 42;
+    streamed_req.tbc = false;
+    NotifyReportRequestsSplitter splitter{streamed_req, max_size, [this]() { return this->generate_message_id(); }};
+
+    std::vector<json> res;
+    for (const auto& report_data : req.reportData.value()) {
+        auto payload = splitter.add_report_data(report_data);
+        if (payload.has_value()) {
+            res.push_back(payload.value());
+        }
+    }
+    res.push_back(splitter.finalize());
+
+    // Verify: same payloads apart from the message id
+    ASSERT_EQ(res.size(), expected.size());
+    for (size_t i = 0; i < res.size(); i++) {
+        check_valid_call_payload(res[i]);
+        ASSERT_EQ(expected[i][3]["reportData"].dump(), res[i][3]["reportData"].dump());
+        ASSERT_EQ(expected[i][3]["tbc"], res[i][3]["tbc"]);
+        ASSERT_EQ(expected[i][3]["seqNo"], res[i][3]["seqNo"]);
+    }
+}
+
+/// \brief Test that finalizing a report without any report data still results in a single payload
+TEST_F(NotifyReportRequestsSplitterTest, test_finalize_without_report_data) {
+    NotifyReportRequest req{};
+    req.requestId = 42;
+    req.tbc = false;
+    NotifyReportRequestsSplitter splitter{req, 1000, [this]() { return this->generate_message_id(); }};
+
+    auto payload = splitter.finalize();
+
+    check_valid_call_payload(payload);
+    ASSERT_EQ("[]", payload[3]["reportData"].dump());
+    ASSERT_EQ("false", payload[3]["tbc"].dump());
+    ASSERT_EQ("0", payload[3]["seqNo"].dump());
+}
+
 } // namespace v2
 } // namespace ocpp
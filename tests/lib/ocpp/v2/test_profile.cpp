@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright 2020 - 2024 Pionix GmbH and Contributors to EVerest
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
 #include <fstream>
@@ -723,4 +724,80 @@ TEST(OCPPTypesTest, ChargingSchedule_Equality) {
     ASSERT_EQ(schedule1, schedule2);
 }
 
+TEST(OCPPTypesTest, CalculateAllProfiles_DailyRecurringForAWeek) {
+    // Three daily profiles with a period every 6 hours, starting at 00:00, 01:00 and 02:00
+    std::vector<ChargingProfile> profiles;
+    for (std::int32_t i = 0; i < 3; i++) {
+        auto profile = create_charging_profile(
+            i + 1, ChargingProfilePurposeEnum::TxDefaultProfile,
+            create_charge_schedule(ChargingRateUnitEnum::A,
+                                   create_charging_schedule_periods({0, 6 * 3600, 12 * 3600, 18 * 3600}),
+                                   ocpp::DateTime("2024-01-01T0" + std::to_string(i) + ":00:00Z")),
+            std::nullopt, ChargingProfileKindEnum::Recurring);
+        profile.recurrencyKind = RecurrencyKindEnum::Daily;
+        profiles.push_back(profile);
+    }
+
+    const auto periods = calculate_all_profiles(dt("10T00:30"), dt("17T00:30"), std::nullopt, profiles,
+                                                ChargingProfilePurposeEnum::TxDefaultProfile);
+
+    // 7 days of 4 periods per profile, together with the periods that started before and after the week
+    ASSERT_EQ(periods.size(), 3 * 29);
+    EXPECT_TRUE(std::is_sorted(periods.begin(), periods.end(),
+                               [](const period_entry_t& a, const period_entry_t& b) { return a.start < b.start; }));
+    EXPECT_EQ(periods.front().start, dt("9T19:00"));
+    EXPECT_EQ(periods.back().start, dt("17T00:00"));
+
+    std::size_t nr_of_profile_periods = 0;
+    for (const auto& profile : profiles) {
+        nr_of_profile_periods += calculate_profile(dt("10T00:30"), dt("17T00:30"), std::nullopt, profile).size();
+    }
+    EXPECT_EQ(nr_of_profile_periods, periods.size());
+}
+
+TEST(OCPPTypesTest, MergeProfilesByLowestLimit_ManyPeriods) {
+    const auto create_intermediate = [](const std::int32_t nr_of_periods, const std::int32_t period_duration,
+                                        const float offset) {
+        IntermediateProfile profile;
+        for (std::int32_t i = 0; i < nr_of_periods; i++) {
+            IntermediatePeriod period{};
+            period.startPeriod = i * period_duration;
+            period.current_limit = {offset + static_cast<float>(i % 7), NO_LIMIT_SPECIFIED, NO_LIMIT_SPECIFIED};
+            period.power_limit = {NO_LIMIT_SPECIFIED, NO_LIMIT_SPECIFIED, NO_LIMIT_SPECIFIED};
+            period.current_discharge_limit = {NO_DISCHARGE_LIMIT_SPECIFIED, NO_DISCHARGE_LIMIT_SPECIFIED,
+                                              NO_DISCHARGE_LIMIT_SPECIFIED};
+            period.power_discharge_limit = {NO_DISCHARGE_LIMIT_SPECIFIED, NO_DISCHARGE_LIMIT_SPECIFIED,
+                                            NO_DISCHARGE_LIMIT_SPECIFIED};
+            period.current_setpoint = {NO_SETPOINT_SPECIFIED, NO_SETPOINT_SPECIFIED, NO_SETPOINT_SPECIFIED};
+            period.power_setpoint = {NO_SETPOINT_SPECIFIED, NO_SETPOINT_SPECIFIED, NO_SETPOINT_SPECIFIED};
+            profile.push_back(period);
+        }
+        return profile;
+    };
+    const std::vector<IntermediateProfile> profiles = {create_intermediate(600, 60, 10.0F),
+                                                       create_intermediate(400, 90, 12.0F)};
+
+    const auto limit_at = [](const IntermediateProfile& profile, const std::int32_t time) {
+        auto it = std::upper_bound(
+            profile.begin(), profile.end(), time,
+            [](const std::int32_t value, const IntermediatePeriod& period) { return value < period.startPeriod; });
+        return std::prev(it)->current_limit.limit;
+    };
+
+    const auto merged = merge_profiles_by_lowest_limit(profiles, OcppProtocolVersion::v201);
+    ASSERT_FALSE(merged.empty());
+    EXPECT_EQ(merged.front().startPeriod, 0);
+    for (std::size_t i = 0; i < merged.size(); i++) {
+        if (i > 0) {
+            EXPECT_LT(merged[i - 1].startPeriod, merged[i].startPeriod);
+            EXPECT_NE(merged[i - 1].current_limit, merged[i].current_limit);
+        }
+        const auto end = i + 1 < merged.size() ? merged[i + 1].startPeriod : 36000;
+        for (auto time = merged[i].startPeriod; time < end; time += 30) {
+            EXPECT_FLOAT_EQ(merged[i].current_limit.limit,
+                            std::min(limit_at(profiles[0], time), limit_at(profiles[1], time)));
+        }
+    }
+}
+
 } // namespace
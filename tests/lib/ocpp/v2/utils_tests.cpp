@@ -44,6 +44,15 @@ TEST_F(V2UtilsTest, test_valid_generate_token_hash) {
               ocpp::v2::utils::generate_token_hash(valid_iso15693_token));
 }
 
+TEST_F(V2UtilsTest, test_sha256_hex_of_parts) {
+    // The parts are hashed like their concatenation
+    const auto hex = ocpp::v2::utils::sha256_hex({"hello", "", " there"});
+    EXPECT_EQ(std::string(hex.data(), hex.size()), ocpp::v2::utils::sha256(short_input));
+
+    const auto empty_hex = ocpp::v2::utils::sha256_hex({});
+    EXPECT_EQ(std::string(empty_hex.data(), empty_hex.size()), ocpp::v2::utils::sha256(empty_input));
+}
+
 TEST_F(V2UtilsTest, test_is_critical_security_event) {
     EXPECT_TRUE(ocpp::v2::utils::is_critical(ocpp::security_events::FIRMWARE_UPDATED));
     EXPECT_TRUE(ocpp::v2::utils::is_critical(ocpp::security_events::SETTINGSYSTEMTIME));
@@ -68,5 +77,15 @@ TEST_F(V2UtilsTest, test_is_critical_security_event) {
     EXPECT_FALSE(ocpp::v2::utils::is_critical(ocpp::security_events::ATTEMPTEDREPLAYATTACKS));
 }
 
+TEST_F(V2UtilsTest, test_get_json_dump_size) {
+    const json empty_object = json::object();
+    const json report = {{"component", {{"name", "short_input"}}},
+                         {"variable", {{"name", long_input}}},
+                         {"values", {1, 2.5, true, nullptr, "\u00e4\"escaped\""}}};
+
+    EXPECT_EQ(empty_object.dump().size(), ocpp::v2::utils::get_json_dump_size(empty_object));
+    EXPECT_EQ(report.dump().size(), ocpp::v2::utils::get_json_dump_size(report));
+}
+
 } // namespace common
 } // namespace ocpp